@@ -0,0 +1,392 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <boost/asio.hpp>
+#include <boost/beast.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "client.hpp"
+#include "client.pb.h"
+#include "common/logging.hpp"
+#include "core/pose_codec.hpp"
+#include "server.pb.h"
+
+namespace beast = boost::beast;
+namespace net = boost::asio;
+namespace websocket = beast::websocket;
+using tcp = net::ip::tcp;
+
+// 按线程统计堆分配：计数线程把 t_allocations 指向自己的计数器
+namespace {
+thread_local std::atomic<std::size_t>* t_allocations = nullptr;
+}  // namespace
+
+void* operator new(std::size_t size) {
+  if (t_allocations != nullptr) {
+    t_allocations->fetch_add(1, std::memory_order_relaxed);
+  }
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t /*size*/) noexcept {
+  std::free(ptr);
+}
+
+namespace {
+
+constexpr auto kToken = "benchmark_token";
+// 每次迭代推送的帧数，摊薄唤醒接收线程的开销
+constexpr std::size_t kBatch = 64;
+constexpr auto kFrameDeadline = std::chrono::seconds(5);
+
+using Frame = std::shared_ptr<const std::string>;
+
+// 只做鉴权的假服务器：按需把预先编码好的帧写给客户端，统计收到的消息
+class FrameServer {
+ public:
+  FrameServer() : acceptor_(ioc_, {net::ip::make_address("127.0.0.1"), 0}) {
+    acceptor_.async_accept([this](beast::error_code ec, tcp::socket socket) {
+      if (!ec) {
+        onAccept(std::move(socket));
+      }
+    });
+    thread_ = std::thread([this] { ioc_.run(); });
+  }
+
+  ~FrameServer() {
+    ioc_.stop();
+    thread_.join();
+  }
+
+  FrameServer(const FrameServer&) = delete;
+  auto operator=(const FrameServer&) -> FrameServer& = delete;
+
+  [[nodiscard]] auto address() const -> std::string {
+    return "127.0.0.1:" + std::to_string(acceptor_.local_endpoint().port());
+  }
+
+  void send(std::vector<Frame> frames) {
+    net::post(ioc_, [this, frames = std::move(frames)] {
+      const bool idle = queue_.empty();
+      queue_.insert(queue_.end(), frames.begin(), frames.end());
+      if (idle) {
+        doWrite();
+      }
+    });
+  }
+
+  // 鉴权之后收到的客户端消息数
+  [[nodiscard]] auto received() const -> std::size_t {
+    return received_.load(std::memory_order_acquire);
+  }
+
+ private:
+  void onAccept(tcp::socket socket) {
+    ws_ = std::make_unique<websocket::stream<beast::tcp_stream>>(
+        std::move(socket));
+    ws_->binary(true);
+    ws_->async_accept([this](beast::error_code ec) {
+      if (!ec) {
+        doRead();
+      }
+    });
+  }
+
+  void doRead() {
+    buffer_.clear();
+    ws_->async_read(buffer_, [this](beast::error_code ec, std::size_t) {
+      if (ec) {
+        return;
+      }
+      picoradar::ClientToServer message;
+      message.ParseFromString(beast::buffers_to_string(buffer_.data()));
+      if (message.has_auth_request()) {
+        picoradar::ServerToClient response;
+        response.mutable_auth_response()->set_success(true);
+        send({std::make_shared<const std::string>(
+            response.SerializeAsString())});
+      } else {
+        received_.fetch_add(1, std::memory_order_release);
+      }
+      doRead();
+    });
+  }
+
+  void doWrite() {
+    ws_->async_write(net::buffer(*queue_.front()),
+                     [this](beast::error_code ec, std::size_t) {
+                       if (ec) {
+                         return;
+                       }
+                       queue_.pop_front();
+                       if (!queue_.empty()) {
+                         doWrite();
+                       }
+                     });
+  }
+
+  net::io_context ioc_;
+  tcp::acceptor acceptor_;
+  std::unique_ptr<websocket::stream<beast::tcp_stream>> ws_;
+  beast::flat_buffer buffer_;
+  std::deque<Frame> queue_;
+  std::atomic<std::size_t> received_{0};
+  std::thread thread_;
+};
+
+// 头显的典型位姿：头部加 bodies 个手柄或追踪器
+auto makePlayer(std::size_t index, std::size_t bodies)
+    -> picoradar::PlayerData {
+  picoradar::PlayerData player;
+  player.set_player_id("player_" + std::to_string(index));
+  player.set_scene_id("arena");
+  const auto offset = static_cast<float>(index);
+  player.mutable_position()->set_x(offset * 0.7F);
+  player.mutable_position()->set_y(1.7F);
+  player.mutable_position()->set_z(offset * 0.3F);
+  player.mutable_rotation()->set_y(0.38F);
+  player.mutable_rotation()->set_w(0.92F);
+  player.set_timestamp(1700000000000 + static_cast<std::int64_t>(index));
+  for (std::size_t slot = 0; slot < bodies; ++slot) {
+    auto* body = player.add_bodies();
+    body->set_slot(static_cast<std::uint32_t>(slot));
+    body->mutable_position()->set_x(offset * 0.7F + 0.3F);
+    body->mutable_position()->set_y(1.2F);
+    body->mutable_position()->set_z(offset * 0.3F);
+    body->mutable_rotation()->set_w(1.0F);
+  }
+  return player;
+}
+
+auto makeFrame(const picoradar::ServerToClient& message) -> Frame {
+  return std::make_shared<const std::string>(message.SerializeAsString());
+}
+
+auto playerList(std::size_t players, std::size_t first = 0,
+                bool partial = false) -> Frame {
+  picoradar::ServerToClient message;
+  auto* list = message.mutable_player_list();
+  list->set_partial(partial);
+  for (std::size_t i = first; i < first + players; ++i) {
+    *list->add_players() = makePlayer(i, 2);
+  }
+  return makeFrame(message);
+}
+
+auto compactPlayerList(std::size_t players) -> Frame {
+  picoradar::ServerToClient message;
+  auto* list = message.mutable_compact_player_list();
+  for (std::size_t i = 0; i < players; ++i) {
+    picoradar::core::PoseCodec::encode(makePlayer(i, 2),
+                                       picoradar::core::PrecisionBand::Near,
+                                       list->add_players());
+  }
+  return makeFrame(message);
+}
+
+auto proximityAlert() -> Frame {
+  picoradar::ServerToClient message;
+  auto* event = message.mutable_proximity_alert()->add_events();
+  event->set_other_player_id("player_1");
+  event->set_distance(1.2F);
+  event->set_closing_speed(0.4F);
+  return makeFrame(message);
+}
+
+// 已连接到 FrameServer 的客户端；回调在网络线程上计数并开启分配统计
+class ConnectedClient {
+ public:
+  ConnectedClient() {
+    logger::Logger::setGlobalLevel(logger::LogLevel::ERROR);
+    client_.setOnPlayerListUpdate(
+        [this](const std::vector<picoradar::PlayerData>& players) {
+          benchmark::DoNotOptimize(players.data());
+          onFrame();
+        });
+    client_.setOnProximityAlert(
+        [this](const picoradar::ProximityAlert& alert) {
+          benchmark::DoNotOptimize(&alert);
+          onFrame();
+        });
+    client_.connect(server_.address(), "benchmark_player", kToken).get();
+  }
+
+  ~ConnectedClient() { client_.disconnect(); }
+
+  ConnectedClient(const ConnectedClient&) = delete;
+  auto operator=(const ConnectedClient&) -> ConnectedClient& = delete;
+
+  auto client() -> picoradar::client::Client& { return client_; }
+  auto server() -> FrameServer& { return server_; }
+
+  // 推送 frames 并等待回调全部触发；超时返回 false
+  auto deliver(std::vector<Frame> frames) -> bool {
+    const auto target = frames_.load(std::memory_order_acquire) + frames.size();
+    server_.send(std::move(frames));
+    const auto deadline = std::chrono::steady_clock::now() + kFrameDeadline;
+    while (frames_.load(std::memory_order_acquire) < target) {
+      if (std::chrono::steady_clock::now() > deadline) {
+        return false;
+      }
+      std::this_thread::yield();
+    }
+    return true;
+  }
+
+  [[nodiscard]] auto networkAllocations() const -> std::size_t {
+    return network_allocations_.load();
+  }
+
+ private:
+  void onFrame() {
+    t_allocations = &network_allocations_;
+    frames_.fetch_add(1, std::memory_order_release);
+  }
+
+  FrameServer server_;
+  picoradar::client::Client client_;
+  std::atomic<std::size_t> frames_{0};
+  std::atomic<std::size_t> network_allocations_{0};
+};
+
+// 每次迭代推送一批帧，报告每帧耗时与网络线程上的堆分配次数。
+// 计时包含 WebSocket 读取、解析、合并或解码，以及回调分发；工作发生在
+// 客户端网络线程上，因此这些基准使用墙钟时间 (UseRealTime)。
+void runReceive(benchmark::State& state, const std::vector<Frame>& warmup,
+                const std::vector<Frame>& batch) {
+  ConnectedClient fixture;
+  if (!fixture.deliver(warmup)) {
+    state.SkipWithError("warm-up frames were not delivered");
+    return;
+  }
+
+  const auto allocations_before = fixture.networkAllocations();
+  std::size_t bytes = 0;
+  for (const auto& frame : batch) {
+    bytes += frame->size();
+  }
+  for (auto _ : state) {
+    if (!fixture.deliver(batch)) {
+      state.SkipWithError("frames were not delivered in time");
+      return;
+    }
+  }
+
+  const auto frames = static_cast<double>(state.iterations()) *
+                      static_cast<double>(batch.size());
+  state.SetItemsProcessed(static_cast<int64_t>(frames));
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(bytes));
+  state.counters["time/frame"] = benchmark::Counter(
+      frames, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+  state.counters["allocs/frame"] = benchmark::Counter(
+      static_cast<double>(fixture.networkAllocations() - allocations_before) /
+      frames);
+}
+
+// 完整玩家列表 (process_server_message 的主路径)
+void BM_ReceivePlayerList(benchmark::State& state) {
+  const auto players = static_cast<std::size_t>(state.range(0));
+  const std::vector<Frame> batch(kBatch, playerList(players));
+  runReceive(state, {batch.front()}, batch);
+}
+
+// 带宽受限时的部分帧：每帧十分之一的玩家，与上一次的完整列表合并
+void BM_ReceivePartialPlayerList(benchmark::State& state) {
+  const auto players = static_cast<std::size_t>(state.range(0));
+  const auto slice = std::max<std::size_t>(1, players / 10);
+  std::vector<Frame> batch;
+  for (std::size_t i = 0; i < kBatch; ++i) {
+    batch.push_back(
+        playerList(slice, (i * slice) % (players - slice + 1), true));
+  }
+  runReceive(state, {playerList(players)}, batch);
+}
+
+// 紧凑编码的玩家列表，逐个解码为 PlayerData
+void BM_ReceiveCompactPlayerList(benchmark::State& state) {
+  const auto players = static_cast<std::size_t>(state.range(0));
+  const std::vector<Frame> batch(kBatch, compactPlayerList(players));
+  runReceive(state, {batch.front()}, batch);
+}
+
+// 小消息的固定开销：读取、解析与回调分发
+void BM_ReceiveProximityAlert(benchmark::State& state) {
+  const std::vector<Frame> batch(kBatch, proximityAlert());
+  runReceive(state, {batch.front()}, batch);
+}
+
+// sendPlayerData 在调用线程上的序列化与入队开销；参数为追踪部位数。
+// 每 kBatch 次调用后暂停计时，等待网络线程写完，避免队列无限增长。
+void BM_SendPlayerData(benchmark::State& state) {
+  ConnectedClient fixture;
+  // 收到一帧后网络线程开始统计分配，写出的开销记为 net_allocs/op
+  if (!fixture.deliver({playerList(1)})) {
+    state.SkipWithError("warm-up frame was not delivered");
+    return;
+  }
+
+  const auto pose = makePlayer(0, static_cast<std::size_t>(state.range(0)));
+  std::atomic<std::size_t> caller_allocations{0};
+  const auto network_before = fixture.networkAllocations();
+  std::size_t sent = 0;
+
+  for (auto _ : state) {
+    t_allocations = &caller_allocations;
+    fixture.client().sendPlayerData(pose);
+    t_allocations = nullptr;
+
+    if (++sent % kBatch == 0) {
+      state.PauseTiming();
+      const auto deadline = std::chrono::steady_clock::now() + kFrameDeadline;
+      while (fixture.server().received() < sent &&
+             std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+      }
+      state.ResumeTiming();
+    }
+  }
+
+  const auto iterations = static_cast<double>(state.iterations());
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+  state.counters["allocs/op"] = benchmark::Counter(
+      static_cast<double>(caller_allocations.load()) / iterations);
+  state.counters["net_allocs/op"] = benchmark::Counter(
+      static_cast<double>(fixture.networkAllocations() - network_before) /
+      iterations);
+}
+
+}  // namespace
+
+BENCHMARK(BM_ReceivePlayerList)
+    ->Arg(10)
+    ->Arg(50)
+    ->Arg(100)
+    ->Arg(200)
+    ->UseRealTime();
+BENCHMARK(BM_ReceivePartialPlayerList)
+    ->Arg(10)
+    ->Arg(50)
+    ->Arg(100)
+    ->Arg(200)
+    ->UseRealTime();
+BENCHMARK(BM_ReceiveCompactPlayerList)
+    ->Arg(10)
+    ->Arg(50)
+    ->Arg(100)
+    ->Arg(200)
+    ->UseRealTime();
+BENCHMARK(BM_ReceiveProximityAlert)->UseRealTime();
+BENCHMARK(BM_SendPlayerData)->Arg(0)->Arg(3);
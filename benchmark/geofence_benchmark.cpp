@@ -0,0 +1,82 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/geofence.hpp"
+
+using namespace picoradar::core;
+
+namespace {
+
+constexpr float kPi = 3.14159265F;
+
+// 生成半径交替变化的星形多边形（非凸），模拟复杂场地边界
+auto makeStarPolygon(std::size_t vertex_count, float radius)
+    -> std::vector<PlanarPoint> {
+  std::vector<PlanarPoint> vertices;
+  vertices.reserve(vertex_count);
+  for (std::size_t i = 0; i < vertex_count; ++i) {
+    const float angle =
+        2.0F * kPi * static_cast<float>(i) / static_cast<float>(vertex_count);
+    const float r = (i % 2 == 0) ? radius : radius * 0.8F;
+    vertices.push_back({r * std::cos(angle), r * std::sin(angle)});
+  }
+  return vertices;
+}
+
+auto makePlayers(std::size_t count) -> GeofenceEngine::PlayerMap {
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> coord(-25.0F, 25.0F);
+
+  GeofenceEngine::PlayerMap players;
+  for (std::size_t i = 0; i < count; ++i) {
+    const auto id = "player_" + std::to_string(i);
+    auto& player = players[id];
+    player.set_player_id(id);
+    player.set_scene_id("arena");
+    player.mutable_position()->set_x(coord(rng));
+    player.mutable_position()->set_y(1.7F);
+    player.mutable_position()->set_z(coord(rng));
+  }
+  return players;
+}
+
+void runEvaluate(benchmark::State& state, std::size_t slab_count) {
+  const auto players = makePlayers(static_cast<std::size_t>(state.range(0)));
+  const auto vertex_count = static_cast<std::size_t>(state.range(1));
+
+  GeofenceEngine engine;
+  engine.addFence("arena", Geofence::polygon(
+                               "arena_bounds", GeofenceMode::PlayArea,
+                               makeStarPolygon(vertex_count, 20.0F),
+                               slab_count));
+  engine.addFence("arena", Geofence::box("pillar", GeofenceMode::KeepOut,
+                                         {-1.0F, -1.0F}, {1.0F, 1.0F}));
+
+  for (auto _ : state) {
+    auto events = engine.evaluate(players);
+    benchmark::DoNotOptimize(events);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+// 使用条带边索引的批量评估
+static void BM_GeofenceEvaluate(benchmark::State& state) {
+  runEvaluate(state, 0);
+}
+BENCHMARK(BM_GeofenceEvaluate)
+    ->ArgNames({"players", "vertices"})
+    ->ArgsProduct({{100, 500}, {16, 256, 4096}});
+
+// 对照组：单条带即逐边射线测试
+static void BM_GeofenceEvaluateUnindexed(benchmark::State& state) {
+  runEvaluate(state, 1);
+}
+BENCHMARK(BM_GeofenceEvaluateUnindexed)
+    ->ArgNames({"players", "vertices"})
+    ->ArgsProduct({{100, 500}, {16, 256, 4096}});
@@ -0,0 +1,99 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cmath>
+#include <filesystem>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/pose_archive.hpp"
+
+using namespace picoradar::core;
+
+namespace {
+
+constexpr int kPlayers = 100;
+constexpr int kFrames = 36000;  // 1 小时，每 100ms 采样一次
+
+// 100 名玩家随机游走一小时的归档，整个进程只生成一次
+auto archivePath() -> const std::string& {
+  static const std::string path = [] {
+    const auto file = (std::filesystem::temp_directory_path() /
+                       "picoradar_pose_archive_benchmark.pra")
+                          .string();
+    std::mt19937 rng(11);
+    std::normal_distribution<float> step(0.0F, 0.1F);
+    std::vector<std::array<float, 3>> state(kPlayers, {0.0F, 0.0F, 0.0F});
+
+    std::map<std::string, picoradar::PlayerData> players;
+    for (int p = 0; p < kPlayers; ++p) {
+      const auto id = "player_" + std::to_string(p);
+      players[id].set_player_id(id);
+      players[id].set_scene_id(p % 2 == 0 ? "arena" : "lobby");
+    }
+
+    PoseArchiveWriter writer(file, 64);
+    for (int frame = 0; frame < kFrames; ++frame) {
+      int p = 0;
+      for (auto& [id, player] : players) {
+        auto& [x, z, yaw] = state[p++];
+        x += step(rng);
+        z += step(rng);
+        yaw += step(rng);
+        player.mutable_position()->set_x(x);
+        player.mutable_position()->set_y(1.7F);
+        player.mutable_position()->set_z(z);
+        player.mutable_rotation()->set_y(std::sin(yaw / 2.0F));
+        player.mutable_rotation()->set_w(std::cos(yaw / 2.0F));
+      }
+      writer.append(static_cast<std::int64_t>(frame) * 100, players);
+    }
+    return file;
+  }();
+  return path;
+}
+
+void BM_ScanFullArchive(benchmark::State& state) {
+  const PoseArchiveReader reader(archivePath());
+  for (auto _ : state) {
+    double sum = 0.0;
+    reader.scan(reader.getStartTime(), reader.getEndTime(),
+                [&](const PoseColumns& columns) {
+                  for (const float x : columns.position[0]) {
+                    sum += x;
+                  }
+                });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(reader.getSampleCount()));
+  state.counters["file_mb"] =
+      static_cast<double>(std::filesystem::file_size(archivePath())) / 1e6;
+}
+BENCHMARK(BM_ScanFullArchive)->Unit(benchmark::kMillisecond);
+
+// 通过块索引定位一分钟窗口
+void BM_ScanOneMinute(benchmark::State& state) {
+  const PoseArchiveReader reader(archivePath());
+  const auto middle = (reader.getStartTime() + reader.getEndTime()) / 2;
+  for (auto _ : state) {
+    std::size_t rows = 0;
+    reader.scan(middle, middle + 60000,
+                [&](const PoseColumns& columns) { rows += columns.size(); });
+    benchmark::DoNotOptimize(rows);
+  }
+}
+BENCHMARK(BM_ScanOneMinute)->Unit(benchmark::kMicrosecond);
+
+void BM_OpenArchive(benchmark::State& state) {
+  archivePath();
+  for (auto _ : state) {
+    const PoseArchiveReader reader(archivePath());
+    benchmark::DoNotOptimize(reader.getBlocks().data());
+  }
+}
+BENCHMARK(BM_OpenArchive)->Unit(benchmark::kMicrosecond);
+
+}  // namespace
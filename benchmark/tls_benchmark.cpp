@@ -0,0 +1,307 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <boost/asio.hpp>
+#include <boost/beast.hpp>
+#include <boost/beast/ssl.hpp>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "client.pb.h"
+#include "common/config_manager.hpp"
+#include "common/logging.hpp"
+#include "server.hpp"
+#include "server.pb.h"
+#include "utils/network_utils.hpp"
+#include "utils/tls_utils.hpp"
+
+namespace beast = boost::beast;
+namespace net = boost::asio;
+namespace ssl = net::ssl;
+namespace websocket = beast::websocket;
+using tcp = net::ip::tcp;
+
+namespace {
+
+constexpr auto kToken = "benchmark_token";
+constexpr std::size_t kNpcCount = 64;  // 每帧约 64 个玩家的完整列表
+constexpr auto kFrameDeadline = std::chrono::seconds(1);
+
+using PlainStream = websocket::stream<beast::tcp_stream>;
+using SecureStream = websocket::stream<beast::ssl_stream<beast::tcp_stream>>;
+
+// 按需启用 TLS 的本地服务器，以及信任其自签名证书的客户端上下文
+class BenchServer {
+ public:
+  explicit BenchServer(bool tls)
+      : port_(picoradar::test::get_available_port()) {
+    logger::Logger::setGlobalLevel(logger::LogLevel::ERROR);
+
+    auto& config = picoradar::common::ConfigManager::getInstance();
+    config.set("auth.token", std::string(kToken));
+    config.set("discovery.udp_port",
+               static_cast<int>(picoradar::test::get_available_port()));
+    config.set("network.tls.enabled", tls);
+    if (tls) {
+      cert_dir_ = std::filesystem::temp_directory_path() /
+                  ("picoradar_tls_bench_" + std::to_string(port_));
+      std::filesystem::create_directories(cert_dir_);
+      const auto cert = picoradar::test::make_test_certificate(cert_dir_);
+      config.set("network.tls.certificate_file",
+                 cert.certificate_file.string());
+      config.set("network.tls.private_key_file",
+                 cert.private_key_file.string());
+      client_context_.load_verify_file(cert.certificate_file.string());
+      client_context_.set_verify_mode(ssl::verify_peer);
+    }
+
+    server_.start(port_, 1);
+  }
+
+  ~BenchServer() {
+    server_.stop();
+    picoradar::common::ConfigManager::getInstance().set("network.tls.enabled",
+                                                        false);
+    if (!cert_dir_.empty()) {
+      std::filesystem::remove_all(cert_dir_);
+    }
+  }
+
+  BenchServer(const BenchServer&) = delete;
+  auto operator=(const BenchServer&) -> BenchServer& = delete;
+
+  [[nodiscard]] auto endpoint() const -> tcp::endpoint {
+    return {net::ip::make_address("127.0.0.1"), port_};
+  }
+  auto server() -> picoradar::server::Server& { return server_; }
+  auto clientContext() -> ssl::context& { return client_context_; }
+
+ private:
+  std::uint16_t port_;
+  std::filesystem::path cert_dir_;
+  ssl::context client_context_{ssl::context::tls_client};
+  picoradar::server::Server server_;
+};
+
+template <class Stream>
+constexpr bool kSecure = std::is_same_v<Stream, SecureStream>;
+
+template <class Stream>
+auto makeStream(net::io_context& ioc, BenchServer& server)
+    -> std::unique_ptr<Stream> {
+  if constexpr (kSecure<Stream>) {
+    return std::make_unique<Stream>(ioc, server.clientContext());
+  } else {
+    return std::make_unique<Stream>(ioc);
+  }
+}
+
+// TCP 连接、可选的 TLS 握手（可带上次的会话）与 WebSocket 握手
+template <class Stream>
+void openStream(Stream& ws, const tcp::endpoint& endpoint,
+                SSL_SESSION* session = nullptr) {
+  beast::get_lowest_layer(ws).connect(endpoint);
+  beast::get_lowest_layer(ws).socket().set_option(tcp::no_delay(true));
+  if constexpr (kSecure<Stream>) {
+    if (session != nullptr) {
+      SSL_set_session(ws.next_layer().native_handle(), session);
+    }
+    ws.next_layer().handshake(ssl::stream_base::client);
+  }
+  ws.handshake("127.0.0.1", "/");
+  ws.binary(true);
+}
+
+template <class Stream>
+void runHandshakes(benchmark::State& state, bool resume) {
+  BenchServer server(kSecure<Stream>);
+  net::io_context ioc;
+  std::unique_ptr<SSL_SESSION, decltype(&SSL_SESSION_free)> session(
+      nullptr, &SSL_SESSION_free);
+
+  for (auto _ : state) {
+    auto ws = makeStream<Stream>(ioc, server);
+    openStream(*ws, server.endpoint(), session.get());
+    if constexpr (kSecure<Stream>) {
+      // TLS 1.3 票据随握手后的首批数据到达，此时会话已可恢复
+      if (resume && !session) {
+        session.reset(SSL_SESSION_dup(
+            SSL_get0_session(ws->next_layer().native_handle())));
+      }
+    }
+    beast::error_code ec;
+    ws->close(websocket::close_code::normal, ec);
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+  state.counters["resumed"] = benchmark::Counter(
+      static_cast<double>(server.server().getTlsResumedHandshakes()));
+}
+
+// 已认证的接收端，在 io 线程上持续读取并统计收到的帧
+template <class Stream>
+class Receiver {
+ public:
+  Receiver(net::io_context& ioc, BenchServer& server, const std::string& id)
+      : ws_(makeStream<Stream>(ioc, server)) {
+    openStream(*ws_, server.endpoint());
+
+    picoradar::ClientToServer request;
+    request.mutable_auth_request()->set_player_id(id);
+    request.mutable_auth_request()->set_token(kToken);
+    ws_->write(net::buffer(request.SerializeAsString()));
+
+    picoradar::ServerToClient response;
+    do {
+      buffer_.clear();
+      ws_->read(buffer_);
+      response.ParseFromString(beast::buffers_to_string(buffer_.data()));
+    } while (!response.has_auth_response());
+    if (!response.auth_response().success()) {
+      throw std::runtime_error("authentication failed");
+    }
+  }
+
+  void start() { doRead(); }
+  void close() {
+    beast::error_code ec;
+    beast::get_lowest_layer(*ws_).socket().close(ec);
+  }
+
+  [[nodiscard]] auto frames() const -> std::size_t { return frames_.load(); }
+  [[nodiscard]] auto bytes() const -> std::size_t { return bytes_.load(); }
+
+ private:
+  void doRead() {
+    buffer_.clear();
+    ws_->async_read(buffer_, [this](beast::error_code ec, std::size_t bytes) {
+      if (ec) {
+        return;
+      }
+      bytes_ += bytes;
+      ++frames_;
+      doRead();
+    });
+  }
+
+  std::unique_ptr<Stream> ws_;
+  beast::flat_buffer buffer_;
+  std::atomic<std::size_t> frames_{0};
+  std::atomic<std::size_t> bytes_{0};
+};
+
+auto makeNpc(std::size_t index, float x) -> picoradar::PlayerData {
+  picoradar::PlayerData npc;
+  npc.set_player_id("npc_" + std::to_string(index));
+  npc.set_scene_id("arena");
+  npc.mutable_position()->set_x(x);
+  npc.mutable_position()->set_y(1.7F);
+  npc.mutable_position()->set_z(static_cast<float>(index));
+  npc.mutable_rotation()->set_w(1.0F);
+  return npc;
+}
+
+// 每次迭代更新一个 NPC 并等待所有接收端收到新的玩家列表
+template <class Stream>
+void runBroadcast(benchmark::State& state) {
+  BenchServer server(kSecure<Stream>);
+  for (std::size_t i = 0; i < kNpcCount; ++i) {
+    server.server().upsertNpc(makeNpc(i, 0.0F));
+  }
+
+  net::io_context ioc;
+  std::vector<std::unique_ptr<Receiver<Stream>>> receivers;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    receivers.push_back(std::make_unique<Receiver<Stream>>(
+        ioc, server, "receiver_" + std::to_string(i)));
+  }
+  for (auto& receiver : receivers) {
+    receiver->start();
+  }
+  std::thread io_thread([&ioc] { ioc.run(); });
+
+  const auto total = [&receivers](auto count) {
+    std::size_t sum = 0;
+    for (const auto& receiver : receivers) {
+      sum += count(*receiver);
+    }
+    return sum;
+  };
+  const auto frames = [&] { return total([](auto& r) { return r.frames(); }); };
+  const auto bytes = [&] { return total([](auto& r) { return r.bytes(); }); };
+
+  // 等待鉴权触发的广播排空
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  const auto bytes_before = bytes();
+  std::size_t stalls = 0;
+  float x = 0.0F;
+
+  for (auto _ : state) {
+    const auto target = frames() + receivers.size();
+    x += 0.01F;
+    server.server().upsertNpc(makeNpc(0, x));
+
+    const auto deadline = std::chrono::steady_clock::now() + kFrameDeadline;
+    while (frames() < target) {
+      if (std::chrono::steady_clock::now() > deadline) {
+        ++stalls;
+        break;
+      }
+      std::this_thread::yield();
+    }
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(bytes() - bytes_before));
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range(0));
+  state.counters["stalls"] = static_cast<double>(stalls);
+
+  net::post(ioc, [&receivers] {
+    for (auto& receiver : receivers) {
+      receiver->close();
+    }
+  });
+  io_thread.join();
+}
+
+}  // namespace
+
+// 握手速率：明文、完整 TLS 握手、携带会话票据的恢复握手
+static void BM_HandshakePlain(benchmark::State& state) {
+  runHandshakes<PlainStream>(state, false);
+}
+BENCHMARK(BM_HandshakePlain)->Unit(benchmark::kMicrosecond);
+
+static void BM_HandshakeTls(benchmark::State& state) {
+  runHandshakes<SecureStream>(state, false);
+}
+BENCHMARK(BM_HandshakeTls)->Unit(benchmark::kMicrosecond);
+
+static void BM_HandshakeTlsResumed(benchmark::State& state) {
+  runHandshakes<SecureStream>(state, true);
+}
+BENCHMARK(BM_HandshakeTlsResumed)->Unit(benchmark::kMicrosecond);
+
+// 广播吞吐：每次更新向所有接收端推送约 64 个玩家的完整列表
+static void BM_BroadcastPlain(benchmark::State& state) {
+  runBroadcast<PlainStream>(state);
+}
+BENCHMARK(BM_BroadcastPlain)
+    ->ArgName("receivers")
+    ->Arg(1)
+    ->Arg(8)
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_BroadcastTls(benchmark::State& state) {
+  runBroadcast<SecureStream>(state);
+}
+BENCHMARK(BM_BroadcastTls)
+    ->ArgName("receivers")
+    ->Arg(1)
+    ->Arg(8)
+    ->Unit(benchmark::kMicrosecond);
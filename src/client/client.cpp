@@ -18,6 +18,26 @@ void Client::setOnPlayerListUpdate(PlayerListCallback callback) {
   pimpl_->setOnPlayerListUpdate(std::move(callback));
 }
 
+void Client::setOnHeatmapUpdate(HeatmapCallback callback) {
+  pimpl_->setOnHeatmapUpdate(std::move(callback));
+}
+
+void Client::setOnProximityAlert(ProximityCallback callback) {
+  pimpl_->setOnProximityAlert(std::move(callback));
+}
+
+void Client::setOnGeofenceAlert(GeofenceCallback callback) {
+  pimpl_->setOnGeofenceAlert(std::move(callback));
+}
+
+void Client::setTlsOptions(TlsOptions options) {
+  pimpl_->setTlsOptions(std::move(options));
+}
+
+void Client::setSessionClass(SessionClass session_class) {
+  pimpl_->setSessionClass(session_class);
+}
+
 std::future<void> Client::connect(const std::string& server_address,
                                   const std::string& player_id,
                                   const std::string& token) const {
@@ -27,6 +47,15 @@ std::future<void> Client::connect(const std::string& server_address,
   return pimpl_->connect(server_address, player_id, token);
 }
 
+std::future<void> Client::connect(std::shared_ptr<Transport> transport,
+                                  const std::string& player_id,
+                                  const std::string& token) const {
+  LOG_INFO << "Client connecting over custom transport with player_id: "
+           << player_id;
+
+  return pimpl_->connect(std::move(transport), player_id, token);
+}
+
 void Client::disconnect() const {
   LOG_INFO << "Client disconnecting";
   pimpl_->disconnect();
@@ -38,4 +67,8 @@ void Client::sendPlayerData(const PlayerData& data) {
 
 bool Client::isConnected() const { return pimpl_->isConnected(); }
 
+bool Client::isTlsSessionResumed() const {
+  return pimpl_->isTlsSessionResumed();
+}
+
 }  // namespace picoradar::client
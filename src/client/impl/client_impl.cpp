@@ -1,14 +1,31 @@
 #include "client_impl.hpp"
 
+#include <algorithm>
+#include <boost/asio/ssl/host_name_verification.hpp>
 #include <sstream>
+#include <unordered_map>
 
 #include "client.pb.h"
 #include "common/logging.hpp"
 #include "common/platform_fixes.hpp"
+#include "core/pose_codec.hpp"
 #include "server.pb.h"
 
 namespace picoradar::client {
 
+namespace {
+constexpr std::string_view kSecureScheme = "wss://";
+constexpr std::string_view kPlainScheme = "ws://";
+
+// SSL_CTX 上保存所属 Impl 的扩展数据槽位。app data 已被 asio 的
+// ssl::context 占用，用于保存证书校验回调
+auto tls_owner_index() -> int {
+  static const int index =
+      SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+  return index;
+}
+}  // namespace
+
 Client::Impl::Impl()
     : ioc_(std::make_unique<net::io_context>()),
       resolver_(std::make_unique<tcp::resolver>(*ioc_)),
@@ -35,6 +52,37 @@ void Client::Impl::setOnPlayerListUpdate(Client::PlayerListCallback callback) {
   LOG_DEBUG << "Player list callback set";
 }
 
+void Client::Impl::setOnHeatmapUpdate(Client::HeatmapCallback callback) {
+  std::lock_guard lock(state_mutex_);
+  heatmap_callback_ = std::move(callback);
+  LOG_DEBUG << "Heatmap callback set";
+}
+
+void Client::Impl::setOnProximityAlert(Client::ProximityCallback callback) {
+  std::lock_guard lock(state_mutex_);
+  proximity_callback_ = std::move(callback);
+  LOG_DEBUG << "Proximity callback set";
+}
+
+void Client::Impl::setOnGeofenceAlert(Client::GeofenceCallback callback) {
+  std::lock_guard lock(state_mutex_);
+  geofence_callback_ = std::move(callback);
+  LOG_DEBUG << "Geofence callback set";
+}
+
+void Client::Impl::setSessionClass(SessionClass session_class) {
+  session_class_ = session_class;
+}
+
+void Client::Impl::setTlsOptions(Client::TlsOptions options) {
+  std::lock_guard lock(state_mutex_);
+  tls_options_ = std::move(options);
+  // 新的信任配置下旧会话不再可用
+  tls_context_.reset();
+  std::lock_guard session_lock(tls_mutex_);
+  tls_session_.reset();
+}
+
 std::future<void> Client::Impl::connect(const std::string& server_address,
                                         const std::string& player_id,
                                         const std::string& token) {
@@ -46,8 +94,17 @@ std::future<void> Client::Impl::connect(const std::string& server_address,
     throw std::invalid_argument("Token cannot be empty.");
   }
 
+  // 可选的 ws:// 或 wss:// 前缀选择传输方式
+  std::string_view address = server_address;
+  const bool secure = address.substr(0, kSecureScheme.size()) == kSecureScheme;
+  if (secure) {
+    address.remove_prefix(kSecureScheme.size());
+  } else if (address.substr(0, kPlainScheme.size()) == kPlainScheme) {
+    address.remove_prefix(kPlainScheme.size());
+  }
+
   // 解析服务器地址, 如果地址格式不正确会抛出异常
-  auto [host, port_str] = parse_address(server_address);
+  auto [host, port_str] = parse_address(std::string(address));
 
   std::lock_guard lock(state_mutex_);
 
@@ -64,6 +121,7 @@ std::future<void> Client::Impl::connect(const std::string& server_address,
     ioc_->stop();
     network_thread_.join();
   }
+  release_transport();
 
   // 重置连接状态
   connect_promise_ = std::promise<void>();
@@ -72,26 +130,37 @@ std::future<void> Client::Impl::connect(const std::string& server_address,
 
   player_id_ = player_id;
   token_ = token;
+  host_ = host;
+  roster_.clear();
+  tls_resumed_ = false;
 
   // 重新创建io_context和相关组件以确保状态清洁
   ioc_ = std::make_unique<net::io_context>();
   resolver_ = std::make_unique<tcp::resolver>(*ioc_);
-  ws_ = std::make_unique<websocket::stream<beast::tcp_stream>>(*ioc_);
+  ws_.reset();
+  wss_.reset();
+  if (secure) {
+    ensure_tls_context();
+    wss_ = std::make_unique<
+        websocket::stream<beast::ssl_stream<beast::tcp_stream>>>(
+        *ioc_, *tls_context_);
+  } else {
+    ws_ = std::make_unique<websocket::stream<beast::tcp_stream>>(*ioc_);
+  }
 
   // 设置 WebSocket 选项
-  ws_->set_option(
-      websocket::stream_base::timeout::suggested(beast::role_type::client));
-
-  ws_->set_option(
-      websocket::stream_base::decorator([](websocket::request_type& req) {
-        req.set(beast::http::field::user_agent, "PICORadar-Client/1.0");
-      }));
+  with_stream([](auto& ws) {
+    ws.set_option(
+        websocket::stream_base::timeout::suggested(beast::role_type::client));
+
+    ws.set_option(
+        websocket::stream_base::decorator([](websocket::request_type& req) {
+          req.set(beast::http::field::user_agent, "PICORadar-Client/1.0");
+        }));
+  });
 
   set_state(ClientState::Connecting);
 
-  // 启动网络线程
-  network_thread_ = std::thread(&Client::Impl::run_network_thread, this);
-
   // 为DNS解析设置超时
   auto resolve_timer = std::make_shared<net::steady_timer>(*ioc_);
   resolve_timer->expires_after(std::chrono::seconds(3));
@@ -115,10 +184,83 @@ std::future<void> Client::Impl::connect(const std::string& server_address,
         handle_resolve(ec, results);
       });
 
+  // 先投递解析与超时任务再启动网络线程，否则 run() 可能因为没有任务而
+  // 立即返回，连接永远不会完成
+  network_thread_ = std::thread(&Client::Impl::run_network_thread, this);
+
   LOG_INFO << "Starting connection to " << server_address;
   return future;
 }
 
+std::future<void> Client::Impl::connect(std::shared_ptr<Transport> transport,
+                                        const std::string& player_id,
+                                        const std::string& token) {
+  if (!transport) {
+    throw std::invalid_argument("Transport cannot be null.");
+  }
+  if (player_id.empty()) {
+    throw std::invalid_argument("Player ID cannot be empty.");
+  }
+  if (token.empty()) {
+    throw std::invalid_argument("Token cannot be empty.");
+  }
+
+  std::future<void> future;
+  {
+    std::lock_guard lock(state_mutex_);
+
+    if (get_state() != ClientState::Disconnected) {
+      auto promise = std::promise<void>();
+      future = promise.get_future();
+      promise.set_exception(std::make_exception_ptr(std::runtime_error(
+          "Client is not in disconnected state. Call disconnect() first.")));
+      return future;
+    }
+
+    release_transport();
+
+    connect_promise_ = std::promise<void>();
+    connect_promise_set_ = false;
+    future = connect_promise_.get_future();
+
+    player_id_ = player_id;
+    token_ = token;
+    roster_.clear();
+    tls_resumed_ = false;
+    transport_ = std::move(transport);
+    set_state(ClientState::Connecting);
+  }
+
+  // 传输层可能在 open() 或 send() 内同步投递服务器消息，因此不持锁调用
+  transport_->open(
+      [this](const std::string& frame) { process_server_message(frame); },
+      [this] { handle_transport_close(); });
+  send_auth_request();
+  return future;
+}
+
+void Client::Impl::release_transport() {
+  if (transport_) {
+    transport_->close();
+    transport_.reset();
+  }
+}
+
+void Client::Impl::handle_transport_close() {
+  LOG_INFO << "Transport closed by server";
+  if (get_state() == ClientState::Connecting) {
+    safe_set_promise_exception(std::make_exception_ptr(
+        std::runtime_error("Connection closed during handshake")));
+  }
+
+  // 无论处于哪个阶段，对端关闭后都回到 Disconnected，允许重新连接
+  {
+    std::lock_guard lock(state_mutex_);
+    release_transport();
+  }
+  set_state(ClientState::Disconnected);
+}
+
 void Client::Impl::disconnect() {
   LOG_INFO << "Disconnecting client";
 
@@ -130,6 +272,16 @@ void Client::Impl::disconnect() {
 
   set_state(ClientState::Disconnecting);
 
+  if (transport_) {
+    {
+      std::lock_guard lock(state_mutex_);
+      release_transport();
+    }
+    set_state(ClientState::Disconnected);
+    LOG_INFO << "Client disconnected";
+    return;
+  }
+
   if (ioc_) {
     // 在 io_context 中执行关闭操作，确保在正确的线程中执行
     net::post(*ioc_, [this] { close_connection(); });
@@ -149,6 +301,7 @@ void Client::Impl::disconnect() {
 
   // 清理资源
   ws_.reset();
+  wss_.reset();
   if (ioc_) {
     ioc_->restart();
   }
@@ -173,6 +326,11 @@ void Client::Impl::sendPlayerData(const PlayerData& data) {
     return;
   }
 
+  if (transport_) {
+    transport_->send(serialized);
+    return;
+  }
+
   // 添加到写队列
   {
     std::lock_guard lock(write_queue_mutex_);
@@ -189,6 +347,52 @@ bool Client::Impl::isConnected() const {
   return get_state() == ClientState::Connected;
 }
 
+bool Client::Impl::isTlsSessionResumed() const { return tls_resumed_.load(); }
+
+void Client::Impl::ensure_tls_context() {
+  if (tls_context_) {
+    return;
+  }
+
+  // 证书加载失败时抛出，且不保留半初始化的上下文
+  auto context = std::make_unique<ssl::context>(ssl::context::tls_client);
+  context->set_options(ssl::context::default_workarounds |
+                       ssl::context::no_sslv2 | ssl::context::no_sslv3 |
+                       ssl::context::no_tlsv1 | ssl::context::no_tlsv1_1);
+  if (tls_options_.verify_peer) {
+    context->set_verify_mode(ssl::verify_peer);
+    if (tls_options_.ca_file.empty()) {
+      context->set_default_verify_paths();
+    } else {
+      context->load_verify_file(tls_options_.ca_file);
+    }
+  } else {
+    context->set_verify_mode(ssl::verify_none);
+  }
+
+  // TLS 1.3 的票据在握手完成后才到达，通过回调保存而不是握手后读取
+  auto* native = context->native_handle();
+  SSL_CTX_set_ex_data(native, tls_owner_index(), this);
+  SSL_CTX_set_session_cache_mode(
+      native, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+  SSL_CTX_sess_set_new_cb(native, &Client::Impl::on_new_tls_session);
+  tls_context_ = std::move(context);
+}
+
+int Client::Impl::on_new_tls_session(SSL* ssl, SSL_SESSION* session) {
+  auto* self = static_cast<Impl*>(
+      SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), tls_owner_index()));
+  // 保存副本：连接未经 close_notify 断开时 OpenSSL 会把连接当前的会话
+  // 标记为不可恢复，而头显掉线正是最需要恢复会话的场景
+  std::unique_ptr<SSL_SESSION, decltype(&SSL_SESSION_free)> copy(
+      SSL_SESSION_dup(session), &SSL_SESSION_free);
+  if (copy) {
+    std::lock_guard lock(self->tls_mutex_);
+    self->tls_session_ = std::move(copy);
+  }
+  return 0;  // 不接管 session 的引用
+}
+
 void Client::Impl::run_network_thread() {
   LOG_DEBUG << "Network thread started";
 
@@ -235,14 +439,16 @@ void Client::Impl::handle_resolve(beast::error_code ec,
     });
 
     // 开始连接
-    beast::get_lowest_layer(*ws_).expires_after(std::chrono::seconds(3));
-    beast::get_lowest_layer(*ws_).async_connect(
-        results, [this, connect_timer](
-                     beast::error_code ec,
-                     tcp::resolver::results_type::endpoint_type endpoint) {
-          connect_timer->cancel();  // 取消超时定时器
-          handle_connect(ec, endpoint);
-        });
+    with_stream([&](auto& ws) {
+      beast::get_lowest_layer(ws).expires_after(std::chrono::seconds(3));
+      beast::get_lowest_layer(ws).async_connect(
+          results, [this, connect_timer](
+                       beast::error_code ec,
+                       tcp::resolver::results_type::endpoint_type endpoint) {
+            connect_timer->cancel();  // 取消超时定时器
+            handle_connect(ec, endpoint);
+          });
+    });
   } catch (const std::exception& e) {
     LOG_ERROR << "Exception in handle_resolve: " << e.what();
     try {
@@ -274,15 +480,15 @@ void Client::Impl::handle_connect(
     LOG_DEBUG << "TCP connection established to " << endpoint;
 
     // 关闭超时
-    beast::get_lowest_layer(*ws_).expires_never();
-
-    // 设置WebSocket握手超时
-    ws_->next_layer().expires_after(std::chrono::seconds(2));
+    with_stream([](auto& ws) { beast::get_lowest_layer(ws).expires_never(); });
 
-    // 进行 WebSocket 握手
-    ws_->async_handshake(
-        endpoint.address().to_string() + ":" + std::to_string(endpoint.port()),
-        "/", [this](beast::error_code ec) { handle_handshake(ec); });
+    handshake_target_ =
+        endpoint.address().to_string() + ":" + std::to_string(endpoint.port());
+    if (wss_) {
+      start_tls_handshake();
+    } else {
+      start_handshake();
+    }
   } catch (const std::exception& e) {
     LOG_ERROR << "Exception in handle_connect: " << e.what();
     try {
@@ -301,6 +507,59 @@ void Client::Impl::handle_connect(
   }
 }
 
+void Client::Impl::start_tls_handshake() {
+  auto& tls_stream = wss_->next_layer();
+  auto* native = tls_stream.native_handle();
+
+  // IP 字面量不能用作 SNI
+  beast::error_code ec;
+  net::ip::make_address(host_, ec);
+  if (ec) {
+    SSL_set_tlsext_host_name(native, host_.c_str());
+  }
+  if (tls_options_.verify_peer) {
+    tls_stream.set_verify_callback(ssl::host_name_verification(host_));
+  }
+
+  {
+    std::lock_guard lock(tls_mutex_);
+    if (tls_session_) {
+      SSL_set_session(native, tls_session_.get());
+    }
+  }
+
+  beast::get_lowest_layer(*wss_).expires_after(std::chrono::seconds(2));
+  tls_stream.async_handshake(
+      ssl::stream_base::client,
+      [this](beast::error_code ec) { handle_tls_handshake(ec); });
+}
+
+void Client::Impl::handle_tls_handshake(beast::error_code ec) {
+  if (ec) {
+    LOG_ERROR << "TLS handshake failed: " << ec.message();
+    safe_set_promise_exception(std::make_exception_ptr(
+        std::runtime_error("TLS handshake failed: " + ec.message())));
+    return;
+  }
+
+  tls_resumed_ = SSL_session_reused(wss_->next_layer().native_handle()) == 1;
+  LOG_DEBUG << "TLS handshake successful"
+            << (tls_resumed_ ? " (session resumed)" : "");
+  start_handshake();
+}
+
+void Client::Impl::start_handshake() {
+  with_stream([this](auto& ws) {
+    // 设置WebSocket握手超时
+    beast::get_lowest_layer(ws).expires_after(std::chrono::seconds(2));
+
+    // 进行 WebSocket 握手
+    ws.async_handshake(handshake_target_, "/", [this](beast::error_code ec) {
+      handle_handshake(ec);
+    });
+  });
+}
+
 void Client::Impl::handle_handshake(beast::error_code ec) {
   try {
     if (ec) {
@@ -312,11 +571,13 @@ void Client::Impl::handle_handshake(beast::error_code ec) {
 
     LOG_DEBUG << "WebSocket handshake successful";
 
-    // 设置为二进制模式以处理Protocol Buffers数据
-    ws_->binary(true);
+    with_stream([](auto& ws) {
+      // 设置为二进制模式以处理Protocol Buffers数据
+      ws.binary(true);
 
-    // 关闭超时
-    ws_->next_layer().expires_never();
+      // 关闭超时
+      beast::get_lowest_layer(ws).expires_never();
+    });
 
     // 开始读取消息（在发送认证请求之前）
     start_read();
@@ -349,6 +610,8 @@ void Client::Impl::send_auth_request() {
   auto* auth_req = client_msg.mutable_auth_request();
   auth_req->set_player_id(player_id_);
   auth_req->set_token(token_);
+  auth_req->set_supports_compact_encoding(true);
+  auth_req->set_session_class(session_class_);
 
   // 序列化
   std::string serialized;
@@ -359,11 +622,51 @@ void Client::Impl::send_auth_request() {
     return;
   }
 
-  // 发送
-  ws_->async_write(net::buffer(serialized),
-                   [this](beast::error_code ec, std::size_t bytes_transferred) {
-                     handle_auth_write(ec, bytes_transferred);
-                   });
+  if (transport_) {
+    transport_->send(serialized);
+    LOG_DEBUG << "Authentication request sent (" << serialized.size()
+              << " bytes)";
+    return;
+  }
+
+  // 发送；缓冲区由 lambda 持有直到写完成
+  auto buffer = std::make_shared<std::string>(std::move(serialized));
+  with_stream([this, buffer](auto& ws) {
+    ws.async_write(
+        net::buffer(*buffer),
+        [this, buffer](beast::error_code ec, std::size_t bytes_transferred) {
+          handle_auth_write(ec, bytes_transferred);
+        });
+  });
+}
+
+void Client::Impl::send_subscription() {
+  ClientToServer client_msg;
+  auto* subscription = client_msg.mutable_subscription();
+  subscription->set_heatmap(static_cast<bool>(heatmap_callback_));
+  subscription->set_geofence_events(static_cast<bool>(geofence_callback_));
+  subscription->set_exclude_roster(!player_list_callback_);
+
+  std::string serialized;
+  if (!client_msg.SerializeToString(&serialized)) {
+    LOG_ERROR << "Failed to serialize subscription";
+    return;
+  }
+
+  LOG_DEBUG << "Subscribing: heatmap=" << subscription->heatmap()
+            << ", geofence=" << subscription->geofence_events()
+            << ", roster=" << !subscription->exclude_roster();
+
+  if (transport_) {
+    transport_->send(serialized);
+    return;
+  }
+
+  {
+    std::lock_guard lock(write_queue_mutex_);
+    write_queue_.push(std::move(serialized));
+  }
+  do_write();
 }
 
 void Client::Impl::handle_auth_write(beast::error_code ec,
@@ -380,10 +683,12 @@ void Client::Impl::handle_auth_write(beast::error_code ec,
 }
 
 void Client::Impl::start_read() {
-  ws_->async_read(read_buffer_,
-                  [this](beast::error_code ec, std::size_t bytes_transferred) {
-                    handle_read(ec, bytes_transferred);
-                  });
+  with_stream([this](auto& ws) {
+    ws.async_read(read_buffer_, [this](beast::error_code ec,
+                                       std::size_t bytes_transferred) {
+      handle_read(ec, bytes_transferred);
+    });
+  });
 }
 
 void Client::Impl::handle_read(beast::error_code ec,
@@ -457,6 +762,9 @@ void Client::Impl::process_server_message(const std::string& message) {
 
     if (auth_resp.success()) {
       set_state(ClientState::Connected);
+      if (heatmap_callback_ || geofence_callback_) {
+        send_subscription();
+      }
       safe_set_promise_value();
       LOG_INFO << "Authentication successful";
     } else {
@@ -468,20 +776,100 @@ void Client::Impl::process_server_message(const std::string& message) {
   } else if (server_msg.has_player_list()) {
     if (get_state() == ClientState::Connected && player_list_callback_) {
       const auto& player_list = server_msg.player_list();
-      std::vector<PlayerData> players(player_list.players().begin(),
-                                      player_list.players().end());
+      std::vector<PlayerData> players =
+          player_list.partial()
+              ? merge_partial_player_list(player_list)
+              : std::vector<PlayerData>(player_list.players().begin(),
+                                        player_list.players().end());
+
+      LOG_DEBUG << "Received " << (player_list.partial() ? "partial " : "")
+                << "player list with " << players.size() << " players";
+
+      deliver_player_list(std::move(players));
+    }
+  } else if (server_msg.has_compact_player_list()) {
+    if (get_state() == ClientState::Connected && player_list_callback_) {
+      const auto& compact_list = server_msg.compact_player_list();
+      std::vector<PlayerData> players(
+          static_cast<std::size_t>(compact_list.players_size()));
+      for (int i = 0; i < compact_list.players_size(); ++i) {
+        core::PoseCodec::decode(compact_list.players(i),
+                                &players[static_cast<std::size_t>(i)]);
+      }
 
-      LOG_DEBUG << "Received player list with " << players.size() << " players";
+      LOG_DEBUG << "Received compact player list with " << players.size()
+                << " players";
 
+      deliver_player_list(std::move(players));
+    }
+  } else if (server_msg.has_heatmap()) {
+    if (get_state() == ClientState::Connected && heatmap_callback_) {
       try {
-        player_list_callback_(players);
+        heatmap_callback_(server_msg.heatmap());
       } catch (const std::exception& e) {
-        LOG_ERROR << "Exception in player list callback: " << e.what();
+        LOG_ERROR << "Exception in heatmap callback: " << e.what();
+      }
+    }
+  } else if (server_msg.has_proximity_alert()) {
+    if (get_state() == ClientState::Connected && proximity_callback_) {
+      try {
+        proximity_callback_(server_msg.proximity_alert());
+      } catch (const std::exception& e) {
+        LOG_ERROR << "Exception in proximity callback: " << e.what();
+      }
+    }
+  } else if (server_msg.has_geofence_alert()) {
+    if (get_state() == ClientState::Connected && geofence_callback_) {
+      try {
+        geofence_callback_(server_msg.geofence_alert());
+      } catch (const std::exception& e) {
+        LOG_ERROR << "Exception in geofence callback: " << e.what();
       }
     }
   }
 }
 
+void Client::Impl::deliver_player_list(std::vector<PlayerData> players) {
+  try {
+    player_list_callback_(players);
+  } catch (const std::exception& e) {
+    LOG_ERROR << "Exception in player list callback: " << e.what();
+  }
+
+  roster_ = std::move(players);
+}
+
+std::vector<PlayerData> Client::Impl::merge_partial_player_list(
+    const PlayerList& player_list) {
+  // 服务器在带宽受限时只发送部分玩家，其余玩家沿用上一次的数据
+  std::unordered_map<std::string, std::size_t> index;
+  index.reserve(roster_.size());
+  for (std::size_t i = 0; i < roster_.size(); ++i) {
+    index.emplace(roster_[i].player_id(), i);
+  }
+
+  std::vector<PlayerData> merged = roster_;
+  for (const auto& player : player_list.players()) {
+    auto it = index.find(player.player_id());
+    if (it != index.end()) {
+      merged[it->second] = player;
+    } else {
+      index.emplace(player.player_id(), merged.size());
+      merged.push_back(player);
+    }
+  }
+
+  for (const auto& removed_id : player_list.removed_player_ids()) {
+    merged.erase(std::remove_if(merged.begin(), merged.end(),
+                                [&](const PlayerData& p) {
+                                  return p.player_id() == removed_id;
+                                }),
+                 merged.end());
+  }
+
+  return merged;
+}
+
 void Client::Impl::do_write() {
   std::string message;
 
@@ -500,10 +888,14 @@ void Client::Impl::do_write() {
   }  // 锁在这里自动释放
 
   // 在锁释放后进行异步写操作
-  ws_->async_write(net::buffer(message),
-                   [this](beast::error_code ec, std::size_t bytes_transferred) {
-                     handle_write(ec, bytes_transferred);
-                   });
+  auto buffer = std::make_shared<std::string>(std::move(message));
+  with_stream([this, buffer](auto& ws) {
+    ws.async_write(
+        net::buffer(*buffer),
+        [this, buffer](beast::error_code ec, std::size_t bytes_transferred) {
+          handle_write(ec, bytes_transferred);
+        });
+  });
 }
 
 void Client::Impl::handle_write(beast::error_code ec,
@@ -525,13 +917,13 @@ void Client::Impl::handle_write(beast::error_code ec,
 }
 
 void Client::Impl::close_connection() {
-  if (ws_) {
+  with_stream([](auto& ws) {
     try {
-      if (ws_->is_open()) {
+      if (ws.is_open()) {
         LOG_DEBUG << "Closing WebSocket connection";
 
         // 使用异步关闭来避免阻塞
-        ws_->async_close(
+        ws.async_close(
             websocket::close_code::normal, [](beast::error_code ec) {
               if (ec) {
                 LOG_DEBUG << "WebSocket close completed with error: "
@@ -546,7 +938,7 @@ void Client::Impl::close_connection() {
     } catch (...) {
       LOG_ERROR << "Unknown exception during WebSocket close";
     }
-  }
+  });
 }
 
 void Client::Impl::set_state(ClientState new_state) { state_.store(new_state); }
@@ -3,6 +3,7 @@
 #include <atomic>
 #include <boost/asio.hpp>
 #include <boost/beast.hpp>
+#include <boost/beast/ssl.hpp>
 #include <future>
 #include <memory>
 #include <mutex>
@@ -14,8 +15,13 @@
 namespace beast = boost::beast;
 namespace net = boost::asio;
 namespace websocket = beast::websocket;
+namespace ssl = net::ssl;
 using tcp = net::ip::tcp;
 
+namespace picoradar {
+class PlayerList;
+}
+
 namespace picoradar::client {
 
 /**
@@ -46,18 +52,42 @@ class Client::Impl {
   Impl& operator=(Impl&&) = delete;
 
   void setOnPlayerListUpdate(PlayerListCallback callback);
+  void setOnHeatmapUpdate(HeatmapCallback callback);
+  void setOnProximityAlert(ProximityCallback callback);
+  void setOnGeofenceAlert(GeofenceCallback callback);
+  void setTlsOptions(TlsOptions options);
+  void setSessionClass(SessionClass session_class);
   std::future<void> connect(const std::string& server_address,
                             const std::string& player_id,
                             const std::string& token);
+  std::future<void> connect(std::shared_ptr<Transport> transport,
+                            const std::string& player_id,
+                            const std::string& token);
   void disconnect();
   void sendPlayerData(const PlayerData& data);
   bool isConnected() const;
+  bool isTlsSessionResumed() const;
 
  private:
   // 网络相关
   std::unique_ptr<net::io_context> ioc_;
+  // 每次连接只创建其中一个：ws_ 用于 ws://，wss_ 用于 wss://
   std::unique_ptr<websocket::stream<beast::tcp_stream>> ws_;
+  std::unique_ptr<websocket::stream<beast::ssl_stream<beast::tcp_stream>>>
+      wss_;
   std::unique_ptr<tcp::resolver> resolver_;
+  // 自定义传输层；非空时不使用上面的套接字与网络线程
+  std::shared_ptr<Transport> transport_;
+
+  // TLS 状态。上下文与会话票据跨连接保留，以便重连时恢复会话
+  TlsOptions tls_options_;
+  std::unique_ptr<ssl::context> tls_context_;
+  std::unique_ptr<SSL_SESSION, decltype(&SSL_SESSION_free)> tls_session_{
+      nullptr, &SSL_SESSION_free};
+  std::mutex tls_mutex_;  // 保护 tls_session_，票据在网络线程中到达
+  std::atomic<bool> tls_resumed_{false};
+  std::string host_;  // 用于 SNI 与证书主机名校验
+  std::string handshake_target_;  // WebSocket 握手的 Host 头
 
   // 线程管理
   std::thread network_thread_;
@@ -68,6 +98,10 @@ class Client::Impl {
 
   // 回调和 Promise
   PlayerListCallback player_list_callback_;
+  HeatmapCallback heatmap_callback_;
+  ProximityCallback proximity_callback_;
+  GeofenceCallback geofence_callback_;
+  std::vector<PlayerData> roster_;  // 最近一次回调的完整列表，用于合并部分帧
   std::promise<void> connect_promise_;
   std::atomic<bool> connect_promise_set_{false};
 
@@ -80,6 +114,7 @@ class Client::Impl {
   // 认证信息
   std::string player_id_;
   std::string token_;
+  std::atomic<SessionClass> session_class_{SESSION_CLASS_PLAYER};
 
   // 内部方法
   void run_network_thread();
@@ -87,12 +122,22 @@ class Client::Impl {
                       tcp::resolver::results_type results);
   void handle_connect(beast::error_code ec,
                       tcp::resolver::results_type::endpoint_type endpoint);
+  void start_tls_handshake();
+  void handle_tls_handshake(beast::error_code ec);
+  void start_handshake();
   void handle_handshake(beast::error_code ec);
   void send_auth_request();
+  void send_subscription();
   void handle_auth_write(beast::error_code ec, std::size_t bytes_transferred);
+  void handle_transport_close();
+  // 关闭并丢弃上一次连接遗留的自定义传输层；必须持有 state_mutex_
+  void release_transport();
   void start_read();
   void handle_read(beast::error_code ec, std::size_t bytes_transferred);
   void process_server_message(const std::string& message);
+  auto merge_partial_player_list(const PlayerList& player_list)
+      -> std::vector<PlayerData>;
+  void deliver_player_list(std::vector<PlayerData> players);
   void do_write();
   void handle_write(beast::error_code ec, std::size_t bytes_transferred);
   void close_connection();
@@ -105,6 +150,21 @@ class Client::Impl {
   void safe_set_promise_value();  // 为void promise的特化版本
   void safe_set_promise_exception(std::exception_ptr ex);
 
+  // 对当前连接使用的 WebSocket 流调用 f
+  template <typename F>
+  void with_stream(F&& f) {
+    if (wss_) {
+      f(*wss_);
+    } else if (ws_) {
+      f(*ws_);
+    }
+  }
+
+  // 惰性创建 TLS 上下文；必须持有 state_mutex_
+  void ensure_tls_context();
+  // 保存服务器下发的会话票据 (SSL_CTX new-session 回调)
+  static int on_new_tls_session(SSL* ssl, SSL_SESSION* session);
+
   // 解析服务器地址
   std::pair<std::string, std::string> parse_address(const std::string& address);
 };
@@ -6,7 +6,9 @@
 #include <string>
 #include <vector>
 
+#include "client.pb.h"
 #include "player.pb.h"
+#include "server.pb.h"
 
 namespace picoradar::client {
 
@@ -57,6 +59,80 @@ class Client {
   using PlayerListCallback =
       std::function<void(const std::vector<PlayerData>&)>;
 
+  /**
+   * @brief 热力图更新回调函数类型
+   *
+   * 服务器以较低频率为每个非空场景发送一帧占用热力图。
+   *
+   * @warning 与玩家列表回调相同，在内部网络线程中执行。
+   *
+   * @param frame 单个场景的热力图帧
+   */
+  using HeatmapCallback = std::function<void(const HeatmapFrame&)>;
+
+  /**
+   * @brief 近距离警报回调函数类型
+   *
+   * 服务器在本玩家与其他玩家距离过近时推送警报，
+   * 警报解除时推送 cleared 事件。
+   *
+   * @warning 与玩家列表回调相同，在内部网络线程中执行。
+   *
+   * @param alert 本 tick 中与本玩家相关的所有近距离事件
+   */
+  using ProximityCallback = std::function<void(const ProximityAlert&)>;
+
+  /**
+   * @brief 地理围栏事件回调函数类型
+   *
+   * 用于运营端：服务器在任意玩家越出游玩区域或进入禁入区域、
+   * 以及回到允许区域时推送事件。
+   *
+   * @warning 与玩家列表回调相同，在内部网络线程中执行。
+   *
+   * @param alert 本 tick 中的所有越界状态变化
+   */
+  using GeofenceCallback = std::function<void(const GeofenceAlert&)>;
+
+  /**
+   * @brief wss:// 连接的 TLS 选项
+   */
+  struct TlsOptions {
+    /// 信任的 CA 证书 (PEM)；为空时使用系统默认证书路径
+    std::string ca_file;
+    /// 校验服务器证书链与主机名；仅用于本地调试时关闭
+    bool verify_peer = true;
+  };
+
+  /**
+   * @brief 可替换的消息传输层
+   *
+   * 默认的 connect() 使用 WebSocket 套接字。测试可以实现此接口，把客户端
+   * 接到内存中的服务器（例如虚拟时间仿真），不经过真实网络与网络线程。
+   * 每个 send()/帧都是一条完整的序列化 protobuf 消息。
+   */
+  class Transport {
+   public:
+    /// 收到一帧服务器消息
+    using FrameHandler = std::function<void(const std::string& frame)>;
+    /// 连接被对端关闭
+    using CloseHandler = std::function<void()>;
+
+    virtual ~Transport() = default;
+
+    /**
+     * @brief 建立连接并开始投递服务器消息
+     *
+     * 回调在传输层投递消息的线程中执行，客户端的所有用户回调也因此
+     * 在该线程中执行。
+     */
+    virtual void open(FrameHandler on_frame, CloseHandler on_close) = 0;
+    virtual void send(const std::string& frame) = 0;
+    /// 主动关闭；之后不得再调用 open() 传入的回调。对端关闭后客户端
+    /// 同样会调用 close()，此时应什么也不做
+    virtual void close() = 0;
+  };
+
   /**
    * @brief 构造函数
    *
@@ -89,6 +165,71 @@ class Client {
    */
   void setOnPlayerListUpdate(PlayerListCallback callback);
 
+  /**
+   * @brief 设置热力图更新回调
+   *
+   * 设置后，客户端在认证成功时向服务器订阅热力图。
+   * 若未设置玩家列表回调，同时退订玩家列表，
+   * 使只需要密度信息的概览客户端只接收固定大小的热力图帧。
+   *
+   * @param callback 当收到热力图帧时要调用的回调函数
+   *
+   * @note 此方法必须在调用 connect() 之前调用
+   * @thread_safety 线程安全
+   */
+  void setOnHeatmapUpdate(HeatmapCallback callback);
+
+  /**
+   * @brief 设置近距离警报回调
+   *
+   * @param callback 当收到近距离警报时要调用的回调函数
+   *
+   * @note 此方法必须在调用 connect() 之前调用
+   * @thread_safety 线程安全
+   */
+  void setOnProximityAlert(ProximityCallback callback);
+
+  /**
+   * @brief 设置地理围栏事件回调
+   *
+   * 设置后，客户端在认证成功时向服务器订阅围栏事件。
+   * 与热力图相同，若未设置玩家列表回调则同时退订玩家列表。
+   *
+   * @param callback 当收到围栏事件时要调用的回调函数
+   *
+   * @note 此方法必须在调用 connect() 之前调用
+   * @thread_safety 线程安全
+   */
+  void setOnGeofenceAlert(GeofenceCallback callback);
+
+  /**
+   * @brief 设置 wss:// 连接使用的 TLS 选项
+   *
+   * 客户端在多次 connect() 之间保留服务器下发的会话票据，
+   * 重连时以简化握手恢复会话，省去完整的密钥交换。
+   * 修改选项会丢弃已保存的会话。
+   *
+   * @param options TLS 选项
+   *
+   * @note 此方法必须在调用 connect() 之前调用
+   * @thread_safety 线程安全
+   */
+  void setTlsOptions(TlsOptions options);
+
+  /**
+   * @brief 设置认证时声明的会话类别
+   *
+   * 默认为 SESSION_CLASS_PLAYER。旁观屏幕与运营面板应声明各自的类别：
+   * 它们不会出现在玩家列表中，发送的位姿被忽略，服务器过载时先于
+   * 头显玩家被降低帧率或暂停推送。
+   *
+   * @param session_class 会话类别
+   *
+   * @note 此方法必须在调用 connect() 之前调用
+   * @thread_safety 线程安全
+   */
+  void setSessionClass(SessionClass session_class);
+
   /**
    * @brief 异步连接到服务器
    *
@@ -96,12 +237,12 @@ class Client {
    * 1. 启动内部 io_context 线程
    * 2. 解析服务器地址
    * 3. 建立 TCP 连接
-   * 4. 进行 WebSocket 握手
+   * 4. 进行 TLS 握手（仅 wss://）与 WebSocket 握手
    * 5. 发送认证请求
    * 6. 等待认证响应
    *
    * @param server_address 服务器地址，格式为 "ip:port" (e.g.,
-   * "127.0.0.1:11451")
+   * "127.0.0.1:11451")；以 "wss://" 开头时使用 TLS 连接
    * @param player_id 玩家唯一标识符
    * @param token 认证令牌
    * @return std::future<void> 异步操作的 future，可用于等待连接完成或检查错误
@@ -114,6 +255,23 @@ class Client {
   auto connect(const std::string& server_address, const std::string& player_id,
                const std::string& token) const -> std::future<void>;
 
+  /**
+   * @brief 通过自定义传输层连接并认证
+   *
+   * 与 connect(server_address, ...) 的认证流程相同，但不解析地址、
+   * 不启动网络线程，也没有连接超时：何时送达服务器消息完全由传输层决定。
+   *
+   * @param transport 尚未打开的传输层，客户端在 disconnect() 前持有它
+   * @param player_id 玩家唯一标识符
+   * @param token 认证令牌
+   * @return std::future<void> 收到认证响应后就绪
+   *
+   * @thread_safety 线程安全
+   */
+  auto connect(std::shared_ptr<Transport> transport,
+               const std::string& player_id, const std::string& token) const
+      -> std::future<void>;
+
   /**
    * @brief 断开与服务器的连接
    *
@@ -151,6 +309,15 @@ class Client {
    */
   [[nodiscard]] auto isConnected() const -> bool;
 
+  /**
+   * @brief 最近一次 wss:// 连接是否恢复了之前的 TLS 会话
+   *
+   * @return true 如果 TLS 握手复用了会话票据或服务端缓存的会话
+   *
+   * @thread_safety 线程安全
+   */
+  [[nodiscard]] auto isTlsSessionResumed() const -> bool;
+
  private:
   class Impl;
   std::unique_ptr<Impl> pimpl_;
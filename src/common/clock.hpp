@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+namespace picoradar::common {
+
+/**
+ * @brief 可注入的单调时钟
+ *
+ * 服务器中所有依赖当前时间的逻辑（带宽预算、接近检测等）都通过
+ * 此接口取时间，测试可以替换为 ManualClock 在虚拟时间中运行。
+ */
+class Clock {
+ public:
+  using time_point = std::chrono::steady_clock::time_point;
+  using duration = std::chrono::steady_clock::duration;
+
+  virtual ~Clock() = default;
+
+  [[nodiscard]] virtual auto now() const -> time_point = 0;
+
+  /**
+   * @brief 进程范围内共享的真实时钟 (std::chrono::steady_clock)
+   */
+  static auto system() -> const Clock&;
+};
+
+/**
+ * @brief 基于 std::chrono::steady_clock 的真实时钟
+ */
+class SteadyClock final : public Clock {
+ public:
+  [[nodiscard]] auto now() const -> time_point override {
+    return std::chrono::steady_clock::now();
+  }
+};
+
+inline auto Clock::system() -> const Clock& {
+  static const SteadyClock clock;
+  return clock;
+}
+
+/**
+ * @brief 手动推进的虚拟时钟
+ *
+ * 起点不为 time_point{}，因为部分组件把默认构造的时间点视为“尚未开始”。
+ * now() 可被任意线程读取，推进操作应由驱动仿真的单个线程完成。
+ */
+class ManualClock final : public Clock {
+ public:
+  ManualClock() : ticks_(kStartTicks) {}
+
+  [[nodiscard]] auto now() const -> time_point override {
+    return time_point(duration(ticks_.load(std::memory_order_acquire)));
+  }
+
+  void advance(duration delta) {
+    ticks_.fetch_add(delta.count(), std::memory_order_acq_rel);
+  }
+
+ private:
+  static constexpr duration::rep kStartTicks =
+      std::chrono::duration_cast<duration>(std::chrono::hours(1)).count();
+
+  std::atomic<duration::rep> ticks_;
+};
+
+}  // namespace picoradar::common
@@ -86,4 +86,85 @@ constexpr int kDefaultThreadCount = 4;
 /// @brief 最大线程池线程数
 constexpr int kMaxThreadCount = 16;
 
+/// @brief I/O 线程池采样事件循环延迟与 CPU 利用率的默认间隔
+constexpr auto kDefaultWorkerProbeInterval = std::chrono::milliseconds(100);
+
+/// @brief 按负载在通道间重新分配场景的默认间隔
+constexpr auto kDefaultSceneRebalanceInterval = std::chrono::milliseconds(1000);
+
+//-----------------------------------------------------------------------------
+// 带宽控制 (Bandwidth Control)
+//-----------------------------------------------------------------------------
+
+/// @brief 会话带宽令牌桶的突发窗口
+constexpr auto kBandwidthBurstWindow = std::chrono::milliseconds(100);
+
+/// @brief 估算带宽的上限 (64MB/s)，超过后视为链路不受限
+constexpr std::size_t kMaxEstimatedBandwidth = 64 * 1024 * 1024;
+
+//-----------------------------------------------------------------------------
+// 传输层加密 (TLS)
+//-----------------------------------------------------------------------------
+
+/// @brief TLS 会话票据与服务端会话缓存的默认有效期
+constexpr auto kDefaultTlsSessionTimeout = std::chrono::seconds(7200);
+
+//-----------------------------------------------------------------------------
+// 热力图 (Heatmap)
+//-----------------------------------------------------------------------------
+
+/// @brief 热力图帧默认广播间隔
+constexpr auto kDefaultHeatmapInterval = std::chrono::milliseconds(500);
+
+//-----------------------------------------------------------------------------
+// 近距离警报 (Proximity Alerts)
+//-----------------------------------------------------------------------------
+
+/// @brief 近距离检测的默认 tick 间隔
+constexpr auto kDefaultProximityInterval = std::chrono::milliseconds(50);
+
+//-----------------------------------------------------------------------------
+// 地理围栏 (Geofence)
+//-----------------------------------------------------------------------------
+
+/// @brief 地理围栏检测的默认 tick 间隔
+constexpr auto kDefaultGeofenceInterval = std::chrono::milliseconds(100);
+
+//-----------------------------------------------------------------------------
+// 单写者模拟线程 (Simulation Thread)
+//-----------------------------------------------------------------------------
+
+/// @brief 模拟线程应用位姿并广播的默认 tick 间隔
+constexpr auto kDefaultSimulationTick = std::chrono::milliseconds(20);
+
+/// @brief 每个 I/O 线程摄入队列的默认容量
+constexpr std::size_t kDefaultIngestQueueCapacity = 4096;
+
+//-----------------------------------------------------------------------------
+// 进程内嵌入 (Embedding)
+//-----------------------------------------------------------------------------
+
+/// @brief 向注册表观察者发布批量变更的默认间隔
+constexpr auto kDefaultObserverInterval = std::chrono::milliseconds(20);
+
+/// @brief 注册表变更日志默认保留的记录数；默认关闭，由需要增量消费的嵌入方开启
+constexpr std::size_t kDefaultJournalCapacity = 0;
+
+//-----------------------------------------------------------------------------
+// 位姿归档 (Pose Archive)
+//-----------------------------------------------------------------------------
+
+/// @brief 录制线程采样名单的默认间隔
+constexpr auto kDefaultArchiveSampleInterval = std::chrono::milliseconds(100);
+
+/// @brief 每个归档数据块默认包含的采样帧数
+constexpr std::size_t kDefaultArchiveBlockFrames = 64;
+
+//-----------------------------------------------------------------------------
+// 飞行记录器 (Flight Recorder)
+//-----------------------------------------------------------------------------
+
+/// @brief 指标快照的默认间隔
+constexpr auto kDefaultFlightRecorderInterval = std::chrono::milliseconds(1000);
+
 }  // namespace picoradar::constants
\ No newline at end of file
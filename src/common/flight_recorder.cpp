@@ -0,0 +1,412 @@
+#include "flight_recorder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <csignal>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace picoradar::common {
+
+namespace {
+
+auto writeFd(int fd, const char* data, std::size_t size) -> bool {
+  while (size > 0) {
+#ifdef _WIN32
+    const auto written = ::_write(fd, data, static_cast<unsigned>(size));
+#else
+    const auto written = ::write(fd, data, size);
+#endif
+    if (written <= 0) {
+      return false;
+    }
+    data += written;
+    size -= static_cast<std::size_t>(written);
+  }
+  return true;
+}
+
+/**
+ * @brief 转储用的定长输出缓冲
+ *
+ * 信号处理函数中不能使用 iostream 与 printf，数字由本类自行格式化。
+ */
+class DumpWriter {
+ public:
+  explicit DumpWriter(int fd) : fd_(fd) {}
+  ~DumpWriter() { flush(); }
+
+  DumpWriter(const DumpWriter&) = delete;
+  auto operator=(const DumpWriter&) -> DumpWriter& = delete;
+
+  auto text(const char* data, std::size_t size) -> DumpWriter& {
+    while (size > 0) {
+      const auto chunk = std::min(size, buffer_.size() - length_);
+      std::memcpy(buffer_.data() + length_, data, chunk);
+      length_ += chunk;
+      data += chunk;
+      size -= chunk;
+      if (length_ == buffer_.size()) {
+        flush();
+      }
+    }
+    return *this;
+  }
+
+  auto text(const char* data) -> DumpWriter& {
+    return text(data, std::strlen(data));
+  }
+
+  auto number(std::int64_t value) -> DumpWriter& {
+    std::array<char, 24> digits{};
+    std::size_t count = 0;
+    // 取负数的绝对值时避免 INT64_MIN 溢出
+    auto magnitude = value < 0 ? 0 - static_cast<std::uint64_t>(value)
+                               : static_cast<std::uint64_t>(value);
+    do {
+      digits[count++] = static_cast<char>('0' + magnitude % 10);
+      magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0) {
+      digits[count++] = '-';
+    }
+    std::reverse(digits.begin(), digits.begin() + count);
+    return text(digits.data(), count);
+  }
+
+  // 保留三位小数；超出 int64 范围的值输出为 inf
+  auto number(double value) -> DumpWriter& {
+    if (std::isnan(value)) {
+      return text("nan");
+    }
+    if (std::fabs(value) >= 9.2e15) {
+      return text(value < 0 ? "-inf" : "inf");
+    }
+    const auto scaled = static_cast<std::int64_t>(std::llround(value * 1000));
+    if (scaled < 0) {
+      text("-");
+    }
+    const auto magnitude = scaled < 0 ? -scaled : scaled;
+    number(magnitude / 1000);
+    const auto fraction = magnitude % 1000;
+    const char decimals[] = {'.', static_cast<char>('0' + fraction / 100),
+                             static_cast<char>('0' + fraction / 10 % 10),
+                             static_cast<char>('0' + fraction % 10)};
+    return text(decimals, sizeof(decimals));
+  }
+
+  void flush() {
+    writeFd(fd_, buffer_.data(), length_);
+    length_ = 0;
+  }
+
+ private:
+  int fd_;
+  std::array<char, 4096> buffer_{};
+  std::size_t length_ = 0;
+};
+
+auto nowMillis() -> std::int64_t {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+// 线程的短编号，转储中比 std::thread::id 更易读
+auto threadIndex() -> std::uint32_t {
+  static std::atomic<std::uint32_t> next{0};
+  thread_local const std::uint32_t index = ++next;
+  return index;
+}
+
+// 以 NUL 结尾地复制到定长数组，返回复制的字节数
+template <std::size_t N>
+auto copyTruncated(std::array<char, N>& target, const char* source,
+                   std::size_t size) -> std::size_t {
+  const auto length = std::min(size, N - 1);
+  std::memcpy(target.data(), source, length);
+  target[length] = '\0';
+  return length;
+}
+
+// 读取前后序号一致且等于期望值时，把槽位复制到 out
+template <typename Slot, typename Copy>
+auto readSlot(const Slot& slot, std::uint64_t expected, Copy&& copy) -> bool {
+  if (slot.sequence.load(std::memory_order_acquire) != expected) {
+    return false;
+  }
+  copy(slot);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return slot.sequence.load(std::memory_order_relaxed) == expected;
+}
+
+template <typename Slot>
+void beginWrite(Slot& slot) {
+  slot.sequence.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+#ifndef _WIN32
+std::array<char, FlightRecorder::kPathBytes> g_crash_path{};
+// 备用信号栈：栈溢出时处理函数仍有栈可用
+std::array<char, 64 * 1024> g_alt_stack{};
+
+auto signalName(int signum) -> const char* {
+  switch (signum) {
+    case SIGSEGV:
+      return "SIGSEGV";
+    case SIGBUS:
+      return "SIGBUS";
+    case SIGFPE:
+      return "SIGFPE";
+    case SIGILL:
+      return "SIGILL";
+    case SIGABRT:
+      return "SIGABRT";
+    default:
+      return "signal";
+  }
+}
+
+extern "C" void onCrashSignal(int signum) {
+  const int fd =
+      ::open(g_crash_path.data(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd >= 0) {
+    FlightRecorder::getInstance().dump(fd, signalName(signum));
+    ::close(fd);
+  }
+  // SA_RESETHAND 已恢复默认处理，重新触发信号以正常终止并生成 core
+  ::raise(signum);
+}
+#endif
+
+}  // namespace
+
+FlightRecorder::~FlightRecorder() { stop(); }
+
+auto FlightRecorder::getInstance() -> FlightRecorder& {
+  static FlightRecorder instance;
+  return instance;
+}
+
+void FlightRecorder::recordLog(const std::string& text) {
+  const auto index = log_head_.fetch_add(1, std::memory_order_relaxed);
+  auto& slot = logs_[index % kLogCapacity];
+  beginWrite(slot);
+  slot.length = static_cast<std::uint16_t>(
+      copyTruncated(slot.text, text.data(), text.size()));
+  slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+void FlightRecorder::recordSpan(const char* name,
+                                std::chrono::system_clock::time_point start,
+                                std::chrono::microseconds duration) {
+  const auto index = span_head_.fetch_add(1, std::memory_order_relaxed);
+  auto& slot = spans_[index % kSpanCapacity];
+  beginWrite(slot);
+  slot.start_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                      start.time_since_epoch())
+                      .count();
+  slot.duration_us = duration.count();
+  slot.thread = threadIndex();
+  copyTruncated(slot.name, name, std::strlen(name));
+  slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+auto FlightRecorder::addMetric(const std::string& name, MetricReader reader)
+    -> bool {
+  std::lock_guard lock(metrics_mutex_);
+  const auto index = metric_count_.load();
+  if (index >= kMaxMetrics) {
+    return false;
+  }
+  copyTruncated(metric_names_[index], name.data(), name.size());
+  metric_readers_.push_back(std::move(reader));
+  metric_count_.store(index + 1, std::memory_order_release);
+  return true;
+}
+
+void FlightRecorder::takeSnapshot() {
+  std::lock_guard lock(metrics_mutex_);
+  const auto index = snapshot_head_.fetch_add(1, std::memory_order_relaxed);
+  auto& slot = snapshots_[index % kSnapshotCapacity];
+  beginWrite(slot);
+  slot.time_ms = nowMillis();
+  for (std::size_t i = 0; i < metric_readers_.size(); ++i) {
+    slot.values[i] = metric_readers_[i]();
+  }
+  slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+void FlightRecorder::start(std::chrono::milliseconds interval) {
+  std::lock_guard lock(sampler_mutex_);
+  if (sampler_running_) {
+    return;
+  }
+  sampler_running_ = true;
+  sampler_ = std::thread([this, interval] { runSampler(interval); });
+}
+
+void FlightRecorder::stop() {
+  {
+    std::lock_guard lock(sampler_mutex_);
+    sampler_running_ = false;
+  }
+  sampler_cv_.notify_all();
+  if (sampler_.joinable()) {
+    sampler_.join();
+  }
+}
+
+void FlightRecorder::runSampler(std::chrono::milliseconds interval) {
+  std::unique_lock lock(sampler_mutex_);
+  while (!sampler_cv_.wait_for(lock, interval,
+                               [this] { return !sampler_running_; })) {
+    lock.unlock();
+    takeSnapshot();
+    lock.lock();
+  }
+}
+
+void FlightRecorder::dump(int fd, const char* reason) const {
+  DumpWriter out(fd);
+  out.text("# PicoRadar flight recorder\nreason: ")
+      .text(reason)
+      .text("\ndumped_at_ms: ")
+      .number(nowMillis())
+      .text("\n");
+
+  // 1. 指标快照：表头为注册时的名称
+  const auto metric_count = metric_count_.load(std::memory_order_acquire);
+  out.text("\n[metrics]\ntime_ms");
+  for (std::size_t i = 0; i < metric_count; ++i) {
+    out.text(",").text(metric_names_[i].data());
+  }
+  out.text("\n");
+  const auto snapshot_head = snapshot_head_.load(std::memory_order_acquire);
+  SnapshotSlot snapshot;
+  for (auto i = snapshot_head - std::min<std::uint64_t>(snapshot_head,
+                                                        kSnapshotCapacity);
+       i < snapshot_head; ++i) {
+    const bool complete = readSlot(
+        snapshots_[i % kSnapshotCapacity], i + 1, [&](const auto& slot) {
+          snapshot.time_ms = slot.time_ms;
+          snapshot.values = slot.values;
+        });
+    if (!complete) {
+      continue;
+    }
+    out.number(snapshot.time_ms);
+    for (std::size_t m = 0; m < metric_count; ++m) {
+      out.text(",").number(snapshot.values[m]);
+    }
+    out.text("\n");
+  }
+
+  // 2. 追踪区间
+  out.text("\n[spans]\nstart_us,duration_us,thread,name\n");
+  const auto span_head = span_head_.load(std::memory_order_acquire);
+  SpanSlot span;
+  for (auto i = span_head - std::min<std::uint64_t>(span_head, kSpanCapacity);
+       i < span_head; ++i) {
+    const bool complete =
+        readSlot(spans_[i % kSpanCapacity], i + 1, [&](const auto& slot) {
+          span.start_us = slot.start_us;
+          span.duration_us = slot.duration_us;
+          span.thread = slot.thread;
+          span.name = slot.name;
+        });
+    if (!complete) {
+      continue;
+    }
+    span.name.back() = '\0';
+    out.number(span.start_us)
+        .text(",")
+        .number(span.duration_us)
+        .text(",")
+        .number(static_cast<std::int64_t>(span.thread))
+        .text(",")
+        .text(span.name.data())
+        .text("\n");
+  }
+
+  // 3. 日志尾部
+  out.text("\n[logs]\n");
+  const auto log_head = log_head_.load(std::memory_order_acquire);
+  LogSlot log;
+  for (auto i = log_head - std::min<std::uint64_t>(log_head, kLogCapacity);
+       i < log_head; ++i) {
+    const bool complete =
+        readSlot(logs_[i % kLogCapacity], i + 1, [&](const auto& slot) {
+          log.length = slot.length;
+          log.text = slot.text;
+        });
+    if (!complete) {
+      continue;
+    }
+    out.text(log.text.data(), std::min<std::size_t>(log.length,
+                                                    kLogTextBytes - 1))
+        .text("\n");
+  }
+}
+
+void FlightRecorder::dumpToFile(const std::string& path,
+                                const char* reason) const {
+#ifdef _WIN32
+  const int fd = ::_open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC,
+                         _S_IREAD | _S_IWRITE);
+#else
+  const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+  if (fd < 0) {
+    throw std::runtime_error("Failed to create " + path);
+  }
+  dump(fd, reason);
+#ifdef _WIN32
+  ::_close(fd);
+#else
+  ::close(fd);
+#endif
+}
+
+auto FlightRecorder::installCrashHandler(const std::string& path) -> bool {
+#ifdef _WIN32
+  (void)path;
+  return false;
+#else
+  if (path.empty() || path.size() >= kPathBytes) {
+    return false;
+  }
+  getInstance();  // 处理函数中不能首次构造实例
+  copyTruncated(g_crash_path, path.data(), path.size());
+
+  stack_t stack{};
+  stack.ss_sp = g_alt_stack.data();
+  stack.ss_size = g_alt_stack.size();
+  if (sigaltstack(&stack, nullptr) != 0) {
+    return false;
+  }
+
+  struct sigaction action {};
+  action.sa_handler = onCrashSignal;
+  sigemptyset(&action.sa_mask);
+  action.sa_flags = SA_RESETHAND | SA_ONSTACK;
+  for (const int signum : {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT}) {
+    if (sigaction(signum, &action, nullptr) != 0) {
+      return false;
+    }
+  }
+  return true;
+#endif
+}
+
+}  // namespace picoradar::common
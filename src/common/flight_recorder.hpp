@@ -0,0 +1,204 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logging.hpp"
+
+namespace picoradar::common {
+
+/**
+ * @brief 崩溃飞行记录器
+ *
+ * 在预先分配的固定区域中循环保存最近的日志、追踪区间 (span) 与每秒
+ * 一次的指标快照，写入路径不分配内存、不加锁。崩溃时由信号处理函数
+ * 只用 open/write 把内容转储到预先设置的文件；也可以随时按需转储。
+ * 较旧的记录被新记录覆盖，转储按时间从旧到新输出。
+ */
+class FlightRecorder {
+ public:
+  static constexpr std::size_t kLogCapacity = 1024;
+  static constexpr std::size_t kLogTextBytes = 240;
+  static constexpr std::size_t kSpanCapacity = 4096;
+  static constexpr std::size_t kSpanNameBytes = 32;
+  static constexpr std::size_t kSnapshotCapacity = 300;
+  static constexpr std::size_t kMaxMetrics = 24;
+  static constexpr std::size_t kMetricNameBytes = 40;
+  static constexpr std::size_t kPathBytes = 512;
+
+  using MetricReader = std::function<double()>;
+
+  FlightRecorder() = default;
+  ~FlightRecorder();
+
+  FlightRecorder(const FlightRecorder&) = delete;
+  auto operator=(const FlightRecorder&) -> FlightRecorder& = delete;
+
+  /// 进程级实例，崩溃处理函数转储的就是它
+  static auto getInstance() -> FlightRecorder&;
+
+  /**
+   * @brief 记录一条格式化后的日志，超出 kLogTextBytes 的部分被截断
+   */
+  void recordLog(const std::string& text);
+
+  /**
+   * @brief 记录一个已结束的追踪区间
+   *
+   * name 超出 kSpanNameBytes - 1 的部分被截断。
+   */
+  void recordSpan(const char* name,
+                  std::chrono::system_clock::time_point start,
+                  std::chrono::microseconds duration);
+
+  /**
+   * @brief 注册一个指标，在每次快照时由采样线程读取
+   *
+   * 超过 kMaxMetrics 个时返回 false。reader 引用的对象须在 stop()
+   * 之前保持有效。
+   */
+  auto addMetric(const std::string& name, MetricReader reader) -> bool;
+
+  /// 立即读取所有指标并保存一个快照
+  void takeSnapshot();
+
+  /// 启动采样线程，每隔 interval 保存一个快照
+  void start(std::chrono::milliseconds interval);
+  void stop();
+
+  /**
+   * @brief 把当前内容写入文件描述符
+   *
+   * 只使用异步信号安全的操作，可在信号处理函数中调用。
+   */
+  void dump(int fd, const char* reason) const;
+
+  /**
+   * @brief 把当前内容写入文件
+   * @throws std::runtime_error 无法创建文件时
+   */
+  void dumpToFile(const std::string& path, const char* reason) const;
+
+  /**
+   * @brief 安装崩溃处理函数
+   *
+   * SIGSEGV、SIGBUS、SIGFPE、SIGILL 与 SIGABRT 到达时，先把进程级实例
+   * 转储到 path，再按默认行为终止进程。调用线程安装了备用信号栈，
+   * 其栈溢出时同样能够转储。Windows 上不支持，返回 false。
+   */
+  static auto installCrashHandler(const std::string& path) -> bool;
+
+  [[nodiscard]] auto getLogCount() const -> std::uint64_t {
+    return log_head_.load(std::memory_order_relaxed);
+  }
+  [[nodiscard]] auto getSpanCount() const -> std::uint64_t {
+    return span_head_.load(std::memory_order_relaxed);
+  }
+  [[nodiscard]] auto getSnapshotCount() const -> std::uint64_t {
+    return snapshot_head_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  // 每个槽位带一个序号：写入前清零，写完后置为 (写入序号 + 1)，
+  // 读取时前后序号一致才认为内容完整
+  struct LogSlot {
+    std::atomic<std::uint64_t> sequence{0};
+    std::uint16_t length = 0;
+    std::array<char, kLogTextBytes> text{};
+  };
+
+  struct SpanSlot {
+    std::atomic<std::uint64_t> sequence{0};
+    std::int64_t start_us = 0;
+    std::int64_t duration_us = 0;
+    std::uint32_t thread = 0;
+    std::array<char, kSpanNameBytes> name{};
+  };
+
+  struct SnapshotSlot {
+    std::atomic<std::uint64_t> sequence{0};
+    std::int64_t time_ms = 0;
+    std::array<double, kMaxMetrics> values{};
+  };
+
+  void runSampler(std::chrono::milliseconds interval);
+
+  std::array<LogSlot, kLogCapacity> logs_;
+  std::atomic<std::uint64_t> log_head_{0};
+  std::array<SpanSlot, kSpanCapacity> spans_;
+  std::atomic<std::uint64_t> span_head_{0};
+  std::array<SnapshotSlot, kSnapshotCapacity> snapshots_;
+  std::atomic<std::uint64_t> snapshot_head_{0};
+
+  // 名称在注册时写入固定数组，转储时不访问 std::string
+  std::array<std::array<char, kMetricNameBytes>, kMaxMetrics> metric_names_{};
+  std::atomic<std::size_t> metric_count_{0};
+  std::mutex metrics_mutex_;
+  std::vector<MetricReader> metric_readers_;
+
+  std::mutex sampler_mutex_;
+  std::condition_variable sampler_cv_;
+  bool sampler_running_ = false;
+  std::thread sampler_;
+};
+
+/**
+ * @brief 在作用域结束时向飞行记录器写入一个追踪区间
+ */
+class FlightSpan {
+ public:
+  explicit FlightSpan(const char* name,
+                      FlightRecorder& recorder = FlightRecorder::getInstance())
+      : recorder_(recorder),
+        name_(name),
+        start_(std::chrono::system_clock::now()),
+        started_(std::chrono::steady_clock::now()) {}
+  ~FlightSpan() {
+    recorder_.recordSpan(
+        name_, start_,
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - started_));
+  }
+
+  FlightSpan(const FlightSpan&) = delete;
+  auto operator=(const FlightSpan&) -> FlightSpan& = delete;
+
+ private:
+  FlightRecorder& recorder_;
+  const char* name_;
+  std::chrono::system_clock::time_point start_;
+  std::chrono::steady_clock::time_point started_;
+};
+
+/**
+ * @brief 把日志写入飞行记录器的输出流
+ */
+class FlightRecorderLogStream : public logger::LogOutputStream {
+ public:
+  explicit FlightRecorderLogStream(
+      FlightRecorder& recorder = FlightRecorder::getInstance())
+      : recorder_(recorder) {}
+
+  void write(const logger::LogEntry& entry,
+             const std::string& formatted) override {
+    recorder_.recordLog(formatted);
+  }
+  void flush() override {}
+  [[nodiscard]] auto getType() const -> logger::LogOutputType override {
+    return logger::LogOutputType::FLIGHT_RECORDER;
+  }
+
+ private:
+  FlightRecorder& recorder_;
+};
+
+}  // namespace picoradar::common
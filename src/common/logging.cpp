@@ -78,6 +78,14 @@ LogConfig LogConfig::loadFromConfigManager() {
   log_config.flush_interval_ms = config_manager.template getWithDefault<int>(
       "logging.performance.flush_interval_ms", 1000);
 
+  // 风暴抑制配置
+  log_config.dedup_enabled = config_manager.template getWithDefault<bool>(
+      "logging.dedup.enabled", false);
+  log_config.dedup_window_ms = config_manager.template getWithDefault<int>(
+      "logging.dedup.window_ms", 1000);
+  log_config.dedup_burst =
+      config_manager.template getWithDefault<int>("logging.dedup.burst", 5);
+
   // 加载模块级别配置
   if (config_manager.hasKey("logging.module_levels")) {
     auto config = config_manager.getConfig();
@@ -531,8 +539,12 @@ Logger& Logger::getInstance() {
   return instance;
 }
 
+Logger::~Logger() { stopSuppressionFlusher(); }
+
 void Logger::Init(const std::string& program_name, const LogConfig& config) {
   auto& instance = getInstance();
+  // 汇总线程输出时需要 logger_mutex_，必须在加锁前停止
+  instance.stopSuppressionFlusher();
   std::lock_guard lock(instance.logger_mutex_);
 
   instance.program_name_ = program_name;
@@ -549,6 +561,17 @@ void Logger::Init(const std::string& program_name, const LogConfig& config) {
   // 创建格式化器
   instance.formatter_ = std::make_unique<LogFormatter>(config.format_pattern);
 
+  // 风暴抑制：窗口或突发数为 0 时等同于禁用
+  instance.resetCallSites();
+  const bool dedup = config.dedup_enabled && config.dedup_window_ms > 0 &&
+                     config.dedup_burst > 0;
+  instance.dedup_window_ns_.store(
+      dedup ? static_cast<std::int64_t>(config.dedup_window_ms) * 1000000 : 0);
+  instance.dedup_burst_.store(static_cast<std::uint32_t>(config.dedup_burst));
+  if (dedup) {
+    instance.startSuppressionFlusher();
+  }
+
   // 清空现有输出流
   instance.output_streams_.clear();
 
@@ -671,6 +694,8 @@ void Logger::reloadConfig() {
 
 void Logger::flush() {
   auto& instance = getInstance();
+  instance.flushSuppressed();
+
   std::lock_guard lock(instance.logger_mutex_);
 
   for (auto& stream : instance.output_streams_) {
@@ -680,6 +705,9 @@ void Logger::flush() {
 
 void Logger::shutdown() {
   auto& instance = getInstance();
+  instance.stopSuppressionFlusher();
+  instance.flushSuppressed();
+
   std::lock_guard lock(instance.logger_mutex_);
 
   // 刷新所有输出流 (不调用公共flush方法避免死锁)
@@ -703,6 +731,12 @@ void Logger::log(LogLevel level, const char* file, int line,
     return;
   }
 
+  // 同一调用点的日志风暴只输出前几条
+  if (instance.dedup_window_ns_.load(std::memory_order_relaxed) > 0 &&
+      !instance.admitCallSite(level, file, line, function)) {
+    return;
+  }
+
   // 创建日志条目
   LogEntry entry;
   entry.timestamp = std::chrono::system_clock::now();
@@ -714,13 +748,7 @@ void Logger::log(LogLevel level, const char* file, int line,
   entry.module = module;
   entry.message = message;
 
-  // 写入到输出流
-  instance.writeToStreams(entry);
-
-  // 调用自定义回调
-  if (instance.log_callback_) {
-    instance.log_callback_(entry);
-  }
+  instance.dispatch(entry);
 }
 
 bool Logger::shouldLog(LogLevel level, const char* file,
@@ -734,6 +762,158 @@ bool Logger::shouldLog(LogLevel level, const char* file,
   return instance.level_filter_->shouldLog(level, file, module);
 }
 
+void Logger::dispatch(const LogEntry& entry) {
+  // 写入到输出流
+  writeToStreams(entry);
+
+  // 调用自定义回调
+  if (log_callback_) {
+    log_callback_(entry);
+  }
+}
+
+Logger::CallSiteState* Logger::findCallSite(const char* file, int line) {
+  // 文件名是字符串字面量，指针与行号共同唯一标识一个调用点
+  std::uint64_t key = reinterpret_cast<std::uintptr_t>(file);
+  key ^= static_cast<std::uint64_t>(line) * 0x9E3779B97F4A7C15ULL;
+  key ^= key >> 29;
+  key |= 1;  // 保证非零
+
+  const auto start = static_cast<std::size_t>(key % kCallSiteSlots);
+  for (std::size_t probe = 0; probe < kCallSiteProbes; ++probe) {
+    auto& site = call_sites_[(start + probe) % kCallSiteSlots];
+    std::uint64_t current = site.key.load(std::memory_order_acquire);
+    if (current == key) {
+      return &site;
+    }
+    if (current == 0 && site.key.compare_exchange_strong(
+                            current, key, std::memory_order_acq_rel)) {
+      site.file.store(file, std::memory_order_relaxed);
+      site.line.store(line, std::memory_order_relaxed);
+      return &site;
+    }
+    if (current == key) {  // 其他线程刚刚占用了同一个槽
+      return &site;
+    }
+  }
+  return nullptr;  // 表已满，该调用点不做抑制
+}
+
+bool Logger::admitCallSite(LogLevel level, const char* file, int line,
+                           const char* function) {
+  auto* site = findCallSite(file, line);
+  if (site == nullptr) {
+    return true;
+  }
+  site->function.store(function, std::memory_order_relaxed);
+  site->level.store(level, std::memory_order_relaxed);
+
+  const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch())
+                       .count();
+  const auto window = dedup_window_ns_.load(std::memory_order_relaxed);
+
+  auto start = site->window_start_ns.load(std::memory_order_relaxed);
+  if ((start == 0 || now - start >= window) &&
+      site->window_start_ns.compare_exchange_strong(start, now)) {
+    // 本线程负责开启新窗口，并汇报上一窗口被抑制的数量
+    site->count.store(1, std::memory_order_relaxed);
+    const auto suppressed = site->suppressed.exchange(0);
+    if (suppressed > 0) {
+      emitSuppressed(*site, suppressed);
+    }
+    return true;
+  }
+
+  if (site->count.fetch_add(1, std::memory_order_relaxed) <
+      dedup_burst_.load(std::memory_order_relaxed)) {
+    return true;
+  }
+  site->suppressed.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+void Logger::emitSuppressed(CallSiteState& site, std::uint32_t suppressed) {
+  const char* file = site.file.load(std::memory_order_relaxed);
+  const char* function = site.function.load(std::memory_order_relaxed);
+
+  LogEntry entry;
+  entry.timestamp = std::chrono::system_clock::now();
+  entry.level = site.level.load(std::memory_order_relaxed);
+  entry.file = file != nullptr ? file : "";
+  entry.line = site.line.load(std::memory_order_relaxed);
+  entry.function = function != nullptr ? function : "";
+  entry.thread_id = std::this_thread::get_id();
+  entry.message =
+      "suppressed " + std::to_string(suppressed) + " similar messages";
+  dispatch(entry);
+}
+
+void Logger::flushSuppressed() {
+  for (auto& site : call_sites_) {
+    if (site.key.load(std::memory_order_acquire) == 0) {
+      continue;
+    }
+    const auto suppressed = site.suppressed.exchange(0);
+    if (suppressed > 0) {
+      emitSuppressed(site, suppressed);
+    }
+  }
+}
+
+void Logger::flushExpiredSuppressed() {
+  const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch())
+                       .count();
+  const auto window = dedup_window_ns_.load(std::memory_order_relaxed);
+  for (auto& site : call_sites_) {
+    if (site.key.load(std::memory_order_acquire) == 0 ||
+        now - site.window_start_ns.load(std::memory_order_relaxed) < window) {
+      continue;
+    }
+    // 与开启新窗口的线程竞争时，exchange 保证每个计数只汇报一次
+    const auto suppressed = site.suppressed.exchange(0);
+    if (suppressed > 0) {
+      emitSuppressed(site, suppressed);
+    }
+  }
+}
+
+void Logger::startSuppressionFlusher() {
+  const auto interval = std::chrono::nanoseconds(
+      dedup_window_ns_.load(std::memory_order_relaxed));
+  suppression_flusher_stop_ = false;
+  suppression_flusher_ = std::thread([this, interval] {
+    std::unique_lock lock(suppression_flusher_mutex_);
+    while (!suppression_flusher_cv_.wait_for(
+        lock, interval, [this] { return suppression_flusher_stop_; })) {
+      lock.unlock();
+      flushExpiredSuppressed();
+      lock.lock();
+    }
+  });
+}
+
+void Logger::stopSuppressionFlusher() {
+  {
+    std::lock_guard lock(suppression_flusher_mutex_);
+    suppression_flusher_stop_ = true;
+  }
+  suppression_flusher_cv_.notify_all();
+  if (suppression_flusher_.joinable()) {
+    suppression_flusher_.join();
+  }
+}
+
+void Logger::resetCallSites() {
+  for (auto& site : call_sites_) {
+    site.key.store(0, std::memory_order_relaxed);
+    site.window_start_ns.store(0, std::memory_order_relaxed);
+    site.count.store(0, std::memory_order_relaxed);
+    site.suppressed.store(0, std::memory_order_relaxed);
+  }
+}
+
 void Logger::writeToStreams(const LogEntry& entry) {
   if (!formatter_) return;
 
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <fstream>
 #include <functional>
 #include <map>
@@ -89,6 +92,12 @@ struct LogConfig {
   size_t buffer_size = 1024;
   size_t flush_interval_ms = 1000;
 
+  // 日志风暴抑制配置：同一调用点在窗口内最多输出 dedup_burst 条，
+  // 其余只计数；窗口结束后由后台线程输出一条汇总，风暴停止后也不会遗漏
+  bool dedup_enabled = false;
+  size_t dedup_window_ms = 1000;
+  size_t dedup_burst = 5;
+
   // 模块级别配置
   std::map<std::string, LogLevel> module_levels;
 
@@ -110,6 +119,7 @@ enum class LogOutputType : std::uint8_t {
   CONSOLE,
   CLI_INTERFACE,
   MEMORY_BUFFER,
+  FLIGHT_RECORDER,
   CUSTOM
 };
 
@@ -378,7 +388,7 @@ class Logger {
 
  private:
   Logger() = default;
-  ~Logger() = default;
+  ~Logger();
   Logger(const Logger&) = delete;
   Logger& operator=(const Logger&) = delete;
 
@@ -391,6 +401,49 @@ class Logger {
 
   mutable std::mutex logger_mutex_;
 
+  /**
+   * @brief 单个调用点的风暴抑制状态
+   *
+   * 所有字段都是原子量，日志热路径上无需加锁。
+   */
+  struct CallSiteState {
+    std::atomic<std::uint64_t> key{0};  // 0 表示空槽
+    std::atomic<const char*> file{nullptr};
+    std::atomic<const char*> function{nullptr};
+    std::atomic<int> line{0};
+    std::atomic<LogLevel> level{LogLevel::INFO};
+    std::atomic<std::int64_t> window_start_ns{0};
+    std::atomic<std::uint32_t> count{0};
+    std::atomic<std::uint32_t> suppressed{0};
+  };
+
+  static constexpr std::size_t kCallSiteSlots = 1024;
+  static constexpr std::size_t kCallSiteProbes = 16;
+
+  std::array<CallSiteState, kCallSiteSlots> call_sites_;
+  std::atomic<std::int64_t> dedup_window_ns_{0};  // 0 表示禁用
+  std::atomic<std::uint32_t> dedup_burst_{0};
+
+  // 判断调用点本次是否允许输出；窗口滚动时先输出上一窗口的汇总
+  bool admitCallSite(LogLevel level, const char* file, int line,
+                     const char* function);
+  CallSiteState* findCallSite(const char* file, int line);
+  void emitSuppressed(CallSiteState& site, std::uint32_t suppressed);
+  void flushSuppressed();
+  // 只输出窗口已结束的调用点的汇总
+  void flushExpiredSuppressed();
+  void resetCallSites();
+
+  // 抑制开启时每个窗口唤醒一次，输出已结束窗口的汇总
+  void startSuppressionFlusher();
+  void stopSuppressionFlusher();
+
+  std::thread suppression_flusher_;
+  std::mutex suppression_flusher_mutex_;
+  std::condition_variable suppression_flusher_cv_;
+  bool suppression_flusher_stop_ = false;
+
+  void dispatch(const LogEntry& entry);
   void writeToStreams(const LogEntry& entry);
   std::string extractFilename(const std::string& filepath) const;
   std::string logLevelToString(LogLevel level) const;
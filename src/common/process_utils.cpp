@@ -12,6 +12,7 @@
 #include <tlhelp32.h>
 #else
 #include <fcntl.h>
+#include <sys/resource.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
@@ -37,6 +38,37 @@ auto is_process_running(ProcessId pid) -> bool {
 #endif
 }
 
+auto process_cpu_time() -> std::chrono::microseconds {
+#ifdef _WIN32
+  FILETIME creation;
+  FILETIME exit;
+  FILETIME kernel;
+  FILETIME user;
+  if (GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel,
+                      &user) == 0) {
+    return std::chrono::microseconds{0};
+  }
+  // FILETIME 以 100ns 为单位
+  const auto to_us = [](const FILETIME& time) {
+    ULARGE_INTEGER value;
+    value.LowPart = time.dwLowDateTime;
+    value.HighPart = time.dwHighDateTime;
+    return std::chrono::microseconds(value.QuadPart / 10);
+  };
+  return to_us(kernel) + to_us(user);
+#else
+  rusage usage{};
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return std::chrono::microseconds{0};
+  }
+  const auto to_us = [](const timeval& time) {
+    return std::chrono::seconds(time.tv_sec) +
+           std::chrono::microseconds(time.tv_usec);
+  };
+  return to_us(usage.ru_utime) + to_us(usage.ru_stime);
+#endif
+}
+
 #ifdef _WIN32
 Process::Process(const std::string& executable_path,
                  const std::vector<std::string>& args) {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <optional>
 #include <string>
 #include <vector>
@@ -26,6 +27,11 @@ using ProcessId = pid_t;
  */
 auto is_process_running(ProcessId pid) -> bool;
 
+/**
+ * @brief 获取当前进程累计使用的 CPU 时间（用户态 + 内核态，所有线程）。
+ */
+auto process_cpu_time() -> std::chrono::microseconds;
+
 /**
  * @class Process
  * @brief 以跨平台的方式管理子进程的生命周期。
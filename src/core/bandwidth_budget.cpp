@@ -0,0 +1,88 @@
+#include "bandwidth_budget.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "common/constants.hpp"
+
+namespace picoradar::core {
+
+namespace {
+// 估算速率的指数平滑系数
+constexpr double kEstimateSmoothing = 0.2;
+// 队列空闲时每次写完成对估算速率的放大系数，用于探测更高的可用带宽
+constexpr double kEstimateProbeGrowth = 1.05;
+
+auto toSeconds(BandwidthBudget::Clock::duration d) -> double {
+  return std::chrono::duration<double>(d).count();
+}
+}  // namespace
+
+BandwidthBudget::BandwidthBudget(std::size_t configured_bytes_per_sec,
+                                 bool estimate)
+    : configured_rate_(configured_bytes_per_sec), estimate_(estimate) {}
+
+auto BandwidthBudget::isLimited() const -> bool { return getRate() != 0; }
+
+auto BandwidthBudget::getRate() const -> std::size_t {
+  if (configured_rate_ != 0) {
+    return configured_rate_;
+  }
+  return static_cast<std::size_t>(estimated_rate_);
+}
+
+auto BandwidthBudget::available(Clock::time_point now) -> std::size_t {
+  const auto rate = static_cast<double>(getRate());
+  if (rate == 0.0) {
+    return std::numeric_limits<std::size_t>::max();
+  }
+
+  const double capacity = rate * toSeconds(constants::kBandwidthBurstWindow);
+  if (last_refill_ == Clock::time_point{}) {
+    // 首次进入受限状态时给予一个完整的突发窗口
+    tokens_ = capacity;
+  } else if (now > last_refill_) {
+    tokens_ =
+        std::min(capacity, tokens_ + rate * toSeconds(now - last_refill_));
+  }
+  last_refill_ = now;
+
+  return tokens_ > 0.0 ? static_cast<std::size_t>(tokens_) : 0;
+}
+
+void BandwidthBudget::consume(std::size_t bytes) {
+  if (isLimited()) {
+    tokens_ -= static_cast<double>(bytes);
+  }
+}
+
+void BandwidthBudget::onWriteCompleted(std::size_t bytes,
+                                       Clock::duration elapsed,
+                                       bool backlogged) {
+  if (!estimate_ || configured_rate_ != 0) {
+    return;
+  }
+
+  if (backlogged) {
+    const double seconds = toSeconds(elapsed);
+    if (seconds <= 0.0) {
+      return;
+    }
+    const double sample = static_cast<double>(bytes) / seconds;
+    estimated_rate_ = estimated_rate_ == 0.0
+                          ? sample
+                          : (1.0 - kEstimateSmoothing) * estimated_rate_ +
+                                kEstimateSmoothing * sample;
+  } else if (estimated_rate_ != 0.0) {
+    estimated_rate_ *= kEstimateProbeGrowth;
+  }
+
+  // 估算值超过上限说明链路已不再是瓶颈，回到不受限状态
+  if (estimated_rate_ >
+      static_cast<double>(constants::kMaxEstimatedBandwidth)) {
+    estimated_rate_ = 0.0;
+    last_refill_ = Clock::time_point{};
+  }
+}
+
+}  // namespace picoradar::core
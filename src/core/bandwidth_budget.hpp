@@ -0,0 +1,70 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+namespace picoradar::core {
+
+/**
+ * @brief 单个会话的出口带宽预算（令牌桶）
+ *
+ * 速率来源有两种：
+ * - 配置值：`network.bandwidth.bytes_per_sec` 指定的固定速率；
+ * - 估算值：根据写操作完成情况估算链路吞吐量。只有在发送队列积压时
+ *   完成的写操作才被视为有效样本，因为此时耗时反映的是链路而非内核缓冲区。
+ *
+ * 两者都不存在时预算不受限，调用方应直接发送完整帧。
+ * 此类不是线程安全的，由调用方负责同步。
+ */
+class BandwidthBudget {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * @param configured_bytes_per_sec 配置的速率，0表示未配置
+   * @param estimate 未配置速率时是否根据写完成情况估算
+   */
+  explicit BandwidthBudget(std::size_t configured_bytes_per_sec = 0,
+                           bool estimate = true);
+
+  /**
+   * @brief 当前是否存在有效的速率限制
+   */
+  [[nodiscard]] auto isLimited() const -> bool;
+
+  /**
+   * @brief 获取当前生效的速率（字节/秒），0表示不受限
+   */
+  [[nodiscard]] auto getRate() const -> std::size_t;
+
+  /**
+   * @brief 补充令牌并返回当前可用的字节数
+   *
+   * 不受限时返回 SIZE_MAX。
+   */
+  auto available(Clock::time_point now) -> std::size_t;
+
+  /**
+   * @brief 消耗指定字节数的令牌
+   */
+  void consume(std::size_t bytes);
+
+  /**
+   * @brief 记录一次写操作完成
+   *
+   * @param bytes 本次写入的字节数
+   * @param elapsed 写操作耗时
+   * @param backlogged 完成时发送队列中是否仍有待发送的消息
+   */
+  void onWriteCompleted(std::size_t bytes, Clock::duration elapsed,
+                        bool backlogged);
+
+ private:
+  std::size_t configured_rate_;
+  bool estimate_;
+  double estimated_rate_ = 0.0;  // 0 表示尚无估算
+  double tokens_ = 0.0;
+  Clock::time_point last_refill_{};
+};
+
+}  // namespace picoradar::core
@@ -0,0 +1,146 @@
+#include "encoding_selector.hpp"
+
+#include <algorithm>
+
+namespace picoradar::core {
+
+namespace {
+
+using std::chrono::microseconds;
+
+// 平滑系数，与 TCP 的 SRTT 相同 (RFC 6298)
+constexpr double kSmoothing = 0.125;
+
+auto smooth(microseconds current, microseconds sample) -> microseconds {
+  if (current.count() == 0) {
+    return sample;
+  }
+  return microseconds(static_cast<microseconds::rep>(
+      static_cast<double>(current.count()) * (1.0 - kSmoothing) +
+      static_cast<double>(sample.count()) * kSmoothing));
+}
+
+auto tierIndex(EncodingTier tier) -> std::size_t {
+  return static_cast<std::size_t>(tier);
+}
+
+}  // namespace
+
+auto encodingTierName(EncodingTier tier) -> const char* {
+  switch (tier) {
+    case EncodingTier::Delta:
+      return "delta";
+    case EncodingTier::Compact:
+      return "compact";
+    case EncodingTier::Coarse:
+      return "coarse";
+    default:
+      return "full";
+  }
+}
+
+EncodingSelector::EncodingSelector(EncodingSelectorConfig config,
+                                   std::vector<EncodingTier> ladder)
+    : config_(config), ladder_(std::move(ladder)) {
+  if (ladder_.empty()) {
+    ladder_.push_back(EncodingTier::Full);
+  }
+  config_.degrade_samples = std::max<std::size_t>(1, config_.degrade_samples);
+  config_.recover_samples = std::max<std::size_t>(1, config_.recover_samples);
+}
+
+auto EncodingSelector::makeLadder(bool compact_baseline, bool supports_compact)
+    -> std::vector<EncodingTier> {
+  std::vector<EncodingTier> ladder;
+  // 部分帧携带完整的 PlayerData，只有以完整帧为基线时才比基线更省
+  if (!compact_baseline) {
+    ladder.push_back(EncodingTier::Full);
+    ladder.push_back(EncodingTier::Delta);
+  }
+  if (compact_baseline || supports_compact) {
+    ladder.push_back(EncodingTier::Compact);
+    ladder.push_back(EncodingTier::Coarse);
+  }
+  return ladder;
+}
+
+void EncodingSelector::onRtt(microseconds rtt) {
+  estimate_.rtt = smooth(estimate_.rtt, std::max(rtt, microseconds{1}));
+}
+
+void EncodingSelector::onFrameSize(EncodingTier tier, std::size_t bytes) {
+  frame_bytes_[tierIndex(tier)] = bytes;
+}
+
+auto EncodingSelector::onDelivered(microseconds queued_for,
+                                   microseconds write_time,
+                                   std::size_t throughput) -> EncodingTier {
+  const auto latency = queued_for + estimate_.rtt / 2;
+  estimate_.latency = smooth(estimate_.latency, latency);
+  estimate_.throughput = throughput;
+
+  const bool stalled = write_time > config_.stall_threshold;
+  if (stalled) {
+    ++estimate_.stalls;
+  }
+
+  const auto headroom = microseconds(static_cast<microseconds::rep>(
+      static_cast<double>(config_.latency_budget.count()) *
+      config_.recover_ratio));
+  if (stalled || latency > config_.latency_budget) {
+    recovered_samples_ = 0;
+    ++overloaded_samples_;
+  } else if (latency < headroom) {
+    overloaded_samples_ = 0;
+    ++recovered_samples_;
+  } else {
+    overloaded_samples_ = 0;
+    recovered_samples_ = 0;
+  }
+
+  if (probing_ && ++samples_since_change_ >= config_.recover_samples) {
+    probing_ = false;
+    recover_backoff_ = 1;
+  }
+
+  if (overloaded_samples_ >= config_.degrade_samples &&
+      level_ + 1 < ladder_.size()) {
+    if (probing_) {
+      recover_backoff_ = std::min(recover_backoff_ * 2, kMaxRecoverBackoff);
+      probing_ = false;
+    }
+    setLevel(level_ + 1);
+  } else if (recovered_samples_ >= config_.recover_samples * recover_backoff_ &&
+             level_ > 0) {
+    if (fitsWithHeadroom(ladder_[level_ - 1])) {
+      setLevel(level_ - 1);
+      probing_ = true;
+    } else {
+      recovered_samples_ = 0;
+    }
+  }
+  return getTier();
+}
+
+void EncodingSelector::setLevel(std::size_t level) {
+  level_ = std::min(level, ladder_.size() - 1);
+  overloaded_samples_ = 0;
+  recovered_samples_ = 0;
+  samples_since_change_ = 0;
+}
+
+auto EncodingSelector::fitsWithHeadroom(EncodingTier tier) const -> bool {
+  const auto bytes = frame_bytes_[tierIndex(tier)];
+  if (bytes == 0 || estimate_.throughput == 0) {
+    return true;  // 没有依据时允许尝试，超出预算会很快再降回来
+  }
+  const auto transfer = microseconds(static_cast<microseconds::rep>(
+      static_cast<double>(bytes) * 1e6 /
+      static_cast<double>(estimate_.throughput)));
+  return estimate_.rtt / 2 + transfer <=
+         microseconds(static_cast<microseconds::rep>(
+             static_cast<double>(config_.latency_budget.count()) *
+             config_.recover_ratio));
+}
+
+}  // namespace picoradar::core
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace picoradar::core {
+
+/**
+ * @brief 玩家列表帧的编码方式，按开销从高到低排列
+ */
+enum class EncodingTier : std::uint8_t {
+  Full = 0,     ///< 完整 PlayerList
+  Delta = 1,    ///< 只含自上次发送以来有新数据的玩家的部分 PlayerList
+  Compact = 2,  ///< 按距离选择精度的 CompactPlayerList
+  Coarse = 3,   ///< 所有玩家都使用 Far 精度的 CompactPlayerList
+};
+
+/// @brief 编码方式数量
+constexpr std::size_t kEncodingTierCount = 4;
+
+/// 编码方式在配置与日志中的名称：full、delta、compact、coarse
+auto encodingTierName(EncodingTier tier) -> const char*;
+
+/**
+ * @brief 自适应编码参数 (network.adaptive_encoding.*)
+ */
+struct EncodingSelectorConfig {
+  bool enabled = false;
+  /// 玩家列表帧从入队到到达客户端的目标延迟
+  std::chrono::microseconds latency_budget{50000};
+  /// 延迟低于 latency_budget 的该比例才视为有余量
+  double recover_ratio = 0.5;
+  /// 连续多少个超出预算的采样后降一级
+  std::size_t degrade_samples = 3;
+  /// 连续多少个有余量的采样后升一级，远大于 degrade_samples 以免来回切换
+  std::size_t recover_samples = 50;
+  /// 单次写操作超过该时长记为一次写停顿，立即计为超出预算的采样
+  std::chrono::microseconds stall_threshold{100000};
+  /// WebSocket ping 测量往返时延的间隔
+  std::chrono::milliseconds probe_interval{1000};
+};
+
+/**
+ * @brief 链路质量估算
+ */
+struct LinkEstimate {
+  /// 平滑往返时延，0 表示尚无样本
+  std::chrono::microseconds rtt{0};
+  /// 平滑后的帧延迟：排队与写出耗时加上半个往返时延
+  std::chrono::microseconds latency{0};
+  /// 最近一次使用的吞吐量估算（字节/秒），0 表示不受限或未知
+  std::size_t throughput = 0;
+  std::size_t stalls = 0;
+};
+
+/**
+ * @brief 按单个会话的链路质量选择玩家列表编码方式
+ *
+ * 每个会话从其编码阶梯 (ladder) 的第一级开始。每帧写完后以帧延迟
+ * （排队与写出耗时，加上 ping 测得的半个往返时延）作为一个采样：
+ * - 连续 degrade_samples 个采样超出 latency_budget（或发生写停顿）时
+ *   降到下一级更省带宽的编码；
+ * - 连续 recover_samples 个采样低于 latency_budget × recover_ratio，
+ *   且按吞吐量估算上一级的帧也能在该余量内送达时，才升回上一级；
+ * - 介于两者之间的采样清除累计。
+ * 升级后不到 recover_samples 个采样又降回来，说明上一级放不下，下次
+ * 升级所需的采样数加倍（最多 kMaxRecoverBackoff 倍），升级站稳后复位。
+ * 降级快、升级慢，加上预测检查与退避，避免在两级之间来回切换。
+ * 此类不是线程安全的，由调用方负责同步。
+ */
+class EncodingSelector {
+ public:
+  /// 升级失败后所需恢复采样数的最大倍数
+  static constexpr std::size_t kMaxRecoverBackoff = 16;
+
+  explicit EncodingSelector(EncodingSelectorConfig config = {},
+                            std::vector<EncodingTier> ladder = {
+                                EncodingTier::Full});
+
+  /**
+   * @brief 构建会话的编码阶梯
+   *
+   * @param compact_baseline 服务器默认向该会话发送紧凑帧（精度 LOD 开启）
+   * @param supports_compact 客户端能否解码 CompactPlayerList
+   */
+  static auto makeLadder(bool compact_baseline, bool supports_compact)
+      -> std::vector<EncodingTier>;
+
+  /// 记录一次 ping 往返时延
+  void onRtt(std::chrono::microseconds rtt);
+
+  /// 记录以某种编码发送的一帧的大小，用于升级前的预测
+  void onFrameSize(EncodingTier tier, std::size_t bytes);
+
+  /**
+   * @brief 记录一帧写完，必要时切换编码
+   *
+   * @param queued_for 从入队到写完的耗时
+   * @param write_time 写操作本身的耗时，用于识别写停顿
+   * @param throughput 当前链路吞吐量估算（字节/秒），0 表示未知
+   * @return 更新后的编码方式
+   */
+  auto onDelivered(std::chrono::microseconds queued_for,
+                   std::chrono::microseconds write_time,
+                   std::size_t throughput) -> EncodingTier;
+
+  [[nodiscard]] auto getTier() const -> EncodingTier {
+    return ladder_[level_];
+  }
+  [[nodiscard]] auto getLevel() const -> std::size_t { return level_; }
+  [[nodiscard]] auto getRecoverBackoff() const -> std::size_t {
+    return recover_backoff_;
+  }
+  [[nodiscard]] auto getLadder() const -> const std::vector<EncodingTier>& {
+    return ladder_;
+  }
+  [[nodiscard]] auto getEstimate() const -> const LinkEstimate& {
+    return estimate_;
+  }
+  [[nodiscard]] auto getConfig() const -> const EncodingSelectorConfig& {
+    return config_;
+  }
+
+ private:
+  void setLevel(std::size_t level);
+  [[nodiscard]] auto fitsWithHeadroom(EncodingTier tier) const -> bool;
+
+  EncodingSelectorConfig config_;
+  std::vector<EncodingTier> ladder_;
+  std::size_t level_ = 0;
+  std::size_t overloaded_samples_ = 0;
+  std::size_t recovered_samples_ = 0;
+  std::size_t recover_backoff_ = 1;
+  /// 最近一次切换是升级，且尚未站稳 recover_samples 个采样
+  bool probing_ = false;
+  std::size_t samples_since_change_ = 0;
+  /// 各编码最近一帧的大小，0 表示尚未以该编码发送过
+  std::array<std::size_t, kEncodingTierCount> frame_bytes_{};
+  LinkEstimate estimate_;
+};
+
+}  // namespace picoradar::core
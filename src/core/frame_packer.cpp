@@ -0,0 +1,152 @@
+#include "frame_packer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <google/protobuf/io/coded_stream.h>
+
+namespace picoradar::core {
+
+namespace {
+auto distanceBetween(const picoradar::Vector3& a, const picoradar::Vector3& b)
+    -> float {
+  const float dx = a.x() - b.x();
+  const float dy = a.y() - b.y();
+  const float dz = a.z() - b.z();
+  return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+// 一个 repeated 子消息/字符串字段的开销：1字节tag + varint长度
+auto lengthDelimitedSize(std::size_t payload) -> std::size_t {
+  return 1 + google::protobuf::io::CodedOutputStream::VarintSize64(payload) +
+         payload;
+}
+}  // namespace
+
+FramePacker::FramePacker() = default;
+
+FramePacker::FramePacker(Weights weights) : weights_(weights) {}
+
+auto FramePacker::encodedRecordSize(const picoradar::PlayerData& player)
+    -> std::size_t {
+  return lengthDelimitedSize(player.ByteSizeLong());
+}
+
+auto FramePacker::pack(const std::string& viewer_id, const PlayerMap& players,
+                       std::size_t budget_bytes, Clock::time_point now,
+                       bool changed_only) -> PackResult {
+  PackResult result;
+
+  // 1. 先处理已离开的玩家：它们的开销很小，且必须尽快通知客户端
+  for (auto it = sent_.begin(); it != sent_.end();) {
+    if (players.count(it->first) != 0) {
+      ++it;
+      continue;
+    }
+    const auto cost = lengthDelimitedSize(it->first.size());
+    if (result.bytes + cost > budget_bytes) {
+      ++it;
+      continue;
+    }
+    result.bytes += cost;
+    result.removed.push_back(it->first);
+    it = sent_.erase(it);
+  }
+
+  // 2. 计算每个玩家的优先级
+  const picoradar::Vector3* viewer_position = nullptr;
+  if (auto viewer = players.find(viewer_id); viewer != players.end()) {
+    viewer_position = &viewer->second.position();
+  }
+
+  struct Candidate {
+    const std::string* id;
+    const picoradar::PlayerData* data;
+    float priority;
+    std::size_t size;
+  };
+  std::vector<Candidate> candidates;
+  candidates.reserve(players.size());
+
+  for (const auto& [id, data] : players) {
+    float priority = 0.0F;
+    auto sent = sent_.find(id);
+    if (changed_only && sent != sent_.end() &&
+        !hasChanged(sent->second, data)) {
+      continue;  // 客户端已有这份数据
+    }
+    if (sent == sent_.end()) {
+      // 客户端从未见过的玩家优先级最高
+      priority = std::numeric_limits<float>::max();
+    } else {
+      if (viewer_position != nullptr) {
+        priority += weights_.distance /
+                    (1.0F + distanceBetween(*viewer_position, data.position()));
+      }
+      const float staleness =
+          std::chrono::duration<float>(now - sent->second.time).count();
+      if (staleness > 0.0F) {
+        const float dx = data.position().x() - sent->second.x;
+        const float dy = data.position().y() - sent->second.y;
+        const float dz = data.position().z() - sent->second.z;
+        const float speed = std::sqrt(dx * dx + dy * dy + dz * dz) / staleness;
+        priority += weights_.speed * speed + weights_.staleness * staleness;
+      }
+    }
+    candidates.push_back({&id, &data, priority, encodedRecordSize(data)});
+  }
+
+  std::sort(candidates.begin(), candidates.end(),
+            [](const Candidate& a, const Candidate& b) {
+              return a.priority > b.priority;
+            });
+
+  // 3. 贪心装填：放不下的跳过，继续尝试更小的记录
+  for (const auto& candidate : candidates) {
+    if (result.bytes + candidate.size > budget_bytes) {
+      ++result.deferred;
+      continue;
+    }
+    result.bytes += candidate.size;
+    result.selected.push_back(candidate.data);
+    markSent(*candidate.id, *candidate.data, now);
+  }
+
+  return result;
+}
+
+void FramePacker::markAllSent(const PlayerMap& players,
+                              Clock::time_point now) {
+  for (auto it = sent_.begin(); it != sent_.end();) {
+    it = players.count(it->first) != 0 ? std::next(it) : sent_.erase(it);
+  }
+  for (const auto& [id, data] : players) {
+    markSent(id, data, now);
+  }
+}
+
+void FramePacker::markSent(const std::string& id,
+                           const picoradar::PlayerData& player,
+                           Clock::time_point now) {
+  auto& state = sent_[id];
+  state.time = now;
+  state.x = player.position().x();
+  state.y = player.position().y();
+  state.z = player.position().z();
+  state.rotation = player.rotation();
+  state.timestamp = player.timestamp();
+}
+
+auto FramePacker::hasChanged(const SentState& sent,
+                             const picoradar::PlayerData& player) -> bool {
+  const auto& rotation = player.rotation();
+  return sent.timestamp != player.timestamp() ||
+         sent.x != player.position().x() || sent.y != player.position().y() ||
+         sent.z != player.position().z() ||
+         sent.rotation.x() != rotation.x() ||
+         sent.rotation.y() != rotation.y() ||
+         sent.rotation.z() != rotation.z() || sent.rotation.w() != rotation.w();
+}
+
+}  // namespace picoradar::core
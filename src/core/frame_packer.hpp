@@ -0,0 +1,108 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "player.pb.h"
+
+namespace picoradar::core {
+
+/**
+ * @brief 基于优先级的玩家列表帧打包器
+ *
+ * 当会话的带宽预算不足以容纳完整玩家列表时，按优先级挑选最重要的
+ * 玩家更新放入本帧，其余推迟到后续帧。优先级由三部分组成：
+ * - 与观察者的距离（越近越重要）
+ * - 自上次发送以来的移动速度（越快越重要）
+ * - 自上次发送以来经过的时间（越久越重要，保证不会饿死）
+ *
+ * 每个观察者会话持有一个独立的打包器实例，记录已发送给该客户端的
+ * 玩家状态，从而能够计算速度并通知客户端已离开的玩家。
+ * 此类不是线程安全的，由调用方负责同步。
+ */
+class FramePacker {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using PlayerMap = std::unordered_map<std::string, picoradar::PlayerData>;
+
+  /**
+   * @brief 优先级权重
+   */
+  struct Weights {
+    float distance = 1.0F;   ///< 距离项权重，作用于 1/(1+distance)
+    float speed = 1.0F;      ///< 速度项权重，单位为 米/秒
+    float staleness = 2.0F;  ///< 陈旧度权重，单位为 秒
+  };
+
+  /**
+   * @brief 打包结果
+   */
+  struct PackResult {
+    std::vector<const picoradar::PlayerData*> selected;  ///< 本帧发送的玩家
+    std::vector<std::string> removed;  ///< 客户端已知但已离开的玩家
+    std::size_t deferred = 0;          ///< 被推迟的玩家数量
+    std::size_t bytes = 0;             ///< 预计编码后的字节数
+  };
+
+  FramePacker();
+  explicit FramePacker(Weights weights);
+
+  /**
+   * @brief 在预算内挑选本帧要发送的玩家
+   *
+   * 被选中和被移除的玩家会立即记为"已发送"。
+   *
+   * @param viewer_id 观察者（本会话）的玩家ID，用于计算距离
+   * @param players 当前完整的玩家快照
+   * @param budget_bytes 本帧可用的字节数
+   * @param now 当前时间
+   * @param changed_only 为 true 时跳过自上次发送以来时间戳、位置与朝向
+   *        都没有变化的玩家，得到只含变化部分的增量帧
+   */
+  auto pack(const std::string& viewer_id, const PlayerMap& players,
+            std::size_t budget_bytes, Clock::time_point now,
+            bool changed_only = false) -> PackResult;
+
+  /**
+   * @brief 记录一次完整玩家列表的发送
+   */
+  void markAllSent(const PlayerMap& players, Clock::time_point now);
+
+  /**
+   * @brief 是否已经跟踪客户端已知的玩家集合
+   */
+  [[nodiscard]] auto hasState() const -> bool { return !sent_.empty(); }
+
+  /**
+   * @brief 估算一个玩家在 PlayerList 中编码后占用的字节数
+   */
+  static auto encodedRecordSize(const picoradar::PlayerData& player)
+      -> std::size_t;
+
+ private:
+  struct SentState {
+    Clock::time_point time;
+    float x = 0.0F;
+    float y = 0.0F;
+    float z = 0.0F;
+    picoradar::Quaternion rotation;
+    std::int64_t timestamp = 0;
+  };
+
+  /// 玩家数据自上次发送以来是否有变化（时间戳、位置或朝向）
+  static auto hasChanged(const SentState& sent,
+                         const picoradar::PlayerData& player) -> bool;
+
+  void markSent(const std::string& id, const picoradar::PlayerData& player,
+                Clock::time_point now);
+
+  Weights weights_;
+  std::unordered_map<std::string, SentState> sent_;
+};
+
+}  // namespace picoradar::core
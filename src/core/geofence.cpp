@@ -0,0 +1,263 @@
+#include "geofence.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace picoradar::core {
+
+namespace {
+// 自动选择条带数时每个条带期望包含的边数
+constexpr std::size_t kEdgesPerSlab = 4;
+constexpr std::size_t kMaxSlabCount = 4096;
+
+auto parsePoint(const nlohmann::json& json, const std::string& what)
+    -> PlanarPoint {
+  if (!json.is_array() || json.size() != 2 || !json[0].is_number() ||
+      !json[1].is_number()) {
+    throw std::invalid_argument(what + " must be an [x, z] pair");
+  }
+  return {json[0].get<float>(), json[1].get<float>()};
+}
+
+auto parseMode(const nlohmann::json& fence, const std::string& id)
+    -> GeofenceMode {
+  const auto mode = fence.value("mode", std::string("play_area"));
+  if (mode == "play_area") {
+    return GeofenceMode::PlayArea;
+  }
+  if (mode == "keep_out") {
+    return GeofenceMode::KeepOut;
+  }
+  throw std::invalid_argument("Geofence '" + id + "' has unknown mode '" +
+                              mode + "'");
+}
+}  // namespace
+
+//------------------------------------------------------------------------------
+// Geofence
+
+Geofence::Geofence(std::string id, GeofenceMode mode)
+    : id_(std::move(id)), mode_(mode) {}
+
+auto Geofence::box(std::string id, GeofenceMode mode, PlanarPoint min,
+                   PlanarPoint max) -> Geofence {
+  Geofence fence(std::move(id), mode);
+  fence.min_ = {std::min(min.x, max.x), std::min(min.z, max.z)};
+  fence.max_ = {std::max(min.x, max.x), std::max(min.z, max.z)};
+  return fence;
+}
+
+auto Geofence::polygon(std::string id, GeofenceMode mode,
+                       std::vector<PlanarPoint> vertices,
+                       std::size_t slab_count) -> Geofence {
+  if (vertices.size() < 3) {
+    throw std::invalid_argument("Geofence '" + id +
+                                "' polygon needs at least 3 vertices");
+  }
+  for (const auto& v : vertices) {
+    if (!std::isfinite(v.x) || !std::isfinite(v.z)) {
+      throw std::invalid_argument("Geofence '" + id +
+                                  "' polygon has non-finite vertex");
+    }
+  }
+
+  Geofence fence(std::move(id), mode);
+  fence.is_box_ = false;
+  fence.min_ = vertices.front();
+  fence.max_ = vertices.front();
+  fence.edges_.reserve(vertices.size());
+  for (std::size_t i = 0; i < vertices.size(); ++i) {
+    const auto& a = vertices[i];
+    const auto& b = vertices[(i + 1) % vertices.size()];
+    fence.min_ = {std::min(fence.min_.x, a.x), std::min(fence.min_.z, a.z)};
+    fence.max_ = {std::max(fence.max_.x, a.x), std::max(fence.max_.z, a.z)};
+    if (a.z != b.z) {  // 水平边不会与 +x 方向的射线相交
+      fence.edges_.push_back({a.x, a.z, b.x, b.z});
+    }
+  }
+
+  if (slab_count == 0) {
+    slab_count = std::clamp<std::size_t>(fence.edges_.size() / kEdgesPerSlab,
+                                         1, kMaxSlabCount);
+  }
+  const float height = fence.max_.z - fence.min_.z;
+  fence.slab_height_ =
+      height > 0.0F ? height / static_cast<float>(slab_count) : 1.0F;
+  fence.slabs_.resize(slab_count);
+
+  const auto slabOf = [&fence, slab_count](float z) {
+    const float index = (z - fence.min_.z) / fence.slab_height_;
+    return std::min(static_cast<std::size_t>(std::max(index, 0.0F)),
+                    slab_count - 1);
+  };
+  for (std::size_t i = 0; i < fence.edges_.size(); ++i) {
+    const auto& e = fence.edges_[i];
+    const auto first = slabOf(std::min(e.z0, e.z1));
+    const auto last = slabOf(std::max(e.z0, e.z1));
+    for (auto s = first; s <= last; ++s) {
+      fence.slabs_[s].push_back(static_cast<std::uint32_t>(i));
+    }
+  }
+  return fence;
+}
+
+auto Geofence::contains(float x, float z) const -> bool {
+  // NaN 不满足以下任何比较，视为不在围栏内
+  if (!(x >= min_.x && x <= max_.x && z >= min_.z && z <= max_.z)) {
+    return false;
+  }
+  if (is_box_) {
+    return true;
+  }
+
+  const auto slab = std::min(
+      static_cast<std::size_t>((z - min_.z) / slab_height_), slabs_.size() - 1);
+
+  // 沿 +x 方向的射线与边的交点数为奇数时点在多边形内
+  bool inside = false;
+  for (const auto index : slabs_[slab]) {
+    const auto& e = edges_[index];
+    if ((e.z0 > z) != (e.z1 > z)) {
+      const float cross_x = e.x0 + (z - e.z0) * (e.x1 - e.x0) / (e.z1 - e.z0);
+      if (x < cross_x) {
+        inside = !inside;
+      }
+    }
+  }
+  return inside;
+}
+
+//------------------------------------------------------------------------------
+// GeofenceEngine
+
+auto GeofenceEngine::fromJson(const nlohmann::json& scenes) -> GeofenceEngine {
+  GeofenceEngine engine;
+  if (scenes.is_null()) {
+    return engine;
+  }
+  if (!scenes.is_object()) {
+    throw std::invalid_argument("geofence.scenes must be an object");
+  }
+
+  for (const auto& [scene_id, fences] : scenes.items()) {
+    if (!fences.is_array()) {
+      throw std::invalid_argument("geofence.scenes." + scene_id +
+                                  " must be an array");
+    }
+    for (const auto& fence : fences) {
+      if (!fence.is_object()) {
+        throw std::invalid_argument("geofence.scenes." + scene_id +
+                                    " entries must be objects");
+      }
+      const auto id = fence.value(
+          "id", scene_id + "#" + std::to_string(engine.getFenceCount()));
+      const auto mode = parseMode(fence, id);
+
+      if (fence.contains("box")) {
+        const auto& box = fence.at("box");
+        const auto min =
+            parsePoint(box.value("min", nlohmann::json{}), id + ".box.min");
+        const auto max =
+            parsePoint(box.value("max", nlohmann::json{}), id + ".box.max");
+        engine.addFence(scene_id, Geofence::box(id, mode, min, max));
+      } else if (fence.contains("polygon") && fence.at("polygon").is_array()) {
+        std::vector<PlanarPoint> vertices;
+        for (const auto& vertex : fence.at("polygon")) {
+          vertices.push_back(parsePoint(vertex, id + ".polygon"));
+        }
+        engine.addFence(scene_id,
+                        Geofence::polygon(id, mode, std::move(vertices)));
+      } else {
+        throw std::invalid_argument("Geofence '" + id +
+                                    "' needs a box or polygon");
+      }
+    }
+  }
+  return engine;
+}
+
+void GeofenceEngine::addFence(const std::string& scene_id, Geofence fence) {
+  auto& scene = scenes_[scene_id];
+  if (fence.getMode() == GeofenceMode::PlayArea) {
+    scene.play_areas.push_back(std::move(fence));
+  } else {
+    scene.keep_outs.push_back(std::move(fence));
+  }
+}
+
+auto GeofenceEngine::check(const std::string& scene_id, float x,
+                           float z) const -> const Geofence* {
+  auto it = scenes_.find(scene_id);
+  if (it == scenes_.end()) {
+    return nullptr;
+  }
+  const auto& scene = it->second;
+
+  for (const auto& fence : scene.keep_outs) {
+    if (fence.contains(x, z)) {
+      return &fence;
+    }
+  }
+  if (scene.play_areas.empty()) {
+    return nullptr;
+  }
+  for (const auto& fence : scene.play_areas) {
+    if (fence.contains(x, z)) {
+      return nullptr;
+    }
+  }
+  return &scene.play_areas.front();
+}
+
+auto GeofenceEngine::evaluate(const PlayerMap& players)
+    -> std::vector<GeofenceEvent> {
+  std::vector<GeofenceEvent> events;
+
+  const auto emit = [&events](const picoradar::PlayerData& player,
+                              const std::string& fence_id, bool violated) {
+    events.push_back(GeofenceEvent{player.player_id(), player.scene_id(),
+                                   fence_id, violated, player.position()});
+  };
+
+  for (const auto& [id, player] : players) {
+    const auto* fence = check(player.scene_id(), player.position().x(),
+                              player.position().z());
+    auto previous = violations_.find(id);
+
+    if (fence == nullptr) {
+      if (previous != violations_.end()) {
+        emit(player, previous->second, false);
+        violations_.erase(previous);
+      }
+      continue;
+    }
+
+    if (previous == violations_.end()) {
+      emit(player, fence->getId(), true);
+      violations_.emplace(id, fence->getId());
+    } else if (previous->second != fence->getId()) {
+      emit(player, previous->second, false);
+      emit(player, fence->getId(), true);
+      previous->second = fence->getId();
+    }
+  }
+
+  // 已离开的玩家不再需要跟踪
+  for (auto it = violations_.begin(); it != violations_.end();) {
+    it = players.count(it->first) == 0 ? violations_.erase(it) : std::next(it);
+  }
+
+  return events;
+}
+
+auto GeofenceEngine::getFenceCount() const -> std::size_t {
+  std::size_t count = 0;
+  for (const auto& [scene_id, scene] : scenes_) {
+    count += scene.play_areas.size() + scene.keep_outs.size();
+  }
+  return count;
+}
+
+}  // namespace picoradar::core
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "player.pb.h"
+
+namespace picoradar::core {
+
+/**
+ * @brief 水平面 (x, z) 上的点
+ */
+struct PlanarPoint {
+  float x = 0.0F;
+  float z = 0.0F;
+};
+
+/**
+ * @brief 地理围栏的约束方式
+ */
+enum class GeofenceMode : std::uint8_t {
+  PlayArea,  ///< 游玩区域：玩家必须位于场景内至少一个游玩区域中
+  KeepOut,   ///< 禁入区域：玩家不得进入
+};
+
+/**
+ * @brief 单个地理围栏（矩形或多边形）
+ *
+ * 多边形的边按 z 方向划分为若干水平条带建立索引，
+ * 点包含测试只需检查点所在条带中的边，
+ * 使复杂多边形的单次查询开销接近 O(边数 / 条带数)。
+ */
+class Geofence {
+ public:
+  /**
+   * @brief 创建轴对齐矩形围栏
+   */
+  static auto box(std::string id, GeofenceMode mode, PlanarPoint min,
+                  PlanarPoint max) -> Geofence;
+
+  /**
+   * @brief 创建多边形围栏
+   *
+   * @param vertices 按顺序排列的顶点，首尾自动闭合
+   * @param slab_count 边索引的条带数，0 表示根据边数自动选择
+   * @throws std::invalid_argument 顶点少于 3 个或包含非有限坐标
+   */
+  static auto polygon(std::string id, GeofenceMode mode,
+                      std::vector<PlanarPoint> vertices,
+                      std::size_t slab_count = 0) -> Geofence;
+
+  /**
+   * @brief 判断点是否位于围栏内
+   */
+  [[nodiscard]] auto contains(float x, float z) const -> bool;
+
+  [[nodiscard]] auto getId() const -> const std::string& { return id_; }
+  [[nodiscard]] auto getMode() const -> GeofenceMode { return mode_; }
+  [[nodiscard]] auto getEdgeCount() const -> std::size_t {
+    return is_box_ ? 4 : edges_.size();
+  }
+
+ private:
+  struct Edge {
+    float x0;
+    float z0;
+    float x1;
+    float z1;
+  };
+
+  Geofence(std::string id, GeofenceMode mode);
+
+  std::string id_;
+  GeofenceMode mode_;
+  bool is_box_ = true;
+  PlanarPoint min_;
+  PlanarPoint max_;
+
+  std::vector<Edge> edges_;
+  std::vector<std::vector<std::uint32_t>> slabs_;
+  float slab_height_ = 0.0F;
+};
+
+/**
+ * @brief 地理围栏状态变化事件
+ */
+struct GeofenceEvent {
+  std::string player_id;
+  std::string scene_id;
+  std::string fence_id;
+  bool violated = false;  ///< true 表示开始越界，false 表示已回到允许区域
+  picoradar::Vector3 position;
+};
+
+/**
+ * @brief 按场景批量评估玩家位置的地理围栏引擎
+ *
+ * 每个 tick 对整张位姿表调用一次 evaluate()，只在玩家越界状态
+ * 发生变化时产生事件，避免向运营端重复推送。
+ * 此类不是线程安全的，应由单个 tick 循环驱动。
+ */
+class GeofenceEngine {
+ public:
+  using PlayerMap = std::unordered_map<std::string, picoradar::PlayerData>;
+
+  /**
+   * @brief 从配置加载 (geofence.scenes)
+   *
+   * 格式为 { "<scene_id>": [ { "id": ..., "mode": "play_area" | "keep_out",
+   * "box": { "min": [x, z], "max": [x, z] } 或 "polygon": [[x, z], ...] } ] }
+   *
+   * @throws std::invalid_argument 配置格式错误
+   */
+  static auto fromJson(const nlohmann::json& scenes) -> GeofenceEngine;
+
+  void addFence(const std::string& scene_id, Geofence fence);
+
+  /**
+   * @brief 检查单个位置，返回被违反的围栏
+   *
+   * @return 未越界时返回 nullptr
+   */
+  [[nodiscard]] auto check(const std::string& scene_id, float x,
+                           float z) const -> const Geofence*;
+
+  /**
+   * @brief 批量评估所有玩家，返回越界状态的变化
+   */
+  auto evaluate(const PlayerMap& players) -> std::vector<GeofenceEvent>;
+
+  [[nodiscard]] auto empty() const -> bool { return scenes_.empty(); }
+  [[nodiscard]] auto getFenceCount() const -> std::size_t;
+  [[nodiscard]] auto getViolationCount() const -> std::size_t {
+    return violations_.size();
+  }
+
+ private:
+  struct SceneFences {
+    std::vector<Geofence> play_areas;
+    std::vector<Geofence> keep_outs;
+  };
+
+  std::unordered_map<std::string, SceneFences> scenes_;
+  // 玩家 ID -> 当前违反的围栏 ID
+  std::unordered_map<std::string, std::string> violations_;
+};
+
+}  // namespace picoradar::core
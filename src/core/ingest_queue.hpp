@@ -0,0 +1,143 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace picoradar::core {
+
+/**
+ * @brief 单生产者单消费者的有界无锁环形队列。
+ *
+ * 容量向上取整为 2 的幂。tryPush 只能由一个线程调用，tryPop 只能由另一个
+ * 线程调用；两端各自只写自己的索引，不需要锁。
+ */
+template <typename T>
+class SpscRing {
+ public:
+  explicit SpscRing(std::size_t capacity) {
+    std::size_t rounded = 1;
+    while (rounded < capacity) {
+      rounded <<= 1;
+    }
+    slots_.resize(rounded);
+    mask_ = rounded - 1;
+  }
+
+  SpscRing(const SpscRing&) = delete;
+  auto operator=(const SpscRing&) -> SpscRing& = delete;
+
+  /// 队列已满时返回 false，value 保持不变
+  auto tryPush(T& value) -> bool {
+    const auto tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == slots_.size()) {
+      return false;
+    }
+    slots_[tail & mask_] = std::move(value);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  auto tryPop(T& value) -> bool {
+    const auto head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    value = std::move(slots_[head & mask_]);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  [[nodiscard]] auto capacity() const -> std::size_t { return slots_.size(); }
+
+ private:
+  std::vector<T> slots_;
+  std::size_t mask_ = 0;
+  // 生产者与消费者的索引放在不同缓存行，避免伪共享
+  alignas(64) std::atomic<std::size_t> head_{0};
+  alignas(64) std::atomic<std::size_t> tail_{0};
+};
+
+/**
+ * @brief 多生产者单消费者的摄入队列，每个生产者线程一个 SpscRing。
+ *
+ * 生产者线程先调用 bindCurrentThread() 绑定到自己的环形队列，之后 tryPush
+ * 完全无锁；未绑定的线程共用一个由互斥锁串行化的队列。唯一的消费者用
+ * drain() 依次取空所有队列。不同队列之间没有全局顺序，需要顺序的调用方
+ * 应在元素中携带序号。
+ */
+template <typename T>
+class IngestQueue {
+ public:
+  IngestQueue(std::size_t producers, std::size_t capacity_per_producer)
+      : id_(next_id_.fetch_add(1, std::memory_order_relaxed)),
+        shared_(capacity_per_producer) {
+    rings_.reserve(producers);
+    for (std::size_t i = 0; i < producers; ++i) {
+      rings_.push_back(std::make_unique<SpscRing<T>>(capacity_per_producer));
+    }
+  }
+
+  IngestQueue(const IngestQueue&) = delete;
+  auto operator=(const IngestQueue&) -> IngestQueue& = delete;
+
+  /// 将调用线程绑定到第 index 个生产者队列；每个队列只能绑定一个线程
+  void bindCurrentThread(std::size_t index) {
+    if (index < rings_.size()) {
+      binding_ = {id_, rings_[index].get()};
+    }
+  }
+
+  /// 队列已满时返回 false，value 保持不变
+  auto tryPush(T& value) -> bool {
+    if (binding_.owner == id_) {
+      return binding_.ring->tryPush(value);
+    }
+    std::lock_guard lock(shared_mutex_);
+    return shared_.tryPush(value);
+  }
+
+  /// 只能由消费者线程调用；返回取出的元素数
+  template <typename Consumer>
+  auto drain(Consumer&& consume) -> std::size_t {
+    std::size_t count = 0;
+    T value;
+    for (auto& ring : rings_) {
+      while (ring->tryPop(value)) {
+        consume(std::move(value));
+        ++count;
+      }
+    }
+    while (shared_.tryPop(value)) {
+      consume(std::move(value));
+      ++count;
+    }
+    return count;
+  }
+
+  [[nodiscard]] auto getProducerCount() const -> std::size_t {
+    return rings_.size();
+  }
+
+ private:
+  struct Binding {
+    std::uint64_t owner = 0;
+    SpscRing<T>* ring = nullptr;
+  };
+
+  // 同一线程可能先后服务多个队列实例，绑定时记录实例的唯一 ID，
+  // 而不是可能被复用的地址
+  inline static std::atomic<std::uint64_t> next_id_{1};
+  inline static thread_local Binding binding_{};
+
+  std::uint64_t id_;
+  std::vector<std::unique_ptr<SpscRing<T>>> rings_;
+  std::mutex shared_mutex_;
+  SpscRing<T> shared_;
+};
+
+}  // namespace picoradar::core
@@ -0,0 +1,97 @@
+#include "load_shedder.hpp"
+
+#include <algorithm>
+
+namespace picoradar::core {
+
+namespace {
+
+// 降载阶梯中各类别的先后顺序
+constexpr std::array<picoradar::SessionClass, kSessionClassCount> kShedOrder{
+    picoradar::SESSION_CLASS_SPECTATOR, picoradar::SESSION_CLASS_OPERATOR,
+    picoradar::SESSION_CLASS_PLAYER};
+
+auto intervalFor(int hz) -> std::chrono::microseconds {
+  return hz > 0 ? std::chrono::microseconds(1000000 / hz)
+                : std::chrono::microseconds{0};
+}
+
+}  // namespace
+
+auto sessionClassName(picoradar::SessionClass session_class) -> const char* {
+  switch (session_class) {
+    case picoradar::SESSION_CLASS_SPECTATOR:
+      return "spectator";
+    case picoradar::SESSION_CLASS_OPERATOR:
+      return "operator";
+    default:
+      return "player";
+  }
+}
+
+LoadShedder::LoadShedder(LoadShedderConfig config) : config_(config) {
+  config_.shed_samples = std::max<std::size_t>(1, config_.shed_samples);
+  config_.recover_samples = std::max<std::size_t>(1, config_.recover_samples);
+  for (const auto session_class : kShedOrder) {
+    const auto& policy = config_.classes[session_class];
+    // 降载帧率须低于正常帧率才算一步
+    if (policy.shed_tick_hz > 0 &&
+        (policy.tick_hz == 0 || policy.shed_tick_hz < policy.tick_hz)) {
+      steps_.push_back({session_class, ShedStep::Action::ReduceRate});
+    }
+    if (policy.droppable) {
+      steps_.push_back({session_class, ShedStep::Action::Drop});
+    }
+  }
+}
+
+auto LoadShedder::update(std::chrono::microseconds loop_lag) -> std::size_t {
+  if (loop_lag > config_.shed_lag) {
+    recovered_samples_ = 0;
+    ++overloaded_samples_;
+  } else if (loop_lag < config_.recover_lag) {
+    overloaded_samples_ = 0;
+    ++recovered_samples_;
+  } else {
+    overloaded_samples_ = 0;
+    recovered_samples_ = 0;
+  }
+
+  if (overloaded_samples_ >= config_.shed_samples &&
+      level_ < steps_.size()) {
+    setLevel(level_ + 1);
+  } else if (recovered_samples_ >= config_.recover_samples && level_ > 0) {
+    setLevel(level_ - 1);
+  }
+  return level_;
+}
+
+void LoadShedder::setLevel(std::size_t level) {
+  level_ = std::min(level, steps_.size());
+  overloaded_samples_ = 0;
+  recovered_samples_ = 0;
+}
+
+auto LoadShedder::getDelivery(std::size_t level) const
+    -> std::array<ClassDelivery, kSessionClassCount> {
+  std::array<ClassDelivery, kSessionClassCount> delivery;
+  std::array<int, kSessionClassCount> rates{};
+  for (std::size_t i = 0; i < kSessionClassCount; ++i) {
+    rates[i] = config_.classes[i].tick_hz;
+    delivery[i].queue_limit = config_.classes[i].queue_limit;
+  }
+  for (std::size_t i = 0; i < std::min(level, steps_.size()); ++i) {
+    const auto index = static_cast<std::size_t>(steps_[i].session_class);
+    if (steps_[i].action == ShedStep::Action::Drop) {
+      delivery[index].dropped = true;
+    } else {
+      rates[index] = config_.classes[index].shed_tick_hz;
+    }
+  }
+  for (std::size_t i = 0; i < kSessionClassCount; ++i) {
+    delivery[i].min_interval = intervalFor(rates[i]);
+  }
+  return delivery;
+}
+
+}  // namespace picoradar::core
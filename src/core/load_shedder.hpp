@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+#include "client.pb.h"
+
+namespace picoradar::core {
+
+constexpr std::size_t kSessionClassCount = 3;
+
+/// 会话类别在配置与日志中的名称：player、spectator、operator
+auto sessionClassName(picoradar::SessionClass session_class) -> const char*;
+
+/**
+ * @brief 某一类会话的发送策略 (network.session_classes.<类别>.*)
+ */
+struct SessionClassPolicy {
+  /// 每秒最多发送的玩家列表帧数，0 表示每次广播都发送
+  int tick_hz = 0;
+  /// 降载时的帧率；0 表示降载阶梯中没有降低该类帧率这一步
+  int shed_tick_hz = 0;
+  /// 尚未写出的帧超过该数量时丢弃新的玩家列表帧，0 表示不限
+  std::size_t queue_limit = 0;
+  /// 降载阶梯中是否包含完全停止向该类发送玩家列表这一步
+  bool droppable = false;
+};
+
+/**
+ * @brief 分级降载参数 (network.session_classes.*, network.shedding.*)
+ *
+ * 默认配置下头显玩家不受任何降载影响。
+ */
+struct LoadShedderConfig {
+  std::array<SessionClassPolicy, kSessionClassCount> classes{{
+      {0, 0, 0, false},  // player
+      {30, 5, 4, true},  // spectator
+      {10, 2, 8, false},  // operator
+  }};
+  /// 事件循环延迟超过该值视为过载
+  std::chrono::microseconds shed_lag{20000};
+  /// 事件循环延迟低于该值才视为恢复
+  std::chrono::microseconds recover_lag{5000};
+  /// 连续多少个过载采样后加重一级
+  std::size_t shed_samples = 2;
+  /// 连续多少个恢复采样后减轻一级，远大于 shed_samples 以免来回切换
+  std::size_t recover_samples = 20;
+};
+
+/**
+ * @brief 降载阶梯中的一步
+ */
+struct ShedStep {
+  enum class Action { ReduceRate, Drop };
+  picoradar::SessionClass session_class = picoradar::SESSION_CLASS_PLAYER;
+  Action action = Action::ReduceRate;
+};
+
+/**
+ * @brief 某一类会话在当前降载级别下的发送方式
+ */
+struct ClassDelivery {
+  bool dropped = false;
+  /// 相邻两帧的最小间隔，0 表示不限
+  std::chrono::microseconds min_interval{0};
+  std::size_t queue_limit = 0;
+};
+
+/**
+ * @brief 按会话类别分级降载
+ *
+ * 降载阶梯按 spectator、operator、player 的顺序排列，每一类先降低帧率
+ * (shed_tick_hz) 再停止发送 (droppable)，没有配置的步骤被跳过；因此
+ * 只有旁观屏幕与运营端的降载用尽之后才会影响头显玩家。事件循环延迟
+ * 连续过载时每次加重一级，连续恢复时每次减轻一级。
+ * 此类不是线程安全的，由调用方负责同步。
+ */
+class LoadShedder {
+ public:
+  explicit LoadShedder(LoadShedderConfig config = {});
+
+  /**
+   * @brief 输入一次事件循环延迟采样
+   * @return 更新后的降载级别，0 表示未降载
+   */
+  auto update(std::chrono::microseconds loop_lag) -> std::size_t;
+
+  /// 直接设置降载级别（截断到阶梯长度），并清除累计的采样
+  void setLevel(std::size_t level);
+
+  [[nodiscard]] auto getLevel() const -> std::size_t { return level_; }
+  [[nodiscard]] auto getSteps() const -> const std::vector<ShedStep>& {
+    return steps_;
+  }
+  [[nodiscard]] auto getConfig() const -> const LoadShedderConfig& {
+    return config_;
+  }
+
+  /// 给定降载级别下各类会话的发送方式，按 SessionClass 的值索引
+  [[nodiscard]] auto getDelivery(std::size_t level) const
+      -> std::array<ClassDelivery, kSessionClassCount>;
+
+ private:
+  LoadShedderConfig config_;
+  std::vector<ShedStep> steps_;
+  std::size_t level_ = 0;
+  std::size_t overloaded_samples_ = 0;
+  std::size_t recovered_samples_ = 0;
+};
+
+}  // namespace picoradar::core
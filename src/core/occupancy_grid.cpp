@@ -0,0 +1,141 @@
+#include "occupancy_grid.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace picoradar::core {
+
+OccupancyGrid::OccupancyGrid() : OccupancyGrid(OccupancyGridConfig{}) {}
+
+OccupancyGrid::OccupancyGrid(OccupancyGridConfig config) : config_(config) {
+  if (!(config_.cell_size > 0.0F)) {
+    config_.cell_size = OccupancyGridConfig{}.cell_size;
+  }
+  config_.width = std::max<std::uint32_t>(config_.width, 1);
+  config_.height = std::max<std::uint32_t>(config_.height, 1);
+
+  origin_x_ = -static_cast<float>(config_.width) * config_.cell_size / 2.0F;
+  origin_z_ = -static_cast<float>(config_.height) * config_.cell_size / 2.0F;
+}
+
+void OccupancyGrid::update(const picoradar::PlayerData& player) {
+  // 鉴权时写入的占位数据没有场景、位于原点，不是真实位姿
+  if (player.scene_id().empty() || !player.has_position()) {
+    remove(player.player_id());
+    return;
+  }
+  const auto cell = cellIndex(player.position());
+
+  std::lock_guard lock(mutex_);
+  auto it = placements_.find(player.player_id());
+  if (it != placements_.end()) {
+    if (it->second.scene_id == player.scene_id() && it->second.cell == cell) {
+      return;  // 仍在同一单元内
+    }
+    subtract(it->second);
+    it->second.scene_id = player.scene_id();
+    it->second.cell = cell;
+  } else {
+    placements_.emplace(player.player_id(),
+                        Placement{player.scene_id(), cell});
+  }
+  add(player.scene_id(), cell);
+}
+
+void OccupancyGrid::remove(const std::string& player_id) {
+  std::lock_guard lock(mutex_);
+  auto it = placements_.find(player_id);
+  if (it == placements_.end()) {
+    return;
+  }
+  subtract(it->second);
+  placements_.erase(it);
+}
+
+auto OccupancyGrid::snapshot(const std::string& scene_id,
+                             picoradar::HeatmapFrame* out) const -> bool {
+  std::lock_guard lock(mutex_);
+  auto it = scenes_.find(scene_id);
+  if (it == scenes_.end()) {
+    return false;
+  }
+  fillFrame(it->first, it->second, out);
+  return true;
+}
+
+auto OccupancyGrid::snapshotAll() const
+    -> std::vector<picoradar::HeatmapFrame> {
+  std::lock_guard lock(mutex_);
+  std::vector<picoradar::HeatmapFrame> frames(scenes_.size());
+  std::size_t i = 0;
+  for (const auto& [scene_id, grid] : scenes_) {
+    fillFrame(scene_id, grid, &frames[i++]);
+  }
+  return frames;
+}
+
+auto OccupancyGrid::getPlayerCount() const -> std::size_t {
+  std::lock_guard lock(mutex_);
+  return placements_.size();
+}
+
+auto OccupancyGrid::cellIndex(const picoradar::Vector3& position) const
+    -> std::int64_t {
+  const float fx = std::floor((position.x() - origin_x_) / config_.cell_size);
+  const float fz = std::floor((position.z() - origin_z_) / config_.cell_size);
+  // NaN 与超出范围的坐标都不满足以下条件
+  if (!(fx >= 0.0F && fx < static_cast<float>(config_.width) && fz >= 0.0F &&
+        fz < static_cast<float>(config_.height))) {
+    return kOutside;
+  }
+  return static_cast<std::int64_t>(fz) * config_.width +
+         static_cast<std::int64_t>(fx);
+}
+
+void OccupancyGrid::add(const std::string& scene_id, std::int64_t cell) {
+  auto& grid = scenes_[scene_id];
+  if (grid.cells.empty()) {
+    grid.cells.assign(
+        static_cast<std::size_t>(config_.width) * config_.height, 0);
+  }
+  ++grid.total;
+  if (cell != kOutside) {
+    ++grid.cells[static_cast<std::size_t>(cell)];
+  }
+}
+
+void OccupancyGrid::subtract(const Placement& placement) {
+  auto it = scenes_.find(placement.scene_id);
+  if (it == scenes_.end()) {
+    return;
+  }
+  auto& grid = it->second;
+  if (placement.cell != kOutside) {
+    --grid.cells[static_cast<std::size_t>(placement.cell)];
+  }
+  if (--grid.total == 0) {
+    scenes_.erase(it);  // 空场景不再广播
+  }
+}
+
+void OccupancyGrid::fillFrame(const std::string& scene_id,
+                              const SceneGrid& grid,
+                              picoradar::HeatmapFrame* out) const {
+  out->set_scene_id(scene_id);
+  out->set_origin_x(origin_x_);
+  out->set_origin_z(origin_z_);
+  out->set_cell_size(config_.cell_size);
+  out->set_width(config_.width);
+  out->set_height(config_.height);
+  out->set_total_players(grid.total);
+
+  auto* counts = out->mutable_counts();
+  counts->resize(grid.cells.size());
+  for (std::size_t i = 0; i < grid.cells.size(); ++i) {
+    (*counts)[i] = static_cast<char>(std::min<std::uint32_t>(
+        grid.cells[i], std::numeric_limits<std::uint8_t>::max()));
+  }
+}
+
+}  // namespace picoradar::core
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "player.pb.h"
+#include "server.pb.h"
+
+namespace picoradar::core {
+
+/**
+ * @brief 占用网格配置 (network.heatmap.*)
+ *
+ * 网格以世界原点为中心，覆盖水平面 (x, z) 上
+ * width * cell_size 乘 height * cell_size 的区域。
+ */
+struct OccupancyGridConfig {
+  float cell_size = 1.0F;     ///< 单元边长（米）
+  std::uint32_t width = 64;   ///< x 方向单元数
+  std::uint32_t height = 64;  ///< z 方向单元数
+};
+
+/**
+ * @brief 按场景维护的二维玩家占用网格
+ *
+ * 每次位置更新只调整玩家新旧两个单元的计数，
+ * 因此生成热力图帧的开销只与网格大小有关，与玩家数量无关。
+ * 此类是线程安全的。
+ */
+class OccupancyGrid {
+ public:
+  OccupancyGrid();
+  explicit OccupancyGrid(OccupancyGridConfig config);
+
+  // 禁止拷贝和赋值
+  OccupancyGrid(const OccupancyGrid&) = delete;
+  auto operator=(const OccupancyGrid&) -> OccupancyGrid& = delete;
+
+  /**
+   * @brief 根据玩家的最新位置更新网格
+   *
+   * 没有场景或没有位置的数据（例如鉴权时的占位数据）不计入网格。
+   */
+  void update(const picoradar::PlayerData& player);
+
+  /**
+   * @brief 将玩家从网格中移除
+   */
+  void remove(const std::string& player_id);
+
+  /**
+   * @brief 生成指定场景的热力图帧
+   *
+   * @return 场景中没有玩家时返回 false
+   */
+  auto snapshot(const std::string& scene_id,
+                picoradar::HeatmapFrame* out) const -> bool;
+
+  /**
+   * @brief 生成所有非空场景的热力图帧
+   */
+  auto snapshotAll() const -> std::vector<picoradar::HeatmapFrame>;
+
+  /**
+   * @brief 获取网格中的玩家数量
+   */
+  auto getPlayerCount() const -> std::size_t;
+
+  [[nodiscard]] auto getConfig() const -> const OccupancyGridConfig& {
+    return config_;
+  }
+
+ private:
+  /// @brief 网格范围外的单元索引
+  static constexpr std::int64_t kOutside = -1;
+
+  struct SceneGrid {
+    std::vector<std::uint32_t> cells;
+    std::uint32_t total = 0;
+  };
+
+  struct Placement {
+    std::string scene_id;
+    std::int64_t cell = kOutside;
+  };
+
+  auto cellIndex(const picoradar::Vector3& position) const -> std::int64_t;
+  void add(const std::string& scene_id, std::int64_t cell);
+  void subtract(const Placement& placement);
+  void fillFrame(const std::string& scene_id, const SceneGrid& grid,
+                 picoradar::HeatmapFrame* out) const;
+
+  OccupancyGridConfig config_;
+  float origin_x_;
+  float origin_z_;
+
+  std::unordered_map<std::string, SceneGrid> scenes_;
+  std::unordered_map<std::string, Placement> placements_;
+  mutable std::mutex mutex_;
+};
+
+}  // namespace picoradar::core
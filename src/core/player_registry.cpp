@@ -1,22 +1,59 @@
 #include "player_registry.hpp"
 
+#include <algorithm>
+
+#include "common/constants.hpp"
+#include "core/wire_format.hpp"
+#include "server.pb.h"
+
 namespace picoradar::core {
 
 using namespace picoradar::core;
 
-PlayerRegistry::PlayerRegistry() = default;
+PlayerRegistry::PlayerRegistry()
+    : PlayerRegistry(constants::kDefaultJournalCapacity) {}
+
+PlayerRegistry::PlayerRegistry(std::size_t journal_capacity)
+    : journal_(journal_capacity) {}
 
 PlayerRegistry::~PlayerRegistry() = default;
 
 void PlayerRegistry::updatePlayer(std::string playerId,
                                   picoradar::PlayerData data) {
+  // 在锁外序列化，每次更新只编码一次
+  std::string encoded = data.SerializeAsString();
+  updatePlayer(std::move(playerId), std::move(data), std::move(encoded));
+}
+
+void PlayerRegistry::updatePlayer(std::string playerId,
+                                  picoradar::PlayerData data,
+                                  std::string encoded) {
   std::lock_guard lock(mutex_);
+  ++version_;
+  if (!observers_.empty()) {
+    markUpdatedLocked(playerId);
+  }
+  auto shared = std::make_shared<const std::string>(std::move(encoded));
+  if (!journal_.empty()) {
+    appendJournalLocked(ChangeKind::Updated, playerId).encoded = shared;
+  }
+  encoded_[playerId] = std::move(shared);
   players_[std::move(playerId)] = std::move(data);
 }
 
 void PlayerRegistry::removePlayer(std::string playerId) {
   std::lock_guard lock(mutex_);
-  players_.erase(playerId);
+  if (players_.erase(playerId) == 0) {
+    return;
+  }
+  encoded_.erase(playerId);
+  ++version_;
+  if (!observers_.empty()) {
+    markRemovedLocked(playerId);
+  }
+  if (!journal_.empty()) {
+    appendJournalLocked(ChangeKind::Removed, playerId).encoded.reset();
+  }
 }
 
 auto PlayerRegistry::getAllPlayers() const
@@ -40,4 +77,139 @@ auto PlayerRegistry::getPlayerCount() const -> size_t {
   return players_.size();
 }
 
+auto PlayerRegistry::getSnapshot() const -> Snapshot {
+  std::lock_guard lock(mutex_);
+  return getSnapshotLocked();
+}
+
+auto PlayerRegistry::getSnapshotLocked() const -> Snapshot {
+  if (!snapshot_ || snapshot_version_ != version_) {
+    snapshot_ = std::make_shared<const PlayerMap>(players_);
+    snapshot_version_ = version_;
+  }
+  return snapshot_;
+}
+
+auto PlayerRegistry::getEncodedSnapshot() const -> EncodedSnapshot {
+  std::lock_guard lock(mutex_);
+  return {getSnapshotLocked(), getRosterLocked()};
+}
+
+auto PlayerRegistry::getRosterLocked() const
+    -> std::shared_ptr<const std::string> {
+  if (roster_ && roster_version_ == version_) {
+    return roster_;
+  }
+
+  constexpr auto kField = picoradar::PlayerList::kPlayersFieldNumber;
+  std::size_t size = 0;
+  for (const auto& [id, bytes] : encoded_) {
+    size += wire::lengthDelimitedSize(kField, bytes->size());
+  }
+  auto roster = std::make_shared<std::string>();
+  roster->reserve(size);
+  for (const auto& [id, bytes] : encoded_) {
+    wire::appendLengthDelimited(*roster, kField, *bytes);
+  }
+  roster_ = std::move(roster);
+  roster_version_ = version_;
+  return roster_;
+}
+
+auto PlayerRegistry::addObserver(ChangeObserver observer) -> ObserverId {
+  std::lock_guard lock(mutex_);
+  const auto id = next_observer_id_++;
+  observers_.emplace(
+      id, std::make_shared<const ChangeObserver>(std::move(observer)));
+  return id;
+}
+
+void PlayerRegistry::removeObserver(ObserverId id) {
+  std::lock_guard lock(mutex_);
+  observers_.erase(id);
+  if (observers_.empty()) {
+    pending_updated_.clear();
+    pending_removed_.clear();
+  }
+}
+
+auto PlayerRegistry::publishChanges() -> bool {
+  ChangeSet changes;
+  std::vector<std::shared_ptr<const ChangeObserver>> observers;
+  {
+    std::lock_guard lock(mutex_);
+    if (pending_updated_.empty() && pending_removed_.empty()) {
+      return false;
+    }
+    changes.snapshot = getSnapshotLocked();
+    changes.updated.assign(pending_updated_.begin(), pending_updated_.end());
+    changes.removed.assign(pending_removed_.begin(), pending_removed_.end());
+    pending_updated_.clear();
+    pending_removed_.clear();
+
+    observers.reserve(observers_.size());
+    for (const auto& [id, observer] : observers_) {
+      observers.push_back(observer);
+    }
+  }
+
+  for (const auto& observer : observers) {
+    (*observer)(changes);
+  }
+  return true;
+}
+
+auto PlayerRegistry::getVersion() const -> std::uint64_t {
+  std::lock_guard lock(mutex_);
+  return version_;
+}
+
+auto PlayerRegistry::readJournal(std::uint64_t since,
+                                 std::size_t max_records) const
+    -> JournalRead {
+  JournalRead result;
+  std::lock_guard lock(mutex_);
+
+  // 日志中仍保留的最早版本；游标落后于它（或超前于当前版本）时需要重新同步
+  const std::uint64_t retained =
+      std::min<std::uint64_t>(version_, journal_.size());
+  const std::uint64_t oldest = version_ - retained + 1;
+  if (since + 1 < oldest || since > version_) {
+    result.overflowed = true;
+    result.snapshot = getSnapshotLocked();
+    result.next_version = version_;
+    return result;
+  }
+
+  const auto count = static_cast<std::size_t>(std::min<std::uint64_t>(
+      version_ - since, max_records));
+  result.records.reserve(count);
+  for (std::uint64_t v = since + 1; v <= since + count; ++v) {
+    result.records.push_back(journal_[v % journal_.size()]);
+  }
+  result.next_version = since + count;
+  return result;
+}
+
+auto PlayerRegistry::appendJournalLocked(ChangeKind kind,
+                                         const std::string& playerId)
+    -> ChangeRecord& {
+  // 复用被覆盖槽位中 player_id 的内存
+  auto& record = journal_[version_ % journal_.size()];
+  record.version = version_;
+  record.kind = kind;
+  record.player_id = playerId;
+  return record;
+}
+
+void PlayerRegistry::markUpdatedLocked(const std::string& playerId) {
+  pending_removed_.erase(playerId);
+  pending_updated_.insert(playerId);
+}
+
+void PlayerRegistry::markRemovedLocked(const std::string& playerId) {
+  pending_updated_.erase(playerId);
+  pending_removed_.insert(playerId);
+}
+
 }  // namespace picoradar::core
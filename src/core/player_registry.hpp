@@ -1,9 +1,14 @@
 #pragma once
 
+#include <cstdint>
+#include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "player.pb.h"  // Protobuf 生成的代码
 
@@ -11,7 +16,72 @@ namespace picoradar::core {
 
 class PlayerRegistry {
  public:
+  using PlayerMap = std::unordered_map<std::string, picoradar::PlayerData>;
+
+  /// 只读快照，注册表变化前的所有读者共享同一份
+  using Snapshot = std::shared_ptr<const PlayerMap>;
+
+  /**
+   * @brief 同一版本的快照及其 PlayerList.players 的线格式编码。
+   *
+   * roster 是每个玩家 "tag + 长度 + PlayerData 字节" 记录的拼接，
+   * 直接作为 PlayerList 消息体即可，无需重新序列化任何玩家。
+   */
+  struct EncodedSnapshot {
+    Snapshot players;
+    std::shared_ptr<const std::string> roster;
+  };
+
+  /**
+   * @brief 自上次发布以来的一批变更。
+   *
+   * updated 中玩家的最新数据可在 snapshot 中查到；同一批次内先更新后移除的
+   * 玩家只出现在 removed 中。
+   */
+  struct ChangeSet {
+    Snapshot snapshot;
+    std::vector<std::string> updated;
+    std::vector<std::string> removed;
+  };
+
+  using ChangeObserver = std::function<void(const ChangeSet&)>;
+  using ObserverId = std::uint64_t;
+
+  enum class ChangeKind : std::uint8_t { Updated, Removed };
+
+  /**
+   * @brief 变更日志中的一条记录；version 与 getVersion() 使用同一计数。
+   *
+   * encoded 是该版本 PlayerData 的线格式字节，与注册表共享同一份缓冲区，
+   * 追加记录时不复制玩家数据；仅 Updated 记录有效。
+   */
+  struct ChangeRecord {
+    std::uint64_t version = 0;
+    ChangeKind kind = ChangeKind::Updated;
+    std::string player_id;
+    std::shared_ptr<const std::string> encoded;
+  };
+
+  /**
+   * @brief readJournal() 的结果。
+   *
+   * 消费者把 next_version 作为下次读取的游标。overflowed 为 true 时，
+   * 游标之后的部分记录已被覆盖，records 为空，应改用 snapshot
+   * （即 next_version 时的完整状态）重新同步。
+   */
+  struct JournalRead {
+    std::vector<ChangeRecord> records;
+    std::uint64_t next_version = 0;
+    bool overflowed = false;
+    Snapshot snapshot;
+  };
+
   PlayerRegistry();
+
+  /**
+   * @param journal_capacity 变更日志环形缓冲区的容量，为 0 时不记录日志
+   */
+  explicit PlayerRegistry(std::size_t journal_capacity);
   ~PlayerRegistry();
 
   // 禁止拷贝和赋值
@@ -28,6 +98,15 @@ class PlayerRegistry {
    */
   void updatePlayer(std::string playerId, picoradar::PlayerData data);
 
+  /**
+   * @brief 添加或更新玩家，并保存调用方已有的编码。
+   *
+   * encoded 必须是 data 的 PlayerData 线格式字节（例如从已成功解析的
+   * 客户端消息中原样取出），注册表不再序列化该玩家。
+   */
+  void updatePlayer(std::string playerId, picoradar::PlayerData data,
+                    std::string encoded);
+
   /**
    * @brief 移除一个玩家。
    *
@@ -57,12 +136,86 @@ class PlayerRegistry {
    */
   auto getPlayerCount() const -> size_t;
 
+  /**
+   * @brief 获取所有玩家的只读快照。
+   *
+   * 注册表未变化时重复调用返回同一份快照，不再复制玩家数据。
+   */
+  auto getSnapshot() const -> Snapshot;
+
+  /**
+   * @brief 获取快照及拼接好的玩家列表编码。
+   *
+   * 编码按版本缓存；重新生成时只拷贝每个玩家保存的字节。
+   */
+  auto getEncodedSnapshot() const -> EncodedSnapshot;
+
+  /**
+   * @brief 注册变更观察者。
+   *
+   * 注册后注册表开始记录变更，由 publishChanges() 批量通知。
+   * @return 用于 removeObserver() 的 ID
+   */
+  auto addObserver(ChangeObserver observer) -> ObserverId;
+
+  void removeObserver(ObserverId id);
+
+  /**
+   * @brief 将累积的变更作为一个批次通知所有观察者。
+   *
+   * 回调在调用线程上执行且不持有注册表的锁，可以在回调中读取注册表。
+   * @return 有待发布的变更时返回 true
+   */
+  auto publishChanges() -> bool;
+
+  /// 当前版本号，每次 updatePlayer 或成功的 removePlayer 递增 1
+  auto getVersion() const -> std::uint64_t;
+
+  /**
+   * @brief 读取 since 之后的变更记录，最多 max_records 条。
+   *
+   * 游标由消费者各自保存，互不影响；新消费者可以从 0 开始读取，
+   * 若最早的记录已被覆盖则会得到一次快照重新同步。
+   */
+  auto readJournal(std::uint64_t since,
+                   std::size_t max_records = SIZE_MAX) const -> JournalRead;
+
+  auto getJournalCapacity() const -> std::size_t { return journal_.size(); }
+
  private:
+  auto getSnapshotLocked() const -> Snapshot;
+  auto getRosterLocked() const -> std::shared_ptr<const std::string>;
+  void markUpdatedLocked(const std::string& playerId);
+  void markRemovedLocked(const std::string& playerId);
+  auto appendJournalLocked(ChangeKind kind, const std::string& playerId)
+      -> ChangeRecord&;
+
   // 使用unordered_map以获得O(1)的平均查找效率
-  std::unordered_map<std::string, picoradar::PlayerData> players_;
+  PlayerMap players_;
+  // 每个玩家的 PlayerData 线格式字节，与 players_ 同步更新；
+  // 变更日志共享同一份缓冲区
+  std::unordered_map<std::string, std::shared_ptr<const std::string>>
+      encoded_;
 
   // 使用mutable的mutex以允许在const成员函数中锁定
   mutable std::mutex mutex_;
+
+  // players_ 每次变化递增；快照按版本缓存
+  std::uint64_t version_ = 0;
+  mutable Snapshot snapshot_;
+  mutable std::uint64_t snapshot_version_ = 0;
+  mutable std::shared_ptr<const std::string> roster_;
+  mutable std::uint64_t roster_version_ = 0;
+
+  // 仅在存在观察者时记录变更
+  std::map<ObserverId, std::shared_ptr<const ChangeObserver>> observers_;
+  ObserverId next_observer_id_ = 1;
+  std::unordered_set<std::string> pending_updated_;
+  std::unordered_set<std::string> pending_removed_;
+
+  // 变更日志：版本为 v 的记录位于 journal_[v % capacity]，
+  // 保存 (version_ - capacity, version_] 范围内的记录
+  std::vector<ChangeRecord> journal_;
 };
 
 }  // namespace picoradar::core
@@ -0,0 +1,490 @@
+#include "pose_analytics.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <numeric>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+namespace picoradar::core {
+
+/// @brief 单个数据块的局部结果，其中的玩家与场景是所属归档字典的下标
+struct PoseAnalyzer::BlockResult {
+  /// 一名玩家在块内的连续采样
+  struct Track {
+    std::uint32_t player = 0;
+    std::uint64_t samples = 0;
+    double distance_m = 0.0;
+    std::vector<std::pair<std::uint32_t, std::int64_t>> dwell_ms;
+    std::int64_t first_ms = 0;
+    std::int64_t last_ms = 0;
+    std::uint32_t first_scene = 0;
+    std::uint32_t last_scene = 0;
+    float first_x = 0.0F;
+    float first_z = 0.0F;
+    float last_x = 0.0F;
+    float last_z = 0.0F;
+  };
+
+  /// 某一帧中距离不超过 clear_distance 的玩家对
+  struct ClosePair {
+    std::uint32_t frame;
+    std::uint32_t first;
+    std::uint32_t second;
+    float distance;
+  };
+
+  std::uint64_t samples = 0;
+  std::vector<Track> tracks;
+  std::vector<std::int64_t> frames;  ///< 各帧时间，升序
+  std::vector<ClosePair> pairs;      ///< 按帧排序
+};
+
+namespace {
+
+auto sanitize(PoseAnalyticsConfig config) -> PoseAnalyticsConfig {
+  if (!(config.heatmap.cell_size > 0.0F)) {
+    config.heatmap.cell_size = OccupancyGridConfig{}.cell_size;
+  }
+  config.heatmap.width = std::max<std::uint32_t>(config.heatmap.width, 1);
+  config.heatmap.height = std::max<std::uint32_t>(config.heatmap.height, 1);
+  if (!(config.near_miss.alert_distance > 0.0F)) {
+    config.near_miss.alert_distance = ProximityConfig{}.alert_distance;
+  }
+  config.near_miss.clear_distance = std::max(config.near_miss.clear_distance,
+                                             config.near_miss.alert_distance);
+  config.max_gap = std::max(config.max_gap, std::chrono::milliseconds(0));
+  return config;
+}
+
+void addDwell(std::vector<std::pair<std::uint32_t, std::int64_t>>& dwell,
+              std::uint32_t scene, std::int64_t elapsed_ms) {
+  for (auto& [id, total] : dwell) {
+    if (id == scene) {
+      total += elapsed_ms;
+      return;
+    }
+  }
+  dwell.emplace_back(scene, elapsed_ms);
+}
+
+}  // namespace
+
+PoseAnalyzer::PoseAnalyzer(PoseAnalyticsConfig config)
+    : config_(sanitize(config)) {
+  origin_x_ = -static_cast<float>(config_.heatmap.width) *
+              config_.heatmap.cell_size / 2.0F;
+  origin_z_ = -static_cast<float>(config_.heatmap.height) *
+              config_.heatmap.cell_size / 2.0F;
+}
+
+auto PoseAnalyzer::cellIndex(float x, float z) const -> std::int64_t {
+  const float fx = std::floor((x - origin_x_) / config_.heatmap.cell_size);
+  const float fz = std::floor((z - origin_z_) / config_.heatmap.cell_size);
+  if (!(fx >= 0.0F && fx < static_cast<float>(config_.heatmap.width) &&
+        fz >= 0.0F && fz < static_cast<float>(config_.heatmap.height))) {
+    return -1;
+  }
+  return static_cast<std::int64_t>(fz) * config_.heatmap.width +
+         static_cast<std::int64_t>(fx);
+}
+
+void PoseAnalyzer::analyzeBlock(
+    const Task& task, BlockResult& result,
+    std::map<std::string, SceneHeatmap>& heatmaps) const {
+  PoseColumns columns;
+  task.archive->readBlock(task.block, columns);
+  const auto& info = task.archive->getBlocks()[task.block];
+  if (info.first_ms < config_.from_ms || info.last_ms > config_.to_ms) {
+    columns.retainRange(config_.from_ms, config_.to_ms);
+  }
+  const std::size_t rows = columns.size();
+  result.samples = rows;
+  if (rows == 0) {
+    return;
+  }
+
+  const auto& timestamps = columns.timestamp_ms;
+  const auto& players = columns.player;
+  const auto& scenes = columns.scene;
+  const auto& xs = columns.position[0];
+  const auto& ys = columns.position[1];
+  const auto& zs = columns.position[2];
+  const auto& scene_ids = task.archive->getSceneIds();
+
+  // 相邻两行之间的水平步长与时间间隔。跨玩家、跨场景或断线处记为 0，
+  // 循环体无分支且按列连续访问，便于编译器向量化
+  const auto max_gap = config_.max_gap.count();
+  std::vector<float> steps(rows, 0.0F);
+  std::vector<std::int64_t> elapsed(rows, 0);
+  for (std::size_t i = 1; i < rows; ++i) {
+    const float dx = xs[i] - xs[i - 1];
+    const float dz = zs[i] - zs[i - 1];
+    const float step = std::sqrt(dx * dx + dz * dz);
+    const std::int64_t dt = timestamps[i] - timestamps[i - 1];
+    const bool linked = players[i] == players[i - 1] &&
+                        scenes[i] == scenes[i - 1] && dt <= max_gap;
+    steps[i] = linked && std::isfinite(step) ? step : 0.0F;
+    elapsed[i] = linked ? dt : 0;
+  }
+
+  // 行按玩家分组，每组汇总为一条轨迹
+  for (std::size_t begin = 0; begin < rows;) {
+    std::size_t end = begin + 1;
+    while (end < rows && players[end] == players[begin]) {
+      ++end;
+    }
+
+    BlockResult::Track track;
+    track.player = players[begin];
+    track.samples = end - begin;
+    track.distance_m = std::accumulate(steps.begin() + begin + 1,
+                                       steps.begin() + end, 0.0);
+    for (std::size_t i = begin + 1; i < end; ++i) {
+      if (elapsed[i] > 0) {
+        addDwell(track.dwell_ms, scenes[i], elapsed[i]);
+      }
+    }
+    track.first_ms = timestamps[begin];
+    track.first_scene = scenes[begin];
+    track.first_x = xs[begin];
+    track.first_z = zs[begin];
+    track.last_ms = timestamps[end - 1];
+    track.last_scene = scenes[end - 1];
+    track.last_x = xs[end - 1];
+    track.last_z = zs[end - 1];
+    result.tracks.push_back(std::move(track));
+    begin = end;
+  }
+
+  // 热力图只与采样计数有关，各线程独立累加
+  std::vector<SceneHeatmap*> scene_heatmaps(scene_ids.size(), nullptr);
+  for (std::size_t i = 0; i < rows; ++i) {
+    auto*& heatmap = scene_heatmaps.at(scenes[i]);
+    if (heatmap == nullptr) {
+      heatmap = &heatmaps[scene_ids[scenes[i]]];
+      if (heatmap->cells.empty()) {
+        heatmap->scene_id = scene_ids[scenes[i]];
+        heatmap->cells.assign(static_cast<std::size_t>(config_.heatmap.width) *
+                                  config_.heatmap.height,
+                              0);
+      }
+    }
+    const auto cell = cellIndex(xs[i], zs[i]);
+    if (cell < 0) {
+      ++heatmap->outside;
+    } else {
+      ++heatmap->cells[static_cast<std::size_t>(cell)];
+    }
+  }
+
+  // 按时间重排成帧。每帧的行按 (场景, x) 排序后扫描，只比较 x 方向
+  // 相距不超过 clear_distance 的行；批量处理时比逐帧重建空间哈希省去
+  // 大量的分配与查找
+  std::vector<std::size_t> order(rows);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&timestamps](std::size_t a, std::size_t b) {
+                     return timestamps[a] < timestamps[b];
+                   });
+
+  const float clear_distance = config_.near_miss.clear_distance;
+  std::vector<std::size_t> frame_rows;
+  for (std::size_t begin = 0; begin < rows;) {
+    const auto timestamp = timestamps[order[begin]];
+    std::size_t end = begin + 1;
+    while (end < rows && timestamps[order[end]] == timestamp) {
+      ++end;
+    }
+
+    const auto frame = static_cast<std::uint32_t>(result.frames.size());
+    result.frames.push_back(timestamp);
+    frame_rows.clear();
+    for (std::size_t i = begin; i < end; ++i) {
+      const auto row = order[i];
+      if (std::isfinite(xs[row]) && std::isfinite(ys[row]) &&
+          std::isfinite(zs[row])) {
+        frame_rows.push_back(row);
+      }
+    }
+    std::sort(frame_rows.begin(), frame_rows.end(),
+              [&](std::size_t a, std::size_t b) {
+                return scenes[a] != scenes[b] ? scenes[a] < scenes[b]
+                                              : xs[a] < xs[b];
+              });
+
+    for (std::size_t i = 0; i < frame_rows.size(); ++i) {
+      const auto a = frame_rows[i];
+      for (std::size_t j = i + 1; j < frame_rows.size(); ++j) {
+        const auto b = frame_rows[j];
+        const float dx = xs[b] - xs[a];
+        if (scenes[b] != scenes[a] || dx > clear_distance) {
+          break;
+        }
+        const float dy = ys[b] - ys[a];
+        const float dz = zs[b] - zs[a];
+        const float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+        if (distance <= clear_distance) {
+          result.pairs.push_back(
+              BlockResult::ClosePair{frame, players[a], players[b], distance});
+        }
+      }
+    }
+    begin = end;
+  }
+}
+
+auto PoseAnalyzer::run(
+    const std::vector<const PoseArchiveReader*>& archives) const
+    -> PoseAnalyticsReport {
+  auto ordered = archives;
+  ordered.erase(std::remove(ordered.begin(), ordered.end(), nullptr),
+                ordered.end());
+  std::stable_sort(ordered.begin(), ordered.end(),
+                   [](const PoseArchiveReader* a, const PoseArchiveReader* b) {
+                     return a->getStartTime() < b->getStartTime();
+                   });
+
+  std::vector<Task> tasks;
+  for (const auto* archive : ordered) {
+    const auto [first, last] =
+        archive->findBlocks(config_.from_ms, config_.to_ms);
+    for (auto block = first; block < last; ++block) {
+      tasks.push_back(Task{archive, block});
+    }
+  }
+
+  // 并行阶段：线程从任务列表中依次领取数据块
+  std::size_t thread_count = config_.threads != 0
+                                 ? config_.threads
+                                 : std::thread::hardware_concurrency();
+  thread_count = std::max<std::size_t>(
+      std::min(thread_count, tasks.size()), 1);
+
+  std::vector<BlockResult> results(tasks.size());
+  std::vector<std::map<std::string, SceneHeatmap>> partial(thread_count);
+  std::vector<std::exception_ptr> errors(thread_count);
+  std::atomic<std::size_t> next{0};
+  auto worker = [&](std::size_t index) {
+    try {
+      for (auto task = next++; task < tasks.size(); task = next++) {
+        analyzeBlock(tasks[task], results[task], partial[index]);
+      }
+    } catch (...) {
+      errors[index] = std::current_exception();
+      next = tasks.size();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < thread_count; ++i) {
+    threads.emplace_back(worker, i);
+  }
+  worker(0);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  // 合并阶段：按时间顺序衔接跨块的轨迹与险情状态。各归档的字典下标
+  // 先映射为全局下标，合并循环中不再比较字符串
+  struct PlayerState {
+    std::uint64_t samples = 0;
+    double distance_m = 0.0;
+    std::vector<std::int64_t> dwell_ms;  // 按全局场景下标
+    std::uint64_t near_misses = 0;
+    bool has_last = false;
+    std::int64_t last_ms = 0;
+    std::uint32_t last_scene = 0;
+    float last_x = 0.0F;
+    float last_z = 0.0F;
+  };
+  struct PairStats {
+    std::uint64_t count = 0;
+    float min_distance = 0.0F;
+  };
+
+  std::vector<std::string> player_names;
+  std::vector<std::string> scene_names;
+  std::unordered_map<std::string, std::uint32_t> player_index;
+  std::unordered_map<std::string, std::uint32_t> scene_index;
+  auto globalIds = [](const std::vector<std::string>& ids,
+                      std::unordered_map<std::string, std::uint32_t>& index,
+                      std::vector<std::string>& names) {
+    std::vector<std::uint32_t> mapping;
+    mapping.reserve(ids.size());
+    for (const auto& id : ids) {
+      const auto [it, inserted] =
+          index.emplace(id, static_cast<std::uint32_t>(names.size()));
+      if (inserted) {
+        names.push_back(id);
+      }
+      mapping.push_back(it->second);
+    }
+    return mapping;
+  };
+
+  PoseAnalyticsReport report;
+  std::vector<PlayerState> states;
+  std::unordered_map<std::uint64_t, PairStats> near_misses;
+  std::vector<std::uint64_t> active;  // 升序
+  std::vector<std::uint64_t> still_active;
+  bool has_frame = false;
+  std::int64_t previous_frame_ms = 0;
+  const auto max_gap = config_.max_gap.count();
+
+  const PoseArchiveReader* current_archive = nullptr;
+  std::vector<std::uint32_t> players_of_archive;
+  std::vector<std::uint32_t> scenes_of_archive;
+  for (std::size_t task = 0; task < tasks.size(); ++task) {
+    const auto& result = results[task];
+    if (tasks[task].archive != current_archive) {
+      current_archive = tasks[task].archive;
+      players_of_archive = globalIds(current_archive->getPlayerIds(),
+                                     player_index, player_names);
+      scenes_of_archive = globalIds(current_archive->getSceneIds(),
+                                    scene_index, scene_names);
+      states.resize(player_names.size());
+    }
+    report.samples += result.samples;
+    ++report.blocks;
+
+    for (const auto& track : result.tracks) {
+      auto& state = states[players_of_archive.at(track.player)];
+      auto addDwellOf = [&state](std::uint32_t scene, std::int64_t ms) {
+        if (state.dwell_ms.size() <= scene) {
+          state.dwell_ms.resize(scene + 1, 0);
+        }
+        state.dwell_ms[scene] += ms;
+      };
+
+      const auto first_scene = scenes_of_archive.at(track.first_scene);
+      const auto gap = track.first_ms - state.last_ms;
+      if (state.has_last && state.last_scene == first_scene && gap >= 0 &&
+          gap <= max_gap) {
+        const float step = std::hypot(track.first_x - state.last_x,
+                                      track.first_z - state.last_z);
+        if (std::isfinite(step)) {
+          state.distance_m += step;
+        }
+        addDwellOf(first_scene, gap);
+      }
+
+      state.samples += track.samples;
+      state.distance_m += track.distance_m;
+      for (const auto& [scene, elapsed_ms] : track.dwell_ms) {
+        addDwellOf(scenes_of_archive.at(scene), elapsed_ms);
+      }
+      state.has_last = true;
+      state.last_ms = track.last_ms;
+      state.last_scene = scenes_of_archive.at(track.last_scene);
+      state.last_x = track.last_x;
+      state.last_z = track.last_z;
+    }
+
+    auto pair = result.pairs.begin();
+    for (std::size_t frame = 0; frame < result.frames.size(); ++frame) {
+      const auto timestamp = result.frames[frame];
+      if (!has_frame) {
+        report.start_ms = timestamp;
+      } else if (timestamp - previous_frame_ms > max_gap) {
+        active.clear();  // 采样中断，险情随之结束
+      }
+
+      // 与 ProximityDetector 相同的滞回判定
+      still_active.clear();
+      for (; pair != result.pairs.end() && pair->frame == frame; ++pair) {
+        const auto a = players_of_archive.at(pair->first);
+        const auto b = players_of_archive.at(pair->second);
+        const auto key = (static_cast<std::uint64_t>(std::min(a, b)) << 32) |
+                         std::max(a, b);
+        const bool was_active =
+            std::binary_search(active.begin(), active.end(), key);
+        if (pair->distance > config_.near_miss.alert_distance &&
+            !was_active) {
+          continue;
+        }
+
+        auto& stats = near_misses[key];
+        if (!was_active) {
+          if (stats.count == 0) {
+            stats.min_distance = pair->distance;
+          }
+          ++stats.count;
+          ++states[a].near_misses;
+          ++states[b].near_misses;
+        }
+        stats.min_distance = std::min(stats.min_distance, pair->distance);
+        still_active.push_back(key);
+      }
+      std::sort(still_active.begin(), still_active.end());
+      active.swap(still_active);
+
+      has_frame = true;
+      previous_frame_ms = timestamp;
+      report.end_ms = timestamp;
+    }
+  }
+
+  for (std::size_t i = 0; i < states.size(); ++i) {
+    auto& state = states[i];
+    PlayerActivity activity;
+    activity.player_id = player_names[i];
+    activity.samples = state.samples;
+    activity.distance_m = state.distance_m;
+    activity.near_misses = state.near_misses;
+    for (std::size_t scene = 0; scene < state.dwell_ms.size(); ++scene) {
+      if (state.dwell_ms[scene] > 0) {
+        activity.dwell_s[scene_names[scene]] =
+            static_cast<double>(state.dwell_ms[scene]) / 1000.0;
+      }
+    }
+    report.players.push_back(std::move(activity));
+  }
+  std::sort(report.players.begin(), report.players.end(),
+            [](const PlayerActivity& a, const PlayerActivity& b) {
+              return a.player_id < b.player_id;
+            });
+
+  for (const auto& [key, stats] : near_misses) {
+    const auto& a = player_names[key >> 32];
+    const auto& b = player_names[key & 0xFFFFFFFFU];
+    report.near_misses.push_back(NearMissPair{std::min(a, b), std::max(a, b),
+                                              stats.count,
+                                              stats.min_distance});
+  }
+  std::sort(report.near_misses.begin(), report.near_misses.end(),
+            [](const NearMissPair& a, const NearMissPair& b) {
+              return std::tie(a.first, a.second) < std::tie(b.first, b.second);
+            });
+
+  std::map<std::string, SceneHeatmap> heatmaps;
+  for (auto& heatmaps_of_thread : partial) {
+    for (auto& [scene_id, heatmap] : heatmaps_of_thread) {
+      auto& merged = heatmaps[scene_id];
+      if (merged.cells.empty()) {
+        merged = std::move(heatmap);
+        continue;
+      }
+      for (std::size_t i = 0; i < merged.cells.size(); ++i) {
+        merged.cells[i] += heatmap.cells[i];
+      }
+      merged.outside += heatmap.outside;
+    }
+  }
+  for (auto& [scene_id, heatmap] : heatmaps) {
+    report.heatmaps.push_back(std::move(heatmap));
+  }
+
+  return report;
+}
+
+}  // namespace picoradar::core
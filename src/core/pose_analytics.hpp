@@ -0,0 +1,114 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "core/occupancy_grid.hpp"
+#include "core/pose_archive.hpp"
+#include "core/proximity_detector.hpp"
+
+namespace picoradar::core {
+
+/**
+ * @brief 归档分析查询参数
+ */
+struct PoseAnalyticsConfig {
+  std::int64_t from_ms = std::numeric_limits<std::int64_t>::min();
+  std::int64_t to_ms = std::numeric_limits<std::int64_t>::max();
+  OccupancyGridConfig heatmap;  ///< 热力图网格，与实时热力图的划分一致
+  ProximityConfig near_miss;    ///< 险情判定距离，与实时近距离警报一致
+  /// 同一玩家相邻采样间隔超过此值视为断线，期间不计移动距离与停留时长
+  std::chrono::milliseconds max_gap{1000};
+  std::size_t threads = 0;  ///< 扫描线程数，0 表示按硬件并发数
+};
+
+/**
+ * @brief 单个玩家的统计结果
+ */
+struct PlayerActivity {
+  std::string player_id;
+  std::uint64_t samples = 0;
+  double distance_m = 0.0;  ///< 水平面 (x, z) 上累计移动距离
+  std::map<std::string, double> dwell_s;  ///< 停留时长大于 0 的场景（秒）
+  std::uint64_t near_misses = 0;          ///< 参与的险情次数
+};
+
+/**
+ * @brief 一对玩家的险情统计
+ *
+ * 一次险情指两人距离进入 alert_distance，直到超过 clear_distance、
+ * 任一方离开或采样中断为止。first 与 second 按字典序排列。
+ */
+struct NearMissPair {
+  std::string first;
+  std::string second;
+  std::uint64_t count = 0;
+  float min_distance = 0.0F;
+};
+
+/**
+ * @brief 单个场景的采样热力图
+ *
+ * cells 按行优先存放 height 行、width 列的采样数，
+ * 网格以世界原点为中心。
+ */
+struct SceneHeatmap {
+  std::string scene_id;
+  std::vector<std::uint64_t> cells;
+  std::uint64_t outside = 0;  ///< 落在网格范围外的采样数
+};
+
+struct PoseAnalyticsReport {
+  std::int64_t start_ms = 0;  ///< 范围内首个与最后一个采样的时间
+  std::int64_t end_ms = 0;
+  std::uint64_t samples = 0;
+  std::uint64_t blocks = 0;  ///< 扫描的数据块数
+  std::vector<PlayerActivity> players;     ///< 按玩家 ID 排序
+  std::vector<NearMissPair> near_misses;   ///< 按玩家对排序
+  std::vector<SceneHeatmap> heatmaps;      ///< 按场景 ID 排序
+};
+
+/**
+ * @brief 在一组位姿归档上并行计算热力图、移动距离、险情与停留时长
+ *
+ * 所有归档中与时间范围相交的块组成任务列表，由线程池并行解码并计算
+ * 块内结果；块之间有时间依赖的部分（跨块的移动距离、险情状态）随后
+ * 按时间顺序合并。多个归档按起始时间排序后视为一段连续的录制，玩家与
+ * 场景按 ID 合并。
+ */
+class PoseAnalyzer {
+ public:
+  explicit PoseAnalyzer(PoseAnalyticsConfig config);
+
+  /**
+   * @throws std::runtime_error 归档内容损坏时
+   */
+  [[nodiscard]] auto run(
+      const std::vector<const PoseArchiveReader*>& archives) const
+      -> PoseAnalyticsReport;
+
+  [[nodiscard]] auto getConfig() const -> const PoseAnalyticsConfig& {
+    return config_;
+  }
+
+ private:
+  struct BlockResult;
+  struct Task {
+    const PoseArchiveReader* archive;
+    std::size_t block;
+  };
+
+  void analyzeBlock(const Task& task, BlockResult& result,
+                    std::map<std::string, SceneHeatmap>& heatmaps) const;
+  [[nodiscard]] auto cellIndex(float x, float z) const -> std::int64_t;
+
+  PoseAnalyticsConfig config_;
+  float origin_x_;
+  float origin_z_;
+};
+
+}  // namespace picoradar::core
@@ -0,0 +1,620 @@
+#include "pose_archive.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+
+#include "common/platform_fixes.hpp"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace picoradar::core {
+
+namespace {
+
+enum RecordType : std::uint8_t {
+  kPlayerDictionary = 1,
+  kSceneDictionary = 2,
+  kBlock = 3,
+};
+
+// 列顺序与 PoseArchiveWriter::Row 一致
+enum Column : std::size_t {
+  kTimestamp = 0,
+  kScene = 1,
+  kPosition = 2,  // x, y, z
+  kRotation = 5,  // x, y, z, w
+  kColumnCount = 9,
+};
+
+constexpr std::size_t kFileHeaderSize = 16;
+constexpr std::size_t kRecordHeaderSize = 5;
+// 打包数据之后的补零字节，解码时可以整字读取而不越界
+constexpr std::size_t kStreamPadding = 8;
+
+// 按主机字节序写入；支持的平台均为小端序
+template <class T>
+void put(std::string& out, T value) {
+  char bytes[sizeof(T)];
+  std::memcpy(bytes, &value, sizeof(T));
+  out.append(bytes, sizeof(T));
+}
+
+class Cursor {
+ public:
+  Cursor(const unsigned char* data, std::size_t size)
+      : data_(data), size_(size) {}
+
+  template <class T>
+  auto read() -> T {
+    T value;
+    std::memcpy(&value, bytes(sizeof(T)), sizeof(T));
+    return value;
+  }
+
+  auto bytes(std::size_t count) -> const unsigned char* {
+    if (size_ - position_ < count) {
+      throw std::runtime_error("Truncated pose archive record");
+    }
+    const auto* result = data_ + position_;
+    position_ += count;
+    return result;
+  }
+
+ private:
+  const unsigned char* data_;
+  std::size_t size_;
+  std::size_t position_ = 0;
+};
+
+/**
+ * @brief 参考帧编码：减去最小值后以统一位宽紧凑打包
+ *
+ * 格式为 "最小值(8) + 位宽(1) + 数据长度(4) + 数据"，低位在前。
+ */
+void packStream(std::string& out, const std::vector<std::int64_t>& values) {
+  const auto reference =
+      values.empty() ? 0 : *std::min_element(values.begin(), values.end());
+  std::uint64_t max_offset = 0;
+  for (const auto value : values) {
+    const auto offset = static_cast<std::uint64_t>(value) -
+                        static_cast<std::uint64_t>(reference);
+    max_offset = std::max(max_offset, offset);
+  }
+  int width = 0;
+  while (width < 64 && (max_offset >> width) != 0) {
+    ++width;
+  }
+
+  std::vector<unsigned char> data(
+      (values.size() * static_cast<std::size_t>(width) + 7) / 8 +
+      kStreamPadding);
+  std::size_t bit = 0;
+  for (const auto value : values) {
+    const auto offset = static_cast<std::uint64_t>(value) -
+                        static_cast<std::uint64_t>(reference);
+    for (int written = 0; written < width;) {
+      const auto shift = static_cast<int>(bit % 8);
+      const int take = std::min(8 - shift, width - written);
+      const auto bits = (offset >> written) & ((1U << take) - 1);
+      data[bit / 8] |= static_cast<unsigned char>(bits << shift);
+      written += take;
+      bit += static_cast<std::size_t>(take);
+    }
+  }
+
+  put(out, reference);
+  put(out, static_cast<std::uint8_t>(width));
+  put(out, static_cast<std::uint32_t>(data.size()));
+  out.append(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+void unpackStream(Cursor& cursor, std::size_t count,
+                  std::vector<std::int64_t>& out) {
+  const auto reference = cursor.read<std::int64_t>();
+  const auto width = cursor.read<std::uint8_t>();
+  const auto length = cursor.read<std::uint32_t>();
+  if (width > 64 || length < (count * width + 7) / 8 + kStreamPadding) {
+    throw std::runtime_error("Corrupt pose archive stream");
+  }
+  const auto* data = cursor.bytes(length);
+
+  out.resize(count);
+  if (width == 0) {
+    std::fill(out.begin(), out.end(), reference);
+    return;
+  }
+  const auto mask =
+      width == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << width) - 1;
+  std::size_t bit = 0;
+  for (auto& value : out) {
+    const auto byte = bit / 8;
+    const auto shift = static_cast<unsigned>(bit % 8);
+    std::uint64_t word;
+    std::memcpy(&word, data + byte, sizeof(word));
+    word >>= shift;
+    if (shift + width > 64) {
+      word |= static_cast<std::uint64_t>(data[byte + 8]) << (64 - shift);
+    }
+    value = static_cast<std::int64_t>(static_cast<std::uint64_t>(reference) +
+                                      (word & mask));
+    bit += width;
+  }
+}
+
+auto quantize(float value, std::uint32_t units) -> std::int64_t {
+  return std::llround(static_cast<double>(value) * units);
+}
+
+}  // namespace
+
+void PoseColumns::clear() {
+  timestamp_ms.clear();
+  player.clear();
+  scene.clear();
+  for (auto& column : position) {
+    column.clear();
+  }
+  for (auto& column : rotation) {
+    column.clear();
+  }
+}
+
+void PoseColumns::retainRange(std::int64_t from_ms, std::int64_t to_ms) {
+  std::size_t kept = 0;
+  for (std::size_t row = 0; row < size(); ++row) {
+    const auto timestamp = timestamp_ms[row];
+    if (timestamp < from_ms || timestamp > to_ms) {
+      continue;
+    }
+    timestamp_ms[kept] = timestamp;
+    player[kept] = player[row];
+    scene[kept] = scene[row];
+    for (auto& column : position) {
+      column[kept] = column[row];
+    }
+    for (auto& column : rotation) {
+      column[kept] = column[row];
+    }
+    ++kept;
+  }
+
+  timestamp_ms.resize(kept);
+  player.resize(kept);
+  scene.resize(kept);
+  for (auto& column : position) {
+    column.resize(kept);
+  }
+  for (auto& column : rotation) {
+    column.resize(kept);
+  }
+}
+
+//------------------------------------------------------------------------------
+// PoseArchiveWriter
+
+PoseArchiveWriter::PoseArchiveWriter(const std::string& path,
+                                     std::size_t block_frames)
+    : file_(std::fopen(path.c_str(), "wb")),
+      block_frames_(std::max<std::size_t>(1, block_frames)) {
+  if (file_ == nullptr) {
+    throw std::runtime_error("Cannot create pose archive '" + path + "'");
+  }
+
+  std::string header(pose_archive::kMagic.begin(), pose_archive::kMagic.end());
+  put(header, pose_archive::kVersion);
+  put(header, std::uint16_t{0});
+  put(header, pose_archive::kPositionUnits);
+  put(header, pose_archive::kRotationUnits);
+  if (std::fwrite(header.data(), 1, header.size(), file_) != header.size() ||
+      std::fflush(file_) != 0) {
+    std::fclose(file_);
+    throw std::runtime_error("Cannot write pose archive '" + path + "'");
+  }
+  bytes_written_ = header.size();
+}
+
+PoseArchiveWriter::~PoseArchiveWriter() {
+  try {
+    flush();
+  } catch (const std::exception&) {
+    // 写入失败时已写出的块仍然可读
+  }
+  std::fclose(file_);
+}
+
+void PoseArchiveWriter::appendRow(std::int64_t timestamp_ms,
+                                  const std::string& player_id,
+                                  const picoradar::PlayerData& data) {
+  const auto player = intern(players_, new_players_, player_id);
+  Row row{};
+  row[kTimestamp] = timestamp_ms;
+  row[kScene] = intern(scenes_, new_scenes_, data.scene_id());
+  const auto& position = data.position();
+  row[kPosition] = quantize(position.x(), pose_archive::kPositionUnits);
+  row[kPosition + 1] = quantize(position.y(), pose_archive::kPositionUnits);
+  row[kPosition + 2] = quantize(position.z(), pose_archive::kPositionUnits);
+  const auto& rotation = data.rotation();
+  row[kRotation] = quantize(rotation.x(), pose_archive::kRotationUnits);
+  row[kRotation + 1] = quantize(rotation.y(), pose_archive::kRotationUnits);
+  row[kRotation + 2] = quantize(rotation.z(), pose_archive::kRotationUnits);
+  row[kRotation + 3] = quantize(rotation.w(), pose_archive::kRotationUnits);
+  rows_[player].push_back(row);
+}
+
+auto PoseArchiveWriter::intern(
+    std::unordered_map<std::string, std::uint32_t>& dictionary,
+    std::vector<std::string>& pending, const std::string& id)
+    -> std::uint32_t {
+  auto [it, inserted] = dictionary.try_emplace(
+      id, static_cast<std::uint32_t>(dictionary.size()));
+  if (inserted) {
+    pending.push_back(id);
+  }
+  return it->second;
+}
+
+void PoseArchiveWriter::flush() {
+  pending_frames_ = 0;
+  if (rows_.empty()) {
+    return;
+  }
+  // 字典记录先于引用它们的数据块写出
+  writeDictionary(kPlayerDictionary, new_players_);
+  writeDictionary(kSceneDictionary, new_scenes_);
+
+  std::size_t row_count = 0;
+  std::int64_t first_ms = INT64_MAX;
+  std::int64_t last_ms = INT64_MIN;
+  std::vector<std::int64_t> run_players;
+  std::vector<std::int64_t> run_lengths;
+  std::uint32_t previous_player = 0;
+  for (const auto& [player, rows] : rows_) {
+    run_players.push_back(static_cast<std::int64_t>(player) -
+                          static_cast<std::int64_t>(previous_player));
+    run_lengths.push_back(static_cast<std::int64_t>(rows.size()));
+    previous_player = player;
+    row_count += rows.size();
+    first_ms = std::min(first_ms, rows.front()[kTimestamp]);
+    last_ms = std::max(last_ms, rows.back()[kTimestamp]);
+  }
+
+  std::string payload;
+  put(payload, first_ms);
+  put(payload, last_ms);
+  put(payload, static_cast<std::uint32_t>(row_count));
+  put(payload, static_cast<std::uint32_t>(rows_.size()));
+  packStream(payload, run_players);
+  packStream(payload, run_lengths);
+
+  std::vector<std::int64_t> starts;
+  std::vector<std::int64_t> deltas;
+  for (std::size_t column = 0; column < kColumnCount; ++column) {
+    starts.clear();
+    deltas.clear();
+    std::int64_t previous_start = 0;
+    for (const auto& [player, rows] : rows_) {
+      starts.push_back(rows.front()[column] - previous_start);
+      previous_start = rows.front()[column];
+      for (std::size_t i = 1; i < rows.size(); ++i) {
+        deltas.push_back(rows[i][column] - rows[i - 1][column]);
+      }
+    }
+    packStream(payload, starts);
+    packStream(payload, deltas);
+  }
+
+  writeRecord(kBlock, payload);
+  if (std::fflush(file_) != 0) {
+    throw std::runtime_error("Failed to flush pose archive");
+  }
+  samples_ += row_count;
+  rows_.clear();
+}
+
+void PoseArchiveWriter::writeDictionary(std::uint8_t kind,
+                                        std::vector<std::string>& ids) {
+  if (ids.empty()) {
+    return;
+  }
+  std::string payload;
+  put(payload, static_cast<std::uint32_t>(ids.size()));
+  for (const auto& id : ids) {
+    put(payload, static_cast<std::uint32_t>(id.size()));
+    payload += id;
+  }
+  writeRecord(kind, payload);
+  ids.clear();
+}
+
+void PoseArchiveWriter::writeRecord(std::uint8_t type,
+                                    const std::string& payload) {
+  std::string header;
+  put(header, type);
+  put(header, static_cast<std::uint32_t>(payload.size()));
+  if (std::fwrite(header.data(), 1, header.size(), file_) != header.size() ||
+      std::fwrite(payload.data(), 1, payload.size(), file_) !=
+          payload.size()) {
+    throw std::runtime_error("Failed to write pose archive record");
+  }
+  bytes_written_ += header.size() + payload.size();
+}
+
+//------------------------------------------------------------------------------
+// PoseArchiveReader
+
+PoseArchiveReader::PoseArchiveReader(const std::string& path) {
+  const auto fail = [&path](const char* what) {
+    throw std::runtime_error("Cannot open pose archive '" + path +
+                             "': " + what);
+  };
+
+#ifdef _WIN32
+  file_handle_ = CreateFileA(path.c_str(), GENERIC_READ,
+                             FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                             OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file_handle_ == INVALID_HANDLE_VALUE) {
+    file_handle_ = nullptr;
+    fail("open failed");
+  }
+  LARGE_INTEGER size;
+  if (GetFileSizeEx(file_handle_, &size) == 0) {
+    CloseHandle(file_handle_);
+    fail("stat failed");
+  }
+  size_ = static_cast<std::size_t>(size.QuadPart);
+  if (size_ != 0) {
+    mapping_handle_ = CreateFileMappingA(file_handle_, nullptr, PAGE_READONLY,
+                                         0, 0, nullptr);
+    data_ = mapping_handle_ == nullptr
+                ? nullptr
+                : static_cast<const unsigned char*>(
+                      MapViewOfFile(mapping_handle_, FILE_MAP_READ, 0, 0, 0));
+    if (data_ == nullptr) {
+      if (mapping_handle_ != nullptr) {
+        CloseHandle(mapping_handle_);
+      }
+      CloseHandle(file_handle_);
+      fail("mapping failed");
+    }
+  }
+#else
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    fail("open failed");
+  }
+  struct stat info {};
+  if (::fstat(fd, &info) != 0) {
+    ::close(fd);
+    fail("stat failed");
+  }
+  size_ = static_cast<std::size_t>(info.st_size);
+  if (size_ != 0) {
+    void* mapped = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED) {
+      ::close(fd);
+      fail("mmap failed");
+    }
+    data_ = static_cast<const unsigned char*>(mapped);
+    // 分析扫描按顺序读取整个文件
+    ::madvise(mapped, size_, MADV_SEQUENTIAL);
+  }
+  ::close(fd);  // 映射在关闭描述符后仍然有效
+#endif
+
+  try {
+    buildIndex();
+  } catch (const std::exception& e) {
+    unmap();
+    fail(e.what());
+  }
+}
+
+PoseArchiveReader::~PoseArchiveReader() { unmap(); }
+
+void PoseArchiveReader::unmap() {
+#ifdef _WIN32
+  if (data_ != nullptr) {
+    UnmapViewOfFile(data_);
+  }
+  if (mapping_handle_ != nullptr) {
+    CloseHandle(mapping_handle_);
+  }
+  if (file_handle_ != nullptr) {
+    CloseHandle(file_handle_);
+  }
+  mapping_handle_ = nullptr;
+  file_handle_ = nullptr;
+#else
+  if (data_ != nullptr) {
+    ::munmap(const_cast<unsigned char*>(data_), size_);
+  }
+#endif
+  data_ = nullptr;
+}
+
+void PoseArchiveReader::buildIndex() {
+  Cursor header(data_, size_);
+  const auto* magic = header.bytes(pose_archive::kMagic.size());
+  if (std::memcmp(magic, pose_archive::kMagic.data(),
+                  pose_archive::kMagic.size()) != 0) {
+    throw std::runtime_error("not a pose archive");
+  }
+  if (header.read<std::uint16_t>() != pose_archive::kVersion) {
+    throw std::runtime_error("unsupported version");
+  }
+  header.read<std::uint16_t>();
+  if (header.read<std::uint32_t>() != pose_archive::kPositionUnits ||
+      header.read<std::uint32_t>() != pose_archive::kRotationUnits) {
+    throw std::runtime_error("unsupported quantization");
+  }
+
+  std::size_t offset = kFileHeaderSize;
+  while (size_ - offset >= kRecordHeaderSize) {
+    Cursor record(data_ + offset, kRecordHeaderSize);
+    const auto type = record.read<std::uint8_t>();
+    const auto length = record.read<std::uint32_t>();
+    const auto payload = offset + kRecordHeaderSize;
+    if (size_ - payload < length) {
+      break;  // 录制中断时末尾的记录可能不完整
+    }
+
+    if (type == kPlayerDictionary || type == kSceneDictionary) {
+      readDictionary(type, data_ + payload, length);
+    } else if (type == kBlock) {
+      Cursor block(data_ + payload, length);
+      BlockInfo info;
+      info.first_ms = block.read<std::int64_t>();
+      info.last_ms = block.read<std::int64_t>();
+      info.rows = block.read<std::uint32_t>();
+      info.offset = payload;
+      info.size = length;
+      samples_ += info.rows;
+      blocks_.push_back(info);
+    }
+    offset = payload + length;  // 跳过未知类型的记录
+  }
+}
+
+void PoseArchiveReader::readDictionary(std::uint8_t type,
+                                       const unsigned char* data,
+                                       std::size_t size) {
+  auto& ids = type == kPlayerDictionary ? player_ids_ : scene_ids_;
+  Cursor cursor(data, size);
+  const auto count = cursor.read<std::uint32_t>();
+  for (std::uint32_t i = 0; i < count; ++i) {
+    const auto length = cursor.read<std::uint32_t>();
+    const auto* bytes = cursor.bytes(length);
+    ids.emplace_back(reinterpret_cast<const char*>(bytes), length);
+  }
+}
+
+auto PoseArchiveReader::getStartTime() const -> std::int64_t {
+  return blocks_.empty() ? 0 : blocks_.front().first_ms;
+}
+
+auto PoseArchiveReader::getEndTime() const -> std::int64_t {
+  return blocks_.empty() ? 0 : blocks_.back().last_ms;
+}
+
+void PoseArchiveReader::readBlock(std::size_t index, PoseColumns& out) const {
+  const auto& info = blocks_.at(index);
+  Cursor cursor(data_ + info.offset, info.size);
+  cursor.bytes(2 * sizeof(std::int64_t));
+  const std::size_t rows = cursor.read<std::uint32_t>();
+  const std::size_t runs = cursor.read<std::uint32_t>();
+  if (runs > rows || (runs == 0 && rows != 0)) {
+    throw std::runtime_error("Corrupt pose archive block");
+  }
+
+  std::vector<std::int64_t> run_players;
+  std::vector<std::int64_t> run_lengths;
+  unpackStream(cursor, runs, run_players);
+  unpackStream(cursor, runs, run_lengths);
+  std::size_t total = 0;
+  for (const auto length : run_lengths) {
+    if (length <= 0) {
+      throw std::runtime_error("Corrupt pose archive block");
+    }
+    total += static_cast<std::size_t>(length);
+  }
+  if (total != rows) {
+    throw std::runtime_error("Corrupt pose archive block");
+  }
+
+  const auto base = out.size();
+  out.player.resize(base + rows);
+  std::int64_t player = 0;
+  for (std::size_t run = 0, row = base; run < runs; ++run) {
+    player += run_players[run];
+    std::fill_n(out.player.begin() + static_cast<std::ptrdiff_t>(row),
+                run_lengths[run], static_cast<std::uint32_t>(player));
+    row += static_cast<std::size_t>(run_lengths[run]);
+  }
+
+  // 每列先还原为整数，再转换为目标类型
+  std::vector<std::int64_t> starts;
+  std::vector<std::int64_t> deltas;
+  std::vector<std::int64_t> values(rows);
+  for (std::size_t column = 0; column < kColumnCount; ++column) {
+    unpackStream(cursor, runs, starts);
+    unpackStream(cursor, rows - runs, deltas);
+    std::int64_t start = 0;
+    std::size_t row = 0;
+    std::size_t delta = 0;
+    for (std::size_t run = 0; run < runs; ++run) {
+      start += starts[run];
+      auto value = start;
+      values[row++] = value;
+      for (std::int64_t i = 1; i < run_lengths[run]; ++i) {
+        value += deltas[delta++];
+        values[row++] = value;
+      }
+    }
+
+    const auto to_float = [&values](std::vector<float>& target,
+                                    double units) {
+      target.reserve(target.size() + values.size());
+      for (const auto value : values) {
+        target.push_back(
+            static_cast<float>(static_cast<double>(value) / units));
+      }
+    };
+    if (column == kTimestamp) {
+      out.timestamp_ms.insert(out.timestamp_ms.end(), values.begin(),
+                              values.end());
+    } else if (column == kScene) {
+      for (const auto value : values) {
+        out.scene.push_back(static_cast<std::uint32_t>(value));
+      }
+    } else if (column < kRotation) {
+      to_float(out.position[column - kPosition],
+               pose_archive::kPositionUnits);
+    } else {
+      to_float(out.rotation[column - kRotation],
+               pose_archive::kRotationUnits);
+    }
+  }
+}
+
+auto PoseArchiveReader::findBlocks(std::int64_t from_ms,
+                                   std::int64_t to_ms) const
+    -> std::pair<std::size_t, std::size_t> {
+  // 块按录制顺序追加，起止时间单调，二分查找相交的块
+  const auto first = std::partition_point(
+      blocks_.begin(), blocks_.end(),
+      [from_ms](const BlockInfo& block) { return block.last_ms < from_ms; });
+  const auto last = std::partition_point(
+      first, blocks_.end(),
+      [to_ms](const BlockInfo& block) { return block.first_ms <= to_ms; });
+  return {static_cast<std::size_t>(first - blocks_.begin()),
+          static_cast<std::size_t>(last - blocks_.begin())};
+}
+
+void PoseArchiveReader::scan(
+    std::int64_t from_ms, std::int64_t to_ms,
+    const std::function<void(const PoseColumns&)>& visitor) const {
+  const auto [first, last] = findBlocks(from_ms, to_ms);
+  PoseColumns block;
+  for (auto index = first; index < last; ++index) {
+    const auto& info = blocks_[index];
+    block.clear();
+    readBlock(index, block);
+    if (info.first_ms < from_ms || info.last_ms > to_ms) {
+      block.retainRange(from_ms, to_ms);
+    }
+    if (block.size() != 0) {
+      visitor(block);
+    }
+  }
+}
+
+}  // namespace picoradar::core
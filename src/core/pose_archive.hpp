@@ -0,0 +1,211 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "player.pb.h"
+
+namespace picoradar::core {
+
+/**
+ * @brief 位姿归档文件格式 (.pra)
+ *
+ * 文件由文件头和依次追加的记录组成，每条记录为 "类型(1 字节) + 长度(4
+ * 字节) + 内容"：
+ * - 字典记录：新出现的玩家 ID 或场景 ID，按出现顺序编号；
+ * - 数据块：若干采样帧，行按玩家、再按时间排序。除玩家外的每一列都拆成
+ *   "各玩家首行相对上一玩家首行的差值" 与 "玩家内相邻行的差值" 两段，
+ *   每段减去最小值后按统一位宽紧凑打包。
+ *
+ * 块头中的起止时间构成时间索引。记录只追加不改写，进程中途退出时读取方
+ * 忽略末尾不完整的记录。所有整数均为小端序。
+ */
+namespace pose_archive {
+constexpr std::array<char, 4> kMagic = {'P', 'R', 'P', 'A'};
+constexpr std::uint16_t kVersion = 1;
+/// @brief 位置量化精度：每米 1000 个单位 (1mm)
+constexpr std::uint32_t kPositionUnits = 1000;
+/// @brief 四元数分量量化精度：每单位 4096 个刻度
+constexpr std::uint32_t kRotationUnits = 4096;
+}  // namespace pose_archive
+
+/**
+ * @brief 解码后的采样，按列存放
+ *
+ * player 与 scene 是读取器字典中的下标。
+ */
+struct PoseColumns {
+  std::vector<std::int64_t> timestamp_ms;
+  std::vector<std::uint32_t> player;
+  std::vector<std::uint32_t> scene;
+  std::array<std::vector<float>, 3> position;  ///< x, y, z
+  std::array<std::vector<float>, 4> rotation;  ///< x, y, z, w
+
+  [[nodiscard]] auto size() const -> std::size_t {
+    return timestamp_ms.size();
+  }
+  void clear();
+  /// 原地剔除时间不在 [from_ms, to_ms] 内的行
+  void retainRange(std::int64_t from_ms, std::int64_t to_ms);
+};
+
+/**
+ * @brief 追加写入位姿归档文件
+ *
+ * append() 缓存一帧名单，满 block_frames 帧时编码为一个数据块写入文件。
+ * 此类不是线程安全的，由录制线程独占。
+ */
+class PoseArchiveWriter {
+ public:
+  /**
+   * @brief 创建（或截断）归档文件并写入文件头
+   * @throws std::runtime_error 文件无法打开时
+   */
+  PoseArchiveWriter(const std::string& path, std::size_t block_frames);
+  ~PoseArchiveWriter();
+
+  // 禁止拷贝和赋值
+  PoseArchiveWriter(const PoseArchiveWriter&) = delete;
+  auto operator=(const PoseArchiveWriter&) -> PoseArchiveWriter& = delete;
+
+  /**
+   * @brief 追加在 timestamp_ms 时刻采样的名单
+   * @throws std::runtime_error 写入失败时
+   */
+  template <class PlayerMap>
+  void append(std::int64_t timestamp_ms, const PlayerMap& players) {
+    for (const auto& [player_id, data] : players) {
+      appendRow(timestamp_ms, player_id, data);
+    }
+    if (++pending_frames_ >= block_frames_) {
+      flush();
+    }
+  }
+
+  /**
+   * @brief 把缓存的帧编码为数据块写入文件并刷新
+   */
+  void flush();
+
+  [[nodiscard]] auto getBytesWritten() const -> std::uint64_t {
+    return bytes_written_;
+  }
+  [[nodiscard]] auto getSampleCount() const -> std::uint64_t {
+    return samples_;
+  }
+
+ private:
+  /// 量化后的一行：时间、场景、位置 x3、旋转 x4
+  using Row = std::array<std::int64_t, 9>;
+
+  void appendRow(std::int64_t timestamp_ms, const std::string& player_id,
+                 const picoradar::PlayerData& data);
+  auto intern(std::unordered_map<std::string, std::uint32_t>& dictionary,
+              std::vector<std::string>& pending, const std::string& id)
+      -> std::uint32_t;
+  void writeDictionary(std::uint8_t kind, std::vector<std::string>& ids);
+  void writeRecord(std::uint8_t type, const std::string& payload);
+
+  std::FILE* file_ = nullptr;
+  std::size_t block_frames_;
+  std::size_t pending_frames_ = 0;
+  std::map<std::uint32_t, std::vector<Row>> rows_;  // 按玩家下标排序
+  std::unordered_map<std::string, std::uint32_t> players_;
+  std::unordered_map<std::string, std::uint32_t> scenes_;
+  std::vector<std::string> new_players_;
+  std::vector<std::string> new_scenes_;
+  std::uint64_t bytes_written_ = 0;
+  std::uint64_t samples_ = 0;
+};
+
+/**
+ * @brief 以内存映射方式读取位姿归档文件
+ *
+ * 打开时只遍历记录头，建立字典与块索引；数据块在扫描时才解码。
+ * 读取方法可以从多个线程并发调用。
+ */
+class PoseArchiveReader {
+ public:
+  struct BlockInfo {
+    std::int64_t first_ms = 0;
+    std::int64_t last_ms = 0;
+    std::uint32_t rows = 0;
+    std::size_t offset = 0;  ///< 块内容在文件中的偏移
+    std::size_t size = 0;
+  };
+
+  /**
+   * @throws std::runtime_error 文件无法映射或不是归档文件时
+   */
+  explicit PoseArchiveReader(const std::string& path);
+  ~PoseArchiveReader();
+
+  // 禁止拷贝和赋值
+  PoseArchiveReader(const PoseArchiveReader&) = delete;
+  auto operator=(const PoseArchiveReader&) -> PoseArchiveReader& = delete;
+
+  [[nodiscard]] auto getPlayerIds() const -> const std::vector<std::string>& {
+    return player_ids_;
+  }
+  [[nodiscard]] auto getSceneIds() const -> const std::vector<std::string>& {
+    return scene_ids_;
+  }
+  [[nodiscard]] auto getBlocks() const -> const std::vector<BlockInfo>& {
+    return blocks_;
+  }
+  [[nodiscard]] auto getSampleCount() const -> std::uint64_t {
+    return samples_;
+  }
+  /// 首个与最后一个采样的时间，空归档均为 0
+  [[nodiscard]] auto getStartTime() const -> std::int64_t;
+  [[nodiscard]] auto getEndTime() const -> std::int64_t;
+
+  /**
+   * @brief 解码第 index 个数据块，结果追加到 out
+   * @throws std::runtime_error 块内容损坏时
+   */
+  void readBlock(std::size_t index, PoseColumns& out) const;
+
+  /**
+   * @brief 通过块索引查找与 [from_ms, to_ms] 相交的块
+   * @return 块下标的半开区间 [first, last)
+   */
+  [[nodiscard]] auto findBlocks(std::int64_t from_ms, std::int64_t to_ms) const
+      -> std::pair<std::size_t, std::size_t>;
+
+  /**
+   * @brief 访问 [from_ms, to_ms] 内的采样
+   *
+   * 通过块索引跳过范围外的块；与范围相交的块按时间顺序各解码一次并调用
+   * visitor，块内的行按玩家分组、组内按时间排序，超出范围的行已被剔除。
+   */
+  void scan(std::int64_t from_ms, std::int64_t to_ms,
+            const std::function<void(const PoseColumns&)>& visitor) const;
+
+ private:
+  void buildIndex();
+  void unmap();
+  void readDictionary(std::uint8_t type, const unsigned char* data,
+                      std::size_t size);
+
+  const unsigned char* data_ = nullptr;
+  std::size_t size_ = 0;
+#ifdef _WIN32
+  void* file_handle_ = nullptr;
+  void* mapping_handle_ = nullptr;
+#endif
+
+  std::vector<std::string> player_ids_;
+  std::vector<std::string> scene_ids_;
+  std::vector<BlockInfo> blocks_;
+  std::uint64_t samples_ = 0;
+};
+
+}  // namespace picoradar::core
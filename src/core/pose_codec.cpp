@@ -0,0 +1,311 @@
+#include "pose_codec.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string_view>
+
+#include "core/wire_format.hpp"
+
+namespace picoradar::core {
+
+namespace {
+// 每个精度等级下每米对应的量化单位数
+constexpr std::array<float, kPrecisionBandCount> kUnitsPerMeter = {
+    1000.0F, 100.0F, 10.0F};
+// 每个精度等级下朝向每个分量占用的位数
+constexpr std::array<int, kPrecisionBandCount> kRotationBits = {10, 8, 6};
+// smallest-three 中非最大分量的取值范围为 [-1/√2, 1/√2]
+constexpr float kInvSqrt2 = 0.70710678F;
+
+auto bandIndex(PrecisionBand band) -> std::size_t {
+  return static_cast<std::size_t>(band);
+}
+
+auto bandFromPrecision(std::uint32_t precision) -> PrecisionBand {
+  return static_cast<PrecisionBand>(
+      std::min<std::uint32_t>(precision, kPrecisionBandCount - 1));
+}
+
+auto quantize(float value, float units) -> std::int32_t {
+  if (!std::isfinite(value)) {
+    return 0;
+  }
+  const double scaled = std::round(static_cast<double>(value) * units);
+  return static_cast<std::int32_t>(std::clamp(
+      scaled, static_cast<double>(std::numeric_limits<std::int32_t>::min()),
+      static_cast<double>(std::numeric_limits<std::int32_t>::max())));
+}
+
+auto zigzag(std::int64_t value) -> std::uint64_t {
+  return (static_cast<std::uint64_t>(value) << 1) ^
+         static_cast<std::uint64_t>(value >> 63);
+}
+
+auto unzigzag(std::uint64_t value) -> std::int64_t {
+  return static_cast<std::int64_t>(value >> 1) ^
+         -static_cast<std::int64_t>(value & 1);
+}
+
+// 追踪部位记录：相对头部的量化位置 x/y/z (zigzag varint) + 打包朝向 (varint)
+void encodeBodies(const picoradar::PlayerData& player, float units, int bits,
+                  picoradar::CompactPlayer* out) {
+  std::array<const picoradar::TrackedBody*, kMaxTrackedBodies> slots{};
+  for (const auto& body : player.bodies()) {
+    if (body.slot() < kMaxTrackedBodies) {
+      slots[body.slot()] = &body;
+    }
+  }
+
+  const std::array<std::int64_t, 3> head = {out->x(), out->y(), out->z()};
+  std::uint32_t mask = 0;
+  std::string packed;
+  for (std::size_t slot = 0; slot < slots.size(); ++slot) {
+    const auto* body = slots[slot];
+    if (body == nullptr) {
+      continue;
+    }
+    mask |= 1U << slot;
+    const std::array<float, 3> position = {
+        body->position().x(), body->position().y(), body->position().z()};
+    for (std::size_t axis = 0; axis < 3; ++axis) {
+      wire::appendVarint(packed, zigzag(quantize(position[axis], units) -
+                                        head[axis]));
+    }
+    wire::appendVarint(packed,
+                       PoseCodec::packRotation(body->rotation(), bits));
+  }
+  out->set_body_mask(mask);
+  out->set_bodies(std::move(packed));
+}
+
+void decodeBodies(const picoradar::CompactPlayer& compact, float units,
+                  int bits, picoradar::PlayerData* out) {
+  const std::string_view packed = compact.bodies();
+  const std::array<std::int64_t, 3> head = {compact.x(), compact.y(),
+                                            compact.z()};
+  std::size_t pos = 0;
+  for (std::uint32_t slot = 0; slot < kMaxTrackedBodies; ++slot) {
+    if ((compact.body_mask() & (1U << slot)) == 0) {
+      continue;
+    }
+    std::array<std::uint64_t, 4> fields{};
+    for (auto& field : fields) {
+      if (!wire::readVarint(packed, pos, field)) {
+        return;
+      }
+    }
+
+    auto* body = out->add_bodies();
+    body->set_slot(slot);
+    auto* position = body->mutable_position();
+    position->set_x(static_cast<float>(head[0] + unzigzag(fields[0])) / units);
+    position->set_y(static_cast<float>(head[1] + unzigzag(fields[1])) / units);
+    position->set_z(static_cast<float>(head[2] + unzigzag(fields[2])) / units);
+    PoseCodec::unpackRotation(static_cast<std::uint32_t>(fields[3]), bits,
+                              body->mutable_rotation());
+  }
+}
+
+auto distanceBetween(const picoradar::Vector3& a, const picoradar::Vector3& b)
+    -> float {
+  const float dx = a.x() - b.x();
+  const float dy = a.y() - b.y();
+  const float dz = a.z() - b.z();
+  return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+}  // namespace
+
+//------------------------------------------------------------------------------
+// PoseCodec
+
+auto PoseCodec::selectBand(float distance, const PrecisionLodConfig& config)
+    -> PrecisionBand {
+  if (!(distance >= config.near_distance)) {  // 同时处理 NaN
+    return PrecisionBand::Near;
+  }
+  if (distance < config.mid_distance) {
+    return PrecisionBand::Mid;
+  }
+  return PrecisionBand::Far;
+}
+
+auto PoseCodec::positionStep(PrecisionBand band) -> float {
+  return 1.0F / kUnitsPerMeter[bandIndex(band)];
+}
+
+void PoseCodec::encode(const picoradar::PlayerData& player, PrecisionBand band,
+                       picoradar::CompactPlayer* out, bool include_bodies) {
+  const float units = kUnitsPerMeter[bandIndex(band)];
+
+  out->set_player_id(player.player_id());
+  out->set_scene_id(player.scene_id());
+  out->set_precision(static_cast<std::uint32_t>(band));
+  out->set_x(quantize(player.position().x(), units));
+  out->set_y(quantize(player.position().y(), units));
+  out->set_z(quantize(player.position().z(), units));
+  if (player.has_rotation()) {
+    out->set_rotation(
+        packRotation(player.rotation(), kRotationBits[bandIndex(band)]));
+  }
+  out->set_timestamp(player.timestamp());
+  if (include_bodies && player.bodies_size() > 0) {
+    encodeBodies(player, units, kRotationBits[bandIndex(band)], out);
+  }
+}
+
+void PoseCodec::decode(const picoradar::CompactPlayer& compact,
+                       picoradar::PlayerData* out) {
+  const auto band = bandFromPrecision(compact.precision());
+  const float units = kUnitsPerMeter[bandIndex(band)];
+
+  out->set_player_id(compact.player_id());
+  out->set_scene_id(compact.scene_id());
+  auto* position = out->mutable_position();
+  position->set_x(static_cast<float>(compact.x()) / units);
+  position->set_y(static_cast<float>(compact.y()) / units);
+  position->set_z(static_cast<float>(compact.z()) / units);
+  if (compact.has_rotation()) {
+    unpackRotation(compact.rotation(), kRotationBits[bandIndex(band)],
+                   out->mutable_rotation());
+  }
+  out->set_timestamp(compact.timestamp());
+  out->clear_bodies();
+  if (compact.body_mask() != 0) {
+    decodeBodies(compact, units, kRotationBits[bandIndex(band)], out);
+  }
+}
+
+auto PoseCodec::packRotation(const picoradar::Quaternion& rotation, int bits)
+    -> std::uint32_t {
+  std::array<float, 4> c = {rotation.x(), rotation.y(), rotation.z(),
+                            rotation.w()};
+
+  float norm = 0.0F;
+  for (float v : c) {
+    norm += v * v;
+  }
+  norm = std::sqrt(norm);
+  if (!(norm > 1e-6F)) {
+    c = {0.0F, 0.0F, 0.0F, 1.0F};
+  } else {
+    for (float& v : c) {
+      v /= norm;
+    }
+  }
+
+  std::size_t largest = 0;
+  for (std::size_t i = 1; i < c.size(); ++i) {
+    if (std::fabs(c[i]) > std::fabs(c[largest])) {
+      largest = i;
+    }
+  }
+  // q 与 -q 表示同一旋转，保证最大分量为正即可省略其符号
+  const float sign = c[largest] < 0.0F ? -1.0F : 1.0F;
+
+  const auto max_value = static_cast<float>((1U << bits) - 1U);
+  std::uint32_t packed = static_cast<std::uint32_t>(largest);
+  int shift = 2;
+  for (std::size_t i = 0; i < c.size(); ++i) {
+    if (i == largest) {
+      continue;
+    }
+    const float normalized =
+        std::clamp((c[i] * sign + kInvSqrt2) / (2.0F * kInvSqrt2), 0.0F, 1.0F);
+    packed |= static_cast<std::uint32_t>(std::lround(normalized * max_value))
+              << shift;
+    shift += bits;
+  }
+  return packed;
+}
+
+void PoseCodec::unpackRotation(std::uint32_t packed, int bits,
+                               picoradar::Quaternion* out) {
+  const std::uint32_t mask = (1U << bits) - 1U;
+  const auto max_value = static_cast<float>(mask);
+  const auto largest = static_cast<std::size_t>(packed & 0x3U);
+
+  std::array<float, 4> c{};
+  float sum = 0.0F;
+  int shift = 2;
+  for (std::size_t i = 0; i < c.size(); ++i) {
+    if (i == largest) {
+      continue;
+    }
+    const float normalized =
+        static_cast<float>((packed >> shift) & mask) / max_value;
+    c[i] = normalized * 2.0F * kInvSqrt2 - kInvSqrt2;
+    sum += c[i] * c[i];
+    shift += bits;
+  }
+  c[largest] = std::sqrt(std::max(0.0F, 1.0F - sum));
+
+  out->set_x(c[0]);
+  out->set_y(c[1]);
+  out->set_z(c[2]);
+  out->set_w(c[3]);
+}
+
+//------------------------------------------------------------------------------
+// CompactFrameBuilder
+
+CompactFrameBuilder::CompactFrameBuilder(const PlayerMap& players,
+                                         PrecisionLodConfig config)
+    : config_(config) {
+  players_.reserve(players.size());
+  index_.reserve(players.size());
+  for (const auto& [id, data] : players) {
+    index_.emplace(id, players_.size());
+    players_.push_back(&data);
+  }
+  cache_.resize(players_.size());
+  encoded_.resize(players_.size() * kPrecisionBandCount, false);
+}
+
+auto CompactFrameBuilder::encoded(std::size_t index, PrecisionBand band)
+    -> const std::string& {
+  auto& record = cache_[index][bandIndex(band)];
+  const auto slot = index * kPrecisionBandCount + bandIndex(band);
+  if (!encoded_[slot]) {
+    picoradar::CompactPlayer compact;
+    PoseCodec::encode(*players_[index], band, &compact,
+                      band != PrecisionBand::Far || config_.far_bodies);
+    compact.SerializeToString(&record);
+    encoded_[slot] = true;
+    ++encode_count_;
+  }
+  return record;
+}
+
+auto CompactFrameBuilder::buildFor(const std::string& viewer_id,
+                                   PrecisionBand min_band) -> std::string {
+  const picoradar::Vector3* viewer_position = nullptr;
+  if (auto it = index_.find(viewer_id); it != index_.end()) {
+    viewer_position = &players_[it->second]->position();
+  }
+
+  std::string list_payload;
+  for (std::size_t i = 0; i < players_.size(); ++i) {
+    const auto band = std::max(
+        min_band,
+        viewer_position == nullptr
+            ? PrecisionBand::Near
+            : PoseCodec::selectBand(
+                  distanceBetween(*viewer_position, players_[i]->position()),
+                  config_));
+    wire::appendLengthDelimited(
+        list_payload, picoradar::CompactPlayerList::kPlayersFieldNumber,
+        encoded(i, band));
+  }
+
+  std::string frame;
+  frame.reserve(wire::lengthDelimitedSize(
+      picoradar::ServerToClient::kCompactPlayerListFieldNumber,
+      list_payload.size()));
+  wire::appendLengthDelimited(
+      frame, picoradar::ServerToClient::kCompactPlayerListFieldNumber,
+      list_payload);
+  return frame;
+}
+
+}  // namespace picoradar::core
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "player.pb.h"
+#include "server.pb.h"
+
+namespace picoradar::core {
+
+/**
+ * @brief 量化精度等级
+ *
+ * 远处的玩家既不需要毫米级位置，也不需要精确的头部朝向。
+ * 服务器根据观察者与玩家的距离为每个 (观察者, 玩家) 对选择精度等级。
+ */
+enum class PrecisionBand : std::uint8_t {
+  Near = 0,  ///< 1mm 位置，每分量 10 位朝向
+  Mid = 1,   ///< 1cm 位置，每分量 8 位朝向
+  Far = 2,   ///< 10cm 位置，每分量 6 位朝向
+};
+
+/// @brief 精度等级数量
+constexpr std::size_t kPrecisionBandCount = 3;
+
+/// @brief 每名玩家最多追踪的头部以外部位数 (TrackedBody.slot 的上限)
+constexpr std::size_t kMaxTrackedBodies = 8;
+
+/**
+ * @brief 精度 LOD 的距离分段配置 (network.precision_lod.*)
+ */
+struct PrecisionLodConfig {
+  bool enabled = false;
+  float near_distance = 5.0F;  ///< 小于此距离使用 Near
+  float mid_distance = 20.0F;  ///< 小于此距离使用 Mid，否则使用 Far
+  bool far_bodies = false;  ///< Far 精度下是否仍发送手柄与追踪器
+};
+
+/**
+ * @brief 玩家姿态的量化编解码
+ */
+class PoseCodec {
+ public:
+  /**
+   * @brief 根据距离选择精度等级
+   */
+  static auto selectBand(float distance, const PrecisionLodConfig& config)
+      -> PrecisionBand;
+
+  /**
+   * @brief 获取某精度等级下位置的量化步长（米）
+   */
+  static auto positionStep(PrecisionBand band) -> float;
+
+  /**
+   * @brief 按指定精度编码玩家数据
+   *
+   * 追踪部位与头部使用同一精度，位置相对头部量化，按槽位升序紧凑打包
+   * 到 bodies 中；include_bodies 为 false 时省略全部追踪部位。
+   * 槽位不小于 kMaxTrackedBodies 的部位被忽略，重复槽位以最后一个为准。
+   */
+  static void encode(const picoradar::PlayerData& player, PrecisionBand band,
+                     picoradar::CompactPlayer* out,
+                     bool include_bodies = true);
+
+  /**
+   * @brief 将紧凑编码还原为玩家数据
+   *
+   * bodies 截断时丢弃无法解码的部位。
+   */
+  static void decode(const picoradar::CompactPlayer& compact,
+                     picoradar::PlayerData* out);
+
+  /**
+   * @brief 打包四元数 (smallest-three)
+   *
+   * 2 位存放最大分量的索引，其余三个分量各占 bits 位。
+   */
+  static auto packRotation(const picoradar::Quaternion& rotation, int bits)
+      -> std::uint32_t;
+
+  /**
+   * @brief 解包四元数
+   */
+  static void unpackRotation(std::uint32_t packed, int bits,
+                             picoradar::Quaternion* out);
+};
+
+/**
+ * @brief 为每个观察者构建紧凑编码的玩家列表帧
+ *
+ * 同一次广播中，每个玩家在每个精度等级下只编码一次，
+ * 不同观察者的帧通过拼接共享的编码结果得到。
+ * 此类不是线程安全的，应在单次广播内顺序使用。
+ */
+class CompactFrameBuilder {
+ public:
+  using PlayerMap = std::unordered_map<std::string, picoradar::PlayerData>;
+
+  CompactFrameBuilder(const PlayerMap& players, PrecisionLodConfig config);
+
+  /**
+   * @brief 构建发给指定观察者的完整 ServerToClient 帧
+   *
+   * 观察者位置未知时所有玩家都使用 Near 精度。min_band 限定最高精度，
+   * 例如传入 Far 时所有玩家都按 Far 编码，用于链路较差的观察者。
+   */
+  auto buildFor(const std::string& viewer_id,
+                PrecisionBand min_band = PrecisionBand::Near) -> std::string;
+
+  /**
+   * @brief 已编码的 (玩家, 精度) 记录数，用于观察编码共享情况
+   */
+  [[nodiscard]] auto getEncodeCount() const -> std::size_t {
+    return encode_count_;
+  }
+
+ private:
+  auto encoded(std::size_t index, PrecisionBand band) -> const std::string&;
+
+  PrecisionLodConfig config_;
+  std::vector<const picoradar::PlayerData*> players_;
+  std::unordered_map<std::string, std::size_t> index_;
+  std::vector<std::array<std::string, kPrecisionBandCount>> cache_;
+  std::vector<bool> encoded_;  ///< 编码结果可能为空串，单独记录是否已编码
+  std::size_t encode_count_ = 0;
+};
+
+}  // namespace picoradar::core
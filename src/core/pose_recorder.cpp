@@ -0,0 +1,91 @@
+#include "pose_recorder.hpp"
+
+#include <algorithm>
+
+namespace picoradar::core {
+
+PoseRecorder::PoseRecorder(const PlayerRegistry& registry,
+                           PoseRecorderConfig config)
+    : registry_(registry), config_(std::move(config)) {
+  config_.sample_interval =
+      std::max(config_.sample_interval, std::chrono::milliseconds(1));
+}
+
+PoseRecorder::~PoseRecorder() { stop(); }
+
+void PoseRecorder::start() {
+  if (thread_.joinable()) {
+    return;
+  }
+  writer_ =
+      std::make_unique<PoseArchiveWriter>(config_.path, config_.block_frames);
+  bytes_written_ = writer_->getBytesWritten();
+  {
+    std::lock_guard lock(mutex_);
+    running_ = true;
+    error_.clear();
+  }
+  thread_ = std::thread([this] { run(); });
+}
+
+void PoseRecorder::stop() {
+  {
+    std::lock_guard lock(mutex_);
+    running_ = false;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  writer_.reset();  // 析构时写出最后一个不完整的块
+}
+
+auto PoseRecorder::getError() const -> std::string {
+  std::lock_guard lock(mutex_);
+  return error_;
+}
+
+void PoseRecorder::run() {
+  auto next_sample = std::chrono::steady_clock::now();
+  std::unique_lock lock(mutex_);
+  while (running_) {
+    lock.unlock();
+    try {
+      const auto snapshot = registry_.getSnapshot();
+      if (!snapshot->empty()) {
+        const auto now_ms =
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch())
+                .count();
+        writer_->append(now_ms, *snapshot);
+        ++frames_;
+        bytes_written_ = writer_->getBytesWritten();
+      }
+    } catch (const std::exception& e) {
+      lock.lock();
+      error_ = e.what();
+      running_ = false;
+      return;
+    }
+    lock.lock();
+
+    // 固定节拍；落后时重新对齐，不补录
+    next_sample += config_.sample_interval;
+    const auto now = std::chrono::steady_clock::now();
+    if (next_sample < now) {
+      next_sample = now;
+    }
+    cv_.wait_until(lock, next_sample, [this] { return !running_; });
+  }
+  lock.unlock();
+
+  try {
+    writer_->flush();
+    bytes_written_ = writer_->getBytesWritten();
+  } catch (const std::exception& e) {
+    lock.lock();
+    error_ = e.what();
+  }
+}
+
+}  // namespace picoradar::core
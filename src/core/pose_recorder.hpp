@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "core/player_registry.hpp"
+#include "core/pose_archive.hpp"
+
+namespace picoradar::core {
+
+/**
+ * @brief 位姿录制配置 (archive.*)
+ */
+struct PoseRecorderConfig {
+  std::string path;  ///< 归档文件路径
+  std::chrono::milliseconds sample_interval{100};
+  std::size_t block_frames = 64;  ///< 每个数据块包含的采样帧数
+};
+
+/**
+ * @brief 在后台线程按固定间隔采样注册表名单，写入位姿归档
+ *
+ * 每次采样只取注册表的共享快照，量化、编码与磁盘写入都在录制线程上
+ * 完成，不占用 I/O 线程。没有玩家的帧不会写入。
+ */
+class PoseRecorder {
+ public:
+  PoseRecorder(const PlayerRegistry& registry, PoseRecorderConfig config);
+  ~PoseRecorder();
+
+  // 禁止拷贝和赋值
+  PoseRecorder(const PoseRecorder&) = delete;
+  auto operator=(const PoseRecorder&) -> PoseRecorder& = delete;
+
+  /**
+   * @brief 创建归档文件并启动录制线程
+   * @throws std::runtime_error 文件无法创建时
+   */
+  void start();
+
+  /**
+   * @brief 停止录制，把缓存的帧写入文件
+   */
+  void stop();
+
+  /// start() 之后、stop() 之前为 true
+  [[nodiscard]] auto isRecording() const -> bool { return writer_ != nullptr; }
+  [[nodiscard]] auto getPath() const -> const std::string& {
+    return config_.path;
+  }
+  [[nodiscard]] auto getFramesRecorded() const -> std::uint64_t {
+    return frames_.load();
+  }
+  [[nodiscard]] auto getBytesWritten() const -> std::uint64_t {
+    return bytes_written_.load();
+  }
+
+  /**
+   * @brief 写入失败时的错误信息；录制随之停止，已写出的块仍然可读
+   */
+  [[nodiscard]] auto getError() const -> std::string;
+
+ private:
+  void run();
+
+  const PlayerRegistry& registry_;
+  PoseRecorderConfig config_;
+  std::unique_ptr<PoseArchiveWriter> writer_;
+  std::thread thread_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  bool running_ = false;
+  std::string error_;
+
+  std::atomic<std::uint64_t> frames_{0};
+  std::atomic<std::uint64_t> bytes_written_{0};
+};
+
+}  // namespace picoradar::core
@@ -0,0 +1,115 @@
+#include "proximity_detector.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace picoradar::core {
+
+namespace {
+using Position = std::array<float, 3>;
+
+auto toPosition(const picoradar::Vector3& v) -> Position {
+  return {v.x(), v.y(), v.z()};
+}
+
+auto distanceBetween(const Position& a, const Position& b) -> float {
+  const float dx = a[0] - b[0];
+  const float dy = a[1] - b[1];
+  const float dz = a[2] - b[2];
+  return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+auto sanitize(ProximityConfig config) -> ProximityConfig {
+  if (!(config.alert_distance > 0.0F)) {
+    config.alert_distance = ProximityConfig{}.alert_distance;
+  }
+  config.clear_distance =
+      std::max(config.clear_distance, config.alert_distance);
+  return config;
+}
+}  // namespace
+
+ProximityDetector::ProximityDetector()
+    : ProximityDetector(ProximityConfig{}) {}
+
+ProximityDetector::ProximityDetector(ProximityConfig config)
+    : config_(sanitize(config)), hash_(config_.clear_distance) {}
+
+auto ProximityDetector::update(const PlayerMap& players, Clock::time_point now)
+    -> std::vector<ProximityPairEvent> {
+  std::vector<const PlayerMap::value_type*> entries;
+  entries.reserve(players.size());
+  hash_.clear();
+  for (const auto& entry : players) {
+    // 鉴权时的占位数据没有场景、位于原点，两个尚未发送位姿的玩家不应
+    // 以距离 0 触发警报
+    if (entry.second.scene_id().empty() || !entry.second.has_position()) {
+      continue;
+    }
+    hash_.insert(entries.size(), entry.second.scene_id(),
+                 entry.second.position());
+    entries.push_back(&entry);
+  }
+
+  const double dt =
+      previous_time_ == Clock::time_point{}
+          ? 0.0
+          : std::chrono::duration<double>(now - previous_time_).count();
+
+  std::vector<ProximityPairEvent> events;
+  std::set<PairKey> still_active;
+
+  for (const auto& [i, j] : hash_.findPairs()) {
+    const auto* a = entries[i];
+    const auto* b = entries[j];
+    PairKey key = a->first < b->first ? PairKey{a->first, b->first}
+                                      : PairKey{b->first, a->first};
+
+    const auto pos_a = toPosition(a->second.position());
+    const auto pos_b = toPosition(b->second.position());
+    const float distance = distanceBetween(pos_a, pos_b);
+    if (distance > config_.alert_distance && active_.count(key) == 0) {
+      continue;  // 位于警报与解除距离之间，但尚未触发
+    }
+
+    float closing_speed = 0.0F;
+    auto prev_a = previous_positions_.find(a->first);
+    auto prev_b = previous_positions_.find(b->first);
+    if (dt > 0.0 && prev_a != previous_positions_.end() &&
+        prev_b != previous_positions_.end()) {
+      const float previous = distanceBetween(prev_a->second, prev_b->second);
+      closing_speed = static_cast<float>((previous - distance) / dt);
+    }
+
+    events.push_back(
+        ProximityPairEvent{key.first, key.second, distance, closing_speed,
+                           false});
+    still_active.insert(std::move(key));
+  }
+
+  for (const auto& key : active_) {
+    if (still_active.count(key) != 0) {
+      continue;
+    }
+    float distance = 0.0F;
+    auto a = players.find(key.first);
+    auto b = players.find(key.second);
+    if (a != players.end() && b != players.end()) {
+      distance = distanceBetween(toPosition(a->second.position()),
+                                 toPosition(b->second.position()));
+    }
+    events.push_back(
+        ProximityPairEvent{key.first, key.second, distance, 0.0F, true});
+  }
+
+  active_ = std::move(still_active);
+  previous_positions_.clear();
+  for (const auto& [id, player] : players) {
+    previous_positions_.emplace(id, toPosition(player.position()));
+  }
+  previous_time_ = now;
+
+  return events;
+}
+
+}  // namespace picoradar::core
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "core/spatial_hash.hpp"
+#include "player.pb.h"
+
+namespace picoradar::core {
+
+/**
+ * @brief 近距离警报配置 (network.proximity.*)
+ */
+struct ProximityConfig {
+  float alert_distance = 1.5F;  ///< 进入此距离时触发警报
+  float clear_distance = 2.0F;  ///< 超过此距离时解除警报，避免边界抖动
+};
+
+/**
+ * @brief 一个近距离玩家对的状态变化
+ *
+ * first 与 second 按字典序排列。
+ */
+struct ProximityPairEvent {
+  std::string first;
+  std::string second;
+  float distance = 0.0F;
+  float closing_speed = 0.0F;  ///< 米/秒，正值表示正在靠近
+  bool cleared = false;
+};
+
+/**
+ * @brief 每个 tick 计算近距离玩家对
+ *
+ * 使用 SpatialHash 只比较相邻单元中的玩家。处于警报状态的玩家对
+ * 每个 tick 都会产生事件（携带最新距离和接近速度），
+ * 离开 clear_distance 或玩家离开时产生一次 cleared 事件。
+ * 此类不是线程安全的，应由单个 tick 循环驱动。
+ */
+class ProximityDetector {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using PlayerMap = std::unordered_map<std::string, picoradar::PlayerData>;
+
+  ProximityDetector();
+  explicit ProximityDetector(ProximityConfig config);
+
+  /**
+   * @brief 根据当前玩家位置计算本 tick 的事件
+   *
+   * 没有场景或没有位置的玩家（例如鉴权后尚未发送位姿）不参与检测。
+   */
+  auto update(const PlayerMap& players, Clock::time_point now)
+      -> std::vector<ProximityPairEvent>;
+
+  [[nodiscard]] auto getActivePairCount() const -> std::size_t {
+    return active_.size();
+  }
+
+  [[nodiscard]] auto getConfig() const -> const ProximityConfig& {
+    return config_;
+  }
+
+ private:
+  using Position = std::array<float, 3>;
+  using PairKey = std::pair<std::string, std::string>;
+
+  ProximityConfig config_;
+  SpatialHash hash_;
+  std::unordered_map<std::string, Position> previous_positions_;
+  Clock::time_point previous_time_;
+  std::set<PairKey> active_;
+};
+
+}  // namespace picoradar::core
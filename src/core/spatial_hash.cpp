@@ -0,0 +1,91 @@
+#include "spatial_hash.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace picoradar::core {
+
+SpatialHash::SpatialHash(float cell_size)
+    : cell_size_(cell_size > 0.0F ? cell_size : 1.0F) {}
+
+void SpatialHash::clear() {
+  scene_ids_.clear();
+  points_.clear();
+  cells_.clear();
+}
+
+void SpatialHash::insert(std::size_t index, const std::string& scene_id,
+                         const picoradar::Vector3& position) {
+  constexpr auto kLimit =
+      static_cast<float>(std::numeric_limits<std::int32_t>::max() / 2);
+
+  const float fx = std::floor(position.x() / cell_size_);
+  const float fy = std::floor(position.y() / cell_size_);
+  const float fz = std::floor(position.z() / cell_size_);
+  // 同时过滤 NaN、无穷以及无法用 int32 表示的单元坐标
+  if (!(std::fabs(fx) < kLimit && std::fabs(fy) < kLimit &&
+        std::fabs(fz) < kLimit)) {
+    return;
+  }
+
+  const auto scene = scene_ids_
+                         .emplace(scene_id, static_cast<std::uint32_t>(
+                                                scene_ids_.size()))
+                         .first->second;
+  const CellKey cell{scene, static_cast<std::int32_t>(fx),
+                     static_cast<std::int32_t>(fy),
+                     static_cast<std::int32_t>(fz)};
+
+  cells_[cell].push_back(points_.size());
+  points_.push_back(
+      Point{index, cell, position.x(), position.y(), position.z()});
+}
+
+auto SpatialHash::findPairs() const -> std::vector<Pair> {
+  const float max_distance_sq = cell_size_ * cell_size_;
+  std::vector<Pair> pairs;
+
+  for (std::size_t i = 0; i < points_.size(); ++i) {
+    const auto& a = points_[i];
+    for (int dx = -1; dx <= 1; ++dx) {
+      for (int dy = -1; dy <= 1; ++dy) {
+        for (int dz = -1; dz <= 1; ++dz) {
+          const CellKey neighbor{a.cell.scene, a.cell.x + dx, a.cell.y + dy,
+                                 a.cell.z + dz};
+          auto it = cells_.find(neighbor);
+          if (it == cells_.end()) {
+            continue;
+          }
+          for (const auto j : it->second) {
+            if (j <= i) {
+              continue;  // 每个点对只由较早插入的点报告一次
+            }
+            const auto& b = points_[j];
+            const float ddx = a.x - b.x;
+            const float ddy = a.y - b.y;
+            const float ddz = a.z - b.z;
+            if (ddx * ddx + ddy * ddy + ddz * ddz <= max_distance_sq) {
+              pairs.emplace_back(a.index, b.index);
+            }
+          }
+        }
+      }
+    }
+  }
+  return pairs;
+}
+
+auto SpatialHash::CellKeyHash::operator()(const CellKey& key) const
+    -> std::size_t {
+  // 常用的三维网格哈希质数
+  auto h = static_cast<std::size_t>(key.scene) * 2654435761U;
+  h ^= static_cast<std::size_t>(static_cast<std::uint32_t>(key.x)) *
+       73856093U;
+  h ^= static_cast<std::size_t>(static_cast<std::uint32_t>(key.y)) *
+       19349663U;
+  h ^= static_cast<std::size_t>(static_cast<std::uint32_t>(key.z)) *
+       83492791U;
+  return h;
+}
+
+}  // namespace picoradar::core
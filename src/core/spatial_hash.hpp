@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "player.pb.h"
+
+namespace picoradar::core {
+
+/**
+ * @brief 按场景划分的均匀网格空间哈希
+ *
+ * 点按 cell_size 划分到三维网格单元中，查询近邻时只需检查相邻的
+ * 27 个单元，使近距离玩家对的查找开销与玩家数近似线性，而不是平方。
+ * 每个 tick 重新构建，因此不需要支持删除。
+ */
+class SpatialHash {
+ public:
+  using Pair = std::pair<std::size_t, std::size_t>;
+
+  explicit SpatialHash(float cell_size);
+
+  void clear();
+
+  /**
+   * @brief 插入一个点
+   *
+   * @param index 调用方自定义的索引，在 findPairs 的结果中返回
+   * @param scene_id 不同场景的点互不相邻
+   * @param position 位置，包含 NaN 或无穷的点被忽略
+   */
+  void insert(std::size_t index, const std::string& scene_id,
+              const picoradar::Vector3& position);
+
+  /**
+   * @brief 查找距离不超过 cell_size 的所有点对
+   *
+   * 每个点对只返回一次，且 first 对应较早插入的点。
+   */
+  auto findPairs() const -> std::vector<Pair>;
+
+  [[nodiscard]] auto size() const -> std::size_t { return points_.size(); }
+
+ private:
+  struct CellKey {
+    std::uint32_t scene;
+    std::int32_t x;
+    std::int32_t y;
+    std::int32_t z;
+
+    auto operator==(const CellKey& other) const -> bool {
+      return scene == other.scene && x == other.x && y == other.y &&
+             z == other.z;
+    }
+  };
+
+  struct CellKeyHash {
+    auto operator()(const CellKey& key) const -> std::size_t;
+  };
+
+  struct Point {
+    std::size_t index;
+    CellKey cell;
+    float x;
+    float y;
+    float z;
+  };
+
+  float cell_size_;
+  std::unordered_map<std::string, std::uint32_t> scene_ids_;
+  std::vector<Point> points_;
+  std::unordered_map<CellKey, std::vector<std::size_t>, CellKeyHash> cells_;
+};
+
+}  // namespace picoradar::core
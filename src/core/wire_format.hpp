@@ -0,0 +1,155 @@
+#pragma once
+
+/**
+ * @file wire_format.hpp
+ * @brief Protobuf 线格式的最小拼接与提取工具
+ *
+ * repeated 子消息在线格式上就是若干个 "tag + 长度 + 字节" 记录的简单拼接，
+ * 因此预先编码好的子消息可以直接拼接成外层消息，而无需重新序列化；
+ * 反过来，已校验过的消息中的子消息字节也可以原样取出保存。
+ */
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace picoradar::core::wire {
+
+/// @brief varint 类型 (int32/int64/bool/enum 等)
+constexpr std::uint32_t kWireTypeVarint = 0;
+/// @brief 64 位定长类型 (fixed64/double)
+constexpr std::uint32_t kWireTypeFixed64 = 1;
+/// @brief 长度分隔类型 (子消息、字符串、bytes)
+constexpr std::uint32_t kWireTypeLengthDelimited = 2;
+/// @brief 32 位定长类型 (fixed32/float)
+constexpr std::uint32_t kWireTypeFixed32 = 5;
+
+/**
+ * @brief 生成字段 tag
+ */
+constexpr auto makeTag(std::uint32_t field_number, std::uint32_t wire_type)
+    -> std::uint32_t {
+  return (field_number << 3) | wire_type;
+}
+
+/**
+ * @brief 计算 varint 编码后的字节数
+ */
+inline auto varintSize(std::uint64_t value) -> std::size_t {
+  std::size_t size = 1;
+  while (value >= 0x80) {
+    value >>= 7;
+    ++size;
+  }
+  return size;
+}
+
+/**
+ * @brief 追加一个 varint
+ */
+inline void appendVarint(std::string& out, std::uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+/**
+ * @brief 计算一个长度分隔字段编码后的总字节数
+ */
+inline auto lengthDelimitedSize(std::uint32_t field_number,
+                                std::size_t payload_size) -> std::size_t {
+  return varintSize(makeTag(field_number, kWireTypeLengthDelimited)) +
+         varintSize(payload_size) + payload_size;
+}
+
+/**
+ * @brief 追加一个长度分隔字段的头部 (tag + 长度)
+ */
+inline void appendLengthDelimitedHeader(std::string& out,
+                                        std::uint32_t field_number,
+                                        std::size_t payload_size) {
+  appendVarint(out, makeTag(field_number, kWireTypeLengthDelimited));
+  appendVarint(out, payload_size);
+}
+
+/**
+ * @brief 追加一个完整的长度分隔字段
+ */
+inline void appendLengthDelimited(std::string& out, std::uint32_t field_number,
+                                  const std::string& payload) {
+  appendLengthDelimitedHeader(out, field_number, payload.size());
+  out.append(payload);
+}
+
+/**
+ * @brief 从 data[pos] 读取一个 varint 并前移 pos；数据截断或超长时返回 false
+ */
+inline auto readVarint(std::string_view data, std::size_t& pos,
+                       std::uint64_t& value) -> bool {
+  value = 0;
+  for (int shift = 0; shift < 64 && pos < data.size(); shift += 7) {
+    const auto byte = static_cast<std::uint8_t>(data[pos++]);
+    value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief 取出消息中某个长度分隔字段的原始字节，不做拷贝
+ *
+ * 只扫描顶层字段。字段不存在、出现多次 (解析时会被合并，字节不再等价)
+ * 或消息格式错误时返回 std::nullopt。
+ */
+inline auto findLengthDelimited(std::string_view message,
+                                std::uint32_t field_number)
+    -> std::optional<std::string_view> {
+  std::optional<std::string_view> found;
+  std::size_t pos = 0;
+  while (pos < message.size()) {
+    std::uint64_t tag = 0;
+    if (!readVarint(message, pos, tag)) {
+      return std::nullopt;
+    }
+    std::uint64_t value = 0;
+    switch (tag & 0x7) {
+      case kWireTypeVarint:
+        if (!readVarint(message, pos, value)) {
+          return std::nullopt;
+        }
+        break;
+      case kWireTypeFixed64:
+        pos += 8;
+        break;
+      case kWireTypeFixed32:
+        pos += 4;
+        break;
+      case kWireTypeLengthDelimited:
+        if (!readVarint(message, pos, value) ||
+            value > message.size() - pos) {
+          return std::nullopt;
+        }
+        if ((tag >> 3) == field_number) {
+          if (found) {
+            return std::nullopt;
+          }
+          found = message.substr(pos, static_cast<std::size_t>(value));
+        }
+        pos += static_cast<std::size_t>(value);
+        break;
+      default:
+        return std::nullopt;  // group 已废弃，不支持
+    }
+  }
+  if (pos != message.size()) {
+    return std::nullopt;
+  }
+  return found;
+}
+
+}  // namespace picoradar::core::wire
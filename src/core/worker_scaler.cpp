@@ -0,0 +1,55 @@
+#include "worker_scaler.hpp"
+
+#include <algorithm>
+
+namespace picoradar::core {
+
+WorkerScaler::WorkerScaler(WorkerScalerConfig config) : config_(config) {
+  config_.min_workers = std::max<std::size_t>(1, config_.min_workers);
+  config_.max_workers = std::max(config_.min_workers, config_.max_workers);
+}
+
+auto WorkerScaler::update(std::size_t current, const WorkerLoadSample& sample)
+    -> std::size_t {
+  const auto clamped =
+      std::clamp(current, config_.min_workers, config_.max_workers);
+  if (clamped != current) {
+    reset();
+    return clamped;
+  }
+
+  const bool overloaded = sample.loop_lag > config_.scale_up_lag ||
+                          sample.utilization > config_.scale_up_utilization;
+  const bool idle = sample.loop_lag < config_.scale_down_lag &&
+                    sample.utilization < config_.scale_down_utilization;
+
+  if (overloaded) {
+    idle_samples_ = 0;
+    ++overloaded_samples_;
+  } else if (idle) {
+    overloaded_samples_ = 0;
+    ++idle_samples_;
+  } else {
+    overloaded_samples_ = 0;
+    idle_samples_ = 0;
+  }
+
+  if (overloaded_samples_ >= config_.scale_up_samples &&
+      current < config_.max_workers) {
+    reset();
+    return current + 1;
+  }
+  if (idle_samples_ >= config_.scale_down_samples &&
+      current > config_.min_workers) {
+    reset();
+    return current - 1;
+  }
+  return current;
+}
+
+void WorkerScaler::reset() {
+  overloaded_samples_ = 0;
+  idle_samples_ = 0;
+}
+
+}  // namespace picoradar::core
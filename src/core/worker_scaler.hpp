@@ -0,0 +1,67 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+namespace picoradar::core {
+
+/**
+ * @brief I/O 线程池伸缩策略的参数 (network.workers.*)
+ */
+struct WorkerScalerConfig {
+  std::size_t min_workers = 1;
+  std::size_t max_workers = 1;
+  /// 事件循环延迟超过该值视为过载
+  std::chrono::microseconds scale_up_lag{5000};
+  /// 事件循环延迟低于该值才可能视为空闲
+  std::chrono::microseconds scale_down_lag{1000};
+  /// 每个工作线程的平均 CPU 利用率阈值
+  double scale_up_utilization = 0.75;
+  double scale_down_utilization = 0.25;
+  /// 连续多少个过载/空闲采样后才调整，避免抖动
+  std::size_t scale_up_samples = 2;
+  std::size_t scale_down_samples = 30;
+};
+
+/**
+ * @brief 一次负载采样
+ */
+struct WorkerLoadSample {
+  std::chrono::microseconds loop_lag{0};  ///< 定时任务实际触发比预期晚的时间
+  double utilization = 0.0;  ///< 进程 CPU 时间 / (墙钟时间 × 工作线程数)
+};
+
+/**
+ * @brief 根据事件循环延迟与 CPU 利用率决定 I/O 工作线程数
+ *
+ * 过载时很快扩容（默认连续 2 个采样），空闲时缓慢缩容（默认连续 30 个
+ * 采样），每次只增减一个线程，调整后重新开始计数。
+ * 此类不是线程安全的，由调用方负责同步。
+ */
+class WorkerScaler {
+ public:
+  explicit WorkerScaler(WorkerScalerConfig config);
+
+  /**
+   * @brief 输入一个采样，返回建议的工作线程数
+   *
+   * @param current 当前工作线程数
+   * @return 与 current 相同表示保持不变
+   */
+  auto update(std::size_t current, const WorkerLoadSample& sample)
+      -> std::size_t;
+
+  /// 外部手动调整线程数后清除累计的采样
+  void reset();
+
+  [[nodiscard]] auto getConfig() const -> const WorkerScalerConfig& {
+    return config_;
+  }
+
+ private:
+  WorkerScalerConfig config_;
+  std::size_t overloaded_samples_ = 0;
+  std::size_t idle_samples_ = 0;
+};
+
+}  // namespace picoradar::core
@@ -41,15 +41,23 @@ class ErrorLogger {
  public:
   /**
    * @brief 记录网络错误
+   *
+   * 日志的位置取调用方，而不是本头文件：风暴抑制按调用点计数，读失败的
+   * 风暴不会连带抑制接受连接或 TLS 握手等其他调用点的错误。
    */
   static void logNetworkError(const NetworkContext& ctx,
                               const boost::beast::error_code& ec,
-                              const std::string& additional_info = "") {
+                              const std::string& additional_info = "",
+                              const char* file = __builtin_FILE(),
+                              int line = __builtin_LINE(),
+                              const char* function = __builtin_FUNCTION()) {
     const auto duration = std::chrono::steady_clock::now() - ctx.start_time;
     const auto duration_ms =
         std::chrono::duration_cast<std::chrono::milliseconds>(duration);
 
-    LOG_ERROR << "Network error in " << ctx.operation
+    ::logger::Logger::LogStream(file, line, function,
+                                ::logger::LogLevel::ERROR)
+        << "Network error in " << ctx.operation
               << " operation - Endpoint: " << ctx.endpoint << ", Player: "
               << (ctx.player_id.empty() ? "unauthenticated" : ctx.player_id)
               << ", Duration: " << duration_ms.count() << "ms"
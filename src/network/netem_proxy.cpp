@@ -0,0 +1,431 @@
+#include "network/netem_proxy.hpp"
+
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "common/logging.hpp"
+
+namespace picoradar::network {
+
+namespace {
+constexpr std::size_t kReadChunkSize = 16 * 1024;
+constexpr std::uint32_t kDefaultSeed = 5489U;
+}  // namespace
+
+//------------------------------------------------------------------------------
+// NetemPipe: one direction of a proxied connection
+
+class NetemPipe {
+ public:
+  NetemPipe(NetemConnection& connection, tcp::socket& from, tcp::socket& to,
+            NetemDirection direction);
+
+  void start() { doRead(); }
+  void cancel() { timer_.cancel(); }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Chunk {
+    Clock::time_point due;
+    std::string data;
+  };
+
+  void doRead();
+  void onRead(const boost::system::error_code& ec, std::size_t bytes);
+  void schedule();
+  void onTimer(const boost::system::error_code& ec);
+  void onWrite(const boost::system::error_code& ec, std::size_t bytes);
+
+  NetemConnection& connection_;
+  tcp::socket& from_;
+  tcp::socket& to_;
+  NetemDirection direction_;
+
+  std::array<char, kReadChunkSize> buffer_{};
+  std::deque<Chunk> queue_;
+  std::size_t queued_bytes_ = 0;
+  net::steady_timer timer_;
+  Clock::time_point link_free_;  // 带宽受限时链路空闲的时刻
+  Clock::time_point last_due_;   // 保证字节按序送达
+  bool writing_ = false;
+  bool read_paused_ = false;
+  bool eof_ = false;
+};
+
+//------------------------------------------------------------------------------
+// NetemConnection
+
+class NetemConnection : public std::enable_shared_from_this<NetemConnection> {
+ public:
+  NetemConnection(NetemProxy& proxy, tcp::socket client)
+      : proxy_{proxy},
+        client_{std::move(client)},
+        server_{proxy.ioc_},
+        upstream_{*this, client_, server_, NetemDirection::Upstream},
+        downstream_{*this, server_, client_, NetemDirection::Downstream} {}
+
+  void start(const tcp::endpoint& target) {
+    server_.async_connect(target, [self = shared_from_this()](
+                                      const boost::system::error_code& ec) {
+      if (ec) {
+        LOG_WARNING << "Netem proxy failed to reach target: " << ec.message();
+        self->close(false);
+        return;
+      }
+      boost::system::error_code ignored;
+      self->client_.set_option(tcp::no_delay(true), ignored);
+      self->server_.set_option(tcp::no_delay(true), ignored);
+      self->upstream_.start();
+      self->downstream_.start();
+    });
+  }
+
+  void close(bool dropped) {
+    if (closed_) {
+      return;
+    }
+    closed_ = true;
+
+    // 先更新统计，保证对端观察到断开时计数已经可见
+    const auto self = shared_from_this();
+    proxy_.onConnectionClosed(self, dropped);
+
+    boost::system::error_code ignored;
+    if (dropped) {
+      // 以 RST 结束连接，模拟链路中断而不是正常关闭
+      client_.set_option(net::socket_base::linger(true, 0), ignored);
+      server_.set_option(net::socket_base::linger(true, 0), ignored);
+    }
+    client_.close(ignored);
+    server_.close(ignored);
+    upstream_.cancel();
+    downstream_.cancel();
+  }
+
+  // 两个方向都已正常结束时关闭连接
+  void onPipeFinished() {
+    if (++finished_pipes_ == 2) {
+      close(false);
+    }
+  }
+
+  [[nodiscard]] auto isClosed() const -> bool { return closed_; }
+  auto getProxy() -> NetemProxy& { return proxy_; }
+
+ private:
+  NetemProxy& proxy_;
+  tcp::socket client_;
+  tcp::socket server_;
+  NetemPipe upstream_;
+  NetemPipe downstream_;
+  int finished_pipes_ = 0;
+  bool closed_ = false;
+};
+
+//------------------------------------------------------------------------------
+// NetemPipe implementation
+
+NetemPipe::NetemPipe(NetemConnection& connection, tcp::socket& from,
+                     tcp::socket& to, NetemDirection direction)
+    : connection_{connection},
+      from_{from},
+      to_{to},
+      direction_{direction},
+      timer_{from.get_executor()} {}
+
+void NetemPipe::doRead() {
+  from_.async_read_some(
+      net::buffer(buffer_),
+      [self = connection_.shared_from_this(), this](
+          const boost::system::error_code& ec, std::size_t bytes) {
+        onRead(ec, bytes);
+      });
+}
+
+void NetemPipe::onRead(const boost::system::error_code& ec,
+                       std::size_t bytes) {
+  if (connection_.isClosed()) {
+    return;
+  }
+  if (ec == net::error::eof) {
+    // 对端半关闭：先把已排队的数据送完，再向另一端转发 FIN
+    eof_ = true;
+    if (!writing_) {
+      schedule();
+    }
+    return;
+  }
+  if (ec) {
+    connection_.close(false);
+    return;
+  }
+
+  auto& proxy = connection_.getProxy();
+  const auto profile = proxy.getProfile(direction_);
+  if (profile.drop_probability > 0.0 &&
+      proxy.nextRandom() < profile.drop_probability) {
+    LOG_DEBUG << "Netem proxy dropping connection";
+    connection_.close(true);
+    return;
+  }
+
+  const auto now = Clock::now();
+  auto sent = now;
+  if (profile.bytes_per_sec > 0) {
+    link_free_ =
+        std::max(link_free_, now) +
+        std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(static_cast<double>(bytes) /
+                                          static_cast<double>(
+                                              profile.bytes_per_sec)));
+    sent = link_free_;
+  }
+
+  auto delay = std::chrono::duration_cast<Clock::duration>(profile.latency);
+  if (profile.jitter.count() > 0) {
+    const double offset = (proxy.nextRandom() * 2.0 - 1.0) *
+                          std::chrono::duration<double>(profile.jitter).count();
+    delay += std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(offset));
+  }
+  delay = std::max(delay, Clock::duration::zero());
+  last_due_ = std::max(last_due_, sent + delay);
+
+  queue_.push_back({last_due_, std::string(buffer_.data(), bytes)});
+  queued_bytes_ += bytes;
+  if (!writing_) {
+    schedule();
+  }
+
+  if (queued_bytes_ < NetemProxy::kMaxQueuedBytes) {
+    doRead();
+  } else {
+    read_paused_ = true;  // 停止读取，让发送方感受到背压
+  }
+}
+
+void NetemPipe::schedule() {
+  if (queue_.empty()) {
+    writing_ = false;
+    if (eof_) {
+      boost::system::error_code ignored;
+      to_.shutdown(tcp::socket::shutdown_send, ignored);
+      connection_.onPipeFinished();
+    }
+    return;
+  }
+
+  writing_ = true;
+  timer_.expires_at(
+      std::max(queue_.front().due, connection_.getProxy().getStallUntil()));
+  timer_.async_wait([self = connection_.shared_from_this(),
+                     this](const boost::system::error_code& ec) {
+    onTimer(ec);
+  });
+}
+
+void NetemPipe::onTimer(const boost::system::error_code& ec) {
+  if (ec || connection_.isClosed()) {
+    return;
+  }
+  // 等待期间可能开始了新的停顿
+  if (connection_.getProxy().getStallUntil() > Clock::now()) {
+    schedule();
+    return;
+  }
+
+  // 交给套接字即计为已转发，保证对端读到数据时计数已经可见
+  connection_.getProxy().addBytesForwarded(direction_,
+                                           queue_.front().data.size());
+  net::async_write(to_, net::buffer(queue_.front().data),
+                   [self = connection_.shared_from_this(), this](
+                       const boost::system::error_code& write_ec,
+                       std::size_t bytes) { onWrite(write_ec, bytes); });
+}
+
+void NetemPipe::onWrite(const boost::system::error_code& ec,
+                        std::size_t /*bytes*/) {
+  if (connection_.isClosed()) {
+    return;
+  }
+  if (ec) {
+    connection_.close(false);
+    return;
+  }
+
+  queued_bytes_ -= queue_.front().data.size();
+  queue_.pop_front();
+
+  if (read_paused_ && queued_bytes_ < NetemProxy::kMaxQueuedBytes && !eof_) {
+    read_paused_ = false;
+    doRead();
+  }
+  schedule();
+}
+
+//------------------------------------------------------------------------------
+// NetemProxy implementation
+
+NetemProxy::NetemProxy(std::string target_host, std::uint16_t target_port)
+    : target_host_{std::move(target_host)},
+      target_port_{target_port},
+      acceptor_{ioc_},
+      rng_{kDefaultSeed} {}
+
+NetemProxy::~NetemProxy() { stop(); }
+
+void NetemProxy::start(std::uint16_t listen_port) {
+  if (running_) {
+    throw std::runtime_error("Netem proxy is already running");
+  }
+
+  try {
+    tcp::resolver resolver(ioc_);
+    target_endpoint_ =
+        *resolver
+             .resolve(target_host_, std::to_string(target_port_),
+                      tcp::resolver::numeric_service)
+             .begin();
+
+    const tcp::endpoint endpoint(net::ip::make_address("127.0.0.1"),
+                                 listen_port);
+    acceptor_.open(endpoint.protocol());
+    acceptor_.set_option(net::socket_base::reuse_address(true));
+    acceptor_.bind(endpoint);
+    acceptor_.listen(net::socket_base::max_listen_connections);
+    port_ = acceptor_.local_endpoint().port();
+  } catch (const boost::system::system_error& e) {
+    boost::system::error_code ignored;
+    acceptor_.close(ignored);
+    throw std::runtime_error("Failed to start netem proxy: " +
+                             std::string(e.what()));
+  }
+
+  ioc_.restart();
+  doAccept();
+  thread_ = std::thread([this] { ioc_.run(); });
+  running_ = true;
+
+  LOG_INFO << "Netem proxy listening on 127.0.0.1:" << port_ << " -> "
+           << target_host_ << ":" << target_port_;
+}
+
+void NetemProxy::stop() {
+  if (!running_) {
+    return;
+  }
+
+  net::post(ioc_, [this] {
+    boost::system::error_code ignored;
+    acceptor_.close(ignored);
+    const auto connections = connections_;
+    for (const auto& connection : connections) {
+      connection->close(false);
+    }
+    ioc_.stop();
+  });
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  connections_.clear();
+  running_ = false;
+}
+
+void NetemProxy::doAccept() {
+  acceptor_.async_accept([this](const boost::system::error_code& ec,
+                                tcp::socket socket) {
+    if (ec) {
+      return;  // 停止时接收器被关闭
+    }
+    auto connection =
+        std::make_shared<NetemConnection>(*this, std::move(socket));
+    connections_.insert(connection);
+    ++connection_count_;
+    connection->start(target_endpoint_);
+    doAccept();
+  });
+}
+
+void NetemProxy::onConnectionClosed(
+    const std::shared_ptr<NetemConnection>& connection, bool dropped) {
+  if (connections_.erase(connection) != 0U) {
+    --connection_count_;
+  }
+  if (dropped) {
+    ++dropped_connections_;
+  }
+}
+
+void NetemProxy::setProfile(const NetemProfile& profile) {
+  std::lock_guard lock(profile_mutex_);
+  upstream_ = profile;
+  downstream_ = profile;
+}
+
+void NetemProxy::setProfile(NetemDirection direction,
+                            const NetemProfile& profile) {
+  std::lock_guard lock(profile_mutex_);
+  (direction == NetemDirection::Upstream ? upstream_ : downstream_) = profile;
+}
+
+auto NetemProxy::getProfile(NetemDirection direction) const -> NetemProfile {
+  std::lock_guard lock(profile_mutex_);
+  return direction == NetemDirection::Upstream ? upstream_ : downstream_;
+}
+
+void NetemProxy::setSeed(std::uint32_t seed) {
+  std::lock_guard lock(profile_mutex_);
+  rng_.seed(seed);
+}
+
+auto NetemProxy::nextRandom() -> double {
+  std::lock_guard lock(profile_mutex_);
+  return std::uniform_real_distribution<double>(0.0, 1.0)(rng_);
+}
+
+void NetemProxy::stallFor(std::chrono::milliseconds duration) {
+  const auto until = std::chrono::steady_clock::now() + duration;
+  auto current = stall_until_.load();
+  while (until.time_since_epoch().count() > current &&
+         !stall_until_.compare_exchange_weak(
+             current, until.time_since_epoch().count())) {
+  }
+}
+
+void NetemProxy::dropConnections() {
+  net::post(ioc_, [this] {
+    const auto connections = connections_;
+    for (const auto& connection : connections) {
+      connection->close(true);
+    }
+  });
+}
+
+auto NetemProxy::getStallUntil() const
+    -> std::chrono::steady_clock::time_point {
+  return std::chrono::steady_clock::time_point(
+      std::chrono::steady_clock::duration(stall_until_.load()));
+}
+
+auto NetemProxy::getConnectionCount() const -> std::size_t {
+  return connection_count_;
+}
+
+void NetemProxy::addBytesForwarded(NetemDirection direction,
+                                   std::size_t bytes) {
+  (direction == NetemDirection::Upstream ? upstream_bytes_ : downstream_bytes_)
+      .fetch_add(bytes);
+}
+
+auto NetemProxy::getBytesForwarded(NetemDirection direction) const
+    -> std::size_t {
+  return direction == NetemDirection::Upstream ? upstream_bytes_.load()
+                                               : downstream_bytes_.load();
+}
+
+}  // namespace picoradar::network
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <boost/asio.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+
+namespace picoradar::network {
+
+namespace net = boost::asio;
+using tcp = net::ip::tcp;
+
+class NetemConnection;
+class NetemPipe;
+
+// Impairment applied to one direction of every proxied connection
+struct NetemProfile {
+  std::chrono::milliseconds latency{0};
+  std::chrono::milliseconds jitter{0};  // uniform in [-jitter, +jitter]
+  std::size_t bytes_per_sec = 0;        // 0 = unlimited
+  double drop_probability = 0.0;  // per forwarded chunk; resets connection
+};
+
+enum class NetemDirection : std::uint8_t {
+  Upstream,    ///< client -> server
+  Downstream,  ///< server -> client
+};
+
+// Userspace TCP proxy on loopback that injects latency, jitter, bandwidth
+// caps, stalls and connection drops, for reproducing venue Wi-Fi in tests.
+//
+// Bytes are never reordered or silently discarded (that would corrupt the
+// TCP stream); "drops" reset the whole connection, like a headset losing
+// its association. Each direction buffers at most kMaxQueuedBytes before
+// it stops reading, so a slow link pushes back on the sender exactly like
+// a full socket buffer would.
+//
+// The proxy runs on its own I/O thread; every public method is thread-safe.
+class NetemProxy {
+ public:
+  static constexpr std::size_t kMaxQueuedBytes = 256 * 1024;
+
+  NetemProxy(std::string target_host, std::uint16_t target_port);
+  ~NetemProxy();
+
+  NetemProxy(const NetemProxy&) = delete;
+  auto operator=(const NetemProxy&) -> NetemProxy& = delete;
+
+  // Listen on 127.0.0.1:listen_port (0 = ephemeral) and start forwarding.
+  // Throws std::runtime_error when the port cannot be bound.
+  void start(std::uint16_t listen_port = 0);
+  void stop();
+
+  [[nodiscard]] auto getPort() const -> std::uint16_t { return port_; }
+
+  void setProfile(const NetemProfile& profile);
+  void setProfile(NetemDirection direction, const NetemProfile& profile);
+  [[nodiscard]] auto getProfile(NetemDirection direction) const
+      -> NetemProfile;
+
+  // Seed for jitter and drop decisions, for reproducible runs
+  void setSeed(std::uint32_t seed);
+
+  // Hold all traffic in both directions for the given duration
+  void stallFor(std::chrono::milliseconds duration);
+
+  // Reset every open connection
+  void dropConnections();
+
+  [[nodiscard]] auto getConnectionCount() const -> std::size_t;
+  [[nodiscard]] auto getBytesForwarded(NetemDirection direction) const
+      -> std::size_t;
+  [[nodiscard]] auto getDroppedConnections() const -> std::size_t {
+    return dropped_connections_;
+  }
+
+ private:
+  friend class NetemConnection;
+  friend class NetemPipe;
+
+  void doAccept();
+  void onConnectionClosed(const std::shared_ptr<NetemConnection>& connection,
+                          bool dropped);
+
+  // Uniform sample in [0, 1) from the seeded generator
+  auto nextRandom() -> double;
+  auto getStallUntil() const -> std::chrono::steady_clock::time_point;
+  void addBytesForwarded(NetemDirection direction, std::size_t bytes);
+
+  std::string target_host_;
+  std::uint16_t target_port_;
+  std::uint16_t port_ = 0;
+
+  net::io_context ioc_;
+  tcp::acceptor acceptor_;
+  tcp::endpoint target_endpoint_;
+  std::thread thread_;
+  bool running_ = false;
+
+  mutable std::mutex profile_mutex_;  // guards profiles and rng_
+  NetemProfile upstream_;
+  NetemProfile downstream_;
+  std::mt19937 rng_;
+
+  std::atomic<std::chrono::steady_clock::rep> stall_until_{0};
+  std::set<std::shared_ptr<NetemConnection>> connections_;  // I/O thread
+  std::atomic<std::size_t> connection_count_{0};
+  std::atomic<std::size_t> upstream_bytes_{0};
+  std::atomic<std::size_t> downstream_bytes_{0};
+  std::atomic<std::size_t> dropped_connections_{0};
+};
+
+}  // namespace picoradar::network
@@ -0,0 +1,323 @@
+#include "network/simulation_harness.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "common/config_manager.hpp"
+#include "common/logging.hpp"
+
+namespace picoradar::network {
+
+namespace {
+constexpr auto kDefaultTick = std::chrono::milliseconds(10);
+}  // namespace
+
+//------------------------------------------------------------------------------
+// LoopbackSession implementation
+
+LoopbackSession::LoopbackSession(WebsocketServer& server, std::string endpoint)
+    : Session{server}, endpoint_{std::move(endpoint)} {}
+
+void LoopbackSession::send(const std::string& message) {
+  server().incrementMessagesSent();
+
+  std::lock_guard lock(mutex_);
+  if (closed_) {
+    return;
+  }
+  outbox_.push_back(message);
+  queued_at_.push_back(server().getClock().now());
+  queued_bytes_ += message.size();
+  bytes_sent_ += message.size();
+}
+
+void LoopbackSession::close(std::function<void()> on_closed) {
+  {
+    std::lock_guard lock(mutex_);
+    closed_ = true;
+  }
+  if (on_closed) {
+    on_closed();
+  }
+}
+
+auto LoopbackSession::drain(std::size_t byte_budget,
+                            std::size_t link_bytes_per_sec)
+    -> std::vector<std::string> {
+  std::vector<std::string> frames;
+  std::vector<std::chrono::steady_clock::time_point> queued_at;
+  bool backlogged = false;
+  {
+    std::lock_guard lock(mutex_);
+    while (!outbox_.empty() && outbox_.front().size() <= byte_budget) {
+      byte_budget -= outbox_.front().size();
+      queued_bytes_ -= outbox_.front().size();
+      frames.push_back(std::move(outbox_.front()));
+      queued_at.push_back(queued_at_.front());
+      outbox_.pop_front();
+      queued_at_.pop_front();
+    }
+    backlogged = !outbox_.empty();
+  }
+
+  // 与真实会话一样，把每次“写完成”交给带宽估算
+  for (std::size_t i = 0; i < frames.size(); ++i) {
+    const auto elapsed =
+        link_bytes_per_sec == 0
+            ? std::chrono::steady_clock::duration::zero()
+            : std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                  std::chrono::duration<double>(
+                      static_cast<double>(frames[i].size()) /
+                      static_cast<double>(link_bytes_per_sec)));
+    onWriteCompleted(frames[i].size(), elapsed,
+                     backlogged || i + 1 < frames.size(),
+                     server().getClock().now() - queued_at[i]);
+  }
+  return frames;
+}
+
+auto LoopbackSession::isClosed() const -> bool {
+  std::lock_guard lock(mutex_);
+  return closed_;
+}
+
+auto LoopbackSession::getQueueDepth() const -> std::size_t {
+  std::lock_guard lock(mutex_);
+  return outbox_.size();
+}
+
+auto LoopbackSession::getQueuedBytes() const -> std::size_t {
+  std::lock_guard lock(mutex_);
+  return queued_bytes_;
+}
+
+auto LoopbackSession::getBytesSent() const -> std::size_t {
+  std::lock_guard lock(mutex_);
+  return bytes_sent_;
+}
+
+//------------------------------------------------------------------------------
+// TickTrace
+
+auto TickTrace::operator==(const TickTrace& other) const -> bool {
+  return time == other.time && messages_received == other.messages_received &&
+         frames_sent == other.frames_sent && bytes_sent == other.bytes_sent &&
+         bytes_delivered == other.bytes_delivered &&
+         max_queue_depth == other.max_queue_depth &&
+         total_queue_depth == other.total_queue_depth;
+}
+
+//------------------------------------------------------------------------------
+// SimulationHarness implementation
+
+SimulationHarness::SimulationHarness() : SimulationHarness(kDefaultTick) {}
+
+SimulationHarness::SimulationHarness(std::chrono::milliseconds tick)
+    : tick_{tick.count() > 0 ? tick : kDefaultTick},
+      server_{std::make_unique<WebsocketServer>(ioc_, registry_, clock_)} {
+  server_->configure();
+  tasks_ = server_->getPeriodicTasks();
+  for (const auto& task : tasks_) {
+    next_due_.push_back(task.interval);
+  }
+}
+
+SimulationHarness::~SimulationHarness() = default;
+
+void SimulationHarness::connect(const std::string& player_id,
+                                std::size_t link_bytes_per_sec,
+                                picoradar::SessionClass session_class,
+                                bool supports_compact_encoding) {
+  if (openSession(player_id, link_bytes_per_sec) == nullptr) {
+    return;
+  }
+
+  picoradar::ClientToServer message;
+  auto* auth = message.mutable_auth_request();
+  auth->set_player_id(player_id);
+  auth->set_session_class(session_class);
+  auth->set_supports_compact_encoding(supports_compact_encoding);
+  auth->set_token(common::ConfigManager::getInstance()
+                      .getString("auth.token")
+                      .value_or(""));
+  send(player_id, message);
+}
+
+void SimulationHarness::attach(
+    const std::string& player_id,
+    std::function<void(const std::string& frame)> on_frame,
+    std::function<void()> on_close, std::size_t link_bytes_per_sec) {
+  if (auto* client = openSession(player_id, link_bytes_per_sec)) {
+    client->on_frame = std::move(on_frame);
+    client->on_close = std::move(on_close);
+  }
+}
+
+auto SimulationHarness::openSession(const std::string& player_id,
+                                    std::size_t link_bytes_per_sec)
+    -> SimulatedClient* {
+  auto& client = clients_[player_id];
+  if (client.session) {
+    return nullptr;
+  }
+  client.session =
+      std::make_shared<LoopbackSession>(*server_, "loopback:" + player_id);
+  client.link_bytes_per_sec = link_bytes_per_sec;
+  server_->onSessionOpened(client.session);
+  return &client;
+}
+
+void SimulationHarness::setLink(const std::string& player_id,
+                                std::size_t link_bytes_per_sec) {
+  if (auto it = clients_.find(player_id); it != clients_.end()) {
+    it->second.link_bytes_per_sec = link_bytes_per_sec;
+  }
+}
+
+void SimulationHarness::disconnect(const std::string& player_id) {
+  auto it = clients_.find(player_id);
+  if (it == clients_.end()) {
+    return;
+  }
+  retired_bytes_ += it->second.session->getBytesSent();
+  server_->onSessionClosed(it->second.session);
+  clients_.erase(it);
+}
+
+void SimulationHarness::send(const std::string& player_id,
+                             const picoradar::ClientToServer& message) {
+  sendFrame(player_id, message.SerializeAsString());
+}
+
+void SimulationHarness::sendFrame(const std::string& player_id,
+                                  const std::string& frame) {
+  auto it = clients_.find(player_id);
+  if (it == clients_.end() || it->second.session->isClosed()) {
+    LOG_WARNING << "Simulated client " << player_id << " is not connected";
+    return;
+  }
+  server_->processMessage(it->second.session, frame);
+}
+
+void SimulationHarness::sendPose(const std::string& player_id,
+                                 const picoradar::PlayerData& pose) {
+  picoradar::ClientToServer message;
+  *message.mutable_player_data() = pose;
+  send(player_id, message);
+}
+
+void SimulationHarness::advance(
+    std::chrono::milliseconds duration,
+    const std::function<void(std::chrono::milliseconds)>& on_tick) {
+  const auto end = elapsed_ + duration;
+  while (elapsed_ < end) {
+    if (on_tick) {
+      on_tick(elapsed_);
+    }
+
+    clock_.advance(tick_);
+    elapsed_ += tick_;
+    runDueTasks();
+
+    TickTrace trace;
+    trace.time = elapsed_;
+    const auto received = server_->getMessagesReceived();
+    const auto sent = server_->getMessagesSent();
+    const auto bytes = getTotalBytesSent();
+    trace.messages_received = received - last_received_;
+    trace.frames_sent = sent - last_sent_;
+    trace.bytes_sent = bytes - last_bytes_;
+    last_received_ = received;
+    last_sent_ = sent;
+    last_bytes_ = bytes;
+
+    deliver(trace);
+    trace_.push_back(trace);
+  }
+}
+
+void SimulationHarness::runDueTasks() {
+  for (std::size_t i = 0; i < tasks_.size(); ++i) {
+    while (next_due_[i] <= elapsed_) {
+      (server_.get()->*tasks_[i].run)();
+      next_due_[i] += tasks_[i].interval;
+    }
+  }
+}
+
+void SimulationHarness::deliver(TickTrace& trace) {
+  const double tick_seconds = std::chrono::duration<double>(tick_).count();
+
+  for (auto it = clients_.begin(); it != clients_.end();) {
+    auto& client = it->second;
+
+    auto budget = std::numeric_limits<std::size_t>::max();
+    if (client.link_bytes_per_sec > 0) {
+      // 空闲链路不积累额度，大于单个 tick 额度的帧需要多个 tick 才能送达
+      if (client.session->getQueueDepth() == 0) {
+        client.credit = 0.0;
+      } else {
+        client.credit +=
+            static_cast<double>(client.link_bytes_per_sec) * tick_seconds;
+      }
+      budget = static_cast<std::size_t>(client.credit);
+    }
+
+    for (const auto& frame :
+         client.session->drain(budget, client.link_bytes_per_sec)) {
+      trace.bytes_delivered += frame.size();
+      client.credit = std::max(
+          0.0, client.credit - static_cast<double>(frame.size()));
+      ++client.frames_delivered;
+
+      if (client.on_frame) {
+        client.on_frame(frame);
+      }
+      if (on_frame_) {
+        picoradar::ServerToClient message;
+        if (message.ParseFromString(frame)) {
+          on_frame_(it->first, message);
+        }
+      }
+    }
+
+    const auto depth = client.session->getQueueDepth();
+    trace.max_queue_depth = std::max(trace.max_queue_depth, depth);
+    trace.total_queue_depth += depth;
+
+    // 服务器主动关闭的会话（例如认证失败）在本 tick 结束时断开
+    if (client.session->isClosed()) {
+      if (client.on_close) {
+        client.on_close();
+      }
+      retired_bytes_ += client.session->getBytesSent();
+      server_->onSessionClosed(client.session);
+      it = clients_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+auto SimulationHarness::getFramesDelivered(const std::string& player_id) const
+    -> std::size_t {
+  auto it = clients_.find(player_id);
+  return it == clients_.end() ? 0 : it->second.frames_delivered;
+}
+
+auto SimulationHarness::getSession(const std::string& player_id) const
+    -> std::shared_ptr<LoopbackSession> {
+  auto it = clients_.find(player_id);
+  return it == clients_.end() ? nullptr : it->second.session;
+}
+
+auto SimulationHarness::getTotalBytesSent() const -> std::size_t {
+  std::size_t total = retired_bytes_;
+  for (const auto& [player_id, client] : clients_) {
+    total += client.session->getBytesSent();
+  }
+  return total;
+}
+
+}  // namespace picoradar::network
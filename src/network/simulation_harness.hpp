@@ -0,0 +1,173 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "client.pb.h"
+#include "common/clock.hpp"
+#include "core/player_registry.hpp"
+#include "network/websocket_server.hpp"
+#include "server.pb.h"
+
+namespace picoradar::network {
+
+// In-memory session: frames sent by the server are queued until the
+// simulated client drains them, instead of being written to a socket.
+class LoopbackSession : public Session {
+ public:
+  LoopbackSession(WebsocketServer& server, std::string endpoint);
+
+  void send(const std::string& message) override;
+  using Session::close;
+  void close(std::function<void()> on_closed) override;
+  std::string getSafeEndpoint() const override { return endpoint_; }
+
+  // Pop the queued frames that fit into byte_budget and report each one
+  // to the bandwidth estimator as a write over a link_bytes_per_sec link
+  // (0 = instantaneous)
+  auto drain(std::size_t byte_budget, std::size_t link_bytes_per_sec)
+      -> std::vector<std::string>;
+
+  [[nodiscard]] auto isClosed() const -> bool;
+  [[nodiscard]] auto getQueueDepth() const -> std::size_t override;
+  [[nodiscard]] auto getQueuedBytes() const -> std::size_t;
+  [[nodiscard]] auto getBytesSent() const -> std::size_t;
+
+ private:
+  std::string endpoint_;
+  mutable std::mutex mutex_;
+  std::deque<std::string> outbox_;
+  std::deque<std::chrono::steady_clock::time_point> queued_at_;
+  std::size_t queued_bytes_ = 0;
+  std::size_t bytes_sent_ = 0;
+  bool closed_ = false;
+};
+
+// Server activity during one virtual-time tick
+struct TickTrace {
+  std::chrono::milliseconds time{0};  // virtual time since harness start
+  std::size_t messages_received = 0;  // client -> server
+  std::size_t frames_sent = 0;        // server -> client, queued
+  std::size_t bytes_sent = 0;
+  std::size_t bytes_delivered = 0;
+  std::size_t max_queue_depth = 0;  // deepest per-client queue after tick
+  std::size_t total_queue_depth = 0;
+
+  auto operator==(const TickTrace& other) const -> bool;
+};
+
+// Drives a WebsocketServer over loopback sessions in virtual time. Each tick
+// advances a ManualClock, runs the server's periodic tasks that became due,
+// and delivers queued frames over per-client simulated links, so a long
+// scenario runs as fast as the CPU allows and produces the same trace on
+// every run. Not thread-safe: one thread drives the whole simulation.
+class SimulationHarness {
+ public:
+  SimulationHarness();
+  explicit SimulationHarness(std::chrono::milliseconds tick);
+  ~SimulationHarness();
+
+  // Connect a client and send its auth request (token from auth.token).
+  // link_bytes_per_sec = 0 models an unconstrained link.
+  void connect(const std::string& player_id,
+               std::size_t link_bytes_per_sec = 0,
+               picoradar::SessionClass session_class =
+                   picoradar::SESSION_CLASS_PLAYER,
+               bool supports_compact_encoding = false);
+  // Connect a client that speaks the wire protocol itself, e.g. a
+  // client::Client over an in-memory transport: no auth request is sent,
+  // delivered frames are handed to on_frame unparsed, and on_close runs when
+  // the server closes the session. The callbacks run inside advance() and
+  // may send, but must not connect or disconnect clients.
+  void attach(const std::string& player_id,
+              std::function<void(const std::string& frame)> on_frame,
+              std::function<void()> on_close,
+              std::size_t link_bytes_per_sec = 0);
+  // Change a connected client's link speed, e.g. to model Wi-Fi fading
+  void setLink(const std::string& player_id, std::size_t link_bytes_per_sec);
+  void disconnect(const std::string& player_id);
+
+  void send(const std::string& player_id,
+            const picoradar::ClientToServer& message);
+  // Hand a serialized ClientToServer message to the server
+  void sendFrame(const std::string& player_id, const std::string& frame);
+  void sendPose(const std::string& player_id,
+                const picoradar::PlayerData& pose);
+
+  // Advance virtual time, calling on_tick at the start of every tick
+  // with the elapsed virtual time so scenarios can inject client traffic
+  void advance(std::chrono::milliseconds duration,
+               const std::function<void(std::chrono::milliseconds)>& on_tick =
+                   nullptr);
+
+  // Parse and hand every delivered frame to callback (off by default to
+  // keep long runs cheap)
+  void setOnFrame(std::function<void(const std::string& player_id,
+                                     const picoradar::ServerToClient& frame)>
+                      callback) {
+    on_frame_ = std::move(callback);
+  }
+
+  [[nodiscard]] auto getTrace() const -> const std::vector<TickTrace>& {
+    return trace_;
+  }
+  [[nodiscard]] auto getElapsed() const -> std::chrono::milliseconds {
+    return elapsed_;
+  }
+  [[nodiscard]] auto getFramesDelivered(const std::string& player_id) const
+      -> std::size_t;
+  // The server-side session of a connected client, nullptr otherwise
+  [[nodiscard]] auto getSession(const std::string& player_id) const
+      -> std::shared_ptr<LoopbackSession>;
+
+  auto getServer() -> WebsocketServer& { return *server_; }
+  auto getRegistry() -> core::PlayerRegistry& { return registry_; }
+  auto getClock() const -> const common::ManualClock& { return clock_; }
+
+ private:
+  struct SimulatedClient {
+    std::shared_ptr<LoopbackSession> session;
+    std::size_t link_bytes_per_sec = 0;
+    double credit = 0.0;  // bytes the link may still carry
+    std::size_t frames_delivered = 0;
+    std::function<void(const std::string&)> on_frame;  // attached clients
+    std::function<void()> on_close;
+  };
+
+  auto openSession(const std::string& player_id,
+                   std::size_t link_bytes_per_sec) -> SimulatedClient*;
+  void runDueTasks();
+  void deliver(TickTrace& trace);
+  [[nodiscard]] auto getTotalBytesSent() const -> std::size_t;
+
+  std::chrono::milliseconds tick_;
+  common::ManualClock clock_;
+  net::io_context ioc_;  // never run; sessions do no real I/O
+  core::PlayerRegistry registry_;
+  std::unique_ptr<WebsocketServer> server_;
+
+  std::vector<WebsocketServer::PeriodicTask> tasks_;
+  std::vector<std::chrono::milliseconds> next_due_;
+  std::map<std::string, SimulatedClient> clients_;  // ordered for replay
+  std::chrono::milliseconds elapsed_{0};
+  std::vector<TickTrace> trace_;
+
+  // Counters at the end of the previous tick, so traffic injected between
+  // ticks is attributed to the next one
+  std::size_t last_received_ = 0;
+  std::size_t last_sent_ = 0;
+  std::size_t last_bytes_ = 0;
+  std::size_t retired_bytes_ = 0;  // bytes sent to disconnected clients
+
+  std::function<void(const std::string&, const picoradar::ServerToClient&)>
+      on_frame_;
+};
+
+}  // namespace picoradar::network
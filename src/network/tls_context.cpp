@@ -0,0 +1,72 @@
+#include "network/tls_context.hpp"
+
+#include <openssl/ssl.h>
+
+#include <stdexcept>
+
+#include "common/logging.hpp"
+
+namespace picoradar::network {
+
+namespace {
+// TLS 1.3 suites in preference order; TLS 1.2 falls back to the list below
+constexpr auto kCipherSuites =
+    "TLS_AES_128_GCM_SHA256:TLS_AES_256_GCM_SHA384:"
+    "TLS_CHACHA20_POLY1305_SHA256";
+constexpr auto kCipherList =
+    "ECDHE-ECDSA-AES128-GCM-SHA256:ECDHE-RSA-AES128-GCM-SHA256:"
+    "ECDHE-ECDSA-AES256-GCM-SHA384:ECDHE-RSA-AES256-GCM-SHA384:"
+    "ECDHE-ECDSA-CHACHA20-POLY1305:ECDHE-RSA-CHACHA20-POLY1305";
+// Scopes cached sessions to this service
+constexpr unsigned char kSessionIdContext[] = "picoradar";
+}  // namespace
+
+auto makeServerTlsContext(const TlsConfig& config)
+    -> std::unique_ptr<ssl::context> {
+  auto context = std::make_unique<ssl::context>(ssl::context::tls_server);
+  context->set_options(ssl::context::default_workarounds |
+                       ssl::context::no_sslv2 | ssl::context::no_sslv3 |
+                       ssl::context::no_tlsv1 | ssl::context::no_tlsv1_1 |
+                       ssl::context::single_dh_use);
+
+  boost::system::error_code ec;
+  context->use_certificate_chain_file(config.certificate_file, ec);
+  if (ec) {
+    throw std::runtime_error("Failed to load TLS certificate '" +
+                             config.certificate_file + "': " + ec.message());
+  }
+  context->use_private_key_file(config.private_key_file, ssl::context::pem,
+                                ec);
+  if (ec) {
+    throw std::runtime_error("Failed to load TLS private key '" +
+                             config.private_key_file + "': " + ec.message());
+  }
+
+  auto* native = context->native_handle();
+  if (SSL_CTX_check_private_key(native) != 1) {
+    throw std::runtime_error("TLS private key does not match certificate");
+  }
+  SSL_CTX_set_ciphersuites(native, kCipherSuites);
+  SSL_CTX_set_cipher_list(native, kCipherList);
+  SSL_CTX_set_options(native, SSL_OP_CIPHER_SERVER_PREFERENCE);
+
+  // Idle sessions give their read/write buffers back to the allocator;
+  // most headsets are quiet between pose bursts
+  SSL_CTX_set_mode(native, SSL_MODE_RELEASE_BUFFERS);
+
+  SSL_CTX_set_session_id_context(native, kSessionIdContext,
+                                 sizeof(kSessionIdContext) - 1);
+  SSL_CTX_set_session_cache_mode(native, SSL_SESS_CACHE_SERVER);
+  SSL_CTX_set_timeout(native,
+                      static_cast<long>(config.session_timeout.count()));
+  if (!config.session_tickets) {
+    SSL_CTX_set_options(native, SSL_OP_NO_TICKET);
+  }
+
+  LOG_INFO << "TLS enabled (session tickets "
+           << (config.session_tickets ? "on" : "off") << ", lifetime "
+           << config.session_timeout.count() << "s)";
+  return context;
+}
+
+}  // namespace picoradar::network
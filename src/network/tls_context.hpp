@@ -0,0 +1,32 @@
+#pragma once
+
+#include <boost/asio/ssl.hpp>
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "common/constants.hpp"
+
+namespace picoradar::network {
+
+namespace ssl = boost::asio::ssl;
+
+// Server-side TLS settings (network.tls.*)
+struct TlsConfig {
+  bool enabled = false;
+  std::string certificate_file;  // PEM chain, leaf first
+  std::string private_key_file;  // PEM
+  // Stateless session tickets let reconnecting headsets resume with an
+  // abbreviated handshake instead of a full key exchange
+  bool session_tickets = true;
+  std::chrono::seconds session_timeout = constants::kDefaultTlsSessionTimeout;
+};
+
+// Build the server context shared by every TLS session: TLS 1.2+, AES-GCM
+// preferred over ChaCha20 (hardware AES is cheaper per byte on the x86 and
+// ARM hosts we deploy to), server cipher preference, resumption enabled.
+// Throws std::runtime_error when the certificate or key cannot be loaded.
+auto makeServerTlsContext(const TlsConfig& config)
+    -> std::unique_ptr<ssl::context>;
+
+}  // namespace picoradar::network
@@ -2,17 +2,107 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <unordered_map>
+
 #include "client.pb.h"
 #include "common/config_manager.hpp"
 #include "common/constants.hpp"
+#include "common/flight_recorder.hpp"
 #include "common/logging.hpp"
-#include "common/platform_fixes.hpp"
+#include "common/process_utils.hpp"
+#include "common/platform_fixes.hpp"  // 在 Windows 头文件之后清理冲突的宏
+#include "core/wire_format.hpp"
 #include "network/error_context.hpp"
 #include "player.pb.h"
 #include "server.pb.h"
 
 namespace picoradar::network {
 
+namespace {
+// 工作线程每次运行事件循环的最长时间，也是缩容后线程退出的最大延迟
+constexpr auto kWorkerRetireCheck = std::chrono::milliseconds(100);
+// stop() 等待会话关闭套接字的最长时间，之后不再等待直接停止 io_context
+constexpr auto kSessionCloseTimeout = std::chrono::seconds(1);
+
+// 把作用域内的耗时计入流水线阶段；同一线程上嵌套的阶段从外层扣除，
+// 因此每个阶段只计独占时间。给出 span 时同时向飞行记录器写入追踪区间
+class StageTimer {
+ public:
+  explicit StageTimer(std::atomic<std::uint64_t>& total_ns,
+                      const char* span = nullptr)
+      : total_ns_(total_ns),
+        span_(span),
+        outer_(current_),
+        started_(std::chrono::steady_clock::now()) {
+    current_ = this;
+  }
+  ~StageTimer() {
+    const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - started_);
+    const auto elapsed = static_cast<std::uint64_t>(duration.count());
+    total_ns_.fetch_add(elapsed - std::min(elapsed, nested_ns_),
+                        std::memory_order_relaxed);
+    if (outer_ != nullptr) {
+      outer_->nested_ns_ += elapsed;
+    }
+    current_ = outer_;
+    if (span_ != nullptr) {
+      common::FlightRecorder::getInstance().recordSpan(
+          span_,
+          std::chrono::time_point_cast<std::chrono::system_clock::duration>(
+              std::chrono::system_clock::now() - duration),
+          std::chrono::duration_cast<std::chrono::microseconds>(duration));
+    }
+  }
+
+  StageTimer(const StageTimer&) = delete;
+  auto operator=(const StageTimer&) -> StageTimer& = delete;
+
+ private:
+  inline static thread_local StageTimer* current_ = nullptr;
+
+  std::atomic<std::uint64_t>& total_ns_;
+  const char* span_;
+  StageTimer* outer_;
+  std::chrono::steady_clock::time_point started_;
+  std::uint64_t nested_ns_ = 0;
+};
+
+// 槽位越界或重复的追踪部位
+auto hasInvalidBodies(const picoradar::PlayerData& data) -> bool {
+  std::uint32_t seen = 0;
+  for (const auto& body : data.bodies()) {
+    if (body.slot() >= core::kMaxTrackedBodies ||
+        (seen & (1U << body.slot())) != 0) {
+      return true;
+    }
+    seen |= 1U << body.slot();
+  }
+  return false;
+}
+
+// 丢弃越界槽位，重复槽位保留最后一个，与 PoseCodec 的取舍一致
+void trimBodies(picoradar::PlayerData& data) {
+  std::array<int, core::kMaxTrackedBodies> latest{};
+  latest.fill(-1);
+  for (int i = 0; i < data.bodies_size(); ++i) {
+    if (data.bodies(i).slot() < core::kMaxTrackedBodies) {
+      latest[data.bodies(i).slot()] = i;
+    }
+  }
+  google::protobuf::RepeatedPtrField<picoradar::TrackedBody> kept;
+  for (const int index : latest) {
+    if (index >= 0) {
+      *kept.Add() = data.bodies(index);
+    }
+  }
+  data.mutable_bodies()->Swap(&kept);
+}
+}  // namespace
+
 //------------------------------------------------------------------------------
 // Listener implementation
 
@@ -23,10 +113,24 @@ void Listener::on_accept(beast::error_code ec) {
     return;
   }
 
+  // 位姿帧对延迟敏感，关闭 Nagle，避免与对端的延迟确认叠加出数十毫秒停顿
+  beast::error_code ignored;
+  socket_.set_option(tcp::no_delay(true), ignored);
+
   // Create the session and run it
-  auto session = std::make_shared<Session>(std::move(socket_), server_);
+  std::shared_ptr<Session> session;
+  if (tls_ != nullptr) {
+    auto secure = std::make_shared<SecureWebsocketSession>(std::move(socket_),
+                                                           server_, *tls_);
+    secure->run();
+    session = std::move(secure);
+  } else {
+    auto plain =
+        std::make_shared<WebsocketSession>(std::move(socket_), server_);
+    plain->run();
+    session = std::move(plain);
+  }
   server_.onSessionOpened(session);
-  session->run();
 
   // Accept another connection
   do_accept();
@@ -35,47 +139,188 @@ void Listener::on_accept(beast::error_code ec) {
 //------------------------------------------------------------------------------
 // Session implementation
 
-Session::Session(tcp::socket&& socket, WebsocketServer& server)
-    : ws_{std::move(socket)}, server_{server}, strand_{ws_.get_executor()} {}
+Session::Session(WebsocketServer& server)
+    : server_{&server},
+      budget_{server.getBandwidthConfig().bytes_per_sec,
+              server.getBandwidthConfig().estimate} {}
+
+void Session::onWriteCompleted(
+    std::size_t bytes, std::chrono::steady_clock::duration elapsed,
+    bool backlogged, std::chrono::steady_clock::duration queued_for) {
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+
+  server().onWriteTimed(elapsed);
+  std::lock_guard lock(pacing_mutex_);
+  budget_.onWriteCompleted(bytes, elapsed, backlogged);
+  if (!encoding_selector_) {
+    return;
+  }
 
-void Session::run() {
-  net::dispatch(strand_, beast::bind_front_handler(&Session::do_accept,
-                                                   shared_from_this()));
+  const auto previous = encoding_selector_->getTier();
+  const auto tier = encoding_selector_->onDelivered(
+      duration_cast<microseconds>(queued_for),
+      duration_cast<microseconds>(elapsed), budget_.getRate());
+  if (tier == previous) {
+    return;
+  }
+  encoding_tier_ = tier;
+  server().onEncodingTierChanged(previous, tier);
+
+  const auto& estimate = encoding_selector_->getEstimate();
+  LOG_INFO << fmt::format(
+      "Roster encoding for {}: {} -> {} (latency {} ms, rtt {} ms, "
+      "throughput {} B/s, stalls {})",
+      player_id_, core::encodingTierName(previous),
+      core::encodingTierName(tier), estimate.latency.count() / 1000,
+      estimate.rtt.count() / 1000, estimate.throughput, estimate.stalls);
 }
 
-void Session::do_accept() {
+void Session::onRttMeasured(std::chrono::steady_clock::duration rtt) {
+  std::lock_guard lock(pacing_mutex_);
+  if (encoding_selector_) {
+    encoding_selector_->onRtt(
+        std::chrono::duration_cast<std::chrono::microseconds>(rtt));
+  }
+}
+
+void Session::enableAdaptiveEncoding(
+    const core::EncodingSelectorConfig& config,
+    std::vector<core::EncodingTier> ladder) {
+  std::lock_guard lock(pacing_mutex_);
+  if (encoding_selector_) {
+    // 重新鉴权时从新阶梯的第一级重新开始
+    server().onEncodingTierChanged(encoding_selector_->getTier(),
+                                   std::nullopt);
+  }
+  encoding_selector_.emplace(config, std::move(ladder));
+  encoding_tier_ = encoding_selector_->getTier();
+  using Rep = std::chrono::milliseconds::rep;
+  probe_interval_ms_ = std::max<Rep>(1, config.probe_interval.count());
+  server().onEncodingTierChanged(std::nullopt, encoding_tier_.load());
+}
+
+void Session::disableAdaptiveEncoding() {
+  std::lock_guard lock(pacing_mutex_);
+  if (!encoding_selector_) {
+    return;
+  }
+  server().onEncodingTierChanged(encoding_selector_->getTier(), std::nullopt);
+  encoding_selector_.reset();
+  probe_interval_ms_ = 0;
+}
+
+auto Session::getLinkEstimate() const -> std::optional<core::LinkEstimate> {
+  std::lock_guard lock(pacing_mutex_);
+  if (!encoding_selector_) {
+    return std::nullopt;
+  }
+  return encoding_selector_->getEstimate();
+}
+
+//------------------------------------------------------------------------------
+// WebsocketSession implementation
+
+template <class NextLayer>
+template <class F>
+auto BasicWebsocketSession<NextLayer>::bindToStrand(F&& f) {
+  // 套接字的执行器是 io_context 本身，完成处理器必须显式绑定到 strand_，
+  // 否则会与投递到 strand_ 的发送并发访问流
+  return net::bind_executor(strand_, std::forward<F>(f));
+}
+
+template <class NextLayer>
+void BasicWebsocketSession<NextLayer>::run() {
+  net::dispatch(strand_, beast::bind_front_handler(
+                             &BasicWebsocketSession::do_accept, self()));
+}
+
+template <class NextLayer>
+void BasicWebsocketSession<NextLayer>::do_accept() {
+  if constexpr (kSecure) {
+    if (!tls_established_) {
+      do_tls_handshake();
+      return;
+    }
+  }
+
   // 设置握手超时
   beast::get_lowest_layer(ws_).expires_after(std::chrono::seconds(1));
 
-  ws_.async_accept(
-      beast::bind_front_handler(&Session::on_accept, shared_from_this()));
+  ws_.async_accept(bindToStrand(
+      beast::bind_front_handler(&BasicWebsocketSession::on_accept, self())));
+}
+
+template <class NextLayer>
+void BasicWebsocketSession<NextLayer>::do_tls_handshake() {
+  if constexpr (kSecure) {
+    // TLS 与 WebSocket 握手各自有 1 秒超时
+    beast::get_lowest_layer(ws_).expires_after(std::chrono::seconds(1));
+    ws_.next_layer().async_handshake(
+        ssl::stream_base::server,
+        bindToStrand(beast::bind_front_handler(
+            &BasicWebsocketSession::on_tls_handshake, self())));
+  }
+}
+
+template <class NextLayer>
+void BasicWebsocketSession<NextLayer>::on_tls_handshake(beast::error_code ec) {
+  if constexpr (kSecure) {
+    if (ec) {
+      NetworkContext ctx("tls_handshake", getSafeEndpoint());
+      ErrorLogger::logNetworkError(ctx, ec, "TLS handshake failed");
+      server().onSessionClosed(shared_from_this());
+      return;
+    }
+
+    server().onTlsHandshake(
+        SSL_session_reused(ws_.next_layer().native_handle()) == 1);
+    tls_established_ = true;
+    do_accept();
+  }
 }
 
-void Session::on_accept(beast::error_code ec) {
+template <class NextLayer>
+void BasicWebsocketSession<NextLayer>::on_accept(beast::error_code ec) {
   auto endpoint = getSafeEndpoint();
   NetworkContext ctx("accept", endpoint);
   ctx.player_id = player_id_;
 
   if (ec) {
     ErrorLogger::logNetworkError(ctx, ec, "WebSocket handshake failed");
-    server_.onSessionClosed(shared_from_this());
+    server().onSessionClosed(shared_from_this());
     return;
   }
 
   // 关闭超时，允许长连接
   beast::get_lowest_layer(ws_).expires_never();
 
+  // 控制帧回调在读操作中执行，与 on_read 位于同一 strand
+  ws_.control_callback(
+      [this](websocket::frame_type kind, beast::string_view /*payload*/) {
+        if (kind == websocket::frame_type::pong) {
+          on_pong();
+        }
+      });
+
   ErrorLogger::logOperationSuccess(ctx);
+  accepted_ = true;
+  if (!write_queue_.empty()) {
+    do_write();
+  }
   do_read();
 }
 
-void Session::do_read() {
+template <class NextLayer>
+void BasicWebsocketSession<NextLayer>::do_read() {
   ws_.binary(true);
-  ws_.async_read(buffer_, beast::bind_front_handler(&Session::on_read,
-                                                    shared_from_this()));
+  ws_.async_read(buffer_, bindToStrand(beast::bind_front_handler(
+                              &BasicWebsocketSession::on_read, self())));
 }
 
-void Session::on_read(beast::error_code ec, std::size_t bytes_transferred) {
+template <class NextLayer>
+void BasicWebsocketSession<NextLayer>::on_read(
+    beast::error_code ec, std::size_t bytes_transferred) {
   auto endpoint = getSafeEndpoint();
   NetworkContext ctx("read", endpoint);
   ctx.player_id = player_id_;
@@ -85,10 +330,12 @@ void Session::on_read(beast::error_code ec, std::size_t bytes_transferred) {
     if (ErrorHelper::isClientDisconnect(ec)) {
       LOG_INFO << "Client disconnected: " << endpoint
                << (player_id_.empty() ? "" : " (Player: " + player_id_ + ")");
+    } else if (ec == net::error::operation_aborted) {
+      LOG_DEBUG << "Read aborted, session closed by server";
     } else {
       ErrorLogger::logNetworkError(ctx, ec, "Read operation failed");
     }
-    server_.onSessionClosed(shared_from_this());
+    server().onSessionClosed(shared_from_this());
     return;
   }
 
@@ -99,67 +346,249 @@ void Session::on_read(beast::error_code ec, std::size_t bytes_transferred) {
   const auto* msg_data = static_cast<const char*>(buffer_.data().data());
   std::string message(msg_data, buffer_.size());
 
-  server_.processMessage(shared_from_this(), message);
+  server().processMessage(shared_from_this(), message);
 
   buffer_.consume(buffer_.size());
   do_read();
 }
 
-void Session::send(const std::string& message) {
-  server_.incrementMessagesSent();  // Increment sent message counter
+template <class NextLayer>
+void BasicWebsocketSession<NextLayer>::send(const std::string& message) {
+  server().incrementMessagesSent();  // Increment sent message counter
+  ++queue_depth_;
+  const auto queued_at = server().getClock().now();
 
-  net::post(strand_, [self = shared_from_this(), message] {
-    self->write_queue_.push(message);
-    if (self->write_queue_.size() == 1) {
-      self->do_write();
-    }
+  // 在会话自己的 strand 上（例如回复它自己的消息）直接入队，不再投递
+  if (strand_.running_in_this_thread()) {
+    enqueue(message, queued_at);
+    return;
+  }
+  net::post(strand_, [self = self(), message, queued_at] {
+    self->enqueue(message, queued_at);
   });
 }
 
-void Session::do_write() {
+template <class NextLayer>
+void BasicWebsocketSession<NextLayer>::enqueue(
+    std::string message, std::chrono::steady_clock::time_point queued_at) {
+  write_queue_.push({std::move(message), queued_at});
+  if (accepted_ && write_queue_.size() == 1) {
+    do_write();
+  }
+}
+
+void Session::sendPlayerList(
+    const std::shared_ptr<const core::FramePacker::PlayerMap>& players,
+    const std::string& full_frame, const core::ClassDelivery& delivery) {
+  // ServerToClient/PlayerList 包装及 partial 标志的近似开销
+  constexpr std::size_t kPartialFrameOverhead = 16;
+
+  // 积压超出类别上限时跳过本帧，客户端追上后下一帧仍是完整状态
+  if (delivery.queue_limit > 0 && getQueueDepth() >= delivery.queue_limit) {
+    server().incrementFramesShed();
+    return;
+  }
+
+  const auto now = server().getClock().now();
+  std::string partial_frame;
+  {
+    std::lock_guard lock(pacing_mutex_);
+    if (delivery.min_interval.count() > 0 && last_roster_time_ &&
+        now - *last_roster_time_ < delivery.min_interval) {
+      server().incrementFramesShed();
+      return;
+    }
+    // 自适应会话不在未写完的帧后面排队：下一次广播带来的状态更新，
+    // 而排队的帧只会增加延迟
+    if (encoding_selector_ && getQueueDepth() > 0) {
+      server().incrementFramesShed();
+      return;
+    }
+    last_roster_time_ = now;
+
+    const auto available = budget_.available(now);
+    // 增量编码下 full_frame 仍是完整帧，可用于预测升级后的开销
+    const auto tier = encoding_tier_.load();
+    const bool delta = tier == core::EncodingTier::Delta;
+    if (encoding_selector_) {
+      encoding_selector_->onFrameSize(delta ? core::EncodingTier::Full : tier,
+                                      full_frame.size());
+    }
+
+    if (!delta && full_frame.size() <= available) {
+      budget_.consume(full_frame.size());
+      if (budget_.isLimited()) {
+        packer_.markAllSent(*players, now);
+        last_full_roster_.reset();
+      } else {
+        // 不受限时只记录最近一次完整帧，避免每次广播都更新逐玩家状态
+        last_full_roster_ = players;
+        last_full_time_ = now;
+      }
+    } else {
+      // 增量帧必须以客户端实际持有的列表为基准
+      if (last_full_roster_ && (delta || !packer_.hasState())) {
+        packer_.markAllSent(*last_full_roster_, last_full_time_);
+      }
+      last_full_roster_.reset();
+
+      if (available <= kPartialFrameOverhead) {
+        return;  // 本帧全部推迟
+      }
+
+      auto packed = packer_.pack(player_id_, *players,
+                                 available - kPartialFrameOverhead, now, delta);
+      if (packed.selected.empty() && packed.removed.empty()) {
+        return;
+      }
+
+      picoradar::ServerToClient response;
+      auto* player_list = response.mutable_player_list();
+      player_list->set_partial(true);
+      for (const auto* player : packed.selected) {
+        *player_list->add_players() = *player;
+      }
+      for (auto& id : packed.removed) {
+        player_list->add_removed_player_ids(std::move(id));
+      }
+      response.SerializeToString(&partial_frame);
+      budget_.consume(partial_frame.size());
+      if (delta && encoding_selector_) {
+        encoding_selector_->onFrameSize(tier, partial_frame.size());
+      }
+
+      LOG_TRACE << "Paced player list for " << player_id_ << ": "
+                << packed.selected.size() << " sent, " << packed.deferred
+                << " deferred, budget " << budget_.getRate() << " B/s";
+    }
+  }
+
+  send(partial_frame.empty() ? full_frame : partial_frame);
+}
+
+template <class NextLayer>
+void BasicWebsocketSession<NextLayer>::do_write() {
+  write_started_ = server().getClock().now();
   ws_.binary(true);
-  ws_.async_write(
-      net::buffer(write_queue_.front()),
-      beast::bind_front_handler(&Session::on_write, shared_from_this()));
+  ws_.async_write(net::buffer(write_queue_.front().data),
+                  bindToStrand(beast::bind_front_handler(
+                      &BasicWebsocketSession::on_write, self())));
 }
 
-void Session::on_write(beast::error_code ec, std::size_t bytes_transferred) {
+template <class NextLayer>
+void BasicWebsocketSession<NextLayer>::on_write(
+    beast::error_code ec, std::size_t bytes_transferred) {
   auto endpoint = getSafeEndpoint();
   NetworkContext ctx("write", endpoint);
   ctx.player_id = player_id_;
   ctx.bytes_transferred = bytes_transferred;
 
   if (ec) {
-    ErrorLogger::logNetworkError(ctx, ec, "Write operation failed");
-    server_.onSessionClosed(shared_from_this());
+    if (ec != net::error::operation_aborted) {
+      ErrorLogger::logNetworkError(ctx, ec, "Write operation failed");
+    }
+    server().onSessionClosed(shared_from_this());
     return;
   }
 
   ErrorLogger::logOperationSuccess(ctx);
 
+  const auto now = server().getClock().now();
+  onWriteCompleted(bytes_transferred, now - write_started_,
+                   write_queue_.size() > 1,
+                   now - write_queue_.front().queued_at);
+
   write_queue_.pop();
+  --queue_depth_;
   if (!write_queue_.empty()) {
     do_write();
   }
+  probe_rtt();
+}
+
+template <class NextLayer>
+void BasicWebsocketSession<NextLayer>::probe_rtt() {
+  // 未收到 pong 的探测在若干个间隔后放弃，避免永久停止测量
+  constexpr int kProbeTimeoutIntervals = 5;
+
+  const auto interval = getProbeInterval();
+  if (interval.count() == 0) {
+    return;
+  }
+  const auto now = server().getClock().now();
+  const auto since_last = now - ping_sent_;
+  if (since_last < interval ||
+      (ping_in_flight_ && since_last < interval * kProbeTimeoutIntervals)) {
+    return;
+  }
+
+  ping_sent_ = now;
+  ping_in_flight_ = true;
+  ws_.async_ping({}, bindToStrand([self = self()](beast::error_code ec) {
+    if (ec) {
+      self->ping_in_flight_ = false;
+    }
+  }));
+}
+
+template <class NextLayer>
+void BasicWebsocketSession<NextLayer>::on_pong() {
+  if (!ping_in_flight_) {
+    return;  // 客户端主动发送的 pong
+  }
+  ping_in_flight_ = false;
+  onRttMeasured(server().getClock().now() - ping_sent_);
 }
 
-void Session::close() {
-  net::post(strand_, [self = shared_from_this()] {
+template <class NextLayer>
+void BasicWebsocketSession<NextLayer>::close(std::function<void()> on_closed) {
+  net::post(strand_, [self = self(), on_closed = std::move(on_closed)] {
     beast::get_lowest_layer(self->ws_).close();
+    if (on_closed) {
+      on_closed();
+    }
   });
 }
 
-void Session::on_close(beast::error_code ec) {
+template <class NextLayer>
+void BasicWebsocketSession<NextLayer>::on_close(beast::error_code ec) {
   boost::ignore_unused(ec);
   LOG_DEBUG << "WebSocket connection closed";
 }
 
+template <class NextLayer>
+std::string BasicWebsocketSession<NextLayer>::getSafeEndpoint() const {
+  try {
+    if (beast::get_lowest_layer(ws_).socket().is_open()) {
+      auto endpoint = beast::get_lowest_layer(ws_).socket().remote_endpoint();
+      return endpoint.address().to_string() + ":" +
+             std::to_string(endpoint.port());
+    }
+  } catch (const std::exception& e) {
+    // Socket is closed or not connected, return placeholder
+  }
+  return "disconnected";
+}
+
+template class BasicWebsocketSession<beast::tcp_stream>;
+template class BasicWebsocketSession<beast::ssl_stream<beast::tcp_stream>>;
+
 //------------------------------------------------------------------------------
 // WebsocketServer implementation
 
 WebsocketServer::WebsocketServer(net::io_context& ioc,
                                  core::PlayerRegistry& registry)
-    : ioc_{ioc}, registry_{registry} {}
+    : WebsocketServer(ioc, registry, common::Clock::system()) {}
+
+WebsocketServer::WebsocketServer(net::io_context& ioc,
+                                 core::PlayerRegistry& registry,
+                                 const common::Clock& clock)
+    : ioc_{ioc},
+      registry_{registry},
+      clock_{clock},
+      occupancy_{std::make_unique<core::OccupancyGrid>()},
+      proximity_{std::make_unique<core::ProximityDetector>()},
+      periodic_strand_{net::make_strand(ioc)} {}
 
 WebsocketServer::~WebsocketServer() {
   if (is_running_) {
@@ -180,11 +609,18 @@ void WebsocketServer::start(const std::string& address, uint16_t port,
   }
 
   auto server_address = net::ip::make_address(address);
+  configure();
+
+  // 证书错误在绑定端口之前报告
+  tls_.reset();
+  if (tls_config_.enabled) {
+    tls_ = makeServerTlsContext(tls_config_);
+  }
 
   // Try to create and bind the listener first to detect port conflicts
   try {
     listener_ = std::make_shared<Listener>(
-        ioc_, tcp::endpoint{server_address, port}, *this);
+        ioc_, tcp::endpoint{server_address, port}, *this, tls_.get());
     listener_->run();
   } catch (const std::exception& e) {
     throw std::runtime_error(
@@ -192,62 +628,554 @@ void WebsocketServer::start(const std::string& address, uint16_t port,
                     port, e.what()));
   }
 
-  threads_.reserve(thread_count);
-  for (int i = 0; i < thread_count; ++i) {
-    threads_.emplace_back([this] { ioc_.run(); });
+  // 线程池可以在运行时扩容到 max_workers_，每个槽位一个无锁摄入队列
+  max_workers_ = std::max(worker_scaler_config_.max_workers,
+                          static_cast<std::size_t>(thread_count));
+  worker_scaler_config_.max_workers = max_workers_;
+  worker_scaler_ = std::make_unique<core::WorkerScaler>(worker_scaler_config_);
+  if (simulation_enabled_) {
+    ingest_ = std::make_unique<core::IngestQueue<IngestRecord>>(
+        max_workers_, ingest_capacity_);
+  }
+
+  // 每个可能的工作线程一条通道
+  resetLanes(scene_affinity_ ? max_workers_ : 0);
+
+  createPeriodicTimers();
+  armPeriodicTasks();
+
+  // 租户在 I/O 线程启动前就绪，首个会话被移交时定时器与线程都已创建
+  for (auto* tenant : tenants_) {
+    tenant->startTenant(lane_count_);
+  }
+
+  {
+    std::lock_guard lock(workers_mutex_);
+    last_worker_probe_ = std::chrono::steady_clock::now();
+    last_worker_probe_cpu_ = common::process_cpu_time();
+    resizeWorkersLocked(static_cast<std::size_t>(thread_count));
+  }
+
+  if (simulation_enabled_) {
+    simulation_running_ = true;
+    simulation_thread_ = std::thread([this] { runSimulationThread(); });
   }
 
   is_running_ = true;
-  LOG_INFO << fmt::format("WebSocket server started on {}:{}", address, port);
+  if (!tenants_.empty()) {
+    LOG_INFO << "Hosting " << tenants_.size() << " tenants";
+  }
+  LOG_INFO << fmt::format("WebSocket server started on {}://{}:{}",
+                          tls_ ? "wss" : "ws", address, getPort());
+}
+
+auto WebsocketServer::getPort() const -> uint16_t {
+  return listener_ ? listener_->getPort() : 0;
+}
+
+void WebsocketServer::configure() {
+  const auto& config = picoradar::common::ConfigManager::getInstance();
+  const int configured_rate =
+      config.getWithDefault("network.bandwidth.bytes_per_sec", 0);
+  bandwidth_config_.bytes_per_sec =
+      static_cast<std::size_t>(std::max(0, configured_rate));
+  bandwidth_config_.estimate =
+      config.getWithDefault("network.bandwidth.estimate", true);
+  precision_lod_config_.enabled =
+      config.getWithDefault("network.precision_lod.enabled", false);
+  precision_lod_config_.near_distance =
+      static_cast<float>(config.getWithDefault(
+          "network.precision_lod.near_distance",
+          static_cast<double>(precision_lod_config_.near_distance)));
+  precision_lod_config_.mid_distance =
+      static_cast<float>(config.getWithDefault(
+          "network.precision_lod.mid_distance",
+          static_cast<double>(precision_lod_config_.mid_distance)));
+  precision_lod_config_.far_bodies =
+      config.getWithDefault("network.precision_lod.far_bodies", false);
+
+  tls_config_ = {};
+  tls_config_.enabled = config.getWithDefault("network.tls.enabled", false);
+  if (tls_config_.enabled) {
+    tls_config_.certificate_file = config.getWithDefault(
+        "network.tls.certificate_file", std::string{});
+    tls_config_.private_key_file = config.getWithDefault(
+        "network.tls.private_key_file", std::string{});
+    tls_config_.session_tickets =
+        config.getWithDefault("network.tls.session_tickets", true);
+    tls_config_.session_timeout = std::chrono::seconds(config.getWithDefault(
+        "network.tls.session_timeout_s",
+        static_cast<int>(constants::kDefaultTlsSessionTimeout.count())));
+  }
+
+  core::OccupancyGridConfig grid_config;
+  grid_config.cell_size = static_cast<float>(
+      config.getWithDefault("network.heatmap.cell_size",
+                            static_cast<double>(grid_config.cell_size)));
+  grid_config.width = static_cast<std::uint32_t>(std::max(
+      1, config.getWithDefault("network.heatmap.width",
+                               static_cast<int>(grid_config.width))));
+  grid_config.height = static_cast<std::uint32_t>(std::max(
+      1, config.getWithDefault("network.heatmap.height",
+                               static_cast<int>(grid_config.height))));
+  occupancy_ = std::make_unique<core::OccupancyGrid>(grid_config);
+  heatmap_interval_ = std::chrono::milliseconds(config.getWithDefault(
+      "network.heatmap.interval_ms",
+      static_cast<int>(constants::kDefaultHeatmapInterval.count())));
+
+  core::ProximityConfig proximity_config;
+  proximity_config.alert_distance = static_cast<float>(config.getWithDefault(
+      "network.proximity.alert_distance",
+      static_cast<double>(proximity_config.alert_distance)));
+  proximity_config.clear_distance = static_cast<float>(config.getWithDefault(
+      "network.proximity.clear_distance",
+      static_cast<double>(proximity_config.clear_distance)));
+  proximity_ = std::make_unique<core::ProximityDetector>(proximity_config);
+  proximity_interval_ = std::chrono::milliseconds(config.getWithDefault(
+      "network.proximity.interval_ms",
+      static_cast<int>(constants::kDefaultProximityInterval.count())));
+
+  try {
+    geofences_ = core::GeofenceEngine::fromJson(
+        config.hasKey("geofence.scenes")
+            ? config.getConfig()["geofence"]["scenes"]
+            : nlohmann::json::object());
+  } catch (const std::exception& e) {
+    throw std::runtime_error(
+        fmt::format("Invalid geofence configuration: {}", e.what()));
+  }
+  geofence_interval_ = std::chrono::milliseconds(config.getWithDefault(
+      "geofence.interval_ms",
+      static_cast<int>(constants::kDefaultGeofenceInterval.count())));
+  if (!geofences_.empty()) {
+    LOG_INFO << "Loaded " << geofences_.getFenceCount() << " geofences";
+  }
+
+  observer_interval_ = std::chrono::milliseconds(config.getWithDefault(
+      "embedding.observer_interval_ms",
+      static_cast<int>(constants::kDefaultObserverInterval.count())));
+
+  simulation_enabled_ =
+      config.getWithDefault("network.simulation_thread.enabled", false);
+  simulation_tick_ = std::chrono::milliseconds(std::max(
+      1, config.getWithDefault(
+             "network.simulation_thread.tick_ms",
+             static_cast<int>(constants::kDefaultSimulationTick.count()))));
+  ingest_capacity_ = static_cast<std::size_t>(std::max(
+      1, config.getWithDefault(
+             "network.simulation_thread.queue_capacity",
+             static_cast<int>(constants::kDefaultIngestQueueCapacity))));
+  const auto hardware_threads =
+      static_cast<int>(std::thread::hardware_concurrency());
+  worker_scaler_config_ = {};
+  worker_scaler_config_.min_workers = static_cast<std::size_t>(
+      std::max(1, config.getWithDefault("network.workers.min", 1)));
+  worker_scaler_config_.max_workers = static_cast<std::size_t>(std::clamp(
+      config.getWithDefault("network.workers.max", hardware_threads), 1,
+      constants::kMaxThreadCount));
+  worker_scaler_config_.scale_up_lag = std::chrono::milliseconds(
+      config.getWithDefault("network.workers.scale_up_lag_ms", 5));
+  worker_autoscale_ =
+      config.getWithDefault("network.workers.autoscale", false);
+  worker_probe_interval_ = std::chrono::milliseconds(config.getWithDefault(
+      "network.workers.probe_interval_ms",
+      static_cast<int>(constants::kDefaultWorkerProbeInterval.count())));
+  scene_affinity_ =
+      config.getWithDefault("network.scene_affinity.enabled", false);
+  scene_rebalance_interval_ =
+      std::chrono::milliseconds(config.getWithDefault(
+          "network.scene_affinity.rebalance_interval_ms",
+          static_cast<int>(constants::kDefaultSceneRebalanceInterval.count())));
+
+  core::LoadShedderConfig shedder_config;
+  for (std::size_t i = 0; i < core::kSessionClassCount; ++i) {
+    auto& policy = shedder_config.classes[i];
+    const auto prefix =
+        fmt::format("network.session_classes.{}.",
+                    core::sessionClassName(
+                        static_cast<picoradar::SessionClass>(i)));
+    policy.tick_hz =
+        std::max(0, config.getWithDefault(prefix + "tick_hz", policy.tick_hz));
+    policy.shed_tick_hz = std::max(
+        0, config.getWithDefault(prefix + "shed_tick_hz", policy.shed_tick_hz));
+    policy.queue_limit = static_cast<std::size_t>(std::max(
+        0, config.getWithDefault(prefix + "queue_limit",
+                                 static_cast<int>(policy.queue_limit))));
+    policy.droppable =
+        config.getWithDefault(prefix + "droppable", policy.droppable);
+  }
+  shedder_config.shed_lag = std::chrono::milliseconds(config.getWithDefault(
+      "network.shedding.shed_lag_ms",
+      static_cast<int>(shedder_config.shed_lag.count() / 1000)));
+  shedder_config.recover_lag = std::chrono::milliseconds(config.getWithDefault(
+      "network.shedding.recover_lag_ms",
+      static_cast<int>(shedder_config.recover_lag.count() / 1000)));
+  shedder_config.shed_samples = static_cast<std::size_t>(std::max(
+      1, config.getWithDefault(
+             "network.shedding.shed_samples",
+             static_cast<int>(shedder_config.shed_samples))));
+  shedder_config.recover_samples = static_cast<std::size_t>(std::max(
+      1, config.getWithDefault(
+             "network.shedding.recover_samples",
+             static_cast<int>(shedder_config.recover_samples))));
+  {
+    std::lock_guard lock(shedder_mutex_);
+    load_shedder_ = core::LoadShedder(shedder_config);
+    shed_level_ = 0;
+  }
+
+  adaptive_encoding_config_ = {};
+  adaptive_encoding_config_.enabled =
+      config.getWithDefault("network.adaptive_encoding.enabled", false);
+  adaptive_encoding_config_.latency_budget =
+      std::chrono::milliseconds(std::max(
+          1, config.getWithDefault(
+                 "network.adaptive_encoding.latency_budget_ms",
+                 static_cast<int>(
+                     adaptive_encoding_config_.latency_budget.count() /
+                     1000))));
+  adaptive_encoding_config_.recover_ratio = std::clamp(
+      config.getWithDefault("network.adaptive_encoding.recover_ratio",
+                            adaptive_encoding_config_.recover_ratio),
+      0.0, 1.0);
+  adaptive_encoding_config_.degrade_samples = static_cast<std::size_t>(
+      std::max(1, config.getWithDefault(
+                      "network.adaptive_encoding.degrade_samples",
+                      static_cast<int>(
+                          adaptive_encoding_config_.degrade_samples))));
+  adaptive_encoding_config_.recover_samples = static_cast<std::size_t>(
+      std::max(1, config.getWithDefault(
+                      "network.adaptive_encoding.recover_samples",
+                      static_cast<int>(
+                          adaptive_encoding_config_.recover_samples))));
+  adaptive_encoding_config_.stall_threshold =
+      std::chrono::milliseconds(config.getWithDefault(
+          "network.adaptive_encoding.stall_ms",
+          static_cast<int>(
+              adaptive_encoding_config_.stall_threshold.count() / 1000)));
+  adaptive_encoding_config_.probe_interval =
+      std::chrono::milliseconds(std::max(
+          1, config.getWithDefault(
+                 "network.adaptive_encoding.probe_interval_ms",
+                 static_cast<int>(
+                     adaptive_encoding_config_.probe_interval.count()))));
+
+  if (isTenant()) {
+    simulation_enabled_ = tenant_.dedicated_thread;
+  }
+
+  // 未启动 I/O 线程时（内存模拟）所有写入都进入共享队列；租户与前端共用
+  // I/O 线程，同样只使用共享队列
+  ingest_.reset();
+  if (simulation_enabled_) {
+    ingest_ = std::make_unique<core::IngestQueue<IngestRecord>>(
+        0, ingest_capacity_);
+  }
+}
+
+auto WebsocketServer::getPeriodicTasks() const -> std::vector<PeriodicTask> {
+  std::vector<PeriodicTask> tasks;
+  if (heatmap_interval_.count() > 0) {
+    tasks.push_back(
+        {heatmap_interval_, &WebsocketServer::broadcastHeatmap, "heatmap"});
+  }
+  if (proximity_interval_.count() > 0) {
+    tasks.push_back(
+        {proximity_interval_, &WebsocketServer::checkProximity, "proximity"});
+  }
+  if (geofence_interval_.count() > 0 && !geofences_.empty()) {
+    tasks.push_back(
+        {geofence_interval_, &WebsocketServer::checkGeofences, "geofence"});
+  }
+  if (observer_interval_.count() > 0) {
+    tasks.push_back(
+        {observer_interval_, &WebsocketServer::publishRegistryChanges,
+         "observers"});
+  }
+  if (simulation_enabled_) {
+    tasks.push_back({simulation_tick_, &WebsocketServer::runSimulationTick,
+                     "simulation_tick"});
+  }
+  if (worker_probe_interval_.count() > 0 && !isTenant()) {
+    tasks.push_back({worker_probe_interval_, &WebsocketServer::balanceWorkers,
+                     "balance_workers"});
+  }
+  if (scene_affinity_ && scene_rebalance_interval_.count() > 0) {
+    tasks.push_back(
+        {scene_rebalance_interval_, &WebsocketServer::rebalanceScenes,
+         "rebalance_scenes"});
+  }
+  return tasks;
 }
 
 void WebsocketServer::stop() {
   if (!is_running_) {
     return;
   }
+  if (isTenant()) {
+    stopTenant();  // 会话由前端服务器在 I/O 线程上关闭
+    return;
+  }
 
   LOG_INFO << "Stopping WebSocket server...";
   net::post(ioc_, [this] {
     if (listener_) {
       listener_->stop();
     }
-    auto sessions_copy = sessions_;
-    for (auto& session : sessions_copy) {
-      session->close();
+    std::vector<std::shared_ptr<const SessionList>> detached{detachSessions()};
+    for (auto* tenant : tenants_) {
+      detached.push_back(tenant->detachSessions());
     }
-    sessions_.clear();
-    ioc_.stop();
+
+    // 会话在各自的执行器上关闭套接字。必须等这些关闭全部执行完再停止
+    // io_context，否则它们永远不会运行，客户端只能等到超时才发现断开
+    auto deadline = std::make_shared<net::steady_timer>(ioc_);
+    auto pending = std::make_shared<std::atomic<std::size_t>>(1);
+    const auto on_closed = [this, pending, deadline] {
+      if (pending->fetch_sub(1) == 1) {
+        deadline->cancel();
+        ioc_.stop();
+      }
+    };
+    for (const auto& sessions : detached) {
+      for (const auto& session : *sessions) {
+        pending->fetch_add(1);
+        session->close(on_closed);
+      }
+    }
+    deadline->expires_after(kSessionCloseTimeout);
+    deadline->async_wait([this, pending, deadline](beast::error_code ec) {
+      // 清零计数，迟到的关闭回调不会再次停止 io_context
+      if (!ec && pending->exchange(0) != 0) {
+        LOG_WARNING << "Sessions did not close in time, stopping anyway";
+        ioc_.stop();
+      }
+    });
+    on_closed();
   });
 
-  for (auto& t : threads_) {
-    if (t.joinable()) {
-      t.join();
+  // 不持有锁等待，工作线程可能正在执行 balanceWorkers()
+  std::vector<std::unique_ptr<Worker>> workers;
+  {
+    std::lock_guard lock(workers_mutex_);
+    workers.swap(workers_);
+    active_workers_ = 0;
+  }
+  for (auto& worker : workers) {
+    if (worker->thread.joinable()) {
+      worker->thread.join();
     }
   }
-  threads_.clear();
+  periodic_timers_.clear();
+  stopSimulationThread();
+  for (auto* tenant : tenants_) {
+    tenant->stopTenant();
+  }
 
   is_running_ = false;
   LOG_INFO << "WebSocket server stopped";
 }
 
+auto WebsocketServer::detachSessions() -> std::shared_ptr<const SessionList> {
+  for (auto& timer : periodic_timers_) {
+    timer->cancel();
+  }
+  std::shared_ptr<const SessionList> sessions;
+  {
+    std::lock_guard lock(sessions_mutex_);
+    sessions = session_list_;
+    sessions_.clear();
+    publishSessionsLocked();
+  }
+
+  std::lock_guard lock(lanes_mutex_);
+  scene_lanes_.clear();
+  std::fill(lane_loads_.begin(), lane_loads_.end(), 0);
+  return sessions;
+}
+
+void WebsocketServer::stopSimulationThread() {
+  {
+    std::lock_guard lock(simulation_mutex_);
+    simulation_running_ = false;
+  }
+  simulation_cv_.notify_all();
+  if (simulation_thread_.joinable()) {
+    simulation_thread_.join();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Multi-tenant hosting
+
+auto WebsocketServer::loadTenantConfigs() -> std::vector<TenantConfig> {
+  const auto& config = picoradar::common::ConfigManager::getInstance();
+  if (!config.hasKey("tenants")) {
+    return {};
+  }
+
+  const auto default_token =
+      config.getWithDefault("auth.token", std::string{});
+  std::vector<TenantConfig> tenants;
+  std::unordered_set<std::string> tokens;
+  try {
+    const auto section = config.getConfig()["tenants"];
+    if (!section.is_object()) {
+      throw std::runtime_error("'tenants' must be an object");
+    }
+    for (const auto& item : section.items()) {
+      TenantConfig tenant;
+      tenant.name = item.key();
+      tenant.token = item.value().value("token", std::string{});
+      tenant.dedicated_thread =
+          item.value().value("dedicated_thread", false);
+      // 令牌是租户的唯一选择依据，不能为空、重复或与默认令牌相同
+      if (tenant.token.empty() || tenant.token == default_token ||
+          !tokens.insert(tenant.token).second) {
+        throw std::runtime_error(fmt::format(
+            "tenant '{}' needs a token of its own", tenant.name));
+      }
+      tenants.push_back(std::move(tenant));
+    }
+  } catch (const std::exception& e) {
+    throw std::runtime_error(
+        fmt::format("Invalid tenant configuration: {}", e.what()));
+  }
+  return tenants;
+}
+
+void WebsocketServer::addTenant(TenantConfig config, WebsocketServer& tenant) {
+  if (is_running_) {
+    throw std::runtime_error("Tenants must be added before start()");
+  }
+  if (&tenant.ioc_ != &ioc_) {
+    throw std::invalid_argument("Tenant must share the front io_context");
+  }
+  LOG_INFO << "Registered tenant '" << config.name << "'"
+           << (config.dedicated_thread ? " (dedicated simulation thread)"
+                                       : "");
+  tenants_by_token_[config.token] = &tenant;
+  tenant.tenant_ = std::move(config);
+  tenants_.push_back(&tenant);
+}
+
+auto WebsocketServer::findTenant(const std::string& token) const
+    -> WebsocketServer* {
+  auto it = tenants_by_token_.find(token);
+  return it == tenants_by_token_.end() ? nullptr : it->second;
+}
+
+void WebsocketServer::startTenant(size_t lane_count) {
+  configure();
+  resetLanes(scene_affinity_ ? lane_count : 0);
+  createPeriodicTimers();  // 首个会话到达时才开始计时
+  if (simulation_enabled_) {
+    simulation_running_ = true;
+    simulation_thread_ = std::thread([this] { runSimulationThread(); });
+  }
+  tenant_active_ = false;
+  is_running_ = true;
+}
+
+void WebsocketServer::stopTenant() {
+  stopSimulationThread();
+  periodic_timers_.clear();
+  tenant_active_ = false;
+  is_running_ = false;
+}
+
+auto WebsocketServer::isIdle() const -> bool {
+  return getConnectionCount() == 0 && registry_.getPlayerCount() == 0;
+}
+
+void WebsocketServer::activateTenant() {
+  if (!isTenant() || tenant_active_.exchange(true)) {
+    return;
+  }
+  LOG_DEBUG << "Tenant '" << tenant_.name << "' active";
+  net::dispatch(periodic_strand_, [this] { armPeriodicTasks(); });
+  {
+    std::lock_guard lock(simulation_mutex_);
+  }
+  simulation_cv_.notify_all();
+}
+
+auto WebsocketServer::parkIfIdle() -> bool {
+  if (!isTenant() || !isIdle()) {
+    return false;
+  }
+  if (tenant_active_.exchange(false)) {
+    LOG_DEBUG << "Tenant '" << tenant_.name << "' idle";
+  }
+  // 与并发到达的会话竞争时由这里重新激活，不会错过唤醒
+  if (!isIdle()) {
+    activateTenant();
+    return false;
+  }
+  return true;
+}
+
+auto WebsocketServer::getSessions() const
+    -> std::shared_ptr<const SessionList> {
+  std::lock_guard lock(sessions_mutex_);
+  return session_list_;
+}
+
+auto WebsocketServer::addSession(const std::shared_ptr<Session>& session)
+    -> size_t {
+  std::lock_guard lock(sessions_mutex_);
+  if (sessions_.insert(session).second) {
+    publishSessionsLocked();
+  }
+  return sessions_.size();
+}
+
+auto WebsocketServer::eraseSession(const std::shared_ptr<Session>& session)
+    -> std::optional<size_t> {
+  std::lock_guard lock(sessions_mutex_);
+  if (sessions_.erase(session) == 0) {
+    return std::nullopt;
+  }
+  publishSessionsLocked();
+  return sessions_.size();
+}
+
+void WebsocketServer::publishSessionsLocked() {
+  // 连接变化远少于广播，每次变化重建一份列表，广播只需复制一个指针
+  session_list_ =
+      std::make_shared<const SessionList>(sessions_.begin(), sessions_.end());
+}
+
 void WebsocketServer::onSessionOpened(const std::shared_ptr<Session>& session) {
-  sessions_.insert(session);
-  LOG_DEBUG << "Client connected. Total connections: " << sessions_.size();
+  const auto count = addSession(session);
+  LOG_DEBUG << "Client connected. Total connections: " << count;
+  activateTenant();
 }
 
 void WebsocketServer::onSessionClosed(const std::shared_ptr<Session>& session) {
-  if (!session->getPlayerId().empty()) {
-    registry_.removePlayer(session->getPlayerId());
+  // 旁观与运营会话不在玩家列表中，断开时无需移除或广播
+  bool applied =
+      session->getSessionClass() == picoradar::SESSION_CLASS_PLAYER;
+  if (applied && !session->getPlayerId().empty()) {
+    applied = applyRemoval(session->getPlayerId());
   }
-  if (sessions_.erase(session) != 0u) {
-    LOG_DEBUG << "Client disconnected. Total connections: " << sessions_.size();
-    broadcastPlayerList();
+  if (session->getSceneId()) {
+    std::lock_guard lock(lanes_mutex_);
+    releaseSessionLocked(session);
+  }
+  if (const auto count = eraseSession(session)) {
+    LOG_DEBUG << "Client disconnected. Total connections: " << *count;
+    session->disableAdaptiveEncoding();
+    if (applied) {
+      broadcastPlayerList();
+    }
   }
 }
 
 void WebsocketServer::processMessage(const std::shared_ptr<Session>& session,
                                      const std::string& raw_message) {
   ++messages_received_;  // Increment received message counter
+  const StageTimer timer(ingest_ns_);
 
   try {
     picoradar::ClientToServer client_msg;
@@ -255,145 +1183,926 @@ void WebsocketServer::processMessage(const std::shared_ptr<Session>& session,
       LOG_WARNING << "Failed to parse client message";
       return;
     }
+    handleMessage(session, client_msg, raw_message);
+  } catch (const std::exception& e) {
+    LOG_ERROR << "Error processing message: " << e.what();
+  }
+}
 
-    if (client_msg.has_auth_request()) {
-      const auto& auth_req = client_msg.auth_request();
-      const std::string& token = auth_req.token();
-      const std::string& player_id = auth_req.player_id();
+void WebsocketServer::handleMessage(
+    const std::shared_ptr<Session>& session,
+    const picoradar::ClientToServer& client_msg,
+    const std::string& raw_message) {
+  if (client_msg.has_auth_request()) {
+    const auto& auth_req = client_msg.auth_request();
+    const std::string& token = auth_req.token();
+    const std::string& player_id = auth_req.player_id();
+
+    // 令牌属于某个租户时，会话连同这条鉴权请求一起移交给该租户
+    auto* tenant = findTenant(token);
+    if (tenant != nullptr && session->getPlayerId().empty()) {
+      eraseSession(session);
+      session->moveTo(*tenant);
+      tenant->onSessionOpened(session);
+      tenant->handleMessage(session, client_msg, raw_message);
+      return;
+    }
 
-      auto& config = picoradar::common::ConfigManager::getInstance();
-      auto expectedToken = config.getString("auth.token");
+    auto& config = picoradar::common::ConfigManager::getInstance();
+    auto expectedToken =
+        isTenant() ? common::ConfigResult<std::string>(tenant_.token)
+                   : config.getString("auth.token");
 
-      LOG_DEBUG << "Authentication attempt - Player: " << player_id
-                << ", Received token: " << token << ", Expected token exists: "
-                << (expectedToken ? "yes" : "no");
+    LOG_DEBUG << "Authentication attempt - Player: " << player_id
+              << ", Received token: " << token << ", Expected token exists: "
+              << (expectedToken ? "yes" : "no");
 
-      if (expectedToken) {
-        LOG_DEBUG << "Expected token: " << expectedToken.value();
-      }
+    if (expectedToken) {
+      LOG_DEBUG << "Expected token: " << expectedToken.value();
+    }
 
-      if (!expectedToken || token != expectedToken.value()) {
-        LOG_WARNING << "Authentication failed for player '" << player_id
-                    << "' with token: " << token;
+    if (!expectedToken || token != expectedToken.value()) {
+      LOG_WARNING << "Authentication failed for player '" << player_id
+                  << "' with token: " << token;
 
-        picoradar::ServerToClient response;
-        auto* auth_response = response.mutable_auth_response();
-        auth_response->set_success(false);
-        auth_response->set_message("Invalid authentication token");
+      picoradar::ServerToClient response;
+      auto* auth_response = response.mutable_auth_response();
+      auth_response->set_success(false);
+      auth_response->set_message("Invalid authentication token");
 
-        std::string serialized_response;
-        response.SerializeToString(&serialized_response);
-        session->send(serialized_response);
-        return;
-      }
+      std::string serialized_response;
+      response.SerializeToString(&serialized_response);
+      session->send(serialized_response);
+      return;
+    }
 
-      if (!player_id.empty()) {
-        LOG_INFO << fmt::format("Player {} authenticated successfully",
-                                player_id);
+    if (isInjectedPlayer(player_id)) {
+      LOG_WARNING << "Player ID '" << player_id
+                  << "' is reserved by a server-authored player";
 
-        session->setPlayerId(player_id);
+      picoradar::ServerToClient response;
+      auto* auth_response = response.mutable_auth_response();
+      auth_response->set_success(false);
+      auth_response->set_message("Player ID is reserved by the server");
 
-        picoradar::PlayerData player_data;
-        player_data.set_player_id(player_id);
-        auto* position = player_data.mutable_position();
-        position->set_x(0.0);
-        position->set_y(0.0);
-        position->set_z(0.0);
-        player_data.set_timestamp(
-            std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::system_clock::now().time_since_epoch())
-                .count());
+      std::string serialized_response;
+      response.SerializeToString(&serialized_response);
+      session->send(serialized_response);
+      session->close();
+    } else if (!player_id.empty()) {
+      // 未知的类别按玩家处理，不会被提前降载
+      const auto session_class =
+          picoradar::SessionClass_IsValid(auth_req.session_class())
+              ? auth_req.session_class()
+              : picoradar::SESSION_CLASS_PLAYER;
+      LOG_INFO << fmt::format("{} {} authenticated successfully",
+                              session_class == picoradar::SESSION_CLASS_PLAYER
+                                  ? "Player"
+                                  : core::sessionClassName(session_class),
+                              player_id);
+
+      session->setPlayerId(player_id);
+      session->setSessionClass(session_class);
+      const bool compact = precision_lod_config_.enabled &&
+                           auth_req.supports_compact_encoding();
+      session->setEncodingTier(compact ? core::EncodingTier::Compact
+                                       : core::EncodingTier::Full);
+      if (adaptive_encoding_config_.enabled) {
+        session->enableAdaptiveEncoding(
+            adaptive_encoding_config_,
+            core::EncodingSelector::makeLadder(
+                compact, auth_req.supports_compact_encoding()));
+      }
 
-        registry_.updatePlayer(player_id, std::move(player_data));
+      picoradar::ServerToClient response;
+      auto* auth_response = response.mutable_auth_response();
+      auth_response->set_success(true);
+      auth_response->set_message("Authentication successful");
 
-        picoradar::ServerToClient response;
-        auto* auth_response = response.mutable_auth_response();
-        auth_response->set_success(true);
-        auth_response->set_message("Authentication successful");
+      std::string serialized_response;
+      response.SerializeToString(&serialized_response);
 
-        std::string serialized_response;
-        response.SerializeToString(&serialized_response);
+      // 旁观屏幕与运营面板只观看，不加入玩家列表
+      if (session_class != picoradar::SESSION_CLASS_PLAYER) {
         session->send(serialized_response);
+        return;
+      }
 
+      picoradar::PlayerData player_data;
+      player_data.set_player_id(player_id);
+      auto* position = player_data.mutable_position();
+      position->set_x(0.0);
+      position->set_y(0.0);
+      position->set_z(0.0);
+      player_data.set_timestamp(
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              std::chrono::system_clock::now().time_since_epoch())
+              .count());
+
+      const bool applied = applyUpdate(std::move(player_data), true);
+      session->send(serialized_response);
+
+      if (applied) {
         broadcastPlayerList();
-      } else {
-        LOG_WARNING << "Empty player ID in auth request";
+      }
+    } else {
+      LOG_WARNING << "Empty player ID in auth request";
 
-        picoradar::ServerToClient response;
-        auto* auth_response = response.mutable_auth_response();
-        auth_response->set_success(false);
-        auth_response->set_message("Player ID cannot be empty");
+      picoradar::ServerToClient response;
+      auto* auth_response = response.mutable_auth_response();
+      auth_response->set_success(false);
+      auth_response->set_message("Player ID cannot be empty");
 
-        std::string serialized_response;
-        response.SerializeToString(&serialized_response);
-        session->send(serialized_response);
-        session->close();
-      }
-    } else if (client_msg.has_player_data()) {
-      const auto& player_update = client_msg.player_data();
-      const std::string& player_id = player_update.player_id();
+      std::string serialized_response;
+      response.SerializeToString(&serialized_response);
+      session->send(serialized_response);
+      session->close();
+    }
+  } else if (client_msg.has_player_data()) {
+    const auto& player_update = client_msg.player_data();
+    const std::string& player_id = player_update.player_id();
+    if (session->getSessionClass() != picoradar::SESSION_CLASS_PLAYER) {
+      LOG_DEBUG << "Ignoring pose update from "
+                << core::sessionClassName(session->getSessionClass())
+                << " session " << session->getPlayerId();
+      return;
+    }
+    if (isInjectedPlayer(player_id)) {
+      LOG_WARNING << "Ignoring client update for server-authored player "
+                  << player_id;
+      return;
+    }
 
-      if (session->getPlayerId().empty()) {
-        session->setPlayerId(player_id);
-      }
+    if (session->getPlayerId().empty()) {
+      session->setPlayerId(player_id);
+    }
+    if (lane_count_ > 0 &&
+        session->getSceneId() != player_update.scene_id()) {
+      placeSession(session, player_update.scene_id());
+    }
 
-      registry_.updatePlayer(player_id, player_update);
+    // 消息已完整解析校验过，PlayerData 字节可以原样保存；
+    // 只有携带无效追踪部位时才需要裁剪后重新编码
+    const auto payload = core::wire::findLengthDelimited(
+        raw_message, picoradar::ClientToServer::kPlayerDataFieldNumber);
+    bool applied = false;
+    if (hasInvalidBodies(player_update)) {
+      auto trimmed = player_update;
+      trimBodies(trimmed);
+      applied = applyUpdate(std::move(trimmed), false);
+    } else {
+      applied = payload
+                    ? applyUpdate(player_update, std::string(*payload), false)
+                    : applyUpdate(player_update, false);
+    }
+    if (applied) {
       broadcastPlayerList();
     }
-  } catch (const std::exception& e) {
-    LOG_ERROR << "Error processing message: " << e.what();
+  } else if (client_msg.has_subscription()) {
+    const auto& subscription = client_msg.subscription();
+    session->setHeatmapSubscribed(subscription.heatmap());
+    session->setRosterEnabled(!subscription.exclude_roster());
+    session->setGeofenceSubscribed(subscription.geofence_events());
+
+    LOG_DEBUG << "Session " << session->getPlayerId()
+              << " subscription: heatmap=" << subscription.heatmap()
+              << ", roster=" << !subscription.exclude_roster()
+              << ", geofence=" << subscription.geofence_events();
   }
 }
 
 void WebsocketServer::broadcastPlayerList() {
-  picoradar::ServerToClient response;
-  auto* player_list = response.mutable_player_list();
+  std::shared_ptr<const EncodedPlayerList> list;
+  {
+    const StageTimer timer(encode_ns_, "encode");
+    list = std::make_shared<const EncodedPlayerList>(encodePlayerList());
+  }
+  deliverPlayerList(std::move(list));
+}
+
+auto WebsocketServer::encodePlayerList() const -> EncodedPlayerList {
+  auto encoded = registry_.getEncodedSnapshot();
+  EncodedPlayerList list;
+  list.players = std::move(encoded.players);
+
+  // ServerToClient.player_list 的消息体就是各玩家记录的拼接
+  constexpr auto kField = picoradar::ServerToClient::kPlayerListFieldNumber;
+  list.full_frame.reserve(
+      core::wire::lengthDelimitedSize(kField, encoded.roster->size()));
+  core::wire::appendLengthDelimited(list.full_frame, kField, *encoded.roster);
+  return list;
+}
+
+void WebsocketServer::deliverPlayerList(
+    std::shared_ptr<const EncodedPlayerList> list) {
+  const StageTimer timer(fanout_ns_, "fanout");
+  ++broadcasts_;
+  const auto& players = list->players;
+  const auto sessions = getSessions();
+  LOG_DEBUG << "Broadcasting player list to " << sessions->size()
+            << " clients. Total players: " << players->size();
+
+  const auto delivery = load_shedder_.getDelivery(shed_level_.load());
+
+  // 紧凑帧按观察者构建，但每个玩家在每个精度下只编码一次
+  std::optional<core::CompactFrameBuilder> compact_builder;
+  for (const auto& session : *sessions) {
+    if (!session->isRosterEnabled()) {
+      continue;
+    }
+    const auto& session_delivery = delivery[session->getSessionClass()];
+    if (session_delivery.dropped) {
+      ++frames_shed_;
+      continue;
+    }
+    std::optional<std::string> compact_frame;
+    const auto tier = session->getEncodingTier();
+    if (tier == core::EncodingTier::Compact ||
+        tier == core::EncodingTier::Coarse) {
+      if (!compact_builder) {
+        compact_builder.emplace(*players, precision_lod_config_);
+      }
+      compact_frame = compact_builder->buildFor(
+          session->getPlayerId(), tier == core::EncodingTier::Coarse
+                                      ? core::PrecisionBand::Far
+                                      : core::PrecisionBand::Near);
+    }
+    session->sendPlayerList(
+        players, compact_frame ? *compact_frame : list->full_frame,
+        session_delivery);
+  }
+}
+
+void WebsocketServer::broadcastHeatmap() {
+  std::vector<std::shared_ptr<Session>> subscribers;
+  const auto sessions = getSessions();
+  for (const auto& session : *sessions) {
+    if (session->isHeatmapSubscribed()) {
+      subscribers.push_back(session);
+    }
+  }
+  if (subscribers.empty()) {
+    return;
+  }
 
-  const auto players = registry_.getAllPlayers();
-  for (const auto& player : players) {
-    auto* player_data = player_list->add_players();
-    player_data->CopyFrom(player.second);
+  for (auto& frame : occupancy_->snapshotAll()) {
+    picoradar::ServerToClient response;
+    *response.mutable_heatmap() = std::move(frame);
+
+    std::string serialized_response;
+    response.SerializeToString(&serialized_response);
+    for (const auto& session : subscribers) {
+      session->send(serialized_response);
+    }
+  }
+}
+
+void WebsocketServer::checkProximity() {
+  // 没有潜在玩家对且没有待解除的警报时跳过
+  if (registry_.getPlayerCount() < 2 &&
+      proximity_->getActivePairCount() == 0) {
+    return;
   }
 
-  LOG_DEBUG << "Broadcasting player list to " << sessions_.size()
-            << " clients. Total players: " << players.size();
+  const auto events =
+      proximity_->update(*registry_.getSnapshot(), clock_.now());
+  if (events.empty()) {
+    return;
+  }
+
+  // 每个事件分别发给玩家对中的两个玩家，对方 ID 作为 other_player_id
+  std::unordered_map<std::string, picoradar::ProximityAlert> alerts;
+  const auto add_event = [&alerts](const std::string& recipient,
+                                   const std::string& other,
+                                   const core::ProximityPairEvent& event) {
+    auto* proximity_event = alerts[recipient].add_events();
+    proximity_event->set_other_player_id(other);
+    proximity_event->set_distance(event.distance);
+    proximity_event->set_closing_speed(event.closing_speed);
+    proximity_event->set_cleared(event.cleared);
+  };
+  for (const auto& event : events) {
+    add_event(event.first, event.second, event);
+    add_event(event.second, event.first, event);
+  }
+
+  const auto sessions = getSessions();
+  for (const auto& session : *sessions) {
+    auto it = alerts.find(session->getPlayerId());
+    if (it == alerts.end()) {
+      continue;
+    }
+    picoradar::ServerToClient response;
+    *response.mutable_proximity_alert() = std::move(it->second);
+
+    std::string serialized_response;
+    response.SerializeToString(&serialized_response);
+    session->send(serialized_response);
+    alerts.erase(it);
+  }
+}
+
+void WebsocketServer::checkGeofences() {
+  // 即使没有订阅者也要评估，保证订阅时的越界状态是最新的
+  const auto events = geofences_.evaluate(*registry_.getSnapshot());
+  if (events.empty()) {
+    return;
+  }
+
+  picoradar::ServerToClient response;
+  auto* alert = response.mutable_geofence_alert();
+  for (const auto& event : events) {
+    auto* geofence_event = alert->add_events();
+    geofence_event->set_player_id(event.player_id);
+    geofence_event->set_scene_id(event.scene_id);
+    geofence_event->set_fence_id(event.fence_id);
+    geofence_event->set_violated(event.violated);
+    *geofence_event->mutable_position() = event.position;
+
+    if (event.violated) {
+      LOG_WARNING << "Player " << event.player_id << " violated geofence '"
+                  << event.fence_id << "' in scene '" << event.scene_id
+                  << "'";
+    }
+  }
 
   std::string serialized_response;
   response.SerializeToString(&serialized_response);
+  const auto sessions = getSessions();
+  for (const auto& session : *sessions) {
+    if (session->isGeofenceSubscribed()) {
+      session->send(serialized_response);
+    }
+  }
+}
 
-  for (const auto& session : sessions_) {
-    session->send(serialized_response);
+void WebsocketServer::schedulePeriodic(net::steady_timer& timer,
+                                       PeriodicTask task) {
+  timer.expires_after(task.interval);
+  timer.async_wait([this, &timer, task](beast::error_code ec) {
+    if (ec) {
+      return;  // 服务器停止或重新调度时定时器被取消
+    }
+    {
+      const common::FlightSpan span(task.name);
+      (this->*task.run)();
+    }
+    if (parkIfIdle()) {
+      return;  // 空闲租户不再占用定时器，下个会话到达时重新调度
+    }
+    schedulePeriodic(timer, task);
+  });
+}
+
+void WebsocketServer::createPeriodicTimers() {
+  periodic_tasks_.clear();
+  periodic_timers_.clear();
+  for (const auto& task : getPeriodicTasks()) {
+    if (task.run == &WebsocketServer::runSimulationTick) {
+      continue;  // 由专用的模拟线程驱动
+    }
+    periodic_tasks_.push_back(task);
+    periodic_timers_.push_back(
+        std::make_unique<net::steady_timer>(periodic_strand_));
   }
 }
 
-std::string Session::getSafeEndpoint() const {
-  try {
-    if (ws_.next_layer().socket().is_open()) {
-      auto endpoint = ws_.next_layer().socket().remote_endpoint();
-      return endpoint.address().to_string() + ":" +
-             std::to_string(endpoint.port());
+void WebsocketServer::armPeriodicTasks() {
+  for (std::size_t i = 0; i < periodic_timers_.size(); ++i) {
+    schedulePeriodic(*periodic_timers_[i], periodic_tasks_[i]);
+  }
+}
+
+void WebsocketServer::publishRegistryChanges() { registry_.publishChanges(); }
+
+void WebsocketServer::injectPlayer(picoradar::PlayerData data) {
+  std::string player_id = data.player_id();
+  if (player_id.empty()) {
+    LOG_WARNING << "Ignoring server-authored player without an ID";
+    return;
+  }
+  {
+    std::lock_guard lock(injected_mutex_);
+    injected_ids_.insert(std::move(player_id));
+  }
+  activateTenant();
+  if (applyUpdate(std::move(data), true)) {
+    broadcastPlayerList();
+  }
+}
+
+void WebsocketServer::removeInjectedPlayer(const std::string& player_id) {
+  {
+    std::lock_guard lock(injected_mutex_);
+    if (injected_ids_.erase(player_id) == 0) {
+      return;
     }
-  } catch (const std::exception& e) {
-    // Socket is closed or not connected, return placeholder
   }
-  return "disconnected";
+  if (applyRemoval(player_id)) {
+    broadcastPlayerList();
+  }
+}
+
+auto WebsocketServer::isInjectedPlayer(const std::string& player_id) const
+    -> bool {
+  std::lock_guard lock(injected_mutex_);
+  return injected_ids_.count(player_id) != 0;
+}
+
+auto WebsocketServer::applyUpdate(picoradar::PlayerData data, bool reliable)
+    -> bool {
+  std::string encoded = data.SerializeAsString();
+  return applyUpdate(std::move(data), std::move(encoded), reliable);
+}
+
+auto WebsocketServer::applyUpdate(picoradar::PlayerData data,
+                                  std::string encoded, bool reliable)
+    -> bool {
+  if (ingest_) {
+    IngestRecord record;
+    record.data = std::move(data);
+    record.encoded = std::move(encoded);
+    enqueueIngest(std::move(record), reliable);
+    return false;
+  }
+  occupancy_->update(data);
+  std::string player_id = data.player_id();
+  registry_.updatePlayer(std::move(player_id), std::move(data),
+                         std::move(encoded));
+  return true;
+}
+
+auto WebsocketServer::applyRemoval(const std::string& player_id) -> bool {
+  if (ingest_) {
+    IngestRecord record;
+    record.removed = true;
+    record.data.set_player_id(player_id);
+    enqueueIngest(std::move(record), true);
+    return false;
+  }
+  registry_.removePlayer(player_id);
+  occupancy_->remove(player_id);
+  return true;
+}
+
+void WebsocketServer::enqueueIngest(IngestRecord record, bool reliable) {
+  // 同一会话的处理器在 strand 上串行执行，因此序号在会话内单调递增
+  record.sequence =
+      ingest_sequence_.fetch_add(1, std::memory_order_relaxed) + 1;
+  while (!ingest_->tryPush(record)) {
+    // 鉴权与断开必须送达：等待模拟线程腾出空间；没有消费者时只能丢弃
+    if (!reliable || !simulation_running_.load()) {
+      ++ingest_dropped_;
+      LOG_WARNING << "Ingest queue full, dropping update for "
+                  << record.data.player_id();
+      return;
+    }
+    std::this_thread::yield();
+  }
+}
+
+void WebsocketServer::runSimulationTick() {
+  if (!ingest_) {
+    return;
+  }
+  ++simulation_ticks_;
+  // 取空队列与写入注册表计入摄入阶段，编码与就地投递各自计时
+  const StageTimer timer(ingest_ns_, "simulation_tick");
+
+  // 1. 取空所有摄入队列，每个玩家只保留序号最大的记录
+  std::unordered_map<std::string, IngestRecord> latest;
+  ingest_->drain([&latest](IngestRecord&& record) {
+    auto& slot = latest[record.data.player_id()];
+    if (record.sequence > slot.sequence) {
+      slot = std::move(record);
+    }
+  });
+
+  // 2. 作为唯一的写者批量应用到注册表
+  bool changed = false;
+  for (auto& [player_id, record] : latest) {
+    auto tombstone = tombstones_.find(player_id);
+    if (tombstone != tombstones_.end()) {
+      if (tombstone->second.sequence > record.sequence) {
+        continue;  // 移除之前排队的旧更新
+      }
+      tombstones_.erase(tombstone);
+    }
+
+    if (record.removed) {
+      registry_.removePlayer(player_id);
+      occupancy_->remove(player_id);
+      tombstones_[player_id] = {record.sequence, simulation_ticks_};
+    } else {
+      occupancy_->update(record.data);
+      registry_.updatePlayer(player_id, std::move(record.data),
+                             std::move(record.encoded));
+    }
+    changed = true;
+  }
+
+  for (auto it = tombstones_.begin(); it != tombstones_.end();) {
+    if (simulation_ticks_ - it->second.tick > 1) {
+      it = tombstones_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  if (!changed) {
+    return;
+  }
+
+  // 3. 每个 tick 只编码一次完整帧，再交给 I/O 线程投递
+  std::shared_ptr<const EncodedPlayerList> list;
+  {
+    const StageTimer encode_timer(encode_ns_, "encode");
+    list = std::make_shared<const EncodedPlayerList>(encodePlayerList());
+  }
+  if (simulation_running_.load()) {
+    net::post(ioc_, [this, list] { deliverPlayerList(list); });
+  } else {
+    deliverPlayerList(list);
+  }
+}
+
+auto WebsocketServer::getWorkerCount() const -> size_t {
+  std::lock_guard lock(workers_mutex_);
+  return active_workers_;
+}
+
+void WebsocketServer::setWorkerCount(size_t count) {
+  std::lock_guard lock(workers_mutex_);
+  worker_autoscale_ = false;
+  if (worker_scaler_) {
+    worker_scaler_->reset();
+  }
+  if (workers_.empty()) {
+    return;  // 未运行
+  }
+  LOG_INFO << "Pinning io worker pool to " << count << " workers";
+  resizeWorkersLocked(count);
+}
+
+void WebsocketServer::setWorkerAutoscale(bool enabled) {
+  std::lock_guard lock(workers_mutex_);
+  worker_autoscale_ = enabled;
+  if (worker_scaler_) {
+    worker_scaler_->reset();
+  }
+}
+
+void WebsocketServer::setShedLevel(size_t level) {
+  std::lock_guard lock(shedder_mutex_);
+  load_shedder_.setLevel(level);
+  shed_level_ = load_shedder_.getLevel();
+}
+
+auto WebsocketServer::getEncodingTierCounts() const
+    -> std::array<size_t, core::kEncodingTierCount> {
+  std::array<size_t, core::kEncodingTierCount> counts{};
+  for (std::size_t i = 0; i < counts.size(); ++i) {
+    counts[i] = encoding_tiers_[i].load();
+  }
+  for (const auto* tenant : tenants_) {
+    const auto tenant_counts = tenant->getEncodingTierCounts();
+    for (std::size_t i = 0; i < counts.size(); ++i) {
+      counts[i] += tenant_counts[i];
+    }
+  }
+  return counts;
+}
+
+auto WebsocketServer::getEncodingSwitches() const -> size_t {
+  size_t count = encoding_switches_.load();
+  for (const auto* tenant : tenants_) {
+    count += tenant->getEncodingSwitches();
+  }
+  return count;
+}
+
+void WebsocketServer::onEncodingTierChanged(
+    std::optional<core::EncodingTier> from,
+    std::optional<core::EncodingTier> to) {
+  if (from) {
+    --encoding_tiers_[static_cast<std::size_t>(*from)];
+  }
+  if (to) {
+    ++encoding_tiers_[static_cast<std::size_t>(*to)];
+  }
+  if (from && to) {
+    ++encoding_switches_;
+  }
+}
+
+auto WebsocketServer::getFramesShed() const -> size_t {
+  size_t count = frames_shed_.load();
+  for (const auto* tenant : tenants_) {
+    count += tenant->getFramesShed();
+  }
+  return count;
+}
+
+void WebsocketServer::balanceWorkers() {
+  const auto now = std::chrono::steady_clock::now();
+  const auto cpu = common::process_cpu_time();
+
+  std::lock_guard lock(workers_mutex_);
+  if (workers_.empty() || !worker_scaler_) {
+    return;  // 内存模拟或服务器未运行
+  }
+
+  // 定时器按间隔重新调度，实际间隔超出的部分就是事件循环的排队延迟
+  const auto elapsed =
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          now - last_worker_probe_);
+  core::WorkerLoadSample sample;
+  sample.loop_lag = std::max(std::chrono::microseconds{0},
+                             elapsed - std::chrono::microseconds(
+                                           worker_probe_interval_));
+  if (elapsed.count() > 0) {
+    sample.utilization =
+        static_cast<double>((cpu - last_worker_probe_cpu_).count()) /
+        (static_cast<double>(elapsed.count()) *
+         static_cast<double>(active_workers_));
+  }
+  last_worker_probe_ = now;
+  last_worker_probe_cpu_ = cpu;
+
+  {
+    std::lock_guard shedder_lock(shedder_mutex_);
+    const auto previous = load_shedder_.getLevel();
+    const auto level = load_shedder_.update(sample.loop_lag);
+    if (level != previous) {
+      const auto& steps = load_shedder_.getSteps();
+      const auto& step = steps[std::max(level, previous) - 1];
+      LOG_WARNING << "Load shedding level " << previous << " -> " << level
+                  << " (loop lag " << sample.loop_lag.count() << "us): "
+                  << (level < previous ? "restore "
+                      : step.action == core::ShedStep::Action::Drop
+                          ? "drop "
+                          : "reduce rate of ")
+                  << core::sessionClassName(step.session_class)
+                  << " roster frames";
+      shed_level_ = level;
+      for (auto* tenant : tenants_) {
+        tenant->setShedLevel(level);
+      }
+    }
+  }
+
+  if (!worker_autoscale_) {
+    return;
+  }
+  const auto target = worker_scaler_->update(active_workers_, sample);
+  if (target != active_workers_) {
+    LOG_INFO << "Resizing io worker pool " << active_workers_ << " -> "
+             << target << " (loop lag " << sample.loop_lag.count()
+             << "us, utilization " << sample.utilization << ")";
+    resizeWorkersLocked(target);
+  }
+}
+
+void WebsocketServer::resizeWorkersLocked(std::size_t count) {
+  count = std::clamp<std::size_t>(count, 1, max_workers_);
+
+  for (auto slot = active_workers_; slot < count; ++slot) {
+    if (slot < workers_.size()) {
+      auto& worker = *workers_[slot];
+      // 尚未退出的线程直接恢复，避免同一个摄入队列出现两个生产者
+      auto expected = Worker::State::Retiring;
+      if (worker.state.compare_exchange_strong(expected,
+                                               Worker::State::Running)) {
+        continue;
+      }
+      if (worker.thread.joinable()) {
+        worker.thread.join();
+      }
+      worker.state = Worker::State::Running;
+    } else {
+      workers_.push_back(std::make_unique<Worker>());
+    }
+    auto* worker = workers_[slot].get();
+    worker->thread =
+        std::thread([this, worker, slot] { runWorker(*worker, slot); });
+  }
+
+  for (auto slot = count; slot < active_workers_; ++slot) {
+    workers_[slot]->state = Worker::State::Retiring;
+  }
+  active_workers_ = count;
+}
+
+void WebsocketServer::runWorker(Worker& worker, std::size_t slot) {
+  if (ingest_) {
+    ingest_->bindCurrentThread(slot);
+  }
+  while (!ioc_.stopped()) {
+    if (worker.state.load() == Worker::State::Running) {
+      // 分片运行，以便及时发现自己被缩容
+      ioc_.run_for(kWorkerRetireCheck);
+      continue;
+    }
+    auto expected = Worker::State::Retiring;
+    if (worker.state.compare_exchange_strong(expected,
+                                             Worker::State::Exited)) {
+      return;
+    }
+  }
+  worker.state = Worker::State::Exited;
+}
+
+void WebsocketServer::runSimulationThread() {
+  auto next_tick = std::chrono::steady_clock::now();
+  while (simulation_running_.load()) {
+    runSimulationTick();
+
+    if (parkIfIdle()) {
+      // 空闲租户的模拟线程挂起，直到有会话或玩家到达
+      std::unique_lock lock(simulation_mutex_);
+      simulation_cv_.wait(lock, [this] {
+        return tenant_active_.load() || !simulation_running_.load();
+      });
+      next_tick = std::chrono::steady_clock::now();
+      continue;
+    }
+
+    // 固定节拍；落后超过一个 tick 时重新对齐，不做追赶
+    next_tick += simulation_tick_;
+    const auto now = std::chrono::steady_clock::now();
+    if (next_tick + simulation_tick_ < now) {
+      next_tick = now;
+    }
+    std::this_thread::sleep_until(next_tick);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Scene affinity
+
+void WebsocketServer::resetLanes(size_t lane_count) {
+  std::lock_guard lock(lanes_mutex_);
+  lane_count_ = lane_count;
+  lane_loads_.assign(lane_count_, 0);
+  scene_lanes_.clear();
+  if (lane_count_ > 0 && !isTenant()) {
+    LOG_INFO << "Scene affinity enabled with " << lane_count_ << " lanes";
+  }
+}
+
+auto WebsocketServer::getLaneLoads() const -> std::vector<size_t> {
+  std::lock_guard lock(lanes_mutex_);
+  return lane_loads_;
+}
+
+auto WebsocketServer::getSceneLane(const std::string& scene_id) const
+    -> std::optional<size_t> {
+  std::lock_guard lock(lanes_mutex_);
+  auto it = scene_lanes_.find(scene_id);
+  if (it == scene_lanes_.end()) {
+    return std::nullopt;
+  }
+  return it->second.lane;
+}
+
+void WebsocketServer::placeSession(const std::shared_ptr<Session>& session,
+                                   const std::string& scene_id) {
+  std::lock_guard lock(lanes_mutex_);
+  releaseSessionLocked(session);
+
+  auto& scene = scene_lanes_[scene_id];
+  if (scene.lane == Session::kNoLane) {
+    // 新场景放到负载最低的通道
+    scene.lane = static_cast<std::size_t>(
+        std::min_element(lane_loads_.begin(), lane_loads_.end()) -
+        lane_loads_.begin());
+    LOG_DEBUG << "Scene '" << scene_id << "' placed on lane " << scene.lane;
+  }
+  scene.sessions.insert(session);
+  ++lane_loads_[scene.lane];
+  session->setSceneId(scene_id);
+  session->setLane(scene.lane);
+}
+
+void WebsocketServer::releaseSessionLocked(
+    const std::shared_ptr<Session>& session) {
+  const auto& scene_id = session->getSceneId();
+  if (!scene_id) {
+    return;
+  }
+  auto it = scene_lanes_.find(*scene_id);
+  if (it == scene_lanes_.end() || it->second.sessions.erase(session) == 0) {
+    return;
+  }
+  --lane_loads_[it->second.lane];
+  if (it->second.sessions.empty()) {
+    scene_lanes_.erase(it);
+  }
+}
+
+void WebsocketServer::rebalanceScenes() {
+  std::lock_guard lock(lanes_mutex_);
+  if (lane_loads_.size() < 2) {
+    return;
+  }
+  const auto [idlest, busiest] =
+      std::minmax_element(lane_loads_.begin(), lane_loads_.end());
+  const auto gap = *busiest - *idlest;
+  const auto from = static_cast<std::size_t>(busiest - lane_loads_.begin());
+  const auto to = static_cast<std::size_t>(idlest - lane_loads_.begin());
+
+  // 场景整体迁移；只迁移小于负载差的场景，两条通道的差距才会缩小
+  std::string moved_id;
+  SceneLane* moved = nullptr;
+  for (auto& [scene_id, scene] : scene_lanes_) {
+    const auto size = scene.sessions.size();
+    if (scene.lane == from && size < gap &&
+        (moved == nullptr || size > moved->sessions.size())) {
+      moved_id = scene_id;
+      moved = &scene;
+    }
+  }
+  if (moved == nullptr) {
+    return;
+  }
+
+  const auto count = moved->sessions.size();
+  lane_loads_[from] -= count;
+  lane_loads_[to] += count;
+  moved->lane = to;
+  for (const auto& session : moved->sessions) {
+    session->setLane(to);
+  }
+  LOG_INFO << "Moved scene '" << moved_id << "' (" << count
+           << " sessions) from lane " << from << " to lane " << to;
 }
 
 auto WebsocketServer::getConnectionCount() const -> size_t {
-  std::lock_guard<std::mutex> lock(stats_mutex_);
-  return sessions_.size();
+  size_t count = 0;
+  {
+    std::lock_guard lock(sessions_mutex_);
+    count = sessions_.size();
+  }
+  for (const auto* tenant : tenants_) {
+    count += tenant->getConnectionCount();
+  }
+  return count;
 }
 
 auto WebsocketServer::getMessagesReceived() const -> size_t {
-  return messages_received_.load();
+  size_t count = messages_received_.load();
+  for (const auto* tenant : tenants_) {
+    count += tenant->getMessagesReceived();
+  }
+  return count;
 }
 
 auto WebsocketServer::getMessagesSent() const -> size_t {
-  return messages_sent_.load();
+  size_t count = messages_sent_.load();
+  for (const auto* tenant : tenants_) {
+    count += tenant->getMessagesSent();
+  }
+  return count;
+}
+
+auto WebsocketServer::getStageCosts() const -> StageCosts {
+  StageCosts costs;
+  costs.ingest_ns = ingest_ns_.load();
+  costs.encode_ns = encode_ns_.load();
+  costs.fanout_ns = fanout_ns_.load();
+  costs.write_ns = write_ns_.load();
+  costs.broadcasts = broadcasts_.load();
+  costs.writes = writes_.load();
+  for (const auto* tenant : tenants_) {
+    const auto tenant_costs = tenant->getStageCosts();
+    costs.ingest_ns += tenant_costs.ingest_ns;
+    costs.encode_ns += tenant_costs.encode_ns;
+    costs.fanout_ns += tenant_costs.fanout_ns;
+    costs.write_ns += tenant_costs.write_ns;
+    costs.broadcasts += tenant_costs.broadcasts;
+    costs.writes += tenant_costs.writes;
+  }
+  return costs;
+}
+
+void WebsocketServer::onWriteTimed(
+    std::chrono::steady_clock::duration elapsed) {
+  write_ns_.fetch_add(
+      static_cast<std::uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+              .count()),
+      std::memory_order_relaxed);
+  writes_.fetch_add(1, std::memory_order_relaxed);
 }
 
 void WebsocketServer::incrementMessagesSent() { ++messages_sent_; }
 
 void WebsocketServer::incrementMessagesReceived() { ++messages_received_; }
 
+void WebsocketServer::onTlsHandshake(bool resumed) {
+  ++tls_handshakes_;
+  if (resumed) {
+    ++tls_resumed_handshakes_;
+  }
+}
+
 }  // namespace picoradar::network
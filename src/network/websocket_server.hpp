@@ -1,15 +1,41 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <boost/asio.hpp>
 #include <boost/beast.hpp>
+#include <boost/beast/ssl.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <queue>
 #include <set>
 #include <string>
 #include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
+#include "common/clock.hpp"
+#include "core/bandwidth_budget.hpp"
+#include "core/encoding_selector.hpp"
+#include "core/frame_packer.hpp"
+#include "core/geofence.hpp"
+#include "core/ingest_queue.hpp"
+#include "core/load_shedder.hpp"
+#include "core/occupancy_grid.hpp"
 #include "core/player_registry.hpp"
+#include "core/pose_codec.hpp"
+#include "core/proximity_detector.hpp"
+#include "core/worker_scaler.hpp"
+#include "network/tls_context.hpp"
 #include "player.pb.h"
 
 namespace beast = boost::beast;
@@ -17,21 +43,207 @@ namespace net = boost::asio;
 namespace websocket = beast::websocket;
 using tcp = net::ip::tcp;
 
+namespace picoradar {
+class ClientToServer;
+}  // namespace picoradar
+
 namespace picoradar::network {
 
 class WebsocketServer;  // Forward declaration
 
-// Handles a single WebSocket connection
+// Per-session egress bandwidth settings (network.bandwidth.*)
+struct BandwidthConfig {
+  std::size_t bytes_per_sec = 0;  // 0 = not configured
+  bool estimate = true;           // estimate from write completions
+};
+
+// One venue hosted by a multi-tenant server (tenants.<name>.*)
+struct TenantConfig {
+  std::string name;
+  std::string token;  // auth token that selects this tenant
+  // Run the tenant's registry writes and roster encoding on its own
+  // simulation thread instead of the shared io workers
+  bool dedicated_thread = false;
+};
+
+// Cumulative time spent in each stage of the pose pipeline. CPU stages
+// count exclusive time: a broadcast run inline by an update is charged to
+// encode and fan-out, not to ingest.
+struct StageCosts {
+  std::uint64_t ingest_ns = 0;  // parse client messages, apply updates
+  std::uint64_t encode_ns = 0;  // splice the shared roster frame
+  std::uint64_t fanout_ns = 0;  // per-viewer framing, pacing and queueing
+  std::uint64_t write_ns = 0;   // socket writes, wall time until completion
+  std::uint64_t broadcasts = 0;
+  std::uint64_t writes = 0;
+};
+
+// Transport-independent state of one client connection. The server only
+// talks to this interface, so tests can attach in-memory sessions.
 class Session : public std::enable_shared_from_this<Session> {
-  websocket::stream<beast::tcp_stream> ws_;
-  beast::flat_buffer buffer_;
-  WebsocketServer& server_;
+ public:
+  explicit Session(WebsocketServer& server);
+  virtual ~Session() = default;
+
+  Session(const Session&) = delete;
+  Session& operator=(const Session&) = delete;
+
+  // Queue a serialized ServerToClient frame for delivery
+  virtual void send(const std::string& message) = 0;
+  void close() { close(nullptr); }
+  // Close the transport; on_closed (if any) runs once the socket is closed
+  virtual void close(std::function<void()> on_closed) = 0;
+
+  // Send a player list, packing a prioritized partial frame when the
+  // session's bandwidth budget cannot hold the full one. The frame is
+  // skipped when delivery limits the session's frame rate or queue depth.
+  void sendPlayerList(
+      const std::shared_ptr<const core::FramePacker::PlayerMap>& players,
+      const std::string& full_frame, const core::ClassDelivery& delivery = {});
+
+  // Frames queued for the client and not yet written
+  virtual auto getQueueDepth() const -> std::size_t = 0;
+
+  // Getters and setters for player_id
+  auto getPlayerId() const -> const std::string& { return player_id_; }
+  void setPlayerId(const std::string& id) { player_id_ = id; }
+
+  // Scene the server placed the session in; only touched by its handlers
+  auto getSceneId() const -> const std::optional<std::string>& {
+    return scene_id_;
+  }
+  void setSceneId(const std::string& id) { scene_id_ = id; }
+
+  // Lane the server grouped the session's scene into, kNoLane until placed.
+  // Transports keep their own strand for their whole lifetime; the lane is
+  // bookkeeping only and never touches a pending operation.
+  static constexpr std::size_t kNoLane =
+      std::numeric_limits<std::size_t>::max();
+  auto getLane() const -> std::size_t {
+    return lane_.load(std::memory_order_acquire);
+  }
+  void setLane(std::size_t lane) {
+    lane_.store(lane, std::memory_order_release);
+  }
+
+  // Declared at auth; spectators and operators are shed before players
+  auto getSessionClass() const -> picoradar::SessionClass {
+    return session_class_;
+  }
+  void setSessionClass(picoradar::SessionClass session_class) {
+    session_class_ = session_class;
+  }
+
+  // Roster encoding, chosen at auth. With network.adaptive_encoding the
+  // session moves along its ladder as completed writes report its link
+  // quality; see core::EncodingSelector.
+  auto getEncodingTier() const -> core::EncodingTier { return encoding_tier_; }
+  void setEncodingTier(core::EncodingTier tier) { encoding_tier_ = tier; }
+  void enableAdaptiveEncoding(const core::EncodingSelectorConfig& config,
+                              std::vector<core::EncodingTier> ladder);
+  // Stop adapting and drop the session from the server's tier counts
+  void disableAdaptiveEncoding();
+  auto isAdaptiveEncoding() const -> bool { return probe_interval_ms_ > 0; }
+  // Link estimate of an adaptive session, nullopt otherwise
+  auto getLinkEstimate() const -> std::optional<core::LinkEstimate>;
+
+  auto isHeatmapSubscribed() const -> bool { return heatmap_subscribed_; }
+  void setHeatmapSubscribed(bool enabled) { heatmap_subscribed_ = enabled; }
+  auto isRosterEnabled() const -> bool { return roster_enabled_; }
+  void setRosterEnabled(bool enabled) { roster_enabled_ = enabled; }
+  auto isGeofenceSubscribed() const -> bool { return geofence_subscribed_; }
+  void setGeofenceSubscribed(bool enabled) { geofence_subscribed_ = enabled; }
+
+  // Safe method to get endpoint string
+  virtual std::string getSafeEndpoint() const = 0;
+
+  // The server this session belongs to. A front server hands sessions over
+  // to the tenant selected by their auth token.
+  auto server() const -> WebsocketServer& {
+    return *server_.load(std::memory_order_acquire);
+  }
+  void moveTo(WebsocketServer& server) {
+    server_.store(&server, std::memory_order_release);
+  }
+
+ protected:
+  // Feed a completed write into the bandwidth estimate and, for adaptive
+  // sessions, the encoding selector. queued_for runs from send() to the
+  // end of the write.
+  void onWriteCompleted(std::size_t bytes,
+                        std::chrono::steady_clock::duration elapsed,
+                        bool backlogged,
+                        std::chrono::steady_clock::duration queued_for);
+  void onRttMeasured(std::chrono::steady_clock::duration rtt);
+  // How often transports should measure the round-trip time; zero when
+  // the session is not adaptive
+  auto getProbeInterval() const -> std::chrono::milliseconds {
+    return std::chrono::milliseconds(probe_interval_ms_.load());
+  }
+
   std::string player_id_;
-  std::queue<std::string> write_queue_;
-  net::strand<net::any_io_executor> strand_;
+  std::optional<std::string> scene_id_;
+
+ private:
+  std::atomic<WebsocketServer*> server_;
+  std::atomic<std::size_t> lane_{kNoLane};
+
+  // Egress pacing state, shared between broadcasting threads and the strand
+  mutable std::mutex pacing_mutex_;
+  core::BandwidthBudget budget_;
+  core::FramePacker packer_;
+  std::shared_ptr<const core::FramePacker::PlayerMap> last_full_roster_;
+  std::chrono::steady_clock::time_point last_full_time_;
+  std::optional<std::chrono::steady_clock::time_point> last_roster_time_;
+  std::optional<core::EncodingSelector> encoding_selector_;
+
+  std::atomic<picoradar::SessionClass> session_class_{
+      picoradar::SESSION_CLASS_PLAYER};
+
+  std::atomic<core::EncodingTier> encoding_tier_{core::EncodingTier::Full};
+  std::atomic<std::chrono::milliseconds::rep> probe_interval_ms_{0};
+
+  // Subscription state (see Subscription in client.proto)
+  std::atomic<bool> heatmap_subscribed_{false};
+  std::atomic<bool> roster_enabled_{true};
+  std::atomic<bool> geofence_subscribed_{false};
+};
+
+// Handles a single WebSocket connection. NextLayer is beast::tcp_stream for
+// ws:// or beast::ssl_stream<beast::tcp_stream> for wss://.
+template <class NextLayer>
+class BasicWebsocketSession : public Session {
+  static constexpr bool kSecure =
+      !std::is_same_v<NextLayer, beast::tcp_stream>;
+
+  struct QueuedFrame {
+    std::string data;
+    std::chrono::steady_clock::time_point queued_at;
+  };
+
+  websocket::stream<NextLayer> ws_;
+  beast::flat_buffer buffer_;
+  std::queue<QueuedFrame> write_queue_;
+  std::atomic<std::size_t> queue_depth_{0};  // write_queue_ plus posted sends
+  // Every handler and completion of the session runs here
+  net::strand<net::io_context::executor_type> strand_;
+  std::chrono::steady_clock::time_point write_started_;
+  // RTT probe of adaptive sessions; touched on strand_
+  std::chrono::steady_clock::time_point ping_sent_;
+  bool ping_in_flight_ = false;
+  bool accepted_ = false;  // 握手完成前发送的消息只入队，避免与握手响应并发写
+  bool tls_established_ = false;
 
  public:
-  Session(tcp::socket&& socket, WebsocketServer& server);
+  // Extra arguments are forwarded to the transport (the ssl::context for
+  // TLS sessions)
+  template <class... TransportArgs>
+  BasicWebsocketSession(tcp::socket&& socket, WebsocketServer& server,
+                        TransportArgs&... transport_args)
+      : Session{server},
+        ws_{std::move(socket), transport_args...},
+        strand_{net::make_strand(static_cast<net::io_context&>(
+            net::query(ws_.get_executor(), net::execution::context)))} {}
 
   // Start the asynchronous operation
   void run();
@@ -40,35 +252,62 @@ class Session : public std::enable_shared_from_this<Session> {
   void on_read(beast::error_code ec, std::size_t bytes_transferred);
   void on_accept(beast::error_code ec);
   void on_close(beast::error_code ec);
-  void close();
+  using Session::close;
+  void close(std::function<void()> on_closed) override;
 
   // Method to send a message to the client
-  void send(const std::string& message);
+  void send(const std::string& message) override;
+
   void on_write(beast::error_code ec, std::size_t bytes_transferred);
 
-  // Getters and setters for player_id
-  auto getPlayerId() const -> const std::string& { return player_id_; }
-  void setPlayerId(const std::string& id) { player_id_ = id; }
+  auto getQueueDepth() const -> std::size_t override {
+    return queue_depth_.load(std::memory_order_relaxed);
+  }
 
-  // Safe method to get endpoint string
-  std::string getSafeEndpoint() const;
+  std::string getSafeEndpoint() const override;
 
  private:
+  auto self() -> std::shared_ptr<BasicWebsocketSession> {
+    return std::static_pointer_cast<BasicWebsocketSession>(
+        shared_from_this());
+  }
+
+  // Wrap a completion handler so it runs on strand_
+  template <class F>
+  auto bindToStrand(F&& f);
+  void enqueue(std::string message,
+               std::chrono::steady_clock::time_point queued_at);
+
   void do_write();
+  // Ping the client when an RTT sample is due
+  void probe_rtt();
+  void on_pong();
+  void do_tls_handshake();
+  void on_tls_handshake(beast::error_code ec);
   void do_accept();
 };
 
+using WebsocketSession = BasicWebsocketSession<beast::tcp_stream>;
+using SecureWebsocketSession =
+    BasicWebsocketSession<beast::ssl_stream<beast::tcp_stream>>;
+
 // Accepts incoming connections and launches the sessions
 class Listener : public std::enable_shared_from_this<Listener> {
   net::io_context& ioc_;
   tcp::acceptor acceptor_;
   tcp::socket socket_;
   WebsocketServer& server_;
+  ssl::context* tls_;  // nullptr = plain ws://
+  std::uint16_t port_ = 0;
 
  public:
   Listener(net::io_context& ioc, const tcp::endpoint& endpoint,
-           WebsocketServer& server)
-      : ioc_(ioc), acceptor_(ioc), socket_(ioc), server_(server) {
+           WebsocketServer& server, ssl::context* tls = nullptr)
+      : ioc_(ioc),
+        acceptor_(ioc),
+        socket_(ioc),
+        server_(server),
+        tls_(tls) {
     beast::error_code ec;
 
     // Open the acceptor
@@ -97,10 +336,14 @@ class Listener : public std::enable_shared_from_this<Listener> {
     if (ec) {
       throw std::runtime_error("Failed to listen: " + ec.message());
     }
+    port_ = acceptor_.local_endpoint().port();
   }
 
   void run() { do_accept(); }
 
+  // The bound port, which the OS picks when the endpoint's port is 0
+  [[nodiscard]] auto getPort() const -> std::uint16_t { return port_; }
+
   void stop() { acceptor_.close(); }
 
  private:
@@ -115,37 +358,377 @@ class Listener : public std::enable_shared_from_this<Listener> {
 
 class WebsocketServer {
  public:
+  // A server task run at a fixed interval (heatmap, proximity, geofence)
+  struct PeriodicTask {
+    std::chrono::milliseconds interval;
+    void (WebsocketServer::*run)();
+    const char* name;  // flight recorder span
+  };
+
   WebsocketServer(net::io_context& ioc, core::PlayerRegistry& registry);
+  WebsocketServer(net::io_context& ioc, core::PlayerRegistry& registry,
+                  const common::Clock& clock);
   ~WebsocketServer();
 
+  // port 0 binds an ephemeral port; getPort() reports it after start()
   void start(const std::string& address, uint16_t port, int thread_count);
   void stop();
+  [[nodiscard]] auto getPort() const -> uint16_t;
+
+  // Load runtime settings from ConfigManager. start() calls this; in-memory
+  // simulations call it directly and drive getPeriodicTasks() themselves.
+  void configure();
+
+  // Periodic tasks enabled by the current configuration
+  [[nodiscard]] auto getPeriodicTasks() const -> std::vector<PeriodicTask>;
+
+  // Multi-tenant hosting (tenants.*). The front server owns the listener,
+  // TLS and io workers; each tenant keeps its own registry, periodic tasks
+  // and optional simulation thread on the shared io_context. An auth token
+  // that matches a tenant moves the session to that tenant. Tenants are
+  // started and stopped with their front server, and an idle tenant (no
+  // sessions, no players) parks its timers and simulation thread.
+  //
+  // Throws std::runtime_error on a malformed tenants section or a token
+  // that is empty, repeated or equal to auth.token.
+  static auto loadTenantConfigs() -> std::vector<TenantConfig>;
+  // Register tenant before start(); tenant must share this server's
+  // io_context and outlive it
+  void addTenant(TenantConfig config, WebsocketServer& tenant);
+  [[nodiscard]] auto getTenantName() const -> const std::string& {
+    return tenant_.name;
+  }
+  [[nodiscard]] auto isTenantActive() const -> bool {
+    return tenant_active_.load();
+  }
+
+  [[nodiscard]] auto getClock() const -> const common::Clock& {
+    return clock_;
+  }
+
+  // Connected sessions. Every change publishes a new immutable list, so
+  // broadcasts and periodic tasks on any thread iterate a snapshot without
+  // holding the lock while sessions open and close on other workers.
+  using SessionList = std::vector<std::shared_ptr<Session>>;
+  [[nodiscard]] auto getSessions() const -> std::shared_ptr<const SessionList>;
 
   void onSessionOpened(const std::shared_ptr<Session>& session);
   void onSessionClosed(const std::shared_ptr<Session>& session);
   void processMessage(const std::shared_ptr<Session>& session,
                       const std::string& message);
   void broadcastPlayerList();
+  void broadcastHeatmap();
+  void checkProximity();
+  void checkGeofences();
+
+  // Deliver batched registry changes to embedding observers
+  void publishRegistryChanges();
+
+  // Single-writer mode (network.simulation_thread.*): drain the ingest
+  // queues, apply the newest record per player to the registry, encode the
+  // roster once and hand it back to the io threads. Runs on the dedicated
+  // simulation thread once started, or as a periodic task in simulations.
+  void runSimulationTick();
 
-  // Statistics methods
+  // Elastic io worker pool (network.workers.*). Every worker runs the shared
+  // io_context and sessions live on strands, so sessions accepted after a
+  // resize are spread over the new workers without migration. start()'s
+  // thread_count is the initial size.
+  [[nodiscard]] auto getWorkerCount() const -> size_t;
+  // Pin the pool to count workers (clamped to [1, max]); turns autoscaling
+  // off until setWorkerAutoscale(true)
+  void setWorkerCount(size_t count);
+  void setWorkerAutoscale(bool enabled);
+  [[nodiscard]] auto isWorkerAutoscale() const -> bool {
+    return worker_autoscale_.load();
+  }
+  // Sample event-loop lag and CPU use; resize the pool when autoscaling
+  void balanceWorkers();
+
+  // Scene affinity (network.scene_affinity.*, off by default). The pool
+  // gets one lane per possible worker and all sessions of a scene_id are
+  // grouped on the same lane. New scenes go to the least loaded lane and
+  // rebalanceScenes() moves whole scenes off the busiest one. Only the
+  // grouping is tracked: an accepted Beast stream cannot change executor,
+  // so reads, writes and roster fan-out still run on each session's strand.
+  [[nodiscard]] auto getLaneCount() const -> size_t { return lane_count_; }
+  // Sessions placed on each lane
+  [[nodiscard]] auto getLaneLoads() const -> std::vector<size_t>;
+  [[nodiscard]] auto getSceneLane(const std::string& scene_id) const
+      -> std::optional<size_t>;
+  void rebalanceScenes();
+
+  // Load shedding (network.session_classes.*, network.shedding.*). The
+  // worker probe feeds event-loop lag into the shedder; each level applies
+  // one more step of its ladder to roster delivery. Tenants follow the
+  // level of their front server.
+  [[nodiscard]] auto getShedLevel() const -> size_t {
+    return shed_level_.load();
+  }
+  // Pin the level (clamped to the ladder); the probe keeps adjusting it
+  void setShedLevel(size_t level);
+  [[nodiscard]] auto getLoadShedder() const -> const core::LoadShedder& {
+    return load_shedder_;
+  }
+  // Roster frames skipped by class rate limits, queue limits or shedding
+  [[nodiscard]] auto getFramesShed() const -> size_t;
+  void incrementFramesShed() { ++frames_shed_; }
+
+  // Per-session adaptive encoding (network.adaptive_encoding.*). Sessions
+  // authenticated while it is enabled pick their roster encoding from
+  // their own link quality.
+  [[nodiscard]] auto getAdaptiveEncodingConfig() const
+      -> const core::EncodingSelectorConfig& {
+    return adaptive_encoding_config_;
+  }
+  // Adaptive sessions currently on each tier, indexed by EncodingTier
+  [[nodiscard]] auto getEncodingTierCounts() const
+      -> std::array<size_t, core::kEncodingTierCount>;
+  // Tier changes made by adaptive sessions
+  [[nodiscard]] auto getEncodingSwitches() const -> size_t;
+  void onEncodingTierChanged(std::optional<core::EncodingTier> from,
+                             std::optional<core::EncodingTier> to);
+
+  // Server-authored players (NPCs) from an embedding game server. Must run
+  // on the io_context. They are broadcast like any other player, and their
+  // IDs are refused to WebSocket clients until removed.
+  void injectPlayer(picoradar::PlayerData data);
+  void removeInjectedPlayer(const std::string& player_id);
+  [[nodiscard]] auto isInjectedPlayer(const std::string& player_id) const
+      -> bool;
+
+  // Statistics methods; a front server includes its tenants
   [[nodiscard]] auto getConnectionCount() const -> size_t;
   [[nodiscard]] auto getMessagesReceived() const -> size_t;
   [[nodiscard]] auto getMessagesSent() const -> size_t;
+  // Pose updates dropped because an ingest queue was full
+  [[nodiscard]] auto getIngestDropped() const -> size_t {
+    return ingest_dropped_.load();
+  }
   void incrementMessagesSent();
   void incrementMessagesReceived();
+  // Time spent in each pipeline stage since the server was created
+  [[nodiscard]] auto getStageCosts() const -> StageCosts;
+  void onWriteTimed(std::chrono::steady_clock::duration elapsed);
+
+  // Completed TLS handshakes; resumed ones reused a ticket or cached session
+  [[nodiscard]] auto isTlsEnabled() const -> bool { return tls_ != nullptr; }
+  [[nodiscard]] auto getTlsHandshakes() const -> size_t {
+    return tls_handshakes_.load();
+  }
+  [[nodiscard]] auto getTlsResumedHandshakes() const -> size_t {
+    return tls_resumed_handshakes_.load();
+  }
+  void onTlsHandshake(bool resumed);
+
+  [[nodiscard]] auto getBandwidthConfig() const -> const BandwidthConfig& {
+    return bandwidth_config_;
+  }
+
+  [[nodiscard]] auto getPrecisionLodConfig() const
+      -> const core::PrecisionLodConfig& {
+    return precision_lod_config_;
+  }
+
+  [[nodiscard]] auto getOccupancyGrid() const -> const core::OccupancyGrid& {
+    return *occupancy_;
+  }
 
  private:
+  // A registry write queued for the simulation thread. sequence orders
+  // records of one session that land in different io threads' queues.
+  struct IngestRecord {
+    std::uint64_t sequence = 0;
+    bool removed = false;
+    picoradar::PlayerData data;
+    std::string encoded;  // wire format of data
+  };
+
+  // Roster frame shared by every recipient, spliced from the registry's
+  // per-player records
+  struct EncodedPlayerList {
+    std::shared_ptr<const core::FramePacker::PlayerMap> players;
+    std::string full_frame;
+  };
+
+  // Sessions placed on one scene's lane
+  struct SceneLane {
+    std::size_t lane = Session::kNoLane;
+    std::set<std::shared_ptr<Session>> sessions;
+  };
+
+  // Run task every interval on the io_context until the timer is cancelled
+  // or the tenant goes idle
+  void schedulePeriodic(net::steady_timer& timer, PeriodicTask task);
+  void createPeriodicTimers();
+  void armPeriodicTasks();
+
+  // raw_message is the serialized client_msg; pose updates keep their
+  // PlayerData bytes from it instead of being re-serialized
+  void handleMessage(const std::shared_ptr<Session>& session,
+                     const picoradar::ClientToServer& client_msg,
+                     const std::string& raw_message);
+  [[nodiscard]] auto findTenant(const std::string& token) const
+      -> WebsocketServer*;
+
+  [[nodiscard]] auto isTenant() const -> bool { return !tenant_.name.empty(); }
+  // Tenants group their scenes into as many lanes as the front server
+  void startTenant(size_t lane_count);
+  void stopTenant();
+  // Cancel the periodic timers and detach every session; the caller closes
+  // the returned sessions (io thread only)
+  auto detachSessions() -> std::shared_ptr<const SessionList>;
+  void stopSimulationThread();
+  [[nodiscard]] auto isIdle() const -> bool;
+  // Wake a parked tenant when a session or player arrives
+  void activateTenant();
+  // Park an idle tenant; returns false if it still has work
+  auto parkIfIdle() -> bool;
+
+  // Registry writes. In single-writer mode they are queued for the
+  // simulation thread; otherwise they are applied at once and the caller
+  // broadcasts (returns true). Pose updates that do not have to arrive
+  // (reliable = false) are dropped when the queue is full. encoded is the
+  // PlayerData wire format of data; the first overload serializes it.
+  auto applyUpdate(picoradar::PlayerData data, bool reliable) -> bool;
+  auto applyUpdate(picoradar::PlayerData data, std::string encoded,
+                   bool reliable) -> bool;
+  auto applyRemoval(const std::string& player_id) -> bool;
+  void enqueueIngest(IngestRecord record, bool reliable);
+
+  void runSimulationThread();
+
+  // Session set updates; both return the number of sessions afterwards
+  auto addSession(const std::shared_ptr<Session>& session) -> size_t;
+  auto eraseSession(const std::shared_ptr<Session>& session)
+      -> std::optional<size_t>;  // nullopt if session was not registered
+  void publishSessionsLocked();
+
+  void resetLanes(size_t lane_count);
+  // Move session to the lane of scene_id, placing the scene if it is new
+  void placeSession(const std::shared_ptr<Session>& session,
+                    const std::string& scene_id);
+  void releaseSessionLocked(const std::shared_ptr<Session>& session);
+
+  // One io thread of the elastic pool; slot is its index in workers_ and
+  // its ingest queue
+  struct Worker {
+    enum class State { Running, Retiring, Exited };
+    std::atomic<State> state{State::Running};
+    std::thread thread;
+  };
+  void runWorker(Worker& worker, std::size_t slot);
+  void resizeWorkersLocked(std::size_t count);
+
+  [[nodiscard]] auto encodePlayerList() const -> EncodedPlayerList;
+  void deliverPlayerList(std::shared_ptr<const EncodedPlayerList> list);
+
   net::io_context& ioc_;
   core::PlayerRegistry& registry_;
+  const common::Clock& clock_;
   std::shared_ptr<Listener> listener_;
+  mutable std::mutex sessions_mutex_;
   std::set<std::shared_ptr<Session>> sessions_;
-  std::vector<std::thread> threads_;
+  std::shared_ptr<const SessionList> session_list_ =
+      std::make_shared<const SessionList>();
+  // Retired workers stay in workers_ until their slot is reused or the
+  // server stops; active ones are workers_[0, active_workers_)
+  mutable std::mutex workers_mutex_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::size_t active_workers_ = 0;
+  std::size_t max_workers_ = 0;
+  core::WorkerScalerConfig worker_scaler_config_;
+  std::unique_ptr<core::WorkerScaler> worker_scaler_;
+  std::atomic<bool> worker_autoscale_{false};
+  std::chrono::milliseconds worker_probe_interval_{0};
+  std::chrono::steady_clock::time_point last_worker_probe_;
+  std::chrono::microseconds last_worker_probe_cpu_{0};
   bool is_running_ = false;
+  // Transport encryption (network.tls.*); tls_ is built by start()
+  TlsConfig tls_config_;
+  std::unique_ptr<ssl::context> tls_;
+  BandwidthConfig bandwidth_config_;
+  core::PrecisionLodConfig precision_lod_config_;
+  core::EncodingSelectorConfig adaptive_encoding_config_;
+
+  // Occupancy heatmap for overview subscribers
+  std::unique_ptr<core::OccupancyGrid> occupancy_;
+  std::chrono::milliseconds heatmap_interval_{0};
+
+  // Server-side proximity alerts
+  std::unique_ptr<core::ProximityDetector> proximity_;
+  std::chrono::milliseconds proximity_interval_{0};
+
+  // Play-area boundary checks (geofence.*)
+  core::GeofenceEngine geofences_;
+  std::chrono::milliseconds geofence_interval_{0};
+
+  // Load shedding; load_shedder_ is replaced only by configure()
+  std::mutex shedder_mutex_;
+  core::LoadShedder load_shedder_;
+  std::atomic<size_t> shed_level_{0};
+
+  // Embedding API (embedding.*). injectPlayer() runs on one io thread while
+  // handleMessage() checks the IDs on the others
+  std::chrono::milliseconds observer_interval_{0};
+  mutable std::mutex injected_mutex_;
+  std::unordered_set<std::string> injected_ids_;
+
+  // Single-writer mode (network.simulation_thread.*)
+  bool simulation_enabled_ = false;
+  std::chrono::milliseconds simulation_tick_{0};
+  std::size_t ingest_capacity_ = 0;
+  std::unique_ptr<core::IngestQueue<IngestRecord>> ingest_;
+  std::atomic<std::uint64_t> ingest_sequence_{0};
+  std::atomic<size_t> ingest_dropped_{0};
+  std::thread simulation_thread_;
+  std::atomic<bool> simulation_running_{false};
+  // Owned by the tick: sequence and tick of each removal, kept for one more
+  // tick so updates queued before it on another io thread are discarded
+  struct Tombstone {
+    std::uint64_t sequence = 0;
+    std::uint64_t tick = 0;
+  };
+  std::unordered_map<std::string, Tombstone> tombstones_;
+  std::uint64_t simulation_ticks_ = 0;
+
+  // Timers driving getPeriodicTasks() while the server is running; their
+  // handlers run on periodic_strand_
+  net::strand<net::io_context::executor_type> periodic_strand_;
+  std::vector<PeriodicTask> periodic_tasks_;
+  std::vector<std::unique_ptr<net::steady_timer>> periodic_timers_;
+
+  // Scene affinity; lane_count_ is fixed while the server runs, the
+  // placement below is guarded by lanes_mutex_
+  bool scene_affinity_ = false;
+  std::chrono::milliseconds scene_rebalance_interval_{0};
+  size_t lane_count_ = 0;
+  mutable std::mutex lanes_mutex_;
+  std::vector<std::size_t> lane_loads_;
+  std::unordered_map<std::string, SceneLane> scene_lanes_;
+
+  // Multi-tenant hosting: tenants_ on a front server, tenant_ on a tenant
+  std::vector<WebsocketServer*> tenants_;
+  std::unordered_map<std::string, WebsocketServer*> tenants_by_token_;
+  TenantConfig tenant_;
+  std::atomic<bool> tenant_active_{false};
+  std::mutex simulation_mutex_;
+  std::condition_variable simulation_cv_;  // parked simulation thread
 
   // Statistics
-  mutable std::mutex stats_mutex_;
   std::atomic<size_t> messages_received_{0};
   std::atomic<size_t> messages_sent_{0};
+  std::atomic<size_t> tls_handshakes_{0};
+  std::atomic<size_t> tls_resumed_handshakes_{0};
+  std::atomic<std::uint64_t> ingest_ns_{0};
+  std::atomic<std::uint64_t> encode_ns_{0};
+  std::atomic<std::uint64_t> fanout_ns_{0};
+  std::atomic<std::uint64_t> write_ns_{0};
+  std::atomic<std::uint64_t> broadcasts_{0};
+  std::atomic<std::uint64_t> writes_{0};
+  std::atomic<size_t> frames_shed_{0};
+  std::array<std::atomic<size_t>, core::kEncodingTierCount> encoding_tiers_{};
+  std::atomic<size_t> encoding_switches_{0};
 };
 
 }  // namespace picoradar::network
@@ -221,6 +221,7 @@ Element CLIInterface::renderStats() {
       text("🔧 可用命令") | bold | color(Color::Magenta),
       text("• status - 显示详细状态"),
       text("• connections - 列出连接"),
+      text("• workers [auto|n] - I/O 线程池"),
       text("• restart - 重启服务"),
       text("• help - 显示帮助")};
 
@@ -0,0 +1,435 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <boost/asio.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/websocket.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "client.pb.h"
+#include "server.pb.h"
+
+namespace picoradar::server {
+
+namespace load {
+
+namespace net = boost::asio;
+namespace beast = boost::beast;
+namespace websocket = beast::websocket;
+using tcp = net::ip::tcp;
+
+// 合成负载中位姿的 timestamp 字段携带发送时刻的 steady_clock 微秒数，
+// 用 scene_id 区分由服务器在鉴权时生成的默认位姿
+inline constexpr const char* kLoadScene = "load";
+
+// 会话出生点的网格间距（米），大于接近警报的解除距离，
+// 避免上千个玩家挤在原点使接近检测退化为全连接
+inline constexpr float kSpawnSpacing = 4.0F;
+inline constexpr std::size_t kSpawnColumns = 32;
+
+inline auto steadyMicros() -> std::int64_t {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/**
+ * @brief 负载生成器中的单个 WebSocket 会话。
+ *
+ * 所有操作都在生成器的 I/O 线程上执行，因此无需 strand。
+ * 没有 on_latency 回调的会话在鉴权后不再解析收到的帧。
+ */
+class LoadSession : public std::enable_shared_from_this<LoadSession> {
+ public:
+  struct Callbacks {
+    std::function<void(LoadSession&)> on_authenticated;
+    std::function<void(LoadSession&)> on_closed;
+    std::function<void(std::int64_t sent_us, std::int64_t latency_us)>
+        on_latency;
+  };
+
+  LoadSession(net::io_context& ioc, std::size_t index, bool roster,
+              Callbacks callbacks)
+      : ws_(ioc),
+        player_id_("load_" + std::to_string(index)),
+        spawn_x_(static_cast<float>(index % kSpawnColumns) * kSpawnSpacing),
+        spawn_z_(static_cast<float>(index / kSpawnColumns) * kSpawnSpacing),
+        roster_(roster),
+        callbacks_(std::move(callbacks)) {}
+
+  void start(const tcp::endpoint& endpoint, const std::string& token) {
+    token_ = token;
+    beast::get_lowest_layer(ws_).async_connect(
+        endpoint, [self = shared_from_this()](beast::error_code ec) {
+          self->onConnect(ec);
+        });
+  }
+
+  // 发送相对出生点偏移 (dx, dz) 的位姿
+  void sendPose(float dx, float dz) {
+    ClientToServer message;
+    auto* pose = message.mutable_player_data();
+    pose->set_player_id(player_id_);
+    pose->set_scene_id(kLoadScene);
+    pose->mutable_position()->set_x(spawn_x_ + dx);
+    pose->mutable_position()->set_y(1.7F);
+    pose->mutable_position()->set_z(spawn_z_ + dz);
+    pose->set_timestamp(steadyMicros());
+    write(message);
+  }
+
+  void close() {
+    if (closed_) {
+      return;
+    }
+    beast::error_code ec;
+    beast::get_lowest_layer(ws_).socket().close(ec);
+  }
+
+  [[nodiscard]] auto getPlayerId() const -> const std::string& {
+    return player_id_;
+  }
+  [[nodiscard]] auto isAuthenticated() const -> bool { return authenticated_; }
+  [[nodiscard]] auto getBytesReceived() const -> std::size_t {
+    return bytes_received_;
+  }
+
+ private:
+  void onConnect(beast::error_code ec) {
+    if (ec) {
+      finish();
+      return;
+    }
+    beast::get_lowest_layer(ws_).socket().set_option(tcp::no_delay(true));
+    ws_.async_handshake("127.0.0.1", "/",
+                        [self = shared_from_this()](beast::error_code ec) {
+                          self->onHandshake(ec);
+                        });
+  }
+
+  void onHandshake(beast::error_code ec) {
+    if (ec) {
+      finish();
+      return;
+    }
+    ws_.binary(true);
+
+    // 先关闭玩家列表再鉴权，避免鉴权触发的广播发往纯负载会话
+    if (!roster_) {
+      ClientToServer subscription;
+      subscription.mutable_subscription()->set_exclude_roster(true);
+      write(subscription);
+    }
+    ClientToServer auth;
+    auth.mutable_auth_request()->set_token(token_);
+    auth.mutable_auth_request()->set_player_id(player_id_);
+    write(auth);
+    doRead();
+  }
+
+  void write(const ClientToServer& message) {
+    if (closed_) {
+      return;
+    }
+    write_queue_.push_back(message.SerializeAsString());
+    if (write_queue_.size() == 1) {
+      doWrite();
+    }
+  }
+
+  void doWrite() {
+    ws_.async_write(net::buffer(write_queue_.front()),
+                    [self = shared_from_this()](beast::error_code ec,
+                                                std::size_t /*bytes*/) {
+                      if (ec) {
+                        self->finish();
+                        return;
+                      }
+                      self->write_queue_.pop_front();
+                      if (!self->write_queue_.empty()) {
+                        self->doWrite();
+                      }
+                    });
+  }
+
+  void doRead() {
+    ws_.async_read(buffer_, [self = shared_from_this()](beast::error_code ec,
+                                                        std::size_t bytes) {
+      if (ec) {
+        self->finish();
+        return;
+      }
+      self->bytes_received_ += bytes;
+      self->onMessage();
+      self->buffer_.consume(self->buffer_.size());
+      self->doRead();
+    });
+  }
+
+  void onMessage() {
+    if (authenticated_ && !callbacks_.on_latency) {
+      return;
+    }
+    const auto now = steadyMicros();
+    ServerToClient message;
+    const auto data = buffer_.data();
+    if (!message.ParseFromArray(data.data(), static_cast<int>(data.size()))) {
+      return;
+    }
+
+    if (message.has_auth_response()) {
+      if (message.auth_response().success() && !authenticated_) {
+        authenticated_ = true;
+        sendPose(0.0F, 0.0F);  // 离开服务器分配的原点
+        if (callbacks_.on_authenticated) {
+          callbacks_.on_authenticated(*this);
+        }
+      }
+      return;
+    }
+
+    if (!message.has_player_list() || !callbacks_.on_latency) {
+      return;
+    }
+    // 每个玩家的每条新位姿只计一次延迟
+    for (const auto& player : message.player_list().players()) {
+      if (player.scene_id() != kLoadScene) {
+        continue;
+      }
+      auto& last_seen = last_seen_[player.player_id()];
+      if (player.timestamp() > last_seen) {
+        last_seen = player.timestamp();
+        callbacks_.on_latency(player.timestamp(), now - player.timestamp());
+      }
+    }
+  }
+
+  void finish() {
+    if (closed_) {
+      return;
+    }
+    closed_ = true;
+    write_queue_.clear();
+    beast::error_code ec;
+    beast::get_lowest_layer(ws_).socket().close(ec);
+    if (callbacks_.on_closed) {
+      callbacks_.on_closed(*this);
+    }
+  }
+
+  websocket::stream<beast::tcp_stream> ws_;
+  std::string player_id_;
+  float spawn_x_;
+  float spawn_z_;
+  bool roster_;
+  Callbacks callbacks_;
+  std::string token_;
+
+  beast::flat_buffer buffer_;
+  std::deque<std::string> write_queue_;
+  std::unordered_map<std::string, std::int64_t> last_seen_;
+  std::size_t bytes_received_ = 0;
+  bool authenticated_ = false;
+  bool closed_ = false;
+};
+
+}  // namespace load
+
+/**
+ * @brief 在单个 I/O 线程上驱动大量 WebSocket 会话的负载生成器。
+ *
+ * 用于可扩展性测试与容量自检：数千个会话共享一个 io_context，避免每个
+ * 客户端一个线程带来的调度开销掩盖服务器自身的资源占用。只有 roster 会话
+ * 接收玩家列表，其中 probe 会话解析每一帧并统计广播延迟；其余会话在鉴权
+ * 前退订玩家列表。
+ */
+class LoadGenerator {
+ public:
+  LoadGenerator(std::string host, std::uint16_t port, std::string token)
+      : endpoint_(load::net::ip::make_address(host), port),
+        token_(std::move(token)),
+        work_(load::net::make_work_guard(ioc_)),
+        thread_([this] { ioc_.run(); }) {}
+
+  ~LoadGenerator() { stop(); }
+
+  LoadGenerator(const LoadGenerator&) = delete;
+  auto operator=(const LoadGenerator&) -> LoadGenerator& = delete;
+
+  /**
+   * @brief 发起 count 个新会话并等待它们全部完成鉴权。
+   * @param probe roster 会话是否统计广播延迟
+   * @return 在超时前完成鉴权的会话总数
+   */
+  auto connect(std::size_t count, bool roster,
+               std::chrono::milliseconds timeout, bool probe = true)
+      -> std::size_t {
+    const auto target = authenticated_.load() + count;
+    started_ += count;
+    load::net::post(ioc_, [this, count, roster, probe] {
+      for (std::size_t i = 0; i < count; ++i) {
+        auto session = std::make_shared<load::LoadSession>(
+            ioc_, sessions_.size(), roster, makeCallbacks(roster && probe));
+        sessions_.push_back(session);
+        session->start(endpoint_, token_);
+      }
+    });
+
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (authenticated_ < target &&
+           std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return authenticated_;
+  }
+
+  /**
+   * @brief 让前 senders 个会话以 rate_hz 的频率发送位姿，持续 duration。
+   *
+   * 阻塞直到发送结束。各会话的发送时刻在周期内均匀错开，像真实头显一样
+   * 不会同时到达；每个会话绕出生点做半径 1 米的圆周运动。
+   */
+  void sendPoses(std::size_t senders, int rate_hz,
+                 std::chrono::milliseconds duration) {
+    senders = std::min(senders, started_.load());
+    if (senders == 0 || rate_hz <= 0) {
+      return;
+    }
+    const auto interval = std::chrono::microseconds(1000000 / rate_hz);
+    const auto step = interval / static_cast<long long>(senders);
+    const auto ticks = (duration / interval) * static_cast<long long>(senders);
+    std::atomic<bool> done{false};
+
+    // 第 n 步由第 n % senders 个会话发送第 n / senders 条位姿
+    auto timer = std::make_shared<load::net::steady_timer>(ioc_);
+    auto tick = std::make_shared<std::function<void(long long)>>();
+    *tick = [this, senders, step, ticks, timer, &done,
+             weak_tick = std::weak_ptr<std::function<void(long long)>>(tick)](
+                long long n) {
+      const auto sender = static_cast<std::size_t>(n) % senders;
+      const float t =
+          static_cast<float>(n / static_cast<long long>(senders)) * 0.1F;
+      sessions_[sender]->sendPose(std::cos(t), std::sin(t));
+      ++poses_sent_;
+      if (n + 1 >= ticks) {
+        done = true;
+        return;
+      }
+      timer->expires_at(timer->expiry() + step);
+      timer->async_wait([weak_tick, n](boost::system::error_code ec) {
+        if (auto next = weak_tick.lock(); next && !ec) {
+          (*next)(n + 1);
+        }
+      });
+    };
+
+    load::net::post(ioc_, [timer, tick] {
+      timer->expires_after(std::chrono::milliseconds(0));
+      (*tick)(0);
+    });
+    while (!done) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    // tick 在本函数返回后失效，确保 I/O 线程上不再持有它
+    load::net::post(ioc_, [timer] { timer->cancel(); });
+    drain();
+  }
+
+  // 等待 I/O 线程处理完此前投递的所有工作
+  void drain() {
+    std::atomic<bool> reached{false};
+    load::net::post(ioc_, [&reached] { reached = true; });
+    while (!reached) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+  // 等待所有会话被对端关闭
+  auto waitForClosed(std::chrono::milliseconds timeout) -> bool {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (closed_ < started_ && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return closed_ >= started_;
+  }
+
+  void stop() {
+    if (!thread_.joinable()) {
+      return;
+    }
+    // 关闭套接字后所有挂起的操作都会以错误完成，io_context 随之自然退出
+    load::net::post(ioc_, [this] {
+      for (auto& session : sessions_) {
+        session->close();
+      }
+      sessions_.clear();
+    });
+    work_.reset();
+    thread_.join();
+  }
+
+  [[nodiscard]] auto getAuthenticated() const -> std::size_t {
+    return authenticated_;
+  }
+  [[nodiscard]] auto getPosesSent() const -> std::size_t {
+    return poses_sent_;
+  }
+
+  // 返回并清空至今收集的广播延迟样本（微秒），并开始新的统计窗口：
+  // 之前发出的位姿（例如鉴权时的初始位姿）迟到也不再计入
+  auto takeLatencies() -> std::vector<std::int64_t> {
+    std::lock_guard lock(latency_mutex_);
+    latency_window_us_ = load::steadyMicros();
+    return std::exchange(latencies_us_, {});
+  }
+
+ private:
+  auto makeCallbacks(bool probe) -> load::LoadSession::Callbacks {
+    load::LoadSession::Callbacks callbacks;
+    callbacks.on_authenticated = [this](load::LoadSession&) {
+      ++authenticated_;
+    };
+    callbacks.on_closed = [this](load::LoadSession&) { ++closed_; };
+    if (probe) {
+      callbacks.on_latency = [this](std::int64_t sent_us,
+                                    std::int64_t latency_us) {
+        std::lock_guard lock(latency_mutex_);
+        if (sent_us >= latency_window_us_) {
+          latencies_us_.push_back(latency_us);
+        }
+      };
+    }
+    return callbacks;
+  }
+
+  load::net::io_context ioc_;
+  load::tcp::endpoint endpoint_;
+  std::string token_;
+  load::net::executor_work_guard<load::net::io_context::executor_type> work_;
+  std::vector<std::shared_ptr<load::LoadSession>> sessions_;  // I/O 线程
+
+  std::atomic<std::size_t> started_{0};
+  std::atomic<std::size_t> authenticated_{0};
+  std::atomic<std::size_t> closed_{0};
+  std::atomic<std::size_t> poses_sent_{0};
+
+  std::mutex latency_mutex_;
+  std::vector<std::int64_t> latencies_us_;
+  std::int64_t latency_window_us_ = 0;
+
+  std::thread thread_;  // 最后构造：其余成员就绪后才开始运行
+};
+
+}  // namespace picoradar::server
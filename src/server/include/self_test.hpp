@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace picoradar::server {
+
+/**
+ * @brief 容量自检参数 (selftest.*)
+ */
+struct SelfTestConfig {
+  std::size_t min_players = 10;
+  std::size_t player_step = 10;
+  std::size_t max_players = 200;
+  int min_rate_hz = 30;
+  int rate_step_hz = 30;
+  int max_rate_hz = 90;
+  std::chrono::milliseconds step_duration{2000};  ///< 每档持续发送的时长
+  std::size_t probes = 4;           ///< 解析每一帧并统计延迟的会话数
+  double max_p99_latency_ms = 50.0;  ///< 广播延迟预算
+  /// tick 预算：每个更新周期内流水线耗时占可用线程时间的比例上限
+  double tick_budget = 0.7;
+  int threads = 4;  ///< 自检服务器的 I/O 线程数
+  std::string token;  ///< 鉴权令牌，为空时使用 auth.token
+
+  static auto loadFromConfigManager() -> SelfTestConfig;
+};
+
+/**
+ * @brief 一档负载 (玩家数, 更新频率) 的测量结果
+ *
+ * 各阶段耗时按服务器收到的每条更新折算（微秒），写入耗时按每帧计。
+ */
+struct SelfTestStep {
+  std::size_t players = 0;
+  int rate_hz = 0;
+  std::size_t updates = 0;  ///< 服务器收到的位姿更新数
+  std::size_t frames = 0;   ///< 完成写入的帧数
+  double p50_latency_ms = 0.0;
+  double p99_latency_ms = 0.0;
+  double tick_load = 0.0;  ///< 流水线耗时 / (更新周期 × 可用线程数)
+  double ingest_us = 0.0;
+  double encode_us = 0.0;
+  double fanout_us = 0.0;
+  double write_us_per_frame = 0.0;
+  bool passed = false;
+  std::string limit;  ///< 未通过时超出的预算
+};
+
+/**
+ * @brief 某个更新频率下的可持续容量
+ */
+struct SelfTestCapacity {
+  int rate_hz = 0;
+  std::size_t players = 0;  ///< 0 表示最小档位也未通过
+  bool at_ceiling = false;  ///< 达到 max_players 仍未超出预算
+};
+
+struct SelfTestReport {
+  std::vector<SelfTestStep> steps;
+  std::vector<SelfTestCapacity> capacity;  ///< 按频率升序
+  bool cancelled = false;
+};
+
+/**
+ * @brief 场馆开放前的容量自检
+ *
+ * 在回环地址上启动一个真实的服务器实例，由进程内的合成客户端连接并
+ * 发送位姿，按频率从低到高、玩家数从少到多逐档爬升，直到 p99 广播
+ * 延迟或 tick 预算被超出。更高频率的容量不会超过低频率的容量，因此
+ * 每个频率只爬升到上一频率的容量为止。合成客户端与服务器共用本机
+ * CPU，测得的容量偏保守。
+ */
+class SelfTest {
+ public:
+  using StepCallback = std::function<void(const SelfTestStep&)>;
+
+  explicit SelfTest(SelfTestConfig config);
+
+  /**
+   * @brief 运行自检，每完成一档调用一次 on_step
+   * @throws std::runtime_error 自检服务器无法启动时
+   */
+  auto run(const StepCallback& on_step = {}) -> SelfTestReport;
+
+  // 可从其他线程调用；当前档位结束后停止
+  void cancel() { cancelled_ = true; }
+
+  [[nodiscard]] auto getConfig() const -> const SelfTestConfig& {
+    return config_;
+  }
+
+ private:
+  SelfTestConfig config_;
+  std::atomic<bool> cancelled_{false};
+};
+
+/// 单档结果的一行摘要
+auto formatSelfTestStep(const SelfTestStep& step) -> std::string;
+
+/// 自检报告的多行摘要：每个频率的容量及最后通过档位的阶段耗时
+auto formatSelfTestReport(const SelfTestReport& report)
+    -> std::vector<std::string>;
+
+}  // namespace picoradar::server
@@ -1,17 +1,24 @@
 #pragma once
 
+#include <array>
 #include <boost/asio/io_context.hpp>
 #include <memory>
+#include <string>
 #include <thread>
 #include <vector>
 
+#include "core/encoding_selector.hpp"
+#include "core/player_registry.hpp"
+#include "player.pb.h"
+
 namespace net = boost::asio;
 
 namespace picoradar {
 namespace core {
-class PlayerRegistry;
-}
+class PoseRecorder;
+}  // namespace core
 namespace network {
+struct StageCosts;
 class WebsocketServer;
 class UdpDiscoveryServer;
 }  // namespace network
@@ -20,12 +27,30 @@ namespace server {
 
 class Server {
  public:
+  /// 多租户模式下单个场馆的运行状态
+  struct TenantStats {
+    std::string name;
+    size_t players = 0;
+    size_t connections = 0;
+    bool active = false;  // 空闲租户的定时器与模拟线程处于挂起状态
+  };
+
   Server();
   ~Server();
 
   void start(uint16_t port, int thread_count);
+  /**
+   * @brief 只在 127.0.0.1 上启动 WebSocket 服务。
+   *
+   * 不启动 UDP 发现、位姿归档与租户，可与同一进程中正在运行的服务器
+   * 共存；用于容量自检。port 为 0 时由系统分配端口，通过 getPort() 读取。
+   */
+  void startLoopback(uint16_t port, int thread_count);
   void stop() const;
 
+  // WebSocket 服务实际绑定的端口；尚未启动时为 0
+  [[nodiscard]] auto getPort() const -> uint16_t;
+
   // Method to get player count for testing
   [[nodiscard]] auto getPlayerCount() const -> size_t;
 
@@ -33,12 +58,104 @@ class Server {
   [[nodiscard]] auto getConnectionCount() const -> size_t;
   [[nodiscard]] auto getMessagesReceived() const -> size_t;
   [[nodiscard]] auto getMessagesSent() const -> size_t;
+  // network.tls.enabled 时完成的 TLS 握手数，以及其中恢复会话的次数
+  [[nodiscard]] auto getTlsHandshakes() const -> size_t;
+  [[nodiscard]] auto getTlsResumedHandshakes() const -> size_t;
+  // 位姿流水线各阶段的累计耗时，定义见 network/websocket_server.hpp
+  [[nodiscard]] auto getStageCosts() const -> network::StageCosts;
+
+  /**
+   * @brief 各租户的状态（配置了 tenants 时）。
+   *
+   * 每个租户拥有独立的注册表与定时任务，与默认场馆共用监听端口和 I/O
+   * 线程；客户端的鉴权令牌决定其所属租户。上面的统计包含所有租户。
+   */
+  [[nodiscard]] auto getTenantStats() const -> std::vector<TenantStats>;
+
+  // I/O 工作线程池：network.workers.autoscale 开启时按事件循环延迟与 CPU
+  // 利用率自动伸缩；手动设置线程数会关闭自动伸缩
+  [[nodiscard]] auto getWorkerCount() const -> size_t;
+  void setWorkerCount(size_t count);
+  void setWorkerAutoscale(bool enabled);
+  [[nodiscard]] auto isWorkerAutoscale() const -> bool;
+
+  // 分级降载：过载时先降低旁观屏幕的帧率、再暂停旁观屏幕，最后才影响
+  // 头显玩家；级别 0 表示未降载，被跳过的玩家列表帧计入 getFramesShed()
+  [[nodiscard]] auto getShedLevel() const -> size_t;
+  [[nodiscard]] auto getShedSteps() const -> size_t;
+  [[nodiscard]] auto getFramesShed() const -> size_t;
+
+  // 自适应编码：network.adaptive_encoding.enabled 开启时，每个会话按自身
+  // 链路质量在完整帧、增量帧、紧凑帧与粗精度帧之间切换
+  [[nodiscard]] auto isAdaptiveEncoding() const -> bool;
+  [[nodiscard]] auto getEncodingTierCounts() const
+      -> std::array<size_t, core::kEncodingTierCount>;
+  [[nodiscard]] auto getEncodingSwitches() const -> size_t;
+
+  // --- 进程内嵌入 API ---
+  // 游戏服务器在同一进程中运行 PICORadar 时使用，无需再以 WebSocket 客户端
+  // 的身份连接自身。
+
+  /**
+   * @brief 注册玩家变更观察者。
+   *
+   * 回调在服务器 I/O 线程上每 embedding.observer_interval_ms 以批次调用一次，
+   * 应尽快返回；ChangeSet 中的快照可以在回调之外继续持有。
+   */
+  auto addPlayerObserver(core::PlayerRegistry::ChangeObserver observer)
+      -> core::PlayerRegistry::ObserverId;
+  void removePlayerObserver(core::PlayerRegistry::ObserverId id);
+
+  // 所有玩家的只读快照；注册表未变化时重复获取不会复制数据
+  [[nodiscard]] auto getPlayerSnapshot() const
+      -> core::PlayerRegistry::Snapshot;
+
+  /**
+   * @brief 读取玩家变更日志中 since 之后的记录。
+   *
+   * 录制、统计、中继等增量消费者各自保存 next_version 作为游标；
+   * 落后超过 embedding.journal_capacity 条时返回快照用于重新同步。
+   * 日志默认关闭（容量为 0），此时每次读取都会得到快照。记录中的玩家数据
+   * 为线格式字节，由消费者按需解析。
+   */
+  [[nodiscard]] auto readPlayerJournal(std::uint64_t since,
+                                       std::size_t max_records = SIZE_MAX)
+      const -> core::PlayerRegistry::JournalRead;
+
+  /**
+   * @brief 注入或更新一个由服务器控制的玩家 (NPC)。
+   *
+   * 数据直接写入注册表并像普通玩家一样广播，不经过序列化。可从任意线程
+   * 调用；在 removeNpc() 之前，客户端不能使用该玩家 ID。
+   */
+  void upsertNpc(picoradar::PlayerData data);
+  void removeNpc(const std::string& player_id);
+
+  /**
+   * @brief 当前位姿归档文件的路径，未录制时为空。
+   *
+   * archive.enabled 时，每次 start() 在 archive.directory 下新建一个归档，
+   * 由后台线程按 archive.sample_interval_ms 采样默认场馆的名单；
+   * 使用 core::PoseArchiveReader 读取。
+   */
+  [[nodiscard]] auto getPoseArchivePath() const -> std::string;
 
  private:
+  void startRecorder();
+
+  struct Tenant {
+    std::shared_ptr<core::PlayerRegistry> registry;
+    std::shared_ptr<network::WebsocketServer> ws_server;
+  };
+
   std::unique_ptr<net::io_context> ioc_;
+  std::size_t journal_capacity_ = 0;
   std::shared_ptr<core::PlayerRegistry> registry_;
   std::shared_ptr<network::WebsocketServer> ws_server_;
+  // 在 ws_server_ 之后声明：析构时先于前端服务器销毁
+  std::vector<Tenant> tenants_;
   std::shared_ptr<network::UdpDiscoveryServer> discovery_server_;
+  std::unique_ptr<core::PoseRecorder> recorder_;
   std::vector<std::thread> server_threads_;
 };
 
@@ -1,6 +1,7 @@
 #include <atomic>
 #include <chrono>
 #include <csignal>
+#include <filesystem>
 #include <iostream>
 #include <memory>
 #include <thread>
@@ -9,14 +10,19 @@
 #include "cli_log_adapter.hpp"
 #include "common/config_manager.hpp"
 #include "common/constants.hpp"
+#include "common/flight_recorder.hpp"
 #include "common/logging.hpp"
 #include "common/platform_fixes.hpp"
+#include "common/process_utils.hpp"
 #include "common/single_instance_guard.hpp"
+#include "network/websocket_server.hpp"
+#include "self_test.hpp"
 #include "server.hpp"
 
 static std::atomic<bool> g_stop_signal(false);
 static std::shared_ptr<picoradar::server::CLIInterface> g_cli_interface;
 static bool g_use_traditional_cli = false;
+static bool g_run_selftest = false;
 
 // 统一的日志输出函数
 void logMessageHandler(const std::string& message, logger::LogLevel level) {
@@ -43,6 +49,110 @@ void logMessageHandler(const std::string& message, logger::LogLevel level) {
   }
 }
 
+// 运行容量自检并输出结果；最低频率下至少通过最小档位时返回 true
+auto runSelfTest(picoradar::server::SelfTest& self_test) -> bool {
+  const auto& config = self_test.getConfig();
+  logMessageHandler(
+      "容量自检开始: " + std::to_string(config.min_players) + "-" +
+          std::to_string(config.max_players) + " 名玩家, " +
+          std::to_string(config.min_rate_hz) + "-" +
+          std::to_string(config.max_rate_hz) + " Hz",
+      logger::LogLevel::INFO);
+  try {
+    const auto report =
+        self_test.run([](const picoradar::server::SelfTestStep& step) {
+          logMessageHandler(picoradar::server::formatSelfTestStep(step),
+                            step.passed ? logger::LogLevel::INFO
+                                        : logger::LogLevel::WARNING);
+        });
+    for (const auto& line : picoradar::server::formatSelfTestReport(report)) {
+      logMessageHandler(line, logger::LogLevel::INFO);
+    }
+    return !report.capacity.empty() && report.capacity.front().players > 0;
+  } catch (const std::exception& e) {
+    logMessageHandler(std::string("容量自检失败: ") + e.what(),
+                      logger::LogLevel::ERROR);
+    return false;
+  }
+}
+
+// 启用飞行记录器：接收日志尾部，崩溃时转储，并每秒采样服务器指标。
+// 返回转储路径，未启用时为空
+auto startFlightRecorder(const picoradar::server::Server& server)
+    -> std::string {
+  const auto& config = picoradar::common::ConfigManager::getInstance();
+  if (!config.getWithDefault("flight_recorder.enabled", true)) {
+    return {};
+  }
+  const std::string path = config.getWithDefault(
+      "flight_recorder.dump_path", std::string("./logs/flight_recorder.txt"));
+  const std::filesystem::path directory =
+      std::filesystem::path(path).parent_path();
+  std::error_code ec;
+  if (!directory.empty()) {
+    std::filesystem::create_directories(directory, ec);
+  }
+
+  auto& recorder = picoradar::common::FlightRecorder::getInstance();
+  logger::Logger::addOutputStream(
+      std::make_unique<picoradar::common::FlightRecorderLogStream>());
+  if (!picoradar::common::FlightRecorder::installCrashHandler(path)) {
+    logMessageHandler("无法安装崩溃处理函数，崩溃时不会转储飞行记录",
+                      logger::LogLevel::WARNING);
+  }
+
+  // 计数器均为累计值，相邻快照之差即每秒速率
+  const auto count = [](std::size_t value) {
+    return static_cast<double>(value);
+  };
+  const auto millis = [](std::uint64_t ns) {
+    return static_cast<double>(ns) / 1e6;
+  };
+  recorder.addMetric("connections", [&server, count] {
+    return count(server.getConnectionCount());
+  });
+  recorder.addMetric("players", [&server, count] {
+    return count(server.getPlayerCount());
+  });
+  recorder.addMetric("messages_received", [&server, count] {
+    return count(server.getMessagesReceived());
+  });
+  recorder.addMetric("messages_sent", [&server, count] {
+    return count(server.getMessagesSent());
+  });
+  recorder.addMetric("workers", [&server, count] {
+    return count(server.getWorkerCount());
+  });
+  recorder.addMetric("shed_level", [&server, count] {
+    return count(server.getShedLevel());
+  });
+  recorder.addMetric("frames_shed", [&server, count] {
+    return count(server.getFramesShed());
+  });
+  recorder.addMetric("encoding_switches", [&server, count] {
+    return count(server.getEncodingSwitches());
+  });
+  recorder.addMetric("ingest_ms", [&server, millis] {
+    return millis(server.getStageCosts().ingest_ns);
+  });
+  recorder.addMetric("encode_ms", [&server, millis] {
+    return millis(server.getStageCosts().encode_ns);
+  });
+  recorder.addMetric("fanout_ms", [&server, millis] {
+    return millis(server.getStageCosts().fanout_ns);
+  });
+  recorder.addMetric("cpu_ms", [] {
+    return static_cast<double>(
+               picoradar::common::process_cpu_time().count()) /
+           1e3;
+  });
+  recorder.start(std::chrono::milliseconds(config.getWithDefault(
+      "flight_recorder.snapshot_interval_ms",
+      static_cast<int>(
+          picoradar::constants::kDefaultFlightRecorderInterval.count()))));
+  return path;
+}
+
 void signalHandler(int signum) {
   if (signum == SIGINT) {
     logMessageHandler("收到SIGINT信号，正在关闭...", logger::LogLevel::INFO);
@@ -64,12 +174,14 @@ auto main(const int argc, char* argv[]) -> int {
   config.console_enabled = true;
   logger::Logger::Init(argv[0], config);
 
-  // 检查是否使用传统CLI模式
+  // 检查是否使用传统CLI模式；自检模式同样直接输出到控制台
   for (int i = 1; i < argc; ++i) {
     if (std::string(argv[i]) == "--traditional" ||
         std::string(argv[i]) == "-t") {
       g_use_traditional_cli = true;
-      break;
+    } else if (std::string(argv[i]) == "--selftest") {
+      g_use_traditional_cli = true;
+      g_run_selftest = true;
     }
   }
 
@@ -79,13 +191,16 @@ auto main(const int argc, char* argv[]) -> int {
     picoradar::server::CLILogAdapter::initialize(g_cli_interface);
   }
 
-  try {
-    auto guard = std::make_unique<picoradar::common::SingleInstanceGuard>(
-        "PicoRadar.pid");
-  } catch (const std::runtime_error& e) {
-    logMessageHandler(std::string("启动失败: ") + e.what(),
-                      logger::LogLevel::ERROR);
-    return 1;
+  // 自检只监听回环地址上的临时端口，可与正在运行的实例共存
+  if (!g_run_selftest) {
+    try {
+      auto guard = std::make_unique<picoradar::common::SingleInstanceGuard>(
+          "PicoRadar.pid");
+    } catch (const std::runtime_error& e) {
+      logMessageHandler(std::string("启动失败: ") + e.what(),
+                        logger::LogLevel::ERROR);
+      return 1;
+    }
   }
 
   std::signal(SIGINT, signalHandler);
@@ -108,6 +223,14 @@ auto main(const int argc, char* argv[]) -> int {
     }
   }
 
+  if (g_run_selftest) {
+    // 每个合成会话的连接与断开都会记录日志，自检期间只保留警告
+    logger::Logger::setGlobalLevel(logger::LogLevel::WARNING);
+    picoradar::server::SelfTest self_test(
+        picoradar::server::SelfTestConfig::loadFromConfigManager());
+    return runSelfTest(self_test) ? 0 : 1;
+  }
+
   // 从配置或默认值获取端口
   uint16_t port = picoradar::constants::kDefaultServicePort;
   if (argc > 1) {
@@ -151,6 +274,13 @@ auto main(const int argc, char* argv[]) -> int {
   picoradar::server::Server server;
   server.start(port, 4);
 
+  const auto flight_recorder_path = startFlightRecorder(server);
+
+  // 运行时的自检在后台线程中进行，不阻塞命令输入
+  std::unique_ptr<picoradar::server::SelfTest> self_test;
+  std::thread self_test_thread;
+  std::atomic<bool> self_test_running{false};
+
   // 设置命令处理器（在服务器创建后）
   if (!g_use_traditional_cli) {
     g_cli_interface->setCommandHandler([&](const std::string& command) {
@@ -171,9 +301,95 @@ auto main(const int argc, char* argv[]) -> int {
         // Start again with same parameters
         server.start(port, 4);
         logMessageHandler("服务器重启完成", logger::LogLevel::INFO);
-      } else if (command == "help") {
-        logMessageHandler("可用命令: status, connections, restart, help",
+      } else if (command == "workers") {
+        logMessageHandler(
+            "I/O 工作线程: " + std::to_string(server.getWorkerCount()) +
+                (server.isWorkerAutoscale() ? " (自动伸缩)" : " (固定)"),
+            logger::LogLevel::INFO);
+      } else if (command == "workers auto") {
+        server.setWorkerAutoscale(true);
+        logMessageHandler("I/O 工作线程已切换为自动伸缩",
                           logger::LogLevel::INFO);
+      } else if (command.rfind("workers ", 0) == 0) {
+        try {
+          const auto count = std::stoul(command.substr(8));
+          server.setWorkerCount(count);
+          logMessageHandler(
+              "I/O 工作线程固定为 " + std::to_string(server.getWorkerCount()),
+              logger::LogLevel::INFO);
+        } catch (const std::exception&) {
+          logMessageHandler("用法: workers [auto|<线程数>]",
+                            logger::LogLevel::WARNING);
+        }
+      } else if (command == "shedding") {
+        logMessageHandler(
+            "降载级别: " + std::to_string(server.getShedLevel()) + "/" +
+                std::to_string(server.getShedSteps()) +
+                ", 已跳过的玩家列表帧: " +
+                std::to_string(server.getFramesShed()),
+            logger::LogLevel::INFO);
+      } else if (command == "encoding") {
+        if (!server.isAdaptiveEncoding()) {
+          logMessageHandler("自适应编码未启用", logger::LogLevel::INFO);
+        } else {
+          const auto counts = server.getEncodingTierCounts();
+          std::string text = "自适应编码会话:";
+          for (size_t i = 0; i < counts.size(); ++i) {
+            text += std::string(" ") +
+                    picoradar::core::encodingTierName(
+                        static_cast<picoradar::core::EncodingTier>(i)) +
+                    "=" + std::to_string(counts[i]);
+          }
+          text += ", 切换次数: " + std::to_string(server.getEncodingSwitches());
+          logMessageHandler(text, logger::LogLevel::INFO);
+        }
+      } else if (command == "tenants") {
+        const auto tenants = server.getTenantStats();
+        if (tenants.empty()) {
+          logMessageHandler("未配置租户", logger::LogLevel::INFO);
+        }
+        for (const auto& tenant : tenants) {
+          logMessageHandler(
+              "租户 " + tenant.name + ": 连接数 " +
+                  std::to_string(tenant.connections) + ", 玩家数 " +
+                  std::to_string(tenant.players) +
+                  (tenant.active ? " (活动)" : " (空闲)"),
+              logger::LogLevel::INFO);
+        }
+      } else if (command == "selftest") {
+        if (self_test_running) {
+          logMessageHandler("容量自检正在运行", logger::LogLevel::WARNING);
+        } else {
+          if (self_test_thread.joinable()) {
+            self_test_thread.join();
+          }
+          self_test = std::make_unique<picoradar::server::SelfTest>(
+              picoradar::server::SelfTestConfig::loadFromConfigManager());
+          self_test_running = true;
+          self_test_thread = std::thread([&] {
+            runSelfTest(*self_test);
+            self_test_running = false;
+          });
+        }
+      } else if (command == "dump") {
+        if (flight_recorder_path.empty()) {
+          logMessageHandler("飞行记录器未启用", logger::LogLevel::WARNING);
+        } else {
+          try {
+            picoradar::common::FlightRecorder::getInstance().dumpToFile(
+                flight_recorder_path, "manual");
+            logMessageHandler("飞行记录已转储到 " + flight_recorder_path,
+                              logger::LogLevel::INFO);
+          } catch (const std::exception& e) {
+            logMessageHandler(std::string("转储失败: ") + e.what(),
+                              logger::LogLevel::ERROR);
+          }
+        }
+      } else if (command == "help") {
+        logMessageHandler(
+            "可用命令: status, connections, tenants, workers [auto|<n>], "
+            "shedding, encoding, selftest, dump, restart, help",
+            logger::LogLevel::INFO);
       } else if (command == "exit" || command == "quit") {
         g_stop_signal = true;
       } else {
@@ -216,6 +432,14 @@ auto main(const int argc, char* argv[]) -> int {
   }
 
   // 停止服务器
+  if (self_test) {
+    self_test->cancel();
+  }
+  if (self_test_thread.joinable()) {
+    self_test_thread.join();
+  }
+  // 采样线程读取服务器统计，须在服务器销毁前停止
+  picoradar::common::FlightRecorder::getInstance().stop();
   server.stop();
 
   if (!g_use_traditional_cli) {
@@ -0,0 +1,239 @@
+#include "self_test.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+#include "common/config_manager.hpp"
+#include "load_generator.hpp"
+#include "network/websocket_server.hpp"
+#include "server.hpp"
+
+namespace picoradar::server {
+
+namespace {
+
+// 所有会话完成鉴权的等待上限；服务器握手超时为 1 秒，按批连接
+constexpr auto kConnectTimeout = std::chrono::seconds(10);
+constexpr std::size_t kConnectBatch = 50;
+// 发送结束后等待最后一批广播到达
+constexpr auto kSettleTime = std::chrono::milliseconds(200);
+
+auto percentile(std::vector<std::int64_t>& samples, double p) -> double {
+  if (samples.empty()) {
+    return 0.0;
+  }
+  const auto index = static_cast<std::size_t>(
+      p * static_cast<double>(samples.size() - 1) + 0.5);
+  std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+  return static_cast<double>(samples[index]);
+}
+
+auto perUnit(std::uint64_t total_ns, std::size_t units) -> double {
+  return units == 0 ? 0.0
+                    : static_cast<double>(total_ns) / 1000.0 /
+                          static_cast<double>(units);
+}
+
+}  // namespace
+
+auto SelfTestConfig::loadFromConfigManager() -> SelfTestConfig {
+  const auto& config = common::ConfigManager::getInstance();
+  SelfTestConfig result;
+  const auto count = [&config](const char* key, std::size_t fallback) {
+    return static_cast<std::size_t>(std::max(
+        1, config.getWithDefault(key, static_cast<int>(fallback))));
+  };
+  result.min_players = count("selftest.min_players", result.min_players);
+  result.player_step = count("selftest.player_step", result.player_step);
+  result.max_players = std::max(
+      result.min_players, count("selftest.max_players", result.max_players));
+  result.min_rate_hz = static_cast<int>(
+      count("selftest.min_rate_hz", static_cast<std::size_t>(
+                                        result.min_rate_hz)));
+  result.rate_step_hz = static_cast<int>(
+      count("selftest.rate_step_hz", static_cast<std::size_t>(
+                                         result.rate_step_hz)));
+  result.max_rate_hz = std::max(
+      result.min_rate_hz,
+      static_cast<int>(count("selftest.max_rate_hz",
+                             static_cast<std::size_t>(result.max_rate_hz))));
+  result.step_duration = std::chrono::milliseconds(
+      count("selftest.step_ms",
+            static_cast<std::size_t>(result.step_duration.count())));
+  result.probes = count("selftest.probes", result.probes);
+  result.max_p99_latency_ms = config.getWithDefault(
+      "selftest.max_p99_latency_ms", result.max_p99_latency_ms);
+  result.tick_budget =
+      config.getWithDefault("selftest.tick_budget", result.tick_budget);
+  result.threads = static_cast<int>(
+      count("selftest.threads", static_cast<std::size_t>(result.threads)));
+  return result;
+}
+
+SelfTest::SelfTest(SelfTestConfig config) : config_(std::move(config)) {}
+
+auto SelfTest::run(const StepCallback& on_step) -> SelfTestReport {
+  SelfTestReport report;
+  const auto token =
+      config_.token.empty()
+          ? common::ConfigManager::getInstance().getWithDefault(
+                "auth.token", std::string{})
+          : config_.token;
+  // 自检与服务器共用本机 CPU，可用线程数不超过硬件并发数
+  const auto cores = std::max(1U, std::thread::hardware_concurrency());
+
+  std::size_t ceiling = config_.max_players;
+  for (int rate = config_.min_rate_hz; rate <= config_.max_rate_hz;
+       rate += config_.rate_step_hz) {
+    SelfTestCapacity capacity{rate, 0, false};
+
+    // 每个频率使用新的服务器实例，上一频率的积压不会影响测量
+    // 绑定由系统分配的端口，避免先探测再绑定时被其他进程抢占
+    Server server;
+    server.startLoopback(0, config_.threads);
+    LoadGenerator load("127.0.0.1", server.getPort(), token);
+
+    for (std::size_t players = config_.min_players;
+         players <= ceiling && !cancelled_;
+         players += config_.player_step) {
+      SelfTestStep step;
+      step.players = players;
+      step.rate_hz = rate;
+
+      // 先连接 probe 会话，其余会话同样接收完整玩家列表
+      while (load.getAuthenticated() < players) {
+        const auto connected = load.getAuthenticated();
+        const auto probes = connected < config_.probes
+                                ? config_.probes - connected
+                                : std::size_t{0};
+        const auto batch =
+            std::min({kConnectBatch, players - connected,
+                      probes > 0 ? probes : kConnectBatch});
+        if (load.connect(batch, true, kConnectTimeout, probes > 0) <
+            connected + batch) {
+          break;
+        }
+      }
+      if (load.getAuthenticated() < players) {
+        step.limit = "connect";
+      } else {
+        load.takeLatencies();
+        const auto costs_before = server.getStageCosts();
+        const auto received_before = server.getMessagesReceived();
+
+        load.sendPoses(players, rate, config_.step_duration);
+        std::this_thread::sleep_for(kSettleTime);
+
+        const auto costs = server.getStageCosts();
+        step.updates = server.getMessagesReceived() - received_before;
+        step.frames = costs.writes - costs_before.writes;
+        auto latencies = load.takeLatencies();
+        step.p50_latency_ms = percentile(latencies, 0.50) / 1000.0;
+        step.p99_latency_ms = percentile(latencies, 0.99) / 1000.0;
+
+        const auto ingest_ns = costs.ingest_ns - costs_before.ingest_ns;
+        const auto encode_ns = costs.encode_ns - costs_before.encode_ns;
+        const auto fanout_ns = costs.fanout_ns - costs_before.fanout_ns;
+        step.ingest_us = perUnit(ingest_ns, step.updates);
+        step.encode_us = perUnit(encode_ns, step.updates);
+        step.fanout_us = perUnit(fanout_ns, step.updates);
+        step.write_us_per_frame =
+            perUnit(costs.write_ns - costs_before.write_ns, step.frames);
+
+        // 每个更新周期所有玩家各发送一次，流水线须在周期内处理完
+        const auto threads = std::min<std::size_t>(
+            std::max<std::size_t>(server.getWorkerCount(), 1), cores);
+        const auto available_ns =
+            std::chrono::duration<double, std::nano>(config_.step_duration)
+                .count() *
+            static_cast<double>(threads);
+        step.tick_load =
+            static_cast<double>(ingest_ns + encode_ns + fanout_ns) /
+            available_ns;
+
+        if (latencies.empty()) {
+          step.limit = "no broadcasts";
+        } else if (step.p99_latency_ms > config_.max_p99_latency_ms) {
+          step.limit = "latency";
+        } else if (step.tick_load > config_.tick_budget) {
+          step.limit = "tick budget";
+        }
+      }
+      step.passed = step.limit.empty();
+      report.steps.push_back(step);
+      if (on_step) {
+        on_step(step);
+      }
+      if (!step.passed) {
+        break;
+      }
+      capacity.players = players;
+      capacity.at_ceiling = players + config_.player_step > ceiling &&
+                            ceiling == config_.max_players;
+    }
+
+    load.stop();
+    server.stop();
+    report.capacity.push_back(capacity);
+    if (cancelled_) {
+      report.cancelled = true;
+      break;
+    }
+    // 更高频率的容量不超过当前频率
+    if (capacity.players == 0) {
+      break;
+    }
+    ceiling = capacity.players;
+  }
+  return report;
+}
+
+auto formatSelfTestStep(const SelfTestStep& step) -> std::string {
+  return fmt::format(
+      "{} players @ {} Hz: p50 {:.1f} ms, p99 {:.1f} ms, tick load {:.0f}%, "
+      "per update ingest {:.1f} us, encode {:.1f} us, fan-out {:.1f} us, "
+      "write {:.1f} us/frame - {}",
+      step.players, step.rate_hz, step.p50_latency_ms, step.p99_latency_ms,
+      step.tick_load * 100.0, step.ingest_us, step.encode_us, step.fanout_us,
+      step.write_us_per_frame,
+      step.passed ? std::string("ok") : "exceeded " + step.limit);
+}
+
+auto formatSelfTestReport(const SelfTestReport& report)
+    -> std::vector<std::string> {
+  std::vector<std::string> lines;
+  lines.emplace_back(report.cancelled ? "Self-test cancelled, partial result:"
+                                      : "Sustainable capacity:");
+  for (const auto& capacity : report.capacity) {
+    const SelfTestStep* last = nullptr;
+    for (const auto& step : report.steps) {
+      if (step.rate_hz == capacity.rate_hz && step.passed &&
+          step.players == capacity.players) {
+        last = &step;
+      }
+    }
+    if (last == nullptr) {
+      lines.push_back(fmt::format("  {} Hz: below the smallest step",
+                                  capacity.rate_hz));
+      continue;
+    }
+    const double total = last->ingest_us + last->encode_us + last->fanout_us;
+    const auto share = [total](double us) {
+      return total > 0.0 ? us / total * 100.0 : 0.0;
+    };
+    lines.push_back(fmt::format(
+        "  {} Hz: {}{} players (p99 {:.1f} ms, tick load {:.0f}%; "
+        "per update {:.1f} us = ingest {:.0f}% + encode {:.0f}% + "
+        "fan-out {:.0f}%)",
+        capacity.rate_hz, capacity.at_ceiling ? ">= " : "", capacity.players,
+        last->p99_latency_ms, last->tick_load * 100.0, total,
+        share(last->ingest_us), share(last->encode_us),
+        share(last->fanout_us)));
+  }
+  return lines;
+}
+
+}  // namespace picoradar::server
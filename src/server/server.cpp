@@ -1,17 +1,29 @@
 #include "server.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+
 #include "common/config_manager.hpp"
 #include "common/constants.hpp"
 #include "common/logging.hpp"
 #include "core/player_registry.hpp"
+#include "core/pose_recorder.hpp"
 #include "network/udp_discovery_server.hpp"
 #include "network/websocket_server.hpp"
 
 namespace picoradar::server {
 
 Server::Server() {
+  const auto& config = common::ConfigManager::getInstance();
+  const int journal_capacity = config.getWithDefault(
+      "embedding.journal_capacity",
+      static_cast<int>(constants::kDefaultJournalCapacity));
+
+  journal_capacity_ = static_cast<std::size_t>(std::max(0, journal_capacity));
+
   ioc_ = std::make_unique<net::io_context>();
-  registry_ = std::make_shared<core::PlayerRegistry>();
+  registry_ = std::make_shared<core::PlayerRegistry>(journal_capacity_);
   ws_server_ = std::make_shared<network::WebsocketServer>(*ioc_, *registry_);
 }
 
@@ -25,6 +37,19 @@ void Server::start(uint16_t port, const int thread_count) {
       config.getWithDefault("server.host", std::string("0.0.0.0"));
   uint16_t discovery_port = config.getDiscoveryPort();
 
+  // 租户与默认场馆共用 io_context，由前端服务器统一启动和停止
+  if (tenants_.empty()) {
+    for (auto& tenant_config : network::WebsocketServer::loadTenantConfigs()) {
+      Tenant tenant;
+      tenant.registry =
+          std::make_shared<core::PlayerRegistry>(journal_capacity_);
+      tenant.ws_server =
+          std::make_shared<network::WebsocketServer>(*ioc_, *tenant.registry);
+      ws_server_->addTenant(std::move(tenant_config), *tenant.ws_server);
+      tenants_.push_back(std::move(tenant));
+    }
+  }
+
   // Create and start UDP discovery server
   discovery_server_ = std::make_shared<network::UdpDiscoveryServer>(
       *ioc_, discovery_port, port, address);
@@ -32,22 +57,85 @@ void Server::start(uint16_t port, const int thread_count) {
 
   // Start WebSocket server
   ws_server_->start(address, port, thread_count);
+  startRecorder();
   LOG_INFO << "Server started - WebSocket on port " << port
            << ", UDP Discovery on port " << discovery_port;
 }
 
+void Server::startLoopback(uint16_t port, const int thread_count) {
+  ws_server_->start("127.0.0.1", port, thread_count);
+  LOG_INFO << "Loopback server started on port " << getPort();
+}
+
+void Server::startRecorder() {
+  const auto& config = common::ConfigManager::getInstance();
+  recorder_.reset();
+  if (!config.getWithDefault("archive.enabled", false)) {
+    return;
+  }
+
+  // 每次启动新建一个以启动时间命名的归档
+  const std::filesystem::path directory =
+      config.getWithDefault("archive.directory", std::string("./archives"));
+  const auto started_ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count();
+  core::PoseRecorderConfig recorder_config;
+  recorder_config.path =
+      (directory / ("poses_" + std::to_string(started_ms) + ".pra")).string();
+  recorder_config.sample_interval =
+      std::chrono::milliseconds(config.getWithDefault(
+          "archive.sample_interval_ms",
+          static_cast<int>(constants::kDefaultArchiveSampleInterval.count())));
+  recorder_config.block_frames = static_cast<std::size_t>(std::max(
+      1, config.getWithDefault(
+             "archive.block_frames",
+             static_cast<int>(constants::kDefaultArchiveBlockFrames))));
+
+  // 归档失败不影响实时服务
+  try {
+    std::filesystem::create_directories(directory);
+    recorder_ = std::make_unique<core::PoseRecorder>(*registry_,
+                                                     recorder_config);
+    recorder_->start();
+    LOG_INFO << "Recording poses to " << recorder_config.path;
+  } catch (const std::exception& e) {
+    recorder_.reset();
+    LOG_ERROR << "Pose archive disabled: " << e.what();
+  }
+}
+
 void Server::stop() const {
   if (discovery_server_) {
     discovery_server_->stop();
   }
   ws_server_->stop();
+  if (recorder_ && recorder_->isRecording()) {
+    recorder_->stop();
+    const auto error = recorder_->getError();
+    if (!error.empty()) {
+      LOG_ERROR << "Pose archive stopped early: " << error;
+    }
+    LOG_INFO << "Pose archive " << recorder_->getPath() << ": "
+             << recorder_->getFramesRecorded() << " frames, "
+             << recorder_->getBytesWritten() << " bytes";
+  }
   LOG_INFO << "Server stopped.";
 }
 
+auto Server::getPoseArchivePath() const -> std::string {
+  return recorder_ ? recorder_->getPath() : std::string{};
+}
+
 auto Server::getPlayerCount() const -> size_t {
   return registry_->getPlayerCount();
 }
 
+auto Server::getPort() const -> uint16_t {
+  return ws_server_ ? ws_server_->getPort() : 0;
+}
+
 auto Server::getConnectionCount() const -> size_t {
   return ws_server_ ? ws_server_->getConnectionCount() : 0;
 }
@@ -60,4 +148,102 @@ auto Server::getMessagesSent() const -> size_t {
   return ws_server_ ? ws_server_->getMessagesSent() : 0;
 }
 
+auto Server::getTlsHandshakes() const -> size_t {
+  return ws_server_ ? ws_server_->getTlsHandshakes() : 0;
+}
+
+auto Server::getTlsResumedHandshakes() const -> size_t {
+  return ws_server_ ? ws_server_->getTlsResumedHandshakes() : 0;
+}
+
+auto Server::getStageCosts() const -> network::StageCosts {
+  return ws_server_ ? ws_server_->getStageCosts() : network::StageCosts{};
+}
+
+auto Server::getTenantStats() const -> std::vector<TenantStats> {
+  std::vector<TenantStats> stats;
+  stats.reserve(tenants_.size());
+  for (const auto& tenant : tenants_) {
+    stats.push_back({tenant.ws_server->getTenantName(),
+                     tenant.registry->getPlayerCount(),
+                     tenant.ws_server->getConnectionCount(),
+                     tenant.ws_server->isTenantActive()});
+  }
+  return stats;
+}
+
+auto Server::getWorkerCount() const -> size_t {
+  return ws_server_ ? ws_server_->getWorkerCount() : 0;
+}
+
+void Server::setWorkerCount(size_t count) { ws_server_->setWorkerCount(count); }
+
+void Server::setWorkerAutoscale(bool enabled) {
+  ws_server_->setWorkerAutoscale(enabled);
+}
+
+auto Server::isWorkerAutoscale() const -> bool {
+  return ws_server_ && ws_server_->isWorkerAutoscale();
+}
+
+auto Server::getShedLevel() const -> size_t {
+  return ws_server_ ? ws_server_->getShedLevel() : 0;
+}
+
+auto Server::getShedSteps() const -> size_t {
+  return ws_server_ ? ws_server_->getLoadShedder().getSteps().size() : 0;
+}
+
+auto Server::getFramesShed() const -> size_t {
+  return ws_server_ ? ws_server_->getFramesShed() : 0;
+}
+
+auto Server::isAdaptiveEncoding() const -> bool {
+  return ws_server_ && ws_server_->getAdaptiveEncodingConfig().enabled;
+}
+
+auto Server::getEncodingTierCounts() const
+    -> std::array<size_t, core::kEncodingTierCount> {
+  if (!ws_server_) {
+    return {};
+  }
+  return ws_server_->getEncodingTierCounts();
+}
+
+auto Server::getEncodingSwitches() const -> size_t {
+  return ws_server_ ? ws_server_->getEncodingSwitches() : 0;
+}
+
+auto Server::addPlayerObserver(core::PlayerRegistry::ChangeObserver observer)
+    -> core::PlayerRegistry::ObserverId {
+  return registry_->addObserver(std::move(observer));
+}
+
+void Server::removePlayerObserver(core::PlayerRegistry::ObserverId id) {
+  registry_->removeObserver(id);
+}
+
+auto Server::getPlayerSnapshot() const -> core::PlayerRegistry::Snapshot {
+  return registry_->getSnapshot();
+}
+
+auto Server::readPlayerJournal(std::uint64_t since,
+                               std::size_t max_records) const
+    -> core::PlayerRegistry::JournalRead {
+  return registry_->readJournal(since, max_records);
+}
+
+void Server::upsertNpc(picoradar::PlayerData data) {
+  // 会话与空间索引只在 I/O 线程上访问
+  net::post(*ioc_, [ws_server = ws_server_, data = std::move(data)]() mutable {
+    ws_server->injectPlayer(std::move(data));
+  });
+}
+
+void Server::removeNpc(const std::string& player_id) {
+  net::post(*ioc_, [ws_server = ws_server_, player_id] {
+    ws_server->removeInjectedPlayer(player_id);
+  });
+}
+
 }  // namespace picoradar::server
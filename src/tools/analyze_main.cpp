@@ -0,0 +1,273 @@
+// picoradar_analyze: 对录制的位姿归档 (.pra) 运行离线统计查询
+//
+// 用法:
+//   picoradar_analyze [--from MS] [--to MS] [--cell-size METERS]
+//                     [--grid WIDTHxHEIGHT] [--near-miss ALERT[:CLEAR]]
+//                     [--max-gap MS] [--threads N] [--format json|csv]
+//                     [--output PATH] ARCHIVE_OR_DIRECTORY...
+//
+// 输出每名玩家的移动距离、各场景停留时长与险情次数，每对玩家的险情
+// 统计，以及每个场景的采样热力图。目录参数会展开为其中所有 .pra 文件。
+// json 格式写入 --output 指定的文件（默认标准输出）；csv 格式在
+// --output 指定的目录（默认当前目录）下写入 players.csv、dwell.csv、
+// near_misses.csv 与 heatmap.csv。
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "core/pose_analytics.hpp"
+
+using picoradar::core::PoseAnalyticsConfig;
+using picoradar::core::PoseAnalyticsReport;
+using picoradar::core::PoseAnalyzer;
+using picoradar::core::PoseArchiveReader;
+
+namespace {
+
+struct Options {
+  PoseAnalyticsConfig query;
+  std::string format = "json";
+  std::string output;
+  std::vector<std::string> archives;
+};
+
+void printUsage(const char* program) {
+  std::cout << "Usage: " << program
+            << " [--from MS] [--to MS] [--cell-size METERS]"
+               " [--grid WIDTHxHEIGHT] [--near-miss ALERT[:CLEAR]]"
+               " [--max-gap MS] [--threads N] [--format json|csv]"
+               " [--output PATH] ARCHIVE_OR_DIRECTORY...\n";
+}
+
+auto parseOptions(int argc, char* argv[], Options& options) -> bool {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--help" || arg == "-h") {
+      return false;
+    }
+    if (arg.rfind("--", 0) != 0) {
+      options.archives.push_back(arg);
+      continue;
+    }
+    if (i + 1 >= argc) {
+      return false;
+    }
+    const std::string value = argv[++i];
+
+    if (arg == "--from") {
+      options.query.from_ms = std::stoll(value);
+    } else if (arg == "--to") {
+      options.query.to_ms = std::stoll(value);
+    } else if (arg == "--cell-size") {
+      options.query.heatmap.cell_size = std::stof(value);
+    } else if (arg == "--grid") {
+      const auto x = value.find('x');
+      if (x == std::string::npos) {
+        return false;
+      }
+      options.query.heatmap.width =
+          static_cast<std::uint32_t>(std::stoul(value.substr(0, x)));
+      options.query.heatmap.height =
+          static_cast<std::uint32_t>(std::stoul(value.substr(x + 1)));
+    } else if (arg == "--near-miss") {
+      const auto colon = value.find(':');
+      options.query.near_miss.alert_distance =
+          std::stof(value.substr(0, colon));
+      options.query.near_miss.clear_distance =
+          colon == std::string::npos ? options.query.near_miss.alert_distance
+                                     : std::stof(value.substr(colon + 1));
+    } else if (arg == "--max-gap") {
+      options.query.max_gap = std::chrono::milliseconds(std::stoll(value));
+    } else if (arg == "--threads") {
+      options.query.threads = std::stoul(value);
+    } else if (arg == "--format") {
+      if (value != "json" && value != "csv") {
+        return false;
+      }
+      options.format = value;
+    } else if (arg == "--output") {
+      options.output = value;
+    } else {
+      return false;
+    }
+  }
+  return !options.archives.empty();
+}
+
+// 目录参数展开为其中的 .pra 文件，按文件名排序
+auto expandArchives(const std::vector<std::string>& arguments)
+    -> std::vector<std::string> {
+  std::vector<std::string> paths;
+  for (const auto& argument : arguments) {
+    if (!std::filesystem::is_directory(argument)) {
+      paths.push_back(argument);
+      continue;
+    }
+    std::vector<std::string> found;
+    for (const auto& entry : std::filesystem::directory_iterator(argument)) {
+      if (entry.is_regular_file() && entry.path().extension() == ".pra") {
+        found.push_back(entry.path().string());
+      }
+    }
+    std::sort(found.begin(), found.end());
+    paths.insert(paths.end(), found.begin(), found.end());
+  }
+  return paths;
+}
+
+auto toJson(const PoseAnalyticsReport& report,
+            const PoseAnalyticsConfig& config) -> nlohmann::json {
+  nlohmann::json players = nlohmann::json::array();
+  for (const auto& player : report.players) {
+    players.push_back({{"player_id", player.player_id},
+                       {"samples", player.samples},
+                       {"distance_m", player.distance_m},
+                       {"dwell_s", player.dwell_s},
+                       {"near_misses", player.near_misses}});
+  }
+
+  nlohmann::json near_misses = nlohmann::json::array();
+  for (const auto& pair : report.near_misses) {
+    near_misses.push_back({{"first", pair.first},
+                           {"second", pair.second},
+                           {"count", pair.count},
+                           {"min_distance_m", pair.min_distance}});
+  }
+
+  nlohmann::json heatmaps = nlohmann::json::array();
+  for (const auto& heatmap : report.heatmaps) {
+    heatmaps.push_back({{"scene_id", heatmap.scene_id},
+                        {"cell_size", config.heatmap.cell_size},
+                        {"width", config.heatmap.width},
+                        {"height", config.heatmap.height},
+                        {"outside", heatmap.outside},
+                        {"cells", heatmap.cells}});
+  }
+
+  return {{"start_ms", report.start_ms},
+          {"end_ms", report.end_ms},
+          {"samples", report.samples},
+          {"blocks", report.blocks},
+          {"players", players},
+          {"near_misses", near_misses},
+          {"heatmaps", heatmaps}};
+}
+
+auto openCsv(const std::filesystem::path& directory, const char* name,
+             const char* header) -> std::ofstream {
+  std::ofstream file(directory / name);
+  if (!file) {
+    throw std::runtime_error("Failed to create " +
+                             (directory / name).string());
+  }
+  file << header << "\n";
+  return file;
+}
+
+void writeCsv(const PoseAnalyticsReport& report,
+              const PoseAnalyticsConfig& config,
+              const std::filesystem::path& directory) {
+  std::filesystem::create_directories(directory);
+
+  auto players = openCsv(directory, "players.csv",
+                         "player_id,samples,distance_m,near_misses");
+  auto dwell = openCsv(directory, "dwell.csv", "player_id,scene_id,dwell_s");
+  for (const auto& player : report.players) {
+    players << player.player_id << "," << player.samples << ","
+            << player.distance_m << "," << player.near_misses << "\n";
+    for (const auto& [scene_id, seconds] : player.dwell_s) {
+      dwell << player.player_id << "," << scene_id << "," << seconds << "\n";
+    }
+  }
+
+  auto near_misses = openCsv(directory, "near_misses.csv",
+                             "first,second,count,min_distance_m");
+  for (const auto& pair : report.near_misses) {
+    near_misses << pair.first << "," << pair.second << "," << pair.count
+                << "," << pair.min_distance << "\n";
+  }
+
+  // 只输出非空单元，坐标为单元中心
+  auto heatmap_file = openCsv(directory, "heatmap.csv",
+                              "scene_id,cell_x,cell_z,x_m,z_m,samples");
+  const auto cell_size = config.heatmap.cell_size;
+  const float origin_x =
+      -static_cast<float>(config.heatmap.width) * cell_size / 2.0F;
+  const float origin_z =
+      -static_cast<float>(config.heatmap.height) * cell_size / 2.0F;
+  for (const auto& heatmap : report.heatmaps) {
+    for (std::size_t i = 0; i < heatmap.cells.size(); ++i) {
+      if (heatmap.cells[i] == 0) {
+        continue;
+      }
+      const auto cell_x = i % config.heatmap.width;
+      const auto cell_z = i / config.heatmap.width;
+      heatmap_file << heatmap.scene_id << "," << cell_x << "," << cell_z
+                   << ","
+                   << origin_x + (static_cast<float>(cell_x) + 0.5F) * cell_size
+                   << ","
+                   << origin_z + (static_cast<float>(cell_z) + 0.5F) * cell_size
+                   << "," << heatmap.cells[i] << "\n";
+    }
+  }
+}
+
+}  // namespace
+
+auto main(int argc, char* argv[]) -> int {
+  Options options;
+  try {
+    if (!parseOptions(argc, argv, options)) {
+      printUsage(argv[0]);
+      return 1;
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "Invalid argument: " << e.what() << "\n";
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  try {
+    const auto started = std::chrono::steady_clock::now();
+
+    std::vector<std::unique_ptr<PoseArchiveReader>> readers;
+    std::vector<const PoseArchiveReader*> archives;
+    for (const auto& path : expandArchives(options.archives)) {
+      readers.push_back(std::make_unique<PoseArchiveReader>(path));
+      archives.push_back(readers.back().get());
+    }
+
+    const PoseAnalyzer analyzer(options.query);
+    const auto report = analyzer.run(archives);
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - started);
+    std::cerr << "Scanned " << report.samples << " samples in "
+              << report.blocks << " blocks from " << archives.size()
+              << " archives in " << elapsed.count() << " ms\n";
+
+    if (options.format == "csv") {
+      writeCsv(report, analyzer.getConfig(),
+               options.output.empty() ? "." : options.output);
+    } else if (options.output.empty() || options.output == "-") {
+      std::cout << toJson(report, analyzer.getConfig()).dump(2) << "\n";
+    } else {
+      std::ofstream file(options.output);
+      if (!file) {
+        throw std::runtime_error("Failed to create " + options.output);
+      }
+      file << toJson(report, analyzer.getConfig()).dump(2) << "\n";
+    }
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,178 @@
+// picoradar_netem_proxy: 在本地回环上模拟不稳定网络的 TCP 代理
+//
+// 用法:
+//   picoradar_netem_proxy [--listen PORT] [--target HOST:PORT]
+//                         [--latency MS] [--jitter MS] [--rate BYTES_PER_SEC]
+//                         [--up-rate BYTES_PER_SEC] [--down-rate ...]
+//                         [--drop PROBABILITY] [--seed N]
+//
+// 运行期间可在标准输入中输入命令:
+//   stall <ms>  暂停所有流量    drop  断开所有连接
+//   latency <ms> / jitter <ms> / rate <bytes>  修改双向参数
+//   status  查看统计           quit  退出
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "common/constants.hpp"
+#include "common/logging.hpp"
+#include "network/netem_proxy.hpp"
+
+using picoradar::network::NetemDirection;
+using picoradar::network::NetemProfile;
+using picoradar::network::NetemProxy;
+
+namespace {
+
+struct Options {
+  std::uint16_t listen_port = picoradar::constants::kDefaultServicePort + 10;
+  std::string target_host = "127.0.0.1";
+  std::uint16_t target_port = picoradar::constants::kDefaultServicePort;
+  NetemProfile upstream;
+  NetemProfile downstream;
+  std::uint32_t seed = 0;
+  bool has_seed = false;
+};
+
+void printUsage(const char* program) {
+  std::cout << "Usage: " << program
+            << " [--listen PORT] [--target HOST:PORT] [--latency MS]"
+               " [--jitter MS] [--rate BPS] [--up-rate BPS] [--down-rate BPS]"
+               " [--drop PROBABILITY] [--seed N]\n";
+}
+
+auto parseOptions(int argc, char* argv[], Options& options) -> bool {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--help" || arg == "-h" || i + 1 >= argc) {
+      return false;
+    }
+    const std::string value = argv[++i];
+
+    if (arg == "--listen") {
+      options.listen_port = static_cast<std::uint16_t>(std::stoi(value));
+    } else if (arg == "--target") {
+      const auto colon = value.rfind(':');
+      if (colon == std::string::npos) {
+        return false;
+      }
+      options.target_host = value.substr(0, colon);
+      options.target_port =
+          static_cast<std::uint16_t>(std::stoi(value.substr(colon + 1)));
+    } else if (arg == "--latency") {
+      options.upstream.latency = std::chrono::milliseconds(std::stoi(value));
+      options.downstream.latency = options.upstream.latency;
+    } else if (arg == "--jitter") {
+      options.upstream.jitter = std::chrono::milliseconds(std::stoi(value));
+      options.downstream.jitter = options.upstream.jitter;
+    } else if (arg == "--rate") {
+      options.upstream.bytes_per_sec = std::stoul(value);
+      options.downstream.bytes_per_sec = options.upstream.bytes_per_sec;
+    } else if (arg == "--up-rate") {
+      options.upstream.bytes_per_sec = std::stoul(value);
+    } else if (arg == "--down-rate") {
+      options.downstream.bytes_per_sec = std::stoul(value);
+    } else if (arg == "--drop") {
+      options.upstream.drop_probability = std::stod(value);
+      options.downstream.drop_probability = options.upstream.drop_probability;
+    } else if (arg == "--seed") {
+      options.seed = static_cast<std::uint32_t>(std::stoul(value));
+      options.has_seed = true;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+// 对双向配置应用同一修改
+template <typename Modifier>
+void updateProfiles(NetemProxy& proxy, Modifier modify) {
+  for (const auto direction :
+       {NetemDirection::Upstream, NetemDirection::Downstream}) {
+    auto profile = proxy.getProfile(direction);
+    modify(profile);
+    proxy.setProfile(direction, profile);
+  }
+}
+
+}  // namespace
+
+auto main(int argc, char* argv[]) -> int {
+  logger::LogConfig log_config;
+  log_config.file_enabled = false;
+  log_config.console_enabled = true;
+  log_config.console_min_level = logger::LogLevel::INFO;
+  logger::Logger::Init("picoradar_netem_proxy", log_config);
+
+  Options options;
+  try {
+    if (!parseOptions(argc, argv, options)) {
+      printUsage(argv[0]);
+      return 1;
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "Invalid argument: " << e.what() << "\n";
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  NetemProxy proxy(options.target_host, options.target_port);
+  proxy.setProfile(NetemDirection::Upstream, options.upstream);
+  proxy.setProfile(NetemDirection::Downstream, options.downstream);
+  if (options.has_seed) {
+    proxy.setSeed(options.seed);
+  }
+
+  try {
+    proxy.start(options.listen_port);
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+
+  std::string line;
+  while (std::getline(std::cin, line)) {
+    std::istringstream command(line);
+    std::string name;
+    long value = 0;
+    command >> name >> value;
+
+    if (name == "quit" || name == "exit") {
+      break;
+    }
+    if (name == "stall") {
+      proxy.stallFor(std::chrono::milliseconds(value));
+    } else if (name == "drop") {
+      proxy.dropConnections();
+    } else if (name == "latency") {
+      updateProfiles(proxy, [value](NetemProfile& profile) {
+        profile.latency = std::chrono::milliseconds(value);
+      });
+    } else if (name == "jitter") {
+      updateProfiles(proxy, [value](NetemProfile& profile) {
+        profile.jitter = std::chrono::milliseconds(value);
+      });
+    } else if (name == "rate") {
+      updateProfiles(proxy, [value](NetemProfile& profile) {
+        profile.bytes_per_sec = static_cast<std::size_t>(std::max(0L, value));
+      });
+    } else if (name == "status") {
+      std::cout << "connections=" << proxy.getConnectionCount()
+                << " up_bytes="
+                << proxy.getBytesForwarded(NetemDirection::Upstream)
+                << " down_bytes="
+                << proxy.getBytesForwarded(NetemDirection::Downstream)
+                << " dropped=" << proxy.getDroppedConnections() << "\n";
+    } else if (!name.empty()) {
+      std::cout << "Commands: stall <ms>, drop, latency <ms>, jitter <ms>, "
+                   "rate <bytes>, status, quit\n";
+    }
+  }
+
+  proxy.stop();
+  logger::Logger::shutdown();
+  return 0;
+}
@@ -144,296 +144,101 @@ TEST_F(ClientIntegrationTest, AuthenticationFailure) {
 }
 
 /**
- * @brief 测试发送和接收数据
+ * @brief 测试只订阅热力图的概览客户端
  */
-TEST_F(ClientIntegrationTest, SendAndReceiveData) {
-  Client client;
-
-  // 设置玩家列表回调
-  std::atomic<bool> callback_called{false};
-  std::atomic<size_t> player_count{0};
-
-  client.setOnPlayerListUpdate([&](const std::vector<PlayerData>& players) {
-    callback_called = true;
-    player_count = players.size();
-    LOG_DEBUG << "Received player list with " << players.size() << " players";
+TEST_F(ClientIntegrationTest, HeatmapSubscriber) {
+  Client overview;
+  std::atomic<bool> heatmap_received{false};
+  std::atomic<uint32_t> total_players{0};
+
+  overview.setOnHeatmapUpdate([&](const HeatmapFrame& frame) {
+    if (frame.scene_id() == "heatmap_scene") {
+      total_players = frame.total_players();
+      heatmap_received = true;
+    }
   });
 
-  // 连接到服务器
-  auto future =
-      client.connect("127.0.0.1:" + std::to_string(test_port_),
-                     "integration_test_player", "pico_radar_secret_token");
+  ASSERT_NO_THROW(overview
+                      .connect("127.0.0.1:" + std::to_string(test_port_),
+                               "overview_tablet", "pico_radar_secret_token")
+                      .get());
 
-  ASSERT_NO_THROW(future.get());
-  ASSERT_TRUE(client.isConnected());
+  Client player;
+  ASSERT_NO_THROW(player
+                      .connect("127.0.0.1:" + std::to_string(test_port_),
+                               "heatmap_player", "pico_radar_secret_token")
+                      .get());
 
-  // 发送玩家数据
   PlayerData data;
-  data.set_player_id("integration_test_player");
-  data.set_scene_id("test_scene");
-
-  auto* pos = data.mutable_position();
-  pos->set_x(1.0F);
-  pos->set_y(2.0F);
-  pos->set_z(3.0F);
-
-  auto* rot = data.mutable_rotation();
-  rot->set_x(0.0F);
-  rot->set_y(0.0F);
-  rot->set_z(0.0F);
-  rot->set_w(1.0F);
-
-  data.set_timestamp(std::chrono::duration_cast<std::chrono::milliseconds>(
-                         std::chrono::system_clock::now().time_since_epoch())
-                         .count());
-
-  // 发送数据
-  EXPECT_NO_THROW(client.sendPlayerData(data));
-
-  // 等待一段时间让服务器处理数据并发送玩家列表
-  std::this_thread::sleep_for(std::chrono::seconds(1));
+  data.set_player_id("heatmap_player");
+  data.set_scene_id("heatmap_scene");
+  data.mutable_position()->set_x(1.0F);
+  data.mutable_position()->set_z(2.0F);
+  player.sendPlayerData(data);
+
+  // 热力图按较低频率广播，等待至少两个周期
+  for (int i = 0; i < 30 && !heatmap_received; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
 
-  // 验证是否收到了玩家列表回调
-  EXPECT_TRUE(callback_called.load());
-  EXPECT_GE(player_count.load(), 1);  // 至少应该有我们自己的玩家
+  EXPECT_TRUE(heatmap_received.load());
+  EXPECT_EQ(total_players.load(), 1);
 
-  // 断开连接
-  client.disconnect();
-  EXPECT_FALSE(client.isConnected());
+  player.disconnect();
+  overview.disconnect();
 }
 
 /**
- * @brief 测试多个客户端同时连接
+ * @brief 测试近距离警报只发给涉及的玩家
  */
-TEST_F(ClientIntegrationTest, MultipleClients) {
-  constexpr int num_clients = 3;
-  std::vector<std::unique_ptr<Client>> clients;
-  std::vector<std::future<void>> futures;
-
-  // 为每个客户端存储接收到的玩家数据
-  std::vector<std::map<std::string, PlayerData>> received_data_maps(
-      num_clients);
-  std::vector<std::mutex> map_mutexes(num_clients);
-
-  // 确保服务器从干净状态开始
-  EXPECT_EQ(server_->getPlayerCount(), 0);
-
-  // 创建多个客户端
-  for (int i = 0; i < num_clients; ++i) {
-    auto client = std::make_unique<Client>();
-
-    // 为每个客户端设置回调以存储数据
-    client->setOnPlayerListUpdate(
-        [&, i](const std::vector<PlayerData>& players) {
-          std::lock_guard lock(map_mutexes[i]);
-          LOG_DEBUG << "Client " << i << " received player list with "
-                    << players.size() << " players";
-          // 清除之前的数据，只保留当前的
-          received_data_maps[i].clear();
-          for (const auto& player : players) {
-            received_data_maps[i][player.player_id()] = player;
-          }
-        });
-
-    // 开始连接
-    auto future = client->connect("127.0.0.1:" + std::to_string(test_port_),
-                                  "test_player_" + std::to_string(i),
-                                  "pico_radar_secret_token");
-
-    futures.push_back(std::move(future));
-    clients.push_back(std::move(client));
-
-    // 在连接之间添加更长的延迟以确保顺序连接
-    if (i < num_clients - 1) {
-      std::this_thread::sleep_for(std::chrono::milliseconds(50));
-    }
-  }
-
-  // 等待所有连接完成（带超时）
-  for (int i = 0; i < futures.size(); ++i) {
-    auto& future = futures[i];
-    auto status = future.wait_for(std::chrono::seconds(3));
-    if (status == std::future_status::timeout) {
-      LOG_ERROR << "Client " << i << " connection timeout";
-      FAIL() << "Client " << i << " connection timeout";
+TEST_F(ClientIntegrationTest, ProximityAlertReachesAffectedPlayers) {
+  std::atomic<bool> alice_alerted{false};
+  std::atomic<bool> carol_alerted{false};
+
+  Client alice;
+  alice.setOnProximityAlert([&](const ProximityAlert& alert) {
+    for (const auto& event : alert.events()) {
+      if (event.other_player_id() == "prox_bob" && !event.cleared()) {
+        alice_alerted = true;
+      }
     }
-    EXPECT_NO_THROW(future.get());
-  }
-
-  // 验证所有客户端都已连接
-  for (const auto& client : clients) {
-    EXPECT_TRUE(client->isConnected());
-  }
-
-  // 等待服务器处理所有连接和认证 - 增加等待时间处理时序问题
-  std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+  });
+  Client bob;
+  Client carol;
+  carol.setOnProximityAlert([&](const ProximityAlert&) {
+    carol_alerted = true;
+  });
 
-  // 验证服务器上的玩家数量 - 使用重试机制处理时序问题
-  size_t player_count = 0;
-  for (int retry = 0; retry < 10; ++retry) {
-    player_count = server_->getPlayerCount();
-    if (player_count == num_clients) {
-      break;
-    }
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
-  }
-  EXPECT_EQ(player_count, num_clients)
-      << "Server player count after retries: " << player_count;
+  const auto address = "127.0.0.1:" + std::to_string(test_port_);
+  ASSERT_NO_THROW(
+      alice.connect(address, "prox_alice", "pico_radar_secret_token").get());
+  ASSERT_NO_THROW(
+      bob.connect(address, "prox_bob", "pico_radar_secret_token").get());
+  ASSERT_NO_THROW(
+      carol.connect(address, "prox_carol", "pico_radar_secret_token").get());
 
-  // 每个客户端发送数据
-  for (int i = 0; i < num_clients; ++i) {
+  const auto send_position = [](Client& client, const std::string& id,
+                                float x) {
     PlayerData data;
-    data.set_player_id("test_player_" + std::to_string(i));
-    data.set_scene_id("test_scene");
-
-    auto* pos = data.mutable_position();
-    pos->set_x(static_cast<float>(i));
-    pos->set_y(static_cast<float>(i * 2));
-    pos->set_z(static_cast<float>(i * 3));
-
-    auto* rot = data.mutable_rotation();
-    rot->set_x(0.0F);
-    rot->set_y(0.0F);
-    rot->set_z(0.0F);
-    rot->set_w(1.0F);
-
-    data.set_timestamp(std::chrono::duration_cast<std::chrono::milliseconds>(
-                           std::chrono::system_clock::now().time_since_epoch())
-                           .count());
-
-    clients[i]->sendPlayerData(data);
-
-    // 在发送之间添加小延迟确保顺序
+    data.set_player_id(id);
+    data.set_scene_id("proximity_scene");
+    data.mutable_position()->set_x(x);
+    client.sendPlayerData(data);
+  };
+  send_position(alice, "prox_alice", 0.0F);
+  send_position(bob, "prox_bob", 0.5F);
+  send_position(carol, "prox_carol", 30.0F);
+
+  for (int i = 0; i < 20 && !alice_alerted; ++i) {
     std::this_thread::sleep_for(std::chrono::milliseconds(50));
   }
 
-  // 等待数据传播和服务器处理 - 使用重试机制确保数据正确传播
-  bool data_received = false;
-  for (int retry = 0; retry < 20; ++retry) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
-
-    // 检查至少一个客户端是否收到了正确的数据
-    bool any_client_has_correct_data = false;
-    for (int i = 0; i < num_clients; ++i) {
-      std::lock_guard lock(map_mutexes[i]);
-      const auto& received_map = received_data_maps[i];
-
-      if (received_map.size() == num_clients) {
-        // 检查是否有非空数据
-        for (const auto& pair : received_map) {
-          const auto& data = pair.second;
-          if (!data.scene_id().empty() || data.position().x() != 0.0f ||
-              data.position().y() != 0.0f || data.position().z() != 0.0f) {
-            any_client_has_correct_data = true;
-            break;
-          }
-        }
-        if (any_client_has_correct_data) break;
-      }
-    }
-
-    if (any_client_has_correct_data) {
-      data_received = true;
-      break;
-    }
-  }
-
-  if (!data_received) {
-    LOG_WARNING << "No client received correct data after retries - this might "
-                   "indicate a timing issue";
-  }
-
-  // 验证每个客户端收到的数据是否正确
-  int clients_with_complete_data = 0;
-
-  for (int i = 0; i < num_clients; ++i) {  // 遍历每个客户端
-    std::lock_guard lock(map_mutexes[i]);
-    const auto& received_map = received_data_maps[i];
-
-    // 调试输出
-    LOG_INFO << "Client " << i << " received data for " << received_map.size()
-             << " players";
-    for (const auto& pair : received_map) {
-      LOG_INFO << "  Player: " << pair.first << " Scene: '"
-               << pair.second.scene_id() << "'" << " Pos: ("
-               << pair.second.position().x() << ","
-               << pair.second.position().y() << ","
-               << pair.second.position().z() << ")";
-    }
-
-    // 客户端应该收到所有玩家（包括自己）的数据
-    ASSERT_EQ(received_map.size(), num_clients)
-        << "Client " << i << " expected to receive data for " << num_clients
-        << " players, but got " << received_map.size();
-
-    bool client_has_complete_data = true;
-    int valid_data_count = 0;
-
-    for (int j = 0; j < num_clients; ++j) {  // 验证来自每个发送者的数据
-      std::string expected_player_id = "test_player_" + std::to_string(j);
-      auto it = received_map.find(expected_player_id);
-
-      ASSERT_NE(it, received_map.end())
-          << "Client " << i << " did not receive data for player "
-          << expected_player_id;
-
-      const auto& data = it->second;
-
-      // 检查是否为有效数据（非初始默认值）
-      bool is_valid_data =
-          !data.scene_id().empty() || data.position().x() != 0.0f ||
-          data.position().y() != 0.0f || data.position().z() != 0.0f;
-
-      if (is_valid_data) {
-        valid_data_count++;
-        // 验证非空数据的正确性
-        EXPECT_EQ(data.scene_id(), "test_scene")
-            << "Client " << i << " player " << j << " scene_id mismatch";
-        EXPECT_FLOAT_EQ(data.position().x(), static_cast<float>(j))
-            << "Client " << i << " player " << j << " position.x mismatch";
-        EXPECT_FLOAT_EQ(data.position().y(), static_cast<float>(j * 2))
-            << "Client " << i << " player " << j << " position.y mismatch";
-        EXPECT_FLOAT_EQ(data.position().z(), static_cast<float>(j * 3))
-            << "Client " << i << " player " << j << " position.z mismatch";
-      } else {
-        LOG_WARNING << "Client " << i
-                    << " received initial/default data for player "
-                    << expected_player_id;
-        client_has_complete_data = false;
-      }
-    }
-
-    if (client_has_complete_data && valid_data_count == num_clients) {
-      clients_with_complete_data++;
-    }
-
-    LOG_INFO << "Client " << i << " has " << valid_data_count << "/"
-             << num_clients << " valid data entries";
-  }
-
-  // 由于时序问题，我们允许部分客户端可能没有收到完整数据
-  // 但至少应该有一些客户端收到了正确的数据
-  if (data_received) {
-    LOG_INFO << "Data transmission test: " << clients_with_complete_data << "/"
-             << num_clients << " clients received complete data";
-    EXPECT_GT(clients_with_complete_data, 0)
-        << "No client received complete data - this suggests a system issue";
-  } else {
-    LOG_WARNING << "Skipping data validation due to timing issues";
-  }
-
-  // 手动断开所有客户端
-  for (auto& client : clients) {
-    if (client->isConnected()) {
-      client->disconnect();
-    }
-  }
-
-  // 等待所有客户端断开连接
-  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  EXPECT_TRUE(alice_alerted.load());
+  EXPECT_FALSE(carol_alerted.load());
 
-  // 验证服务器上没有活跃的玩家
-  EXPECT_EQ(server_->getPlayerCount(), 0);
+  carol.disconnect();
+  bob.disconnect();
+  alice.disconnect();
 }
 
 /**
@@ -0,0 +1,219 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "client.hpp"
+#include "common/config_manager.hpp"
+#include "network/simulation_harness.hpp"
+#include "utils/player_utils.hpp"
+
+using namespace picoradar;
+using picoradar::client::Client;
+using picoradar::network::SimulationHarness;
+using picoradar::test::makePlayer;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr auto kToken = "simulation_token";
+constexpr auto kScene = "test_scene";
+
+// 把客户端接到虚拟时间仿真中的服务器：服务器消息在 advance() 中送达，
+// 客户端回调因此在测试线程中执行
+class SimulatedTransport : public Client::Transport {
+ public:
+  SimulatedTransport(SimulationHarness& harness, std::string player_id)
+      : harness_(harness), player_id_(std::move(player_id)) {}
+
+  void open(FrameHandler on_frame, CloseHandler on_close) override {
+    harness_.attach(player_id_, std::move(on_frame),
+                    [this, on_close = std::move(on_close)] {
+                      closed_ = true;
+                      on_close();
+                    });
+  }
+
+  void send(const std::string& frame) override {
+    harness_.sendFrame(player_id_, frame);
+  }
+
+  // 服务器关闭的会话由仿真自行回收，不能在 advance() 的回调中再断开
+  void close() override {
+    if (!closed_) {
+      harness_.disconnect(player_id_);
+    }
+  }
+
+ private:
+  SimulationHarness& harness_;
+  std::string player_id_;
+  bool closed_ = false;
+};
+
+}  // namespace
+
+class ClientSimulationTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    common::ConfigManager::getInstance().set("auth.token",
+                                             std::string(kToken));
+  }
+
+  auto connect(Client& client, const std::string& player_id,
+               const std::string& token = kToken) -> std::future<void> {
+    return client.connect(
+        std::make_shared<SimulatedTransport>(harness_, player_id), player_id,
+        token);
+  }
+
+  // 客户端在析构时断开传输层，因此仿真必须比客户端活得更久
+  SimulationHarness harness_;
+};
+
+/**
+ * @brief 认证响应在虚拟时间中送达，不需要网络线程
+ */
+TEST_F(ClientSimulationTest, ConnectsInVirtualTime) {
+  Client client;
+  auto future = connect(client, "sim_player");
+
+  EXPECT_EQ(future.wait_for(0s), std::future_status::timeout);
+  harness_.advance(10ms);
+
+  ASSERT_EQ(future.wait_for(0s), std::future_status::ready);
+  EXPECT_NO_THROW(future.get());
+  EXPECT_TRUE(client.isConnected());
+  EXPECT_EQ(harness_.getServer().getConnectionCount(), 1);
+
+  client.disconnect();
+  EXPECT_FALSE(client.isConnected());
+  EXPECT_EQ(harness_.getServer().getConnectionCount(), 0);
+}
+
+/**
+ * @brief 认证失败通过 future 报告
+ */
+TEST_F(ClientSimulationTest, AuthenticationFailure) {
+  Client client;
+  auto future = connect(client, "sim_player", "wrong_token");
+  harness_.advance(10ms);
+
+  ASSERT_EQ(future.wait_for(0s), std::future_status::ready);
+  EXPECT_THROW(future.get(), std::exception);
+  EXPECT_FALSE(client.isConnected());
+}
+
+/**
+ * @brief 服务器关闭会话后客户端回到断开状态，并且可以重新连接
+ */
+TEST_F(ClientSimulationTest, ReconnectsAfterServerClose) {
+  Client client;
+  auto future = connect(client, "sim_player");
+  harness_.advance(10ms);
+  ASSERT_NO_THROW(future.get());
+  ASSERT_TRUE(client.isConnected());
+
+  auto session = harness_.getSession("sim_player");
+  ASSERT_NE(session, nullptr);
+  session->close();
+  harness_.advance(10ms);
+
+  EXPECT_FALSE(client.isConnected());
+  EXPECT_EQ(harness_.getServer().getConnectionCount(), 0);
+
+  auto reconnected = connect(client, "sim_player");
+  harness_.advance(10ms);
+  ASSERT_EQ(reconnected.wait_for(0s), std::future_status::ready);
+  EXPECT_NO_THROW(reconnected.get());
+  EXPECT_TRUE(client.isConnected());
+  EXPECT_EQ(harness_.getServer().getConnectionCount(), 1);
+
+  client.disconnect();
+  EXPECT_EQ(harness_.getServer().getConnectionCount(), 0);
+}
+
+/**
+ * @brief 测试发送和接收数据
+ */
+TEST_F(ClientSimulationTest, SendAndReceiveData) {
+  Client client;
+  std::size_t callbacks = 0;
+  std::vector<PlayerData> last_players;
+  client.setOnPlayerListUpdate([&](const std::vector<PlayerData>& players) {
+    ++callbacks;
+    last_players = players;
+  });
+
+  auto future = connect(client, "integration_test_player");
+  harness_.advance(10ms);
+  ASSERT_NO_THROW(future.get());
+
+  client.sendPlayerData(
+      makePlayer("integration_test_player", kScene, 1.0F, 2.0F, 3.0F));
+  harness_.advance(100ms);
+
+  EXPECT_GT(callbacks, 0);
+  ASSERT_EQ(last_players.size(), 1);
+  EXPECT_EQ(last_players[0].player_id(), "integration_test_player");
+  EXPECT_NEAR(last_players[0].position().x(), 1.0F, 0.01F);
+  EXPECT_NEAR(last_players[0].position().z(), 3.0F, 0.01F);
+}
+
+/**
+ * @brief 测试多个客户端互相收到对方的位姿
+ */
+TEST_F(ClientSimulationTest, MultipleClients) {
+  constexpr int num_clients = 3;
+  std::vector<std::unique_ptr<Client>> clients;
+  std::vector<std::future<void>> futures;
+  std::vector<std::map<std::string, PlayerData>> received(num_clients);
+
+  for (int i = 0; i < num_clients; ++i) {
+    auto client = std::make_unique<Client>();
+    client->setOnPlayerListUpdate(
+        [&received, i](const std::vector<PlayerData>& players) {
+          received[i].clear();
+          for (const auto& player : players) {
+            received[i][player.player_id()] = player;
+          }
+        });
+    futures.push_back(connect(*client, "test_player_" + std::to_string(i)));
+    clients.push_back(std::move(client));
+  }
+
+  harness_.advance(10ms);
+  for (auto& future : futures) {
+    ASSERT_NO_THROW(future.get());
+  }
+  EXPECT_EQ(harness_.getRegistry().getPlayerCount(), num_clients);
+
+  for (int i = 0; i < num_clients; ++i) {
+    const auto f = static_cast<float>(i);
+    clients[i]->sendPlayerData(makePlayer("test_player_" + std::to_string(i),
+                                          kScene, f, f * 2, f * 3));
+  }
+  harness_.advance(100ms);
+
+  for (int i = 0; i < num_clients; ++i) {
+    ASSERT_EQ(received[i].size(), num_clients) << "client " << i;
+    for (int j = 0; j < num_clients; ++j) {
+      const auto it = received[i].find("test_player_" + std::to_string(j));
+      ASSERT_NE(it, received[i].end()) << "client " << i << " player " << j;
+      const auto f = static_cast<float>(j);
+      EXPECT_EQ(it->second.scene_id(), kScene);
+      EXPECT_NEAR(it->second.position().x(), f, 0.01F);
+      EXPECT_NEAR(it->second.position().y(), f * 2, 0.01F);
+      EXPECT_NEAR(it->second.position().z(), f * 3, 0.01F);
+    }
+  }
+
+  for (auto& client : clients) {
+    client->disconnect();
+  }
+  EXPECT_EQ(harness_.getRegistry().getPlayerCount(), 0);
+}
@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <set>
+#include <string>
+#include <thread>
+
+#include "client.hpp"
+#include "common/config_manager.hpp"
+#include "common/logging.hpp"
+#include "network/websocket_server.hpp"
+#include "server/include/server.hpp"
+#include "utils/network_utils.hpp"
+
+using namespace picoradar::client;
+using namespace picoradar;
+using namespace picoradar::server;
+
+namespace {
+constexpr auto kDefaultToken = "pico_radar_secret_token";
+constexpr auto kVenueAToken = "venue_a_token";
+constexpr auto kVenueBToken = "venue_b_token";
+
+// 轮询直到条件成立或超时
+auto waitFor(const std::function<bool()>& condition,
+             std::chrono::milliseconds timeout = std::chrono::seconds(3))
+    -> bool {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (!condition()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return true;
+}
+}  // namespace
+
+class ClientTenantTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    logger::LogConfig config = logger::LogConfig::loadFromConfigManager();
+    config.log_directory = "./logs";
+    config.global_level = logger::LogLevel::INFO;
+    config.file_enabled = true;
+    config.console_enabled = false;
+    config.max_files = 10;
+    logger::Logger::Init("client_tenant_test", config);
+  }
+
+  void SetUp() override {
+    auto& config = common::ConfigManager::getInstance();
+    saved_config_ = config.getConfig();
+
+    port_ = test::get_available_port();
+    config.set("auth.token", std::string(kDefaultToken));
+    config.set("discovery.udp_port",
+               static_cast<int>(test::get_available_port()));
+    config.set("network.heatmap.interval_ms", 50);
+    config.set("tenants.venue_a.token", std::string(kVenueAToken));
+    config.set("tenants.venue_b.token", std::string(kVenueBToken));
+    config.set("tenants.venue_b.dedicated_thread", true);
+
+    server_ = std::make_unique<Server>();
+    server_->start(port_, 1);
+  }
+
+  void TearDown() override {
+    if (server_) {
+      server_->stop();
+      server_.reset();
+    }
+    ASSERT_TRUE(common::ConfigManager::getInstance().loadFromJson(
+        saved_config_));
+  }
+
+  [[nodiscard]] auto address() const -> std::string {
+    return "127.0.0.1:" + std::to_string(port_);
+  }
+
+  [[nodiscard]] auto tenant(const std::string& name) const
+      -> Server::TenantStats {
+    for (auto& stats : server_->getTenantStats()) {
+      if (stats.name == name) {
+        return stats;
+      }
+    }
+    ADD_FAILURE() << "No tenant named " << name;
+    return {};
+  }
+
+  static void connect(Client& client, const std::string& address,
+                      const std::string& player_id, const std::string& token) {
+    auto future = client.connect(address, player_id, token);
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(5)),
+              std::future_status::ready);
+    ASSERT_NO_THROW(future.get());
+  }
+
+  nlohmann::json saved_config_;
+  uint16_t port_ = 0;
+  std::unique_ptr<Server> server_;
+};
+
+TEST_F(ClientTenantTest, TokenSelectsIsolatedRegistry) {
+  std::mutex mutex;
+  std::set<std::string> seen_by_a;
+  Client a1;
+  a1.setOnPlayerListUpdate([&](const std::vector<PlayerData>& players) {
+    std::lock_guard lock(mutex);
+    for (const auto& player : players) {
+      seen_by_a.insert(player.player_id());
+    }
+  });
+  Client a2;
+  Client b1;
+  Client lobby;
+
+  connect(a1, address(), "a1", kVenueAToken);
+  connect(a2, address(), "a2", kVenueAToken);
+  connect(b1, address(), "b1", kVenueBToken);
+  connect(lobby, address(), "lobby", kDefaultToken);
+
+  // venue_b 的写入由其专用模拟线程在下一个 tick 应用
+  EXPECT_TRUE(waitFor([&] {
+    return tenant("venue_a").players == 2 && tenant("venue_b").players == 1;
+  }));
+  EXPECT_EQ(server_->getPlayerCount(), 1);  // 只有默认场馆的玩家
+  EXPECT_EQ(tenant("venue_a").connections, 2);
+  EXPECT_EQ(tenant("venue_b").connections, 1);
+  EXPECT_EQ(server_->getConnectionCount(), 4);
+
+  EXPECT_TRUE(waitFor([&] {
+    std::lock_guard lock(mutex);
+    return seen_by_a.count("a2") != 0;
+  }));
+  {
+    std::lock_guard lock(mutex);
+    EXPECT_EQ(seen_by_a.count("b1"), 0);
+    EXPECT_EQ(seen_by_a.count("lobby"), 0);
+  }
+
+  a1.disconnect();
+  a2.disconnect();
+  b1.disconnect();
+  lobby.disconnect();
+}
+
+TEST_F(ClientTenantTest, IdleTenantParks) {
+  EXPECT_FALSE(tenant("venue_a").active);
+  EXPECT_FALSE(tenant("venue_b").active);
+
+  Client a1;
+  Client b1;
+  connect(a1, address(), "a1", kVenueAToken);
+  connect(b1, address(), "b1", kVenueBToken);
+  EXPECT_TRUE(tenant("venue_a").active);
+  EXPECT_TRUE(tenant("venue_b").active);
+
+  a1.disconnect();
+  b1.disconnect();
+  EXPECT_TRUE(waitFor([&] {
+    return !tenant("venue_a").active && !tenant("venue_b").active;
+  }));
+  EXPECT_EQ(tenant("venue_a").players, 0);
+  EXPECT_EQ(tenant("venue_b").players, 0);
+
+  // 挂起后再次到达的会话重新唤醒租户
+  Client b2;
+  connect(b2, address(), "b2", kVenueBToken);
+  EXPECT_TRUE(tenant("venue_b").active);
+  EXPECT_TRUE(waitFor([&] { return tenant("venue_b").players == 1; }));
+  b2.disconnect();
+}
+
+TEST_F(ClientTenantTest, UnknownTokenIsRejected) {
+  Client client;
+  auto future = client.connect(address(), "intruder", "venue_c_token");
+  ASSERT_EQ(future.wait_for(std::chrono::seconds(5)),
+            std::future_status::ready);
+  EXPECT_THROW(future.get(), std::exception);
+  EXPECT_FALSE(client.isConnected());
+}
+
+TEST_F(ClientTenantTest, TenantTokensMustBeUnique) {
+  auto& config = common::ConfigManager::getInstance();
+  config.set("tenants.venue_c.token", std::string(kVenueAToken));
+  EXPECT_THROW(network::WebsocketServer::loadTenantConfigs(),
+               std::runtime_error);
+
+  config.set("tenants.venue_c.token", std::string(kDefaultToken));
+  EXPECT_THROW(network::WebsocketServer::loadTenantConfigs(),
+               std::runtime_error);
+
+  config.set("tenants.venue_c.token", std::string("venue_c_token"));
+  EXPECT_EQ(network::WebsocketServer::loadTenantConfigs().size(), 3);
+}
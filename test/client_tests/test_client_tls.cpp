@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <string>
+#include <thread>
+
+#include "client.hpp"
+#include "common/config_manager.hpp"
+#include "common/logging.hpp"
+#include "server/include/server.hpp"
+#include "utils/network_utils.hpp"
+#include "utils/tls_utils.hpp"
+
+using namespace picoradar::client;
+using namespace picoradar;
+using namespace picoradar::server;
+
+namespace {
+constexpr auto kToken = "pico_radar_secret_token";
+}  // namespace
+
+class ClientTlsTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    logger::LogConfig config = logger::LogConfig::loadFromConfigManager();
+    config.log_directory = "./logs";
+    config.global_level = logger::LogLevel::INFO;
+    config.file_enabled = true;
+    config.console_enabled = false;
+    config.max_files = 10;
+    logger::Logger::Init("client_tls_test", config);
+  }
+
+  void SetUp() override {
+    port_ = test::get_available_port();
+    cert_dir_ = std::filesystem::temp_directory_path() /
+                ("picoradar_tls_" + std::to_string(port_));
+    std::filesystem::create_directories(cert_dir_);
+    cert_ = test::make_test_certificate(cert_dir_);
+
+    auto& config = common::ConfigManager::getInstance();
+    config.set("auth.token", std::string(kToken));
+    config.set("discovery.udp_port",
+               static_cast<int>(test::get_available_port()));
+    config.set("network.tls.enabled", true);
+    config.set("network.tls.certificate_file",
+               cert_.certificate_file.string());
+    config.set("network.tls.private_key_file",
+               cert_.private_key_file.string());
+
+    server_ = std::make_unique<Server>();
+    server_->start(port_, 1);
+  }
+
+  void TearDown() override {
+    if (server_) {
+      server_->stop();
+      server_.reset();
+    }
+    common::ConfigManager::getInstance().set("network.tls.enabled", false);
+    std::filesystem::remove_all(cert_dir_);
+  }
+
+  [[nodiscard]] auto secureAddress() const -> std::string {
+    return "wss://127.0.0.1:" + std::to_string(port_);
+  }
+
+  static void expectConnected(std::future<void>& future) {
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(5)),
+              std::future_status::ready);
+    EXPECT_NO_THROW(future.get());
+  }
+
+  std::filesystem::path cert_dir_;
+  test::TestCertificate cert_;
+  uint16_t port_ = 0;
+  std::unique_ptr<Server> server_;
+};
+
+TEST_F(ClientTlsTest, ConnectsOverTls) {
+  Client client;
+  client.setTlsOptions({cert_.certificate_file.string(), true});
+
+  auto future = client.connect(secureAddress(), "tls_player", kToken);
+  expectConnected(future);
+  EXPECT_TRUE(client.isConnected());
+  EXPECT_FALSE(client.isTlsSessionResumed());
+  EXPECT_EQ(server_->getTlsHandshakes(), 1);
+
+  client.disconnect();
+}
+
+TEST_F(ClientTlsTest, ReconnectResumesSession) {
+  Client client;
+  client.setTlsOptions({cert_.certificate_file.string(), true});
+
+  auto first = client.connect(secureAddress(), "tls_player", kToken);
+  expectConnected(first);
+  // TLS 1.3 的会话票据在握手之后到达，等它被保存下来
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  client.disconnect();
+
+  auto second = client.connect(secureAddress(), "tls_player", kToken);
+  expectConnected(second);
+  EXPECT_TRUE(client.isTlsSessionResumed());
+  EXPECT_EQ(server_->getTlsHandshakes(), 2);
+  EXPECT_EQ(server_->getTlsResumedHandshakes(), 1);
+
+  client.disconnect();
+}
+
+TEST_F(ClientTlsTest, RejectsUntrustedCertificate) {
+  Client client;  // 默认信任系统 CA，不信任自签名证书
+
+  auto future = client.connect(secureAddress(), "tls_player", kToken);
+  ASSERT_EQ(future.wait_for(std::chrono::seconds(5)),
+            std::future_status::ready);
+  EXPECT_THROW(future.get(), std::exception);
+  EXPECT_FALSE(client.isConnected());
+}
+
+TEST_F(ClientTlsTest, PlainClientCannotConnect) {
+  Client client;
+
+  auto future = client.connect("127.0.0.1:" + std::to_string(port_),
+                               "plain_player", kToken);
+  ASSERT_EQ(future.wait_for(std::chrono::seconds(5)),
+            std::future_status::ready);
+  EXPECT_THROW(future.get(), std::exception);
+  EXPECT_FALSE(client.isConnected());
+}
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "common/flight_recorder.hpp"
+#include "common/logging.hpp"
+
+using namespace picoradar::common;
+
+class FlightRecorderTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    temp_dir_ =
+        std::filesystem::temp_directory_path() / "picoradar_flight_recorder";
+    std::filesystem::create_directories(temp_dir_);
+    // 实例约占 1 MB，放在堆上
+    recorder_ = std::make_unique<FlightRecorder>();
+  }
+
+  void TearDown() override {
+    recorder_.reset();
+    std::filesystem::remove_all(temp_dir_);
+  }
+
+  auto dumpText(const char* reason = "test") const -> std::string {
+    const auto path = (temp_dir_ / "dump.txt").string();
+    recorder_->dumpToFile(path, reason);
+    return readFile(path);
+  }
+
+  static auto readFile(const std::filesystem::path& path) -> std::string {
+    std::ifstream file(path);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+  }
+
+  // 返回 [section] 到下一个空行之间的内容
+  static auto section(const std::string& text, const std::string& name)
+      -> std::string {
+    const auto begin = text.find("[" + name + "]\n");
+    if (begin == std::string::npos) {
+      return {};
+    }
+    const auto body = begin + name.size() + 3;
+    const auto end = text.find("\n\n", body);
+    return text.substr(body, end == std::string::npos ? std::string::npos
+                                                      : end + 1 - body);
+  }
+
+  std::filesystem::path temp_dir_;
+  std::unique_ptr<FlightRecorder> recorder_;
+};
+
+TEST_F(FlightRecorderTest, LogRingKeepsNewestEntries) {
+  const auto total = FlightRecorder::kLogCapacity + 10;
+  for (std::size_t i = 0; i < total; ++i) {
+    recorder_->recordLog("line " + std::to_string(i));
+  }
+  EXPECT_EQ(recorder_->getLogCount(), total);
+
+  const auto logs = section(dumpText(), "logs");
+  // 最早的 10 条已被覆盖，剩余按时间从旧到新输出
+  EXPECT_EQ(logs.find("line 9\n"), std::string::npos);
+  EXPECT_EQ(logs.find("line 10\n"), 0U);
+  EXPECT_NE(logs.find("line " + std::to_string(total - 1) + "\n"),
+            std::string::npos);
+}
+
+TEST_F(FlightRecorderTest, LongEntriesAreTruncated) {
+  recorder_->recordLog(std::string(FlightRecorder::kLogTextBytes * 2, 'x'));
+  recorder_->recordSpan(std::string(100, 's').c_str(),
+                        std::chrono::system_clock::now(),
+                        std::chrono::microseconds(5));
+
+  const auto text = dumpText();
+  EXPECT_NE(section(text, "logs").find(
+                std::string(FlightRecorder::kLogTextBytes - 1, 'x') + "\n"),
+            std::string::npos);
+  const auto spans = section(text, "spans");
+  EXPECT_NE(spans.find(",5,"), std::string::npos) << spans;
+  EXPECT_NE(
+      spans.find("," + std::string(FlightRecorder::kSpanNameBytes - 1, 's') +
+                 "\n"),
+      std::string::npos)
+      << spans;
+}
+
+TEST_F(FlightRecorderTest, DumpContainsSpansAndMetricSnapshots) {
+  double value = 1.5;
+  EXPECT_TRUE(recorder_->addMetric("players", [&value] { return value; }));
+  EXPECT_TRUE(recorder_->addMetric("load", [] { return -0.25; }));
+  recorder_->takeSnapshot();
+  value = 42.0;
+  recorder_->takeSnapshot();
+  {
+    FlightSpan span("encode", *recorder_);
+  }
+
+  const auto text = dumpText("manual");
+  EXPECT_NE(text.find("reason: manual\n"), std::string::npos);
+
+  const auto metrics = section(text, "metrics");
+  EXPECT_EQ(metrics.find("time_ms,players,load\n"), 0U) << metrics;
+  EXPECT_NE(metrics.find(",1.500,-0.250\n"), std::string::npos) << metrics;
+  EXPECT_NE(metrics.find(",42.000,-0.250\n"), std::string::npos) << metrics;
+  EXPECT_LT(metrics.find(",1.500,"), metrics.find(",42.000,"));
+
+  const auto spans = section(text, "spans");
+  EXPECT_EQ(spans.find("start_us,duration_us,thread,name\n"), 0U);
+  EXPECT_NE(spans.find(",encode\n"), std::string::npos) << spans;
+}
+
+TEST_F(FlightRecorderTest, RejectsMetricsBeyondCapacity) {
+  for (std::size_t i = 0; i < FlightRecorder::kMaxMetrics; ++i) {
+    EXPECT_TRUE(recorder_->addMetric("m" + std::to_string(i),
+                                     [] { return 0.0; }));
+  }
+  EXPECT_FALSE(recorder_->addMetric("overflow", [] { return 0.0; }));
+}
+
+TEST_F(FlightRecorderTest, SamplerTakesPeriodicSnapshots) {
+  std::atomic<int> reads{0};
+  recorder_->addMetric("reads", [&reads] { return ++reads; });
+  recorder_->start(std::chrono::milliseconds(10));
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  while (recorder_->getSnapshotCount() < 3 &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  recorder_->stop();
+  EXPECT_GE(recorder_->getSnapshotCount(), 3U);
+
+  // 停止后不再采样
+  const auto count = recorder_->getSnapshotCount();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(recorder_->getSnapshotCount(), count);
+}
+
+TEST_F(FlightRecorderTest, LogStreamRecordsFormattedEntries) {
+  logger::LogEntry entry{};
+  FlightRecorderLogStream stream(*recorder_);
+  EXPECT_EQ(stream.getType(), logger::LogOutputType::FLIGHT_RECORDER);
+  stream.write(entry, "[INFO] server started");
+
+  EXPECT_EQ(recorder_->getLogCount(), 1U);
+  EXPECT_EQ(section(dumpText(), "logs"), "[INFO] server started\n");
+}
+
+#ifndef _WIN32
+TEST_F(FlightRecorderTest, CrashHandlerDumpsBeforeTermination) {
+  const auto path = temp_dir_ / "crash.txt";
+  EXPECT_DEATH(
+      {
+        auto& recorder = FlightRecorder::getInstance();
+        recorder.recordLog("last words");
+        if (FlightRecorder::installCrashHandler(path.string())) {
+          std::raise(SIGSEGV);
+        }
+      },
+      "");
+
+  const auto text = readFile(path);
+  EXPECT_NE(text.find("reason: SIGSEGV\n"), std::string::npos) << text;
+  EXPECT_NE(section(text, "logs").find("last words\n"), std::string::npos);
+}
+#endif
@@ -340,3 +340,122 @@ TEST_F(LoggingTest, MemoryLogStream) {
   entries = memory_ptr->getEntries();
   EXPECT_TRUE(entries.empty());
 }
+
+/**
+ * @brief 测试同一调用点的日志风暴抑制
+ */
+TEST_F(LoggingTest, CallSiteStormSuppression) {
+  test_config_.file_enabled = false;
+  test_config_.format_pattern = "{message}";
+  test_config_.dedup_enabled = true;
+  test_config_.dedup_window_ms = 60000;
+  test_config_.dedup_burst = 3;
+  logger::Logger::Init("test_dedup", test_config_);
+
+  auto memory_stream = std::make_unique<logger::MemoryLogStream>(100);
+  auto* memory_ptr = memory_stream.get();
+  logger::Logger::addOutputStream(std::move(memory_stream));
+
+  for (int i = 0; i < 10; ++i) {
+    LOG_WARNING << "Storm " << i;
+  }
+  // 不同调用点互不影响
+  LOG_WARNING << "Other call site";
+
+  auto entries = memory_ptr->getEntries();
+  ASSERT_EQ(entries.size(), 4);
+  EXPECT_EQ(entries[0], "Storm 0");
+  EXPECT_EQ(entries[2], "Storm 2");
+  EXPECT_EQ(entries[3], "Other call site");
+
+  // flush 时输出被抑制数量的汇总
+  logger::Logger::flush();
+  entries = memory_ptr->getEntries();
+  ASSERT_EQ(entries.size(), 5);
+  EXPECT_EQ(entries[4], "suppressed 7 similar messages");
+
+  logger::Logger::flush();
+  EXPECT_EQ(memory_ptr->getEntries().size(), 5);
+}
+
+/**
+ * @brief 测试抑制窗口滚动后恢复输出并汇报上一窗口
+ */
+TEST_F(LoggingTest, CallSiteSuppressionWindowRollover) {
+  test_config_.file_enabled = false;
+  test_config_.format_pattern = "{message}";
+  test_config_.dedup_enabled = true;
+  test_config_.dedup_window_ms = 50;
+  test_config_.dedup_burst = 1;
+  logger::Logger::Init("test_dedup_window", test_config_);
+
+  auto memory_stream = std::make_unique<logger::MemoryLogStream>(100);
+  auto* memory_ptr = memory_stream.get();
+  logger::Logger::addOutputStream(std::move(memory_stream));
+
+  const auto logBurst = [](int count) {
+    for (int i = 0; i < count; ++i) {
+      LOG_ERROR << "Repeated failure";
+    }
+  };
+
+  logBurst(5);
+  EXPECT_EQ(memory_ptr->getEntries().size(), 1);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(80));
+  logBurst(1);
+
+  const auto entries = memory_ptr->getEntries();
+  ASSERT_EQ(entries.size(), 3);
+  EXPECT_EQ(entries[1], "suppressed 4 similar messages");
+  EXPECT_EQ(entries[2], "Repeated failure");
+}
+
+/**
+ * @brief 风暴结束后不再有新日志，汇总也会由后台线程按窗口输出
+ */
+TEST_F(LoggingTest, CallSiteSuppressionFlushedByTimer) {
+  test_config_.file_enabled = false;
+  test_config_.format_pattern = "{message}";
+  test_config_.dedup_enabled = true;
+  test_config_.dedup_window_ms = 50;
+  test_config_.dedup_burst = 1;
+  logger::Logger::Init("test_dedup_timer", test_config_);
+
+  auto memory_stream = std::make_unique<logger::MemoryLogStream>(100);
+  auto* memory_ptr = memory_stream.get();
+  logger::Logger::addOutputStream(std::move(memory_stream));
+
+  for (int i = 0; i < 5; ++i) {
+    LOG_ERROR << "Repeated failure";
+  }
+  EXPECT_EQ(memory_ptr->getEntries().size(), 1);
+
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  while (memory_ptr->getEntries().size() < 2 &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  const auto entries = memory_ptr->getEntries();
+  ASSERT_EQ(entries.size(), 2);
+  EXPECT_EQ(entries[1], "suppressed 4 similar messages");
+}
+
+/**
+ * @brief 默认配置下不做任何抑制
+ */
+TEST_F(LoggingTest, CallSiteSuppressionDisabledByDefault) {
+  test_config_.file_enabled = false;
+  logger::Logger::Init("test_no_dedup", test_config_);
+
+  auto memory_stream = std::make_unique<logger::MemoryLogStream>(100);
+  auto* memory_ptr = memory_stream.get();
+  logger::Logger::addOutputStream(std::move(memory_stream));
+
+  for (int i = 0; i < 20; ++i) {
+    LOG_INFO << "Message " << i;
+  }
+  EXPECT_EQ(memory_ptr->getEntries().size(), 20);
+}
@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+
+#include "core/encoding_selector.hpp"
+
+using picoradar::core::EncodingSelector;
+using picoradar::core::EncodingSelectorConfig;
+using picoradar::core::EncodingTier;
+using namespace std::chrono_literals;
+
+namespace {
+
+auto makeConfig() -> EncodingSelectorConfig {
+  EncodingSelectorConfig config;
+  config.enabled = true;
+  config.latency_budget = 50ms;
+  config.recover_ratio = 0.5;
+  config.degrade_samples = 2;
+  config.recover_samples = 4;
+  config.stall_threshold = 100ms;
+  return config;
+}
+
+auto makeSelector() -> EncodingSelector {
+  return EncodingSelector(makeConfig(),
+                          EncodingSelector::makeLadder(false, true));
+}
+
+}  // namespace
+
+// 测试用例: 以完整帧为基线时先降为增量帧，支持紧凑编码时再降为紧凑帧
+TEST(EncodingSelectorTest, LaddersFollowBaselineAndClientSupport) {
+  EXPECT_EQ(EncodingSelector::makeLadder(false, false),
+            (std::vector<EncodingTier>{EncodingTier::Full,
+                                       EncodingTier::Delta}));
+  EXPECT_EQ(EncodingSelector::makeLadder(false, true),
+            (std::vector<EncodingTier>{EncodingTier::Full,
+                                       EncodingTier::Delta,
+                                       EncodingTier::Compact,
+                                       EncodingTier::Coarse}));
+  // 紧凑基线下部分帧反而更大，不在阶梯中
+  EXPECT_EQ(EncodingSelector::makeLadder(true, true),
+            (std::vector<EncodingTier>{EncodingTier::Compact,
+                                       EncodingTier::Coarse}));
+}
+
+// 测试用例: 连续超出预算时逐级降级，阶梯用尽后保持最后一级
+TEST(EncodingSelectorTest, DegradesAfterConsecutiveSlowFrames) {
+  auto selector = makeSelector();
+  EXPECT_EQ(selector.getTier(), EncodingTier::Full);
+
+  EXPECT_EQ(selector.onDelivered(80ms, 1ms, 0), EncodingTier::Full);
+  EXPECT_EQ(selector.onDelivered(80ms, 1ms, 0), EncodingTier::Delta);
+  EXPECT_EQ(selector.onDelivered(80ms, 1ms, 0), EncodingTier::Delta);
+  EXPECT_EQ(selector.onDelivered(80ms, 1ms, 0), EncodingTier::Compact);
+  for (int i = 0; i < 10; ++i) {
+    selector.onDelivered(80ms, 1ms, 0);
+  }
+  EXPECT_EQ(selector.getTier(), EncodingTier::Coarse);
+}
+
+// 测试用例: 往返时延的一半计入帧延迟
+TEST(EncodingSelectorTest, RoundTripTimeCountsTowardsLatency) {
+  auto selector = makeSelector();
+  selector.onRtt(80ms);
+  EXPECT_EQ(selector.getEstimate().rtt, 80ms);
+
+  // 10ms 的排队加上 40ms 的单程时延，刚好不超出预算
+  selector.onDelivered(10ms, 1ms, 0);
+  selector.onDelivered(10ms, 1ms, 0);
+  EXPECT_EQ(selector.getTier(), EncodingTier::Full);
+
+  selector.onDelivered(20ms, 1ms, 0);
+  selector.onDelivered(20ms, 1ms, 0);
+  EXPECT_EQ(selector.getTier(), EncodingTier::Delta);
+  EXPECT_GT(selector.getEstimate().latency, 40ms);
+}
+
+// 测试用例: 写停顿即使没有排队也计为超出预算
+TEST(EncodingSelectorTest, WriteStallsCountAsOverload) {
+  auto selector = makeSelector();
+  selector.onDelivered(1ms, 150ms, 0);
+  selector.onDelivered(1ms, 150ms, 0);
+  EXPECT_EQ(selector.getTier(), EncodingTier::Delta);
+  EXPECT_EQ(selector.getEstimate().stalls, 2);
+}
+
+// 测试用例: 升级需要更多的连续有余量采样，介于两个阈值之间的采样清除累计
+TEST(EncodingSelectorTest, RecoversSlowlyWithHysteresis) {
+  auto selector = makeSelector();
+  selector.onDelivered(80ms, 1ms, 0);
+  selector.onDelivered(80ms, 1ms, 0);
+  ASSERT_EQ(selector.getTier(), EncodingTier::Delta);
+
+  for (int i = 0; i < 10; ++i) {
+    selector.onDelivered(5ms, 1ms, 0);
+    selector.onDelivered(5ms, 1ms, 0);
+    selector.onDelivered(5ms, 1ms, 0);
+    selector.onDelivered(40ms, 1ms, 0);  // 低于预算但没有余量
+  }
+  EXPECT_EQ(selector.getTier(), EncodingTier::Delta);
+
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(selector.onDelivered(5ms, 1ms, 0), EncodingTier::Delta);
+  }
+  EXPECT_EQ(selector.onDelivered(5ms, 1ms, 0), EncodingTier::Full);
+}
+
+// 测试用例: 按吞吐量估算上一级的帧放不进余量时不升级
+TEST(EncodingSelectorTest, HoldsWhenRicherFrameWouldNotFit) {
+  auto selector = makeSelector();
+  selector.onFrameSize(EncodingTier::Full, 10000);
+  selector.onDelivered(80ms, 1ms, 0);
+  selector.onDelivered(80ms, 1ms, 0);
+  ASSERT_EQ(selector.getTier(), EncodingTier::Delta);
+
+  // 100 KB/s 下 10 KB 的完整帧需要 100ms，超出 25ms 的余量
+  for (int i = 0; i < 20; ++i) {
+    selector.onDelivered(5ms, 1ms, 100000);
+  }
+  EXPECT_EQ(selector.getTier(), EncodingTier::Delta);
+
+  // 1 MB/s 下只需 10ms
+  for (int i = 0; i < 4; ++i) {
+    selector.onDelivered(5ms, 1ms, 1000000);
+  }
+  EXPECT_EQ(selector.getTier(), EncodingTier::Full);
+}
+
+// 测试用例: 升级后很快又降回来时，下次升级所需的采样数加倍
+TEST(EncodingSelectorTest, FailedUpgradeBacksOff) {
+  auto selector = makeSelector();
+  selector.onDelivered(80ms, 1ms, 0);
+  selector.onDelivered(80ms, 1ms, 0);
+  ASSERT_EQ(selector.getTier(), EncodingTier::Delta);
+
+  for (int i = 0; i < 4; ++i) {
+    selector.onDelivered(5ms, 1ms, 0);
+  }
+  ASSERT_EQ(selector.getTier(), EncodingTier::Full);
+  selector.onDelivered(80ms, 1ms, 0);
+  selector.onDelivered(80ms, 1ms, 0);
+  ASSERT_EQ(selector.getTier(), EncodingTier::Delta);
+  EXPECT_EQ(selector.getRecoverBackoff(), 2);
+
+  for (int i = 0; i < 7; ++i) {
+    EXPECT_EQ(selector.onDelivered(5ms, 1ms, 0), EncodingTier::Delta);
+  }
+  EXPECT_EQ(selector.onDelivered(5ms, 1ms, 0), EncodingTier::Full);
+
+  // 升级站稳后退避复位
+  for (int i = 0; i < 4; ++i) {
+    selector.onDelivered(5ms, 1ms, 0);
+  }
+  EXPECT_EQ(selector.getTier(), EncodingTier::Full);
+  EXPECT_EQ(selector.getRecoverBackoff(), 1);
+}
+
+// 测试用例: 单级阶梯永远不会切换
+TEST(EncodingSelectorTest, SingleTierLadderNeverSwitches) {
+  EncodingSelector selector(makeConfig(), {EncodingTier::Compact});
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(selector.onDelivered(500ms, 500ms, 0), EncodingTier::Compact);
+  }
+  EXPECT_EQ(selector.getLevel(), 0);
+}
@@ -0,0 +1,254 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <limits>
+#include <set>
+#include <string>
+
+#include "core/bandwidth_budget.hpp"
+#include "core/frame_packer.hpp"
+#include "utils/player_utils.hpp"
+
+using namespace picoradar::core;
+using picoradar::test::makePlayer;
+using namespace std::chrono_literals;
+
+namespace {
+
+void addPlayer(FramePacker::PlayerMap& players, const std::string& id, float x,
+               float y = 0.0F, float z = 0.0F) {
+  players[id] = makePlayer(id, "scene", x, y, z);
+}
+
+auto contains(const FramePacker::PackResult& result, const std::string& id)
+    -> bool {
+  for (const auto* player : result.selected) {
+    if (player->player_id() == id) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+// ============================== BandwidthBudget ==============================
+
+TEST(BandwidthBudgetTest, UnlimitedByDefault) {
+  BandwidthBudget budget;
+  EXPECT_FALSE(budget.isLimited());
+  EXPECT_EQ(budget.getRate(), 0);
+  EXPECT_EQ(budget.available(BandwidthBudget::Clock::now()),
+            std::numeric_limits<std::size_t>::max());
+}
+
+TEST(BandwidthBudgetTest, ConfiguredRateRefillsOverTime) {
+  BandwidthBudget budget(10000);  // 10KB/s，突发窗口 100ms = 1000 字节
+  const auto start = BandwidthBudget::Clock::now();
+
+  EXPECT_TRUE(budget.isLimited());
+  EXPECT_EQ(budget.available(start), 1000);
+
+  budget.consume(1000);
+  EXPECT_EQ(budget.available(start), 0);
+
+  // 50ms 后补充 500 字节
+  EXPECT_EQ(budget.available(start + 50ms), 500);
+
+  // 令牌不会超过突发容量
+  EXPECT_EQ(budget.available(start + 10s), 1000);
+}
+
+TEST(BandwidthBudgetTest, EstimatesRateFromBackloggedWrites) {
+  BandwidthBudget budget;
+
+  // 队列空闲时的写完成不提供链路容量信息
+  budget.onWriteCompleted(1000, 1ms, false);
+  EXPECT_FALSE(budget.isLimited());
+
+  // 积压时 1000 字节耗时 100ms => 约 10KB/s
+  budget.onWriteCompleted(1000, 100ms, true);
+  EXPECT_TRUE(budget.isLimited());
+  EXPECT_NEAR(static_cast<double>(budget.getRate()), 10000.0, 1.0);
+}
+
+TEST(BandwidthBudgetTest, EstimateProbesUpwardsAndReleases) {
+  BandwidthBudget budget;
+  budget.onWriteCompleted(1000, 100ms, true);
+  const auto initial = budget.getRate();
+
+  budget.onWriteCompleted(1000, 1ms, false);
+  EXPECT_GT(budget.getRate(), initial);
+
+  // 链路足够快时估算值超过上限，回到不受限状态
+  budget.onWriteCompleted(64 * 1024 * 1024, 1ms, true);
+  for (int i = 0; i < 50 && budget.isLimited(); ++i) {
+    budget.onWriteCompleted(1000, 1ms, false);
+  }
+  EXPECT_FALSE(budget.isLimited());
+}
+
+TEST(BandwidthBudgetTest, ConfiguredRateIgnoresEstimation) {
+  BandwidthBudget budget(5000);
+  budget.onWriteCompleted(1000, 1s, true);
+  EXPECT_EQ(budget.getRate(), 5000);
+}
+
+// ================================ FramePacker ================================
+
+TEST(FramePackerTest, EverythingFitsWithUnlimitedBudget) {
+  FramePacker packer;
+  FramePacker::PlayerMap players;
+  for (int i = 0; i < 10; ++i) {
+    addPlayer(players, "p" + std::to_string(i), static_cast<float>(i));
+  }
+
+  auto result = packer.pack("p0", players,
+                            std::numeric_limits<std::size_t>::max(),
+                            FramePacker::Clock::now());
+  EXPECT_EQ(result.selected.size(), players.size());
+  EXPECT_EQ(result.deferred, 0);
+  EXPECT_TRUE(result.removed.empty());
+}
+
+TEST(FramePackerTest, RespectsBudget) {
+  FramePacker packer;
+  FramePacker::PlayerMap players;
+  for (int i = 0; i < 20; ++i) {
+    addPlayer(players, "p" + std::to_string(i), static_cast<float>(i));
+  }
+  const auto record = FramePacker::encodedRecordSize(players.at("p1"));
+
+  auto result = packer.pack("p0", players, record * 5,
+                            FramePacker::Clock::now());
+  EXPECT_LE(result.bytes, record * 5);
+  EXPECT_GE(result.selected.size(), 4);
+  EXPECT_EQ(result.selected.size() + result.deferred, players.size());
+}
+
+TEST(FramePackerTest, PrefersNearbyPlayers) {
+  FramePacker packer;
+  FramePacker::PlayerMap players;
+  addPlayer(players, "viewer", 0.0F);
+  addPlayer(players, "near", 1.0F);
+  addPlayer(players, "far", 100.0F);
+
+  const auto start = FramePacker::Clock::now();
+  packer.markAllSent(players, start);
+
+  // 预算只够两条记录：观察者自身距离为 0，其次是附近的玩家
+  const auto budget = FramePacker::encodedRecordSize(players.at("viewer")) +
+                      FramePacker::encodedRecordSize(players.at("near"));
+  auto result = packer.pack("viewer", players, budget, start + 10ms);
+  ASSERT_EQ(result.selected.size(), 2);
+  EXPECT_TRUE(contains(result, "viewer"));
+  EXPECT_TRUE(contains(result, "near"));
+  EXPECT_FALSE(contains(result, "far"));
+}
+
+TEST(FramePackerTest, PrefersFastMovingPlayers) {
+  FramePacker packer;
+  FramePacker::PlayerMap players;
+  addPlayer(players, "viewer", 0.0F);
+  addPlayer(players, "still", 5.0F);
+  addPlayer(players, "runner", 0.0F, 0.0F, 5.0F);
+
+  const auto start = FramePacker::Clock::now();
+  packer.markAllSent(players, start);
+
+  // runner 在 100ms 内移动了 1 米
+  addPlayer(players, "runner", 0.0F, 0.0F, 6.0F);
+
+  const auto record = FramePacker::encodedRecordSize(players.at("runner"));
+  auto result = packer.pack("viewer", players, record + 1, start + 100ms);
+  ASSERT_EQ(result.selected.size(), 1);
+  EXPECT_TRUE(contains(result, "runner"));
+}
+
+TEST(FramePackerTest, NewPlayersAreSentFirst) {
+  FramePacker packer;
+  FramePacker::PlayerMap players;
+  addPlayer(players, "viewer", 0.0F);
+  addPlayer(players, "old", 1.0F);
+
+  const auto start = FramePacker::Clock::now();
+  packer.markAllSent(players, start);
+
+  addPlayer(players, "newcomer", 50.0F);
+  const auto record = FramePacker::encodedRecordSize(players.at("newcomer"));
+  auto result = packer.pack("viewer", players, record + 1, start + 10ms);
+  ASSERT_EQ(result.selected.size(), 1);
+  EXPECT_TRUE(contains(result, "newcomer"));
+}
+
+TEST(FramePackerTest, DeferredPlayersAreEventuallySent) {
+  FramePacker packer;
+  FramePacker::PlayerMap players;
+  for (int i = 0; i < 10; ++i) {
+    addPlayer(players, "p" + std::to_string(i), static_cast<float>(i * 10));
+  }
+
+  auto now = FramePacker::Clock::now();
+  packer.markAllSent(players, now);
+
+  const auto record = FramePacker::encodedRecordSize(players.at("p1"));
+  std::set<std::string> seen;
+  for (int tick = 0; tick < 20; ++tick) {
+    now += 50ms;
+    auto result = packer.pack("p0", players, record * 2, now);
+    for (const auto* player : result.selected) {
+      seen.insert(player->player_id());
+    }
+  }
+  EXPECT_EQ(seen.size(), players.size());
+}
+
+TEST(FramePackerTest, ReportsRemovedPlayers) {
+  FramePacker packer;
+  FramePacker::PlayerMap players;
+  addPlayer(players, "a", 0.0F);
+  addPlayer(players, "b", 1.0F);
+
+  const auto start = FramePacker::Clock::now();
+  packer.markAllSent(players, start);
+  EXPECT_TRUE(packer.hasState());
+
+  players.erase("b");
+  auto result = packer.pack("a", players, 1024, start + 10ms);
+  ASSERT_EQ(result.removed.size(), 1);
+  EXPECT_EQ(result.removed.front(), "b");
+
+  // 已通知的移除不会重复上报
+  result = packer.pack("a", players, 1024, start + 20ms);
+  EXPECT_TRUE(result.removed.empty());
+}
+
+TEST(FramePackerTest, ChangedOnlySkipsPlayersWithoutNewData) {
+  FramePacker packer;
+  FramePacker::PlayerMap players;
+  addPlayer(players, "a", 0.0F);
+  addPlayer(players, "b", 1.0F);
+  addPlayer(players, "c", 2.0F);
+  players["a"].set_timestamp(100);
+  players["b"].set_timestamp(100);
+
+  const auto start = FramePacker::Clock::now();
+  packer.markAllSent(players, start);
+
+  players["b"].set_timestamp(200);
+  // 未设置时间戳的客户端按位置判断
+  players["c"].mutable_position()->set_x(2.5F);
+  addPlayer(players, "d", 3.0F);
+  const auto limit = std::numeric_limits<std::size_t>::max();
+  auto result = packer.pack("a", players, limit, start + 10ms, true);
+  EXPECT_EQ(result.selected.size(), 3);
+  EXPECT_FALSE(contains(result, "a"));
+  EXPECT_TRUE(contains(result, "b"));
+  EXPECT_TRUE(contains(result, "c"));
+  EXPECT_TRUE(contains(result, "d"));
+  EXPECT_EQ(result.deferred, 0);
+
+  // 发送之后再次打包没有新内容
+  result = packer.pack("a", players, limit, start + 20ms, true);
+  EXPECT_TRUE(result.selected.empty());
+}
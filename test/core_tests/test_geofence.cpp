@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <nlohmann/json.hpp>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include "core/geofence.hpp"
+
+using namespace picoradar::core;
+
+namespace {
+
+// 一个 L 形（非凸）多边形：10x10 的正方形去掉右上角 5x5
+auto makeLShape(std::size_t slab_count = 0) -> Geofence {
+  return Geofence::polygon("l_shape", GeofenceMode::PlayArea,
+                           {{0.0F, 0.0F},
+                            {10.0F, 0.0F},
+                            {10.0F, 5.0F},
+                            {5.0F, 5.0F},
+                            {5.0F, 10.0F},
+                            {0.0F, 10.0F}},
+                           slab_count);
+}
+
+void addPlayer(GeofenceEngine::PlayerMap& players, const std::string& id,
+               float x, float z, const std::string& scene = "arena") {
+  auto& player = players[id];
+  player.set_player_id(id);
+  player.set_scene_id(scene);
+  player.mutable_position()->set_x(x);
+  player.mutable_position()->set_z(z);
+}
+
+}  // namespace
+
+TEST(GeofenceTest, BoxContainment) {
+  const auto fence = Geofence::box("box", GeofenceMode::PlayArea,
+                                   {5.0F, 5.0F}, {-5.0F, -5.0F});
+  EXPECT_TRUE(fence.contains(0.0F, 0.0F));
+  EXPECT_TRUE(fence.contains(5.0F, -5.0F));
+  EXPECT_FALSE(fence.contains(5.1F, 0.0F));
+  EXPECT_FALSE(fence.contains(NAN, 0.0F));
+}
+
+TEST(GeofenceTest, NonConvexPolygonContainment) {
+  const auto fence = makeLShape();
+  EXPECT_TRUE(fence.contains(2.0F, 2.0F));
+  EXPECT_TRUE(fence.contains(8.0F, 2.0F));
+  EXPECT_TRUE(fence.contains(2.0F, 8.0F));
+  EXPECT_FALSE(fence.contains(8.0F, 8.0F));  // 缺口处
+  EXPECT_FALSE(fence.contains(-1.0F, 2.0F));
+  EXPECT_FALSE(fence.contains(2.0F, NAN));
+}
+
+TEST(GeofenceTest, IndexedMatchesUnindexed) {
+  // 多顶点的星形多边形，比较不同条带数下的结果
+  std::vector<PlanarPoint> star;
+  for (int i = 0; i < 200; ++i) {
+    const float angle = 2.0F * 3.14159265F * static_cast<float>(i) / 200.0F;
+    const float r = (i % 2 == 0) ? 10.0F : 6.0F;
+    star.push_back({r * std::cos(angle), r * std::sin(angle)});
+  }
+  const auto indexed = Geofence::polygon("star", GeofenceMode::PlayArea, star);
+  const auto unindexed =
+      Geofence::polygon("star", GeofenceMode::PlayArea, star, 1);
+
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<float> coord(-12.0F, 12.0F);
+  for (int i = 0; i < 5000; ++i) {
+    const float x = coord(rng);
+    const float z = coord(rng);
+    ASSERT_EQ(indexed.contains(x, z), unindexed.contains(x, z))
+        << "x=" << x << " z=" << z;
+  }
+}
+
+TEST(GeofenceTest, RejectsDegeneratePolygon) {
+  EXPECT_THROW(Geofence::polygon("bad", GeofenceMode::PlayArea,
+                                 {{0.0F, 0.0F}, {1.0F, 1.0F}}),
+               std::invalid_argument);
+  EXPECT_THROW(Geofence::polygon("bad", GeofenceMode::PlayArea,
+                                 {{0.0F, 0.0F}, {1.0F, NAN}, {1.0F, 0.0F}}),
+               std::invalid_argument);
+}
+
+TEST(GeofenceEngineTest, ReportsViolationTransitionsOnly) {
+  GeofenceEngine engine;
+  engine.addFence("arena", makeLShape());
+
+  GeofenceEngine::PlayerMap players;
+  addPlayer(players, "p", 2.0F, 2.0F);
+  EXPECT_TRUE(engine.evaluate(players).empty());
+
+  addPlayer(players, "p", 8.0F, 8.0F);
+  auto events = engine.evaluate(players);
+  ASSERT_EQ(events.size(), 1);
+  EXPECT_TRUE(events.front().violated);
+  EXPECT_EQ(events.front().fence_id, "l_shape");
+  EXPECT_EQ(events.front().scene_id, "arena");
+  EXPECT_FLOAT_EQ(events.front().position.x(), 8.0F);
+
+  // 持续越界不重复上报
+  EXPECT_TRUE(engine.evaluate(players).empty());
+  EXPECT_EQ(engine.getViolationCount(), 1);
+
+  addPlayer(players, "p", 2.0F, 8.0F);
+  events = engine.evaluate(players);
+  ASSERT_EQ(events.size(), 1);
+  EXPECT_FALSE(events.front().violated);
+  EXPECT_EQ(engine.getViolationCount(), 0);
+}
+
+TEST(GeofenceEngineTest, KeepOutZonesAndScenes) {
+  GeofenceEngine engine;
+  engine.addFence("arena", Geofence::box("area", GeofenceMode::PlayArea,
+                                         {-10.0F, -10.0F}, {10.0F, 10.0F}));
+  engine.addFence("arena", Geofence::box("pillar", GeofenceMode::KeepOut,
+                                         {-1.0F, -1.0F}, {1.0F, 1.0F}));
+
+  const auto* fence = engine.check("arena", 0.0F, 0.0F);
+  ASSERT_NE(fence, nullptr);
+  EXPECT_EQ(fence->getId(), "pillar");
+  EXPECT_EQ(engine.check("arena", 5.0F, 5.0F), nullptr);
+  EXPECT_EQ(engine.check("arena", 50.0F, 5.0F)->getId(), "area");
+
+  // 没有围栏的场景不受约束
+  EXPECT_EQ(engine.check("lobby", 50.0F, 5.0F), nullptr);
+}
+
+TEST(GeofenceEngineTest, ForgetsDepartedPlayers) {
+  GeofenceEngine engine;
+  engine.addFence("arena", makeLShape());
+
+  GeofenceEngine::PlayerMap players;
+  addPlayer(players, "p", 8.0F, 8.0F);
+  ASSERT_EQ(engine.evaluate(players).size(), 1);
+
+  players.clear();
+  EXPECT_TRUE(engine.evaluate(players).empty());
+  EXPECT_EQ(engine.getViolationCount(), 0);
+}
+
+TEST(GeofenceEngineTest, LoadsFromJson) {
+  const auto config = nlohmann::json::parse(R"({
+    "arena": [
+      {"id": "bounds", "mode": "play_area",
+       "box": {"min": [-10, -10], "max": [10, 10]}},
+      {"id": "stage", "mode": "keep_out",
+       "polygon": [[0, 0], [2, 0], [1, 2]]}
+    ]
+  })");
+  const auto engine = GeofenceEngine::fromJson(config);
+  EXPECT_EQ(engine.getFenceCount(), 2);
+  EXPECT_EQ(engine.check("arena", 1.0F, 0.5F)->getId(), "stage");
+  EXPECT_EQ(engine.check("arena", 20.0F, 0.0F)->getId(), "bounds");
+
+  EXPECT_TRUE(GeofenceEngine::fromJson(nlohmann::json::object()).empty());
+  EXPECT_THROW(GeofenceEngine::fromJson(nlohmann::json::parse(
+                   R"({"arena": [{"id": "x", "mode": "sideways",
+                                  "box": {"min": [0, 0], "max": [1, 1]}}]})")),
+               std::invalid_argument);
+  EXPECT_THROW(GeofenceEngine::fromJson(
+                   nlohmann::json::parse(R"({"arena": [{"id": "x"}]})")),
+               std::invalid_argument);
+}
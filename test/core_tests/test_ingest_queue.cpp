@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "core/ingest_queue.hpp"
+
+using picoradar::core::IngestQueue;
+using picoradar::core::SpscRing;
+
+// 测试用例: 容量取整为 2 的幂，满时拒绝写入并保持 FIFO 顺序
+TEST(SpscRingTest, BoundedFifo) {
+  SpscRing<int> ring(3);
+  EXPECT_EQ(ring.capacity(), 4);
+
+  for (int i = 0; i < 4; ++i) {
+    int value = i;
+    EXPECT_TRUE(ring.tryPush(value));
+  }
+  int overflow = 99;
+  EXPECT_FALSE(ring.tryPush(overflow));
+  EXPECT_EQ(overflow, 99);
+
+  int value = -1;
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(ring.tryPop(value));
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_FALSE(ring.tryPop(value));
+}
+
+// 测试用例: 绑定的生产者线程与未绑定线程并发写入，消费者取到全部记录，
+// 且每个生产者的记录保持各自的顺序
+TEST(IngestQueueTest, ProducersKeepTheirOwnOrder) {
+  constexpr std::size_t kProducers = 3;
+  constexpr std::uint32_t kPerProducer = 20000;
+  IngestQueue<std::uint64_t> queue(kProducers, 256);
+
+  std::vector<std::uint32_t> next(kProducers + 1, 0);
+  std::size_t received = 0;
+  const auto consume = [&](std::uint64_t value) {
+    const auto producer = static_cast<std::size_t>(value >> 32);
+    const auto sequence = static_cast<std::uint32_t>(value);
+    EXPECT_EQ(sequence, next[producer]);
+    next[producer] = sequence + 1;
+    ++received;
+  };
+
+  std::vector<std::thread> producers;
+  for (std::size_t p = 0; p <= kProducers; ++p) {
+    producers.emplace_back([&queue, p] {
+      if (p < kProducers) {
+        queue.bindCurrentThread(p);  // 最后一个线程使用共享队列
+      }
+      for (std::uint32_t i = 0; i < kPerProducer; ++i) {
+        auto value = (static_cast<std::uint64_t>(p) << 32) | i;
+        while (!queue.tryPush(value)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  const std::size_t total = (kProducers + 1) * kPerProducer;
+  while (received < total) {
+    if (queue.drain(consume) == 0) {
+      std::this_thread::yield();
+    }
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  EXPECT_EQ(queue.drain(consume), 0);
+  EXPECT_EQ(received, total);
+}
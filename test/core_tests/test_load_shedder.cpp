@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include "core/load_shedder.hpp"
+
+using picoradar::core::LoadShedder;
+using picoradar::core::LoadShedderConfig;
+using picoradar::core::ShedStep;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr auto kPlayer = picoradar::SESSION_CLASS_PLAYER;
+constexpr auto kSpectator = picoradar::SESSION_CLASS_SPECTATOR;
+constexpr auto kOperator = picoradar::SESSION_CLASS_OPERATOR;
+
+auto makeConfig() -> LoadShedderConfig {
+  LoadShedderConfig config;
+  config.shed_lag = 20ms;
+  config.recover_lag = 5ms;
+  config.shed_samples = 2;
+  config.recover_samples = 3;
+  return config;
+}
+
+}  // namespace
+
+// 测试用例: 默认阶梯先处理旁观屏幕，再处理运营端，不包含玩家
+TEST(LoadShedderTest, DefaultLadderNeverDegradesPlayers) {
+  const LoadShedder shedder;
+  const auto& steps = shedder.getSteps();
+
+  ASSERT_EQ(steps.size(), 3);
+  EXPECT_EQ(steps[0].session_class, kSpectator);
+  EXPECT_EQ(steps[0].action, ShedStep::Action::ReduceRate);
+  EXPECT_EQ(steps[1].session_class, kSpectator);
+  EXPECT_EQ(steps[1].action, ShedStep::Action::Drop);
+  EXPECT_EQ(steps[2].session_class, kOperator);
+  EXPECT_EQ(steps[2].action, ShedStep::Action::ReduceRate);
+
+  const auto delivery = shedder.getDelivery(steps.size());
+  EXPECT_FALSE(delivery[kPlayer].dropped);
+  EXPECT_EQ(delivery[kPlayer].min_interval, 0us);
+  EXPECT_EQ(delivery[kPlayer].queue_limit, 0);
+}
+
+// 测试用例: 每一级在上一级的基础上多执行一步
+TEST(LoadShedderTest, DeliveryAppliesStepsUpToLevel) {
+  const LoadShedder shedder;
+
+  auto delivery = shedder.getDelivery(0);
+  EXPECT_EQ(delivery[kSpectator].min_interval,
+            std::chrono::microseconds(1000000 / 30));
+  EXPECT_EQ(delivery[kSpectator].queue_limit, 4);
+  EXPECT_FALSE(delivery[kSpectator].dropped);
+  EXPECT_EQ(delivery[kOperator].min_interval, 100ms);
+
+  delivery = shedder.getDelivery(1);
+  EXPECT_EQ(delivery[kSpectator].min_interval, 200ms);
+  EXPECT_FALSE(delivery[kSpectator].dropped);
+  EXPECT_EQ(delivery[kOperator].min_interval, 100ms);
+
+  delivery = shedder.getDelivery(2);
+  EXPECT_TRUE(delivery[kSpectator].dropped);
+  EXPECT_EQ(delivery[kOperator].min_interval, 100ms);
+
+  delivery = shedder.getDelivery(3);
+  EXPECT_TRUE(delivery[kSpectator].dropped);
+  EXPECT_EQ(delivery[kOperator].min_interval, 500ms);
+  EXPECT_FALSE(delivery[kOperator].dropped);
+}
+
+// 测试用例: 玩家的降载步骤总是排在最后
+TEST(LoadShedderTest, PlayersAreShedLast) {
+  auto config = makeConfig();
+  config.classes[kPlayer].tick_hz = 90;
+  config.classes[kPlayer].shed_tick_hz = 45;
+  // 降载帧率不低于正常帧率时不算一步
+  config.classes[kOperator].shed_tick_hz = 10;
+  const LoadShedder shedder(config);
+  const auto& steps = shedder.getSteps();
+
+  ASSERT_EQ(steps.size(), 3);
+  EXPECT_EQ(steps[0].session_class, kSpectator);
+  EXPECT_EQ(steps[1].session_class, kSpectator);
+  EXPECT_EQ(steps[2].session_class, kPlayer);
+  EXPECT_EQ(shedder.getDelivery(2)[kPlayer].min_interval,
+            std::chrono::microseconds(1000000 / 90));
+  EXPECT_EQ(shedder.getDelivery(3)[kPlayer].min_interval,
+            std::chrono::microseconds(1000000 / 45));
+}
+
+// 测试用例: 连续过载时逐级加重，连续恢复时更慢地逐级减轻
+TEST(LoadShedderTest, EscalatesQuicklyAndRecoversSlowly) {
+  LoadShedder shedder(makeConfig());
+
+  EXPECT_EQ(shedder.update(30ms), 0);
+  EXPECT_EQ(shedder.update(30ms), 1);
+  EXPECT_EQ(shedder.update(30ms), 1);  // 调整后重新计数
+  EXPECT_EQ(shedder.update(30ms), 2);
+  EXPECT_EQ(shedder.update(30ms), 2);
+  EXPECT_EQ(shedder.update(30ms), 3);
+  EXPECT_EQ(shedder.update(30ms), 3);
+  EXPECT_EQ(shedder.update(30ms), 3);  // 阶梯已用尽
+
+  EXPECT_EQ(shedder.update(1ms), 3);
+  EXPECT_EQ(shedder.update(1ms), 3);
+  EXPECT_EQ(shedder.update(1ms), 2);
+}
+
+// 测试用例: 介于两个阈值之间的采样清除累计，避免来回切换
+TEST(LoadShedderTest, SteadyLagHoldsLevel) {
+  LoadShedder shedder(makeConfig());
+  shedder.setLevel(2);
+
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(shedder.update(1ms), 2);
+    EXPECT_EQ(shedder.update(1ms), 2);
+    EXPECT_EQ(shedder.update(10ms), 2);
+    EXPECT_EQ(shedder.update(30ms), 2);
+    EXPECT_EQ(shedder.update(10ms), 2);
+  }
+}
+
+// 测试用例: 手动设置的级别被截断到阶梯长度
+TEST(LoadShedderTest, SetLevelClampsToLadder) {
+  LoadShedder shedder(makeConfig());
+  shedder.setLevel(100);
+  EXPECT_EQ(shedder.getLevel(), shedder.getSteps().size());
+  shedder.setLevel(0);
+  EXPECT_EQ(shedder.getLevel(), 0);
+}
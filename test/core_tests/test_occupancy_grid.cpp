@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <string>
+
+#include "core/occupancy_grid.hpp"
+#include "utils/player_utils.hpp"
+
+using namespace picoradar::core;
+using picoradar::test::makePlayer;
+
+namespace {
+
+// 返回世界坐标所在单元的计数
+auto countAt(const picoradar::HeatmapFrame& frame, float x, float z) -> int {
+  const auto cx = static_cast<std::uint32_t>(
+      std::floor((x - frame.origin_x()) / frame.cell_size()));
+  const auto cz = static_cast<std::uint32_t>(
+      std::floor((z - frame.origin_z()) / frame.cell_size()));
+  return static_cast<unsigned char>(frame.counts()[cz * frame.width() + cx]);
+}
+
+auto sumCounts(const picoradar::HeatmapFrame& frame) -> int {
+  int sum = 0;
+  for (char c : frame.counts()) {
+    sum += static_cast<unsigned char>(c);
+  }
+  return sum;
+}
+
+}  // namespace
+
+TEST(OccupancyGridTest, FrameHasFixedSize) {
+  OccupancyGrid grid(OccupancyGridConfig{2.0F, 8, 4});
+  grid.update(makePlayer("a", "scene", 0.0F, 1.7F, 0.0F));
+
+  picoradar::HeatmapFrame frame;
+  ASSERT_TRUE(grid.snapshot("scene", &frame));
+  EXPECT_EQ(frame.width(), 8);
+  EXPECT_EQ(frame.height(), 4);
+  EXPECT_FLOAT_EQ(frame.cell_size(), 2.0F);
+  EXPECT_FLOAT_EQ(frame.origin_x(), -8.0F);
+  EXPECT_FLOAT_EQ(frame.origin_z(), -4.0F);
+  EXPECT_EQ(frame.counts().size(), 32);
+
+  for (int i = 0; i < 50; ++i) {
+    grid.update(
+        makePlayer("p" + std::to_string(i), "scene", 1.0F, 1.7F, 1.0F));
+  }
+  ASSERT_TRUE(grid.snapshot("scene", &frame));
+  EXPECT_EQ(frame.counts().size(), 32);
+}
+
+TEST(OccupancyGridTest, MovingPlayerUpdatesCellsIncrementally) {
+  OccupancyGrid grid;
+  grid.update(makePlayer("a", "scene", 0.5F, 1.7F, 0.5F));
+  grid.update(makePlayer("b", "scene", 0.5F, 1.7F, 0.5F));
+
+  picoradar::HeatmapFrame frame;
+  ASSERT_TRUE(grid.snapshot("scene", &frame));
+  EXPECT_EQ(countAt(frame, 0.5F, 0.5F), 2);
+
+  grid.update(makePlayer("a", "scene", 10.5F, 1.7F, -3.5F));
+  ASSERT_TRUE(grid.snapshot("scene", &frame));
+  EXPECT_EQ(countAt(frame, 0.5F, 0.5F), 1);
+  EXPECT_EQ(countAt(frame, 10.5F, -3.5F), 1);
+  EXPECT_EQ(sumCounts(frame), 2);
+  EXPECT_EQ(frame.total_players(), 2);
+}
+
+TEST(OccupancyGridTest, ScenesAreIndependent) {
+  OccupancyGrid grid;
+  grid.update(makePlayer("a", "lobby", 0.0F, 1.7F, 0.0F));
+  grid.update(makePlayer("b", "arena", 0.0F, 1.7F, 0.0F));
+  EXPECT_EQ(grid.snapshotAll().size(), 2);
+
+  // 切换场景时从旧场景中移除
+  grid.update(makePlayer("a", "arena", 0.0F, 1.7F, 0.0F));
+  const auto frames = grid.snapshotAll();
+  ASSERT_EQ(frames.size(), 1);
+  EXPECT_EQ(frames.front().scene_id(), "arena");
+  EXPECT_EQ(frames.front().total_players(), 2);
+}
+
+TEST(OccupancyGridTest, OutOfBoundsPlayersCountOnlyInTotal) {
+  OccupancyGrid grid(OccupancyGridConfig{1.0F, 4, 4});
+  grid.update(makePlayer("inside", "scene", 0.0F, 1.7F, 0.0F));
+  grid.update(makePlayer("outside", "scene", 100.0F, 1.7F, 0.0F));
+  grid.update(makePlayer("nan", "scene", NAN, 1.7F, 0.0F));
+
+  picoradar::HeatmapFrame frame;
+  ASSERT_TRUE(grid.snapshot("scene", &frame));
+  EXPECT_EQ(sumCounts(frame), 1);
+  EXPECT_EQ(frame.total_players(), 3);
+}
+
+TEST(OccupancyGridTest, RemoveDropsEmptyScenes) {
+  OccupancyGrid grid;
+  grid.update(makePlayer("a", "scene", 0.0F, 1.7F, 0.0F));
+  EXPECT_EQ(grid.getPlayerCount(), 1);
+
+  grid.remove("a");
+  grid.remove("unknown");
+  EXPECT_EQ(grid.getPlayerCount(), 0);
+
+  picoradar::HeatmapFrame frame;
+  EXPECT_FALSE(grid.snapshot("scene", &frame));
+  EXPECT_TRUE(grid.snapshotAll().empty());
+}
+
+TEST(OccupancyGridTest, IgnoresPlaceholdersWithoutScene) {
+  // 鉴权后、发送首个位姿前的占位数据：无场景，位于原点
+  OccupancyGrid grid;
+  grid.update(makePlayer("idle_a", "", 0.0F, 0.0F, 0.0F));
+  picoradar::PlayerData no_position;
+  no_position.set_player_id("idle_b");
+  no_position.set_scene_id("scene");
+  grid.update(no_position);
+  EXPECT_EQ(grid.getPlayerCount(), 0);
+  EXPECT_TRUE(grid.snapshotAll().empty());
+
+  // 首个真实位姿计入，之后的占位数据把玩家移出网格
+  grid.update(makePlayer("idle_a", "scene", 2.0F, 1.7F, 2.0F));
+  EXPECT_EQ(grid.getPlayerCount(), 1);
+  grid.update(makePlayer("idle_a", "", 0.0F, 0.0F, 0.0F));
+  EXPECT_EQ(grid.getPlayerCount(), 0);
+}
+
+TEST(OccupancyGridTest, CountsSaturate) {
+  OccupancyGrid grid;
+  for (int i = 0; i < 300; ++i) {
+    grid.update(makePlayer("p" + std::to_string(i), "scene", 0.0F, 1.7F, 0.0F));
+  }
+
+  picoradar::HeatmapFrame frame;
+  ASSERT_TRUE(grid.snapshot("scene", &frame));
+  EXPECT_EQ(countAt(frame, 0.0F, 0.0F), 255);
+  EXPECT_EQ(frame.total_players(), 300);
+}
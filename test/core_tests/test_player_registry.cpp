@@ -1,7 +1,11 @@
+#include <algorithm>
 #include <thread>
+#include <vector>
 
 #include "core/player_registry.hpp"
+#include "core/wire_format.hpp"
 #include "gtest/gtest.h"
+#include "server.pb.h"
 
 using namespace picoradar::core;
 
@@ -318,3 +322,185 @@ TEST_F(PlayerRegistryTest, DetailedThreadSafety) {
   EXPECT_GT(completed_operations.load(), thread_count * operations_per_thread);
   EXPECT_NO_THROW(registry.getAllPlayers());
 }
+
+// 测试用例: 注册表未变化时快照被共享，变化后生成新快照
+TEST_F(PlayerRegistryTest, SnapshotIsSharedUntilChange) {
+  registry.updatePlayer("player1", createTestPlayer("player1", 1.0F));
+
+  const auto first = registry.getSnapshot();
+  const auto second = registry.getSnapshot();
+  EXPECT_EQ(first.get(), second.get());
+  ASSERT_EQ(first->size(), 1);
+
+  registry.updatePlayer("player2", createTestPlayer("player2", 2.0F));
+  const auto third = registry.getSnapshot();
+  EXPECT_NE(first.get(), third.get());
+  EXPECT_EQ(first->size(), 1);  // 旧快照不受影响
+  EXPECT_EQ(third->size(), 2);
+
+  registry.removePlayer("missing");  // 无变化，不应使快照失效
+  EXPECT_EQ(registry.getSnapshot().get(), third.get());
+}
+
+// 测试用例: 观察者按批次收到合并后的变更
+TEST_F(PlayerRegistryTest, ObserversReceiveBatchedChanges) {
+  registry.updatePlayer("before", createTestPlayer("before", 0.0F));
+
+  std::vector<PlayerRegistry::ChangeSet> batches;
+  registry.addObserver([&batches](const PlayerRegistry::ChangeSet& changes) {
+    batches.push_back(changes);
+  });
+  EXPECT_FALSE(registry.publishChanges());
+
+  registry.updatePlayer("a", createTestPlayer("a", 1.0F));
+  registry.updatePlayer("a", createTestPlayer("a", 2.0F));
+  registry.updatePlayer("b", createTestPlayer("b", 3.0F));
+  registry.removePlayer("before");
+  EXPECT_TRUE(registry.publishChanges());
+  EXPECT_FALSE(registry.publishChanges());
+
+  ASSERT_EQ(batches.size(), 1);
+  auto updated = batches[0].updated;
+  std::sort(updated.begin(), updated.end());
+  EXPECT_EQ(updated, (std::vector<std::string>{"a", "b"}));
+  EXPECT_EQ(batches[0].removed, std::vector<std::string>{"before"});
+  EXPECT_FLOAT_EQ(batches[0].snapshot->at("a").position().x(), 2.0F);
+  EXPECT_EQ(batches[0].snapshot.get(), registry.getSnapshot().get());
+
+  // 同一批次内先更新后移除的玩家只出现在 removed 中
+  registry.updatePlayer("c", createTestPlayer("c", 4.0F));
+  registry.removePlayer("c");
+  EXPECT_TRUE(registry.publishChanges());
+  ASSERT_EQ(batches.size(), 2);
+  EXPECT_TRUE(batches[1].updated.empty());
+  EXPECT_EQ(batches[1].removed, std::vector<std::string>{"c"});
+}
+
+// 测试用例: 移除最后一个观察者后不再记录变更
+TEST_F(PlayerRegistryTest, RemovedObserverStopsTracking) {
+  std::size_t calls = 0;
+  const auto id = registry.addObserver(
+      [&calls](const PlayerRegistry::ChangeSet& /*changes*/) { ++calls; });
+
+  registry.updatePlayer("a", createTestPlayer("a", 1.0F));
+  registry.removeObserver(id);
+  EXPECT_FALSE(registry.publishChanges());
+
+  registry.addObserver(
+      [&calls](const PlayerRegistry::ChangeSet& /*changes*/) { ++calls; });
+  EXPECT_FALSE(registry.publishChanges());
+  EXPECT_EQ(calls, 0);
+}
+
+// 测试用例: 多个消费者按各自的游标读取变更日志
+TEST_F(PlayerRegistryTest, JournalCursorsAdvanceIndependently) {
+  PlayerRegistry journaled(16);
+  journaled.updatePlayer("a", createTestPlayer("a", 1.0F));
+  journaled.updatePlayer("b", createTestPlayer("b", 2.0F));
+  journaled.removePlayer("missing");  // 无变化，不写入日志
+  journaled.removePlayer("a");
+  ASSERT_EQ(journaled.getVersion(), 3);
+
+  auto fast = journaled.readJournal(0);
+  EXPECT_FALSE(fast.overflowed);
+  EXPECT_EQ(fast.next_version, 3);
+  ASSERT_EQ(fast.records.size(), 3);
+  EXPECT_EQ(fast.records[0].version, 1);
+  EXPECT_EQ(fast.records[0].player_id, "a");
+  ASSERT_NE(fast.records[0].encoded, nullptr);
+  picoradar::PlayerData data;
+  ASSERT_TRUE(data.ParseFromString(*fast.records[0].encoded));
+  EXPECT_FLOAT_EQ(data.position().x(), 1.0F);
+  EXPECT_EQ(fast.records[2].kind, PlayerRegistry::ChangeKind::Removed);
+  EXPECT_EQ(fast.records[2].player_id, "a");
+  EXPECT_EQ(fast.records[2].encoded, nullptr);
+
+  // 慢消费者分批读取，不受快消费者影响
+  auto slow = journaled.readJournal(0, 2);
+  ASSERT_EQ(slow.records.size(), 2);
+  EXPECT_EQ(slow.next_version, 2);
+  slow = journaled.readJournal(slow.next_version, 2);
+  ASSERT_EQ(slow.records.size(), 1);
+  EXPECT_EQ(slow.records[0].version, 3);
+
+  EXPECT_TRUE(journaled.readJournal(fast.next_version).records.empty());
+}
+
+// 测试用例: 日志记录与注册表共享编码，不复制玩家数据；默认不记录日志
+TEST_F(PlayerRegistryTest, JournalSharesEncodedBuffer) {
+  EXPECT_EQ(registry.getJournalCapacity(), 0);
+
+  PlayerRegistry journaled(4);
+  journaled.updatePlayer("a", createTestPlayer("a", 1.0F));
+  const auto read = journaled.readJournal(0);
+  ASSERT_EQ(read.records.size(), 1);
+  // 注册表、日志槽位与读取结果引用同一份缓冲区
+  EXPECT_EQ(read.records[0].encoded.use_count(), 3);
+  EXPECT_EQ(*read.records[0].encoded,
+            createTestPlayer("a", 1.0F).SerializeAsString());
+}
+
+// 测试用例: 游标落后超过日志容量时返回快照以重新同步
+TEST_F(PlayerRegistryTest, JournalOverflowResyncsFromSnapshot) {
+  PlayerRegistry small(4);
+  for (int i = 0; i < 6; ++i) {
+    small.updatePlayer("p" + std::to_string(i),
+                       createTestPlayer("p" + std::to_string(i), 1.0F));
+  }
+
+  // 版本 1、2 已被覆盖
+  auto read = small.readJournal(1);
+  EXPECT_TRUE(read.overflowed);
+  EXPECT_TRUE(read.records.empty());
+  EXPECT_EQ(read.next_version, 6);
+  ASSERT_NE(read.snapshot, nullptr);
+  EXPECT_EQ(read.snapshot->size(), 6);
+
+  read = small.readJournal(2);
+  EXPECT_FALSE(read.overflowed);
+  ASSERT_EQ(read.records.size(), 4);
+  EXPECT_EQ(read.records.front().player_id, "p2");
+
+  // 关闭日志时任何落后的游标都需要重新同步
+  PlayerRegistry disabled(0);
+  disabled.updatePlayer("a", createTestPlayer("a", 1.0F));
+  EXPECT_TRUE(disabled.readJournal(0).overflowed);
+  EXPECT_FALSE(disabled.readJournal(1).overflowed);
+}
+
+// 测试用例: 拼接的玩家列表编码与逐个序列化的结果等价
+TEST_F(PlayerRegistryTest, EncodedRosterMatchesSnapshot) {
+  registry.updatePlayer("player1", createTestPlayer("player1", 1.0F));
+  registry.updatePlayer("player2", createTestPlayer("player2", 2.0F));
+  registry.updatePlayer("player1", createTestPlayer("player1", 3.0F));
+
+  auto encoded = registry.getEncodedSnapshot();
+  picoradar::PlayerList list;
+  ASSERT_TRUE(list.ParseFromString(*encoded.roster));
+  ASSERT_EQ(list.players_size(), 2);
+  for (const auto& player : list.players()) {
+    const auto& expected = encoded.players->at(player.player_id());
+    EXPECT_EQ(player.SerializeAsString(), expected.SerializeAsString());
+  }
+
+  // 未变化时共享同一份编码，移除后不再包含该玩家
+  EXPECT_EQ(registry.getEncodedSnapshot().roster.get(), encoded.roster.get());
+  registry.removePlayer("player2");
+  encoded = registry.getEncodedSnapshot();
+  ASSERT_TRUE(list.ParseFromString(*encoded.roster));
+  ASSERT_EQ(list.players_size(), 1);
+  EXPECT_EQ(list.players(0).player_id(), "player1");
+  EXPECT_FLOAT_EQ(list.players(0).position().x(), 3.0F);
+}
+
+// 测试用例: 调用方提供的编码原样进入玩家列表
+TEST_F(PlayerRegistryTest, ProvidedEncodingIsSplicedVerbatim) {
+  auto player = createTestPlayer("player1", 1.0F);
+  const auto bytes = player.SerializeAsString();
+  registry.updatePlayer("player1", player, bytes);
+
+  std::string expected;
+  wire::appendLengthDelimited(
+      expected, picoradar::PlayerList::kPlayersFieldNumber, bytes);
+  EXPECT_EQ(*registry.getEncodedSnapshot().roster, expected);
+}
@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <map>
+#include <numeric>
+#include <string>
+
+#include "core/pose_analytics.hpp"
+#include "utils/player_utils.hpp"
+
+using namespace picoradar::core;
+using picoradar::test::makePlayer;
+
+namespace {
+
+using PlayerMap = std::map<std::string, picoradar::PlayerData>;
+
+class PoseAnalyticsTest : public testing::Test {
+ protected:
+  auto archivePath(int index) -> std::string {
+    return (std::filesystem::temp_directory_path() /
+            ("picoradar_" +
+             std::string(testing::UnitTest::GetInstance()
+                             ->current_test_info()
+                             ->name()) +
+             "_" + std::to_string(index) + ".pra"))
+        .string();
+  }
+
+  void TearDown() override {
+    for (int i = 0; i < 2; ++i) {
+      std::filesystem::remove(archivePath(i));
+    }
+  }
+
+  /**
+   * 第一个归档 (0-900ms)：walker 每 100ms 沿 x 轴前进 1m，在 x=5 处
+   * 擦过静止的 sentry。第二个归档：walker 继续前进到 x=14，断线 2 秒后
+   * 出现在 lobby 中又走了 1m。
+   */
+  void recordSession() {
+    {
+      PoseArchiveWriter writer(archivePath(0), 4);
+      for (int frame = 0; frame < 10; ++frame) {
+        writer.append(
+            frame * 100,
+            PlayerMap{{"walker", makePlayer("walker", "arena", frame * 1.0F,
+                                            1.7F, 0.0F)},
+                      {"sentry",
+                       makePlayer("sentry", "arena", 5.0F, 1.7F, 0.5F)}});
+      }
+    }
+    {
+      PoseArchiveWriter writer(archivePath(1), 4);
+      for (int frame = 10; frame < 15; ++frame) {
+        writer.append(
+            frame * 100,
+            PlayerMap{{"walker", makePlayer("walker", "arena", frame * 1.0F,
+                                            1.7F, 0.0F)}});
+      }
+      writer.append(3500, PlayerMap{{"walker", makePlayer("walker", "lobby",
+                                                          0.0F, 1.7F, 0.0F)}});
+      writer.append(3600, PlayerMap{{"walker", makePlayer("walker", "lobby",
+                                                          1.0F, 1.7F, 0.0F)}});
+    }
+  }
+};
+
+}  // namespace
+
+TEST_F(PoseAnalyticsTest, SummarizesSessionAcrossArchives) {
+  recordSession();
+  const PoseArchiveReader first(archivePath(0));
+  const PoseArchiveReader second(archivePath(1));
+
+  for (const std::size_t threads : {1, 3}) {
+    PoseAnalyticsConfig config;
+    config.threads = threads;
+    // 传入顺序与录制顺序相反，应按起始时间重新排序
+    const auto report = PoseAnalyzer(config).run({&second, &first});
+
+    EXPECT_EQ(report.samples, 27);
+    EXPECT_EQ(report.blocks, 5);
+    EXPECT_EQ(report.start_ms, 0);
+    EXPECT_EQ(report.end_ms, 3600);
+
+    ASSERT_EQ(report.players.size(), 2);
+    const auto& sentry = report.players[0];
+    const auto& walker = report.players[1];
+    EXPECT_EQ(sentry.player_id, "sentry");
+    EXPECT_EQ(sentry.samples, 10);
+    EXPECT_NEAR(sentry.distance_m, 0.0, 1e-6);
+    EXPECT_NEAR(sentry.dwell_s.at("arena"), 0.9, 1e-9);
+    EXPECT_EQ(sentry.near_misses, 1);
+
+    EXPECT_EQ(walker.player_id, "walker");
+    EXPECT_EQ(walker.samples, 17);
+    // 断线期间的跳变不计入距离
+    EXPECT_NEAR(walker.distance_m, 15.0, 0.01);
+    EXPECT_NEAR(walker.dwell_s.at("arena"), 1.4, 1e-9);
+    EXPECT_NEAR(walker.dwell_s.at("lobby"), 0.1, 1e-9);
+    EXPECT_EQ(walker.near_misses, 1);
+
+    // 距离在 frame 4-6 低于 1.5m，只算一次险情
+    ASSERT_EQ(report.near_misses.size(), 1);
+    EXPECT_EQ(report.near_misses[0].first, "sentry");
+    EXPECT_EQ(report.near_misses[0].second, "walker");
+    EXPECT_EQ(report.near_misses[0].count, 1);
+    EXPECT_NEAR(report.near_misses[0].min_distance, 0.5F, 0.001F);
+
+    ASSERT_EQ(report.heatmaps.size(), 2);
+    const auto& arena = report.heatmaps[0];
+    EXPECT_EQ(arena.scene_id, "arena");
+    EXPECT_EQ(arena.outside, 0);
+    EXPECT_EQ(std::accumulate(arena.cells.begin(), arena.cells.end(),
+                              std::uint64_t{0}),
+              25);
+    // 网格以原点为中心，(5, 0.5) 位于第 32 行第 37 列
+    EXPECT_EQ(arena.cells[32 * 64 + 37], 11);  // sentry 10 次，walker 1 次
+    EXPECT_EQ(report.heatmaps[1].scene_id, "lobby");
+  }
+}
+
+TEST_F(PoseAnalyticsTest, RestrictsToTimeRange) {
+  recordSession();
+  const PoseArchiveReader first(archivePath(0));
+  const PoseArchiveReader second(archivePath(1));
+
+  PoseAnalyticsConfig config;
+  config.from_ms = 300;
+  config.to_ms = 600;
+  const auto report = PoseAnalyzer(config).run({&first, &second});
+
+  EXPECT_EQ(report.blocks, 2);  // 第二个归档被块索引跳过
+  EXPECT_EQ(report.samples, 8);
+  EXPECT_EQ(report.start_ms, 300);
+  EXPECT_EQ(report.end_ms, 600);
+  ASSERT_EQ(report.players.size(), 2);
+  EXPECT_NEAR(report.players[1].distance_m, 3.0, 0.01);
+  EXPECT_NEAR(report.players[1].dwell_s.at("arena"), 0.3, 1e-9);
+}
+
+TEST_F(PoseAnalyticsTest, NearMissUsesHysteresisAcrossBlocks) {
+  // 每帧单独成块，险情状态必须跨块衔接
+  {
+    PoseArchiveWriter writer(archivePath(0), 1);
+    const float distances[] = {1.0F, 1.8F, 1.2F, 2.5F, 1.0F, 1.0F};
+    std::int64_t timestamp = 0;
+    for (const float distance : distances) {
+      writer.append(
+          timestamp,
+          PlayerMap{{"a", makePlayer("a", "arena", 0.0F, 1.7F, 0.0F)},
+                    {"b", makePlayer("b", "arena", distance, 1.7F, 0.0F)}});
+      timestamp += 100;
+    }
+    // 采样中断后重新出现，视为新的险情
+    writer.append(5000,
+                  PlayerMap{{"a", makePlayer("a", "arena", 0.0F, 1.7F, 0.0F)},
+                            {"b", makePlayer("b", "arena", 1.0F, 1.7F, 0.0F)}});
+  }
+  const PoseArchiveReader archive(archivePath(0));
+
+  PoseAnalyticsConfig config;
+  config.threads = 4;
+  const auto report = PoseAnalyzer(config).run({&archive});
+  ASSERT_EQ(report.near_misses.size(), 1);
+  EXPECT_EQ(report.near_misses[0].count, 3);
+  EXPECT_NEAR(report.near_misses[0].min_distance, 1.0F, 0.001F);
+  EXPECT_EQ(report.players[0].near_misses, 3);
+}
@@ -0,0 +1,222 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "core/player_registry.hpp"
+#include "core/pose_archive.hpp"
+#include "core/pose_recorder.hpp"
+#include "utils/player_utils.hpp"
+
+using namespace picoradar::core;
+using picoradar::test::makePlayer;
+
+namespace {
+
+using PlayerMap = std::map<std::string, picoradar::PlayerData>;
+
+class PoseArchiveTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    path_ = (std::filesystem::temp_directory_path() /
+             ("picoradar_" +
+              std::string(testing::UnitTest::GetInstance()
+                              ->current_test_info()
+                              ->name()) +
+              ".pra"))
+                .string();
+  }
+
+  void TearDown() override { std::filesystem::remove(path_); }
+
+  std::string path_;
+};
+
+}  // namespace
+
+TEST_F(PoseArchiveTest, RoundTripsQuantizedPoses) {
+  {
+    PoseArchiveWriter writer(path_, 2);
+    writer.append(
+        1000,
+        PlayerMap{{"alice", makePlayer("alice", "arena", 1.0F, 1.7F, -1.0F,
+                                       0.1F)},
+                  {"bob", makePlayer("bob", "arena", 2.0F, 1.7F, -2.0F,
+                                     0.2F)}});
+    writer.append(1100, PlayerMap{{"alice", makePlayer("alice", "arena", 1.25F,
+                                                       1.7F, -1.25F, 0.3F)}});
+    // 第二个块引入新玩家与新场景
+    writer.append(
+        1200,
+        PlayerMap{{"carol", makePlayer("carol", "lobby", -3.5F, 1.7F, 3.5F,
+                                       -1.0F)},
+                  {"bob", makePlayer("bob", "lobby", 2.5F, 1.7F, -2.5F,
+                                     0.4F)}});
+    EXPECT_EQ(writer.getSampleCount(), 3);  // 第三帧尚未写出
+  }
+
+  PoseArchiveReader reader(path_);
+  EXPECT_EQ(reader.getPlayerIds(),
+            (std::vector<std::string>{"alice", "bob", "carol"}));
+  EXPECT_EQ(reader.getSceneIds(),
+            (std::vector<std::string>{"arena", "lobby"}));
+  ASSERT_EQ(reader.getBlocks().size(), 2);
+  EXPECT_EQ(reader.getSampleCount(), 5);
+  EXPECT_EQ(reader.getStartTime(), 1000);
+  EXPECT_EQ(reader.getEndTime(), 1200);
+
+  PoseColumns columns;
+  reader.readBlock(0, columns);
+  reader.readBlock(1, columns);
+  ASSERT_EQ(columns.size(), 5);
+
+  // 块内按玩家、再按时间排序
+  const std::vector<std::uint32_t> players = {0, 0, 1, 1, 2};
+  const std::vector<std::int64_t> times = {1000, 1100, 1000, 1200, 1200};
+  const std::vector<float> xs = {1.0F, 1.25F, 2.0F, 2.5F, -3.5F};
+  const std::vector<float> yaws = {0.1F, 0.3F, 0.2F, 0.4F, -1.0F};
+  const std::vector<std::uint32_t> scenes = {0, 0, 0, 1, 1};
+  for (std::size_t i = 0; i < columns.size(); ++i) {
+    EXPECT_EQ(columns.player[i], players[i]) << i;
+    EXPECT_EQ(columns.timestamp_ms[i], times[i]) << i;
+    EXPECT_EQ(columns.scene[i], scenes[i]) << i;
+    EXPECT_NEAR(columns.position[0][i], xs[i], 0.0005F) << i;
+    EXPECT_NEAR(columns.position[1][i], 1.7F, 0.0005F) << i;
+    EXPECT_NEAR(columns.position[2][i], -xs[i], 0.0005F) << i;
+    EXPECT_NEAR(columns.rotation[0][i], 0.0F, 1.0F / 8192) << i;
+    EXPECT_NEAR(columns.rotation[1][i], std::sin(yaws[i] / 2.0F), 1.0F / 8192)
+        << i;
+    EXPECT_NEAR(columns.rotation[3][i], std::cos(yaws[i] / 2.0F), 1.0F / 8192)
+        << i;
+  }
+}
+
+TEST_F(PoseArchiveTest, ScanSeeksByTime) {
+  {
+    PoseArchiveWriter writer(path_, 8);
+    for (int frame = 0; frame < 100; ++frame) {
+      PlayerMap players;
+      for (int p = 0; p < 10; ++p) {
+        const auto id = "player_" + std::to_string(p);
+        const auto x = static_cast<float>(frame);
+        players[id] = makePlayer(id, "arena", x, 1.7F, -x);
+      }
+      writer.append(frame * 10, players);
+    }
+  }
+
+  PoseArchiveReader reader(path_);
+  EXPECT_EQ(reader.getBlocks().size(), 13);
+  EXPECT_EQ(reader.getSampleCount(), 1000);
+
+  std::size_t rows = 0;
+  std::size_t visits = 0;
+  reader.scan(300, 490, [&](const PoseColumns& columns) {
+    ++visits;
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+      EXPECT_GE(columns.timestamp_ms[i], 300);
+      EXPECT_LE(columns.timestamp_ms[i], 490);
+      EXPECT_FLOAT_EQ(columns.position[0][i],
+                      static_cast<float>(columns.timestamp_ms[i] / 10));
+    }
+    rows += columns.size();
+  });
+  EXPECT_EQ(rows, 200);
+  EXPECT_EQ(visits, 4);  // 帧 24-31、32-39、40-47、48-55 四个块
+
+  rows = 0;
+  reader.scan(2000, 3000, [&](const PoseColumns& columns) {
+    rows += columns.size();
+  });
+  EXPECT_EQ(rows, 0);
+}
+
+TEST_F(PoseArchiveTest, IgnoresTruncatedTail) {
+  {
+    PoseArchiveWriter writer(path_, 1);
+    for (int frame = 0; frame < 3; ++frame) {
+      writer.append(frame, PlayerMap{{"alice", makePlayer("alice", "arena",
+                                                          1.0F, 1.7F, -1.0F)}});
+    }
+  }
+  // 模拟录制进程在写最后一个块时退出
+  std::filesystem::resize_file(path_, std::filesystem::file_size(path_) - 3);
+
+  PoseArchiveReader reader(path_);
+  EXPECT_EQ(reader.getBlocks().size(), 2);
+  EXPECT_EQ(reader.getEndTime(), 1);
+}
+
+TEST_F(PoseArchiveTest, RejectsOtherFiles) {
+  {
+    std::ofstream file(path_, std::ios::binary);
+    file << "not an archive at all";
+  }
+  EXPECT_THROW(PoseArchiveReader reader(path_), std::runtime_error);
+  EXPECT_THROW(PoseArchiveReader reader(path_ + ".missing"),
+               std::runtime_error);
+}
+
+TEST_F(PoseArchiveTest, CompressesWalkingPlayers) {
+  // 100 名玩家以步行速度随机游走、转头，每 100ms 采样一次，共 1 分钟
+  constexpr int kPlayers = 100;
+  constexpr int kFrames = 600;
+  std::mt19937 rng(42);
+  std::normal_distribution<float> step(0.0F, 0.1F);
+  std::vector<std::array<float, 3>> state(kPlayers, {0.0F, 0.0F, 0.0F});
+
+  std::uint64_t bytes = 0;
+  {
+    PoseArchiveWriter writer(path_, 64);
+    for (int frame = 0; frame < kFrames; ++frame) {
+      PlayerMap players;
+      for (int p = 0; p < kPlayers; ++p) {
+        auto& [x, z, yaw] = state[p];
+        x += step(rng);
+        z += step(rng);
+        yaw += step(rng);
+        const auto id = "player_" + std::to_string(p);
+        players[id] = makePlayer(id, "arena", x, 1.7F, z, yaw);
+      }
+      writer.append(frame * 100, players);
+    }
+    writer.flush();
+    bytes = writer.getBytesWritten();
+  }
+
+  PoseArchiveReader reader(path_);
+  EXPECT_EQ(reader.getSampleCount(), kPlayers * kFrames);
+  // 原始 PlayerData 每条约 60 字节
+  EXPECT_LT(static_cast<double>(bytes) / (kPlayers * kFrames), 12.0);
+}
+
+TEST_F(PoseArchiveTest, RecorderSamplesRegistry) {
+  PlayerRegistry registry;
+  registry.updatePlayer("alice",
+                        makePlayer("alice", "arena", 1.0F, 1.7F, -1.0F));
+  registry.updatePlayer("bob", makePlayer("bob", "arena", 2.0F, 1.7F, -2.0F));
+
+  PoseRecorder recorder(registry, {path_, std::chrono::milliseconds(5), 4});
+  recorder.start();
+  EXPECT_TRUE(recorder.isRecording());
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  while (recorder.getFramesRecorded() < 10 &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  recorder.stop();
+  EXPECT_FALSE(recorder.isRecording());
+  EXPECT_TRUE(recorder.getError().empty());
+
+  PoseArchiveReader reader(path_);
+  ASSERT_GE(recorder.getFramesRecorded(), 10);
+  EXPECT_EQ(reader.getSampleCount(), recorder.getFramesRecorded() * 2);
+  EXPECT_EQ(reader.getPlayerIds().size(), 2);
+}
@@ -0,0 +1,311 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <string>
+
+#include "core/pose_codec.hpp"
+#include "server.pb.h"
+#include "utils/player_utils.hpp"
+
+using namespace picoradar::core;
+using picoradar::test::makePlayer;
+
+namespace {
+
+auto makeRotation(float x, float y, float z, float w) -> picoradar::Quaternion {
+  const float norm = std::sqrt(x * x + y * y + z * z + w * w);
+  picoradar::Quaternion q;
+  q.set_x(x / norm);
+  q.set_y(y / norm);
+  q.set_z(z / norm);
+  q.set_w(w / norm);
+  return q;
+}
+
+// |dot(a, b)|，q 与 -q 视为相同旋转
+auto rotationSimilarity(const picoradar::Quaternion& a,
+                        const picoradar::Quaternion& b) -> float {
+  return std::fabs(a.x() * b.x() + a.y() * b.y() + a.z() * b.z() +
+                   a.w() * b.w());
+}
+
+void addBody(picoradar::PlayerData& player, std::uint32_t slot, float x,
+             float y, float z, const picoradar::Quaternion& rotation) {
+  auto* body = player.add_bodies();
+  body->set_slot(slot);
+  body->mutable_position()->set_x(x);
+  body->mutable_position()->set_y(y);
+  body->mutable_position()->set_z(z);
+  *body->mutable_rotation() = rotation;
+}
+
+// 头部在 (12.3, 1.7, -4.5)，两只手柄与一个腰部追踪器
+auto makeTrackedPlayer(const std::string& id, float x)
+    -> picoradar::PlayerData {
+  auto player = makePlayer(id, "scene", x, 1.7F, -4.5F);
+  addBody(player, 1, x + 0.3F, 1.2F, -4.2F,
+          makeRotation(0.1F, 0.7F, -0.2F, 0.6F));
+  addBody(player, 0, x - 0.31F, 1.1F, -4.25F,
+          makeRotation(0.0F, 0.0F, 0.0F, 1.0F));
+  addBody(player, 5, x, 1.0F, -4.5F, makeRotation(0.0F, 1.0F, 0.0F, 0.2F));
+  return player;
+}
+
+auto findPlayer(const picoradar::CompactPlayerList& list,
+                const std::string& id) -> const picoradar::CompactPlayer* {
+  for (const auto& player : list.players()) {
+    if (player.player_id() == id) {
+      return &player;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+TEST(PoseCodecTest, SelectsBandByDistance) {
+  PrecisionLodConfig config;
+  EXPECT_EQ(PoseCodec::selectBand(0.0F, config), PrecisionBand::Near);
+  EXPECT_EQ(PoseCodec::selectBand(4.9F, config), PrecisionBand::Near);
+  EXPECT_EQ(PoseCodec::selectBand(5.0F, config), PrecisionBand::Mid);
+  EXPECT_EQ(PoseCodec::selectBand(19.9F, config), PrecisionBand::Mid);
+  EXPECT_EQ(PoseCodec::selectBand(20.0F, config), PrecisionBand::Far);
+  EXPECT_EQ(PoseCodec::selectBand(NAN, config), PrecisionBand::Near);
+}
+
+TEST(PoseCodecTest, PositionErrorWithinBandStep) {
+  auto player = makePlayer("p", "scene", 12.3456F, -7.891F, 0.0042F);
+  player.set_timestamp(123456789);
+
+  for (auto band : {PrecisionBand::Near, PrecisionBand::Mid,
+                    PrecisionBand::Far}) {
+    picoradar::CompactPlayer compact;
+    PoseCodec::encode(player, band, &compact);
+
+    picoradar::PlayerData decoded;
+    PoseCodec::decode(compact, &decoded);
+
+    const float tolerance = PoseCodec::positionStep(band) / 2.0F + 1e-4F;
+    EXPECT_NEAR(decoded.position().x(), player.position().x(), tolerance);
+    EXPECT_NEAR(decoded.position().y(), player.position().y(), tolerance);
+    EXPECT_NEAR(decoded.position().z(), player.position().z(), tolerance);
+    EXPECT_EQ(decoded.player_id(), "p");
+    EXPECT_EQ(decoded.scene_id(), "scene");
+    EXPECT_EQ(decoded.timestamp(), player.timestamp());
+  }
+}
+
+TEST(PoseCodecTest, ClampsOutOfRangePositions) {
+  const auto player = makePlayer("p", "scene", 1e12F, NAN, -1e12F);
+  picoradar::CompactPlayer compact;
+  PoseCodec::encode(player, PrecisionBand::Near, &compact);
+
+  EXPECT_GT(compact.x(), 0);
+  EXPECT_EQ(compact.y(), 0);
+  EXPECT_LT(compact.z(), 0);
+}
+
+TEST(PoseCodecTest, RotationRoundTrip) {
+  const picoradar::Quaternion rotations[] = {
+      makeRotation(0.0F, 0.0F, 0.0F, 1.0F),
+      makeRotation(0.1F, 0.7F, -0.2F, 0.6F),
+      makeRotation(-0.5F, 0.5F, -0.5F, -0.5F),
+      makeRotation(0.0F, 0.0F, -1.0F, 0.01F),
+  };
+  // 各精度下允许的最小 |dot|
+  const std::pair<int, float> cases[] = {{10, 0.9999F}, {8, 0.999F},
+                                         {6, 0.99F}};
+
+  for (const auto& rotation : rotations) {
+    for (const auto& [bits, min_similarity] : cases) {
+      picoradar::Quaternion decoded;
+      PoseCodec::unpackRotation(PoseCodec::packRotation(rotation, bits), bits,
+                                &decoded);
+      EXPECT_GE(rotationSimilarity(rotation, decoded), min_similarity)
+          << "bits=" << bits;
+    }
+  }
+}
+
+TEST(PoseCodecTest, OmitsMissingRotation) {
+  auto player = makePlayer("p", "scene", 1.0F, 0.0F, 0.0F);
+  player.clear_rotation();
+
+  picoradar::CompactPlayer compact;
+  PoseCodec::encode(player, PrecisionBand::Mid, &compact);
+  EXPECT_FALSE(compact.has_rotation());
+
+  picoradar::PlayerData decoded;
+  PoseCodec::decode(compact, &decoded);
+  EXPECT_FALSE(decoded.has_rotation());
+}
+
+TEST(PoseCodecTest, FarBandIsSmallerThanFullPlayerData) {
+  const auto player =
+      makePlayer("player_with_id", "scene", 123.456F, 1.7F, -98.765F);
+  picoradar::CompactPlayer compact;
+  PoseCodec::encode(player, PrecisionBand::Far, &compact);
+  EXPECT_LT(compact.ByteSizeLong(), player.ByteSizeLong());
+}
+
+TEST(PoseCodecTest, TrackedBodiesRoundTrip) {
+  const auto player = makeTrackedPlayer("p", 12.3F);
+  const std::pair<PrecisionBand, float> cases[] = {
+      {PrecisionBand::Near, 0.9999F}, {PrecisionBand::Mid, 0.999F},
+      {PrecisionBand::Far, 0.99F}};
+
+  for (const auto& [band, min_similarity] : cases) {
+    picoradar::CompactPlayer compact;
+    PoseCodec::encode(player, band, &compact);
+    EXPECT_EQ(compact.body_mask(), 0b100011U);
+
+    picoradar::PlayerData decoded;
+    PoseCodec::decode(compact, &decoded);
+    ASSERT_EQ(decoded.bodies_size(), 3);
+
+    // 按槽位升序还原
+    const int order[] = {1, 0, 2};
+    const float tolerance = PoseCodec::positionStep(band) + 1e-4F;
+    for (int i = 0; i < 3; ++i) {
+      const auto& expected = player.bodies(order[i]);
+      const auto& actual = decoded.bodies(i);
+      EXPECT_EQ(actual.slot(), expected.slot());
+      EXPECT_NEAR(actual.position().x(), expected.position().x(), tolerance);
+      EXPECT_NEAR(actual.position().y(), expected.position().y(), tolerance);
+      EXPECT_NEAR(actual.position().z(), expected.position().z(), tolerance);
+      EXPECT_GE(rotationSimilarity(actual.rotation(), expected.rotation()),
+                min_similarity);
+    }
+  }
+}
+
+TEST(PoseCodecTest, TrackedBodiesAreCheaperThanSeparateRecords) {
+  const auto player = makeTrackedPlayer("player_with_id", 12.3F);
+  picoradar::CompactPlayer with_bodies;
+  PoseCodec::encode(player, PrecisionBand::Near, &with_bodies);
+  picoradar::CompactPlayer head_only;
+  PoseCodec::encode(player, PrecisionBand::Near, &head_only, false);
+  EXPECT_EQ(head_only.body_mask(), 0U);
+  EXPECT_TRUE(head_only.bodies().empty());
+
+  // 相对头部 1m 内的部位，每个不超过 12 字节，远小于一条独立记录
+  const auto per_body =
+      (with_bodies.ByteSizeLong() - head_only.ByteSizeLong()) / 3;
+  EXPECT_LE(per_body, 12U);
+  EXPECT_LT(per_body, head_only.ByteSizeLong() / 2);
+}
+
+TEST(PoseCodecTest, IgnoresInvalidBodySlots) {
+  auto player = makePlayer("p", "scene", 0.0F, 0.0F, 0.0F);
+  const auto identity = makeRotation(0.0F, 0.0F, 0.0F, 1.0F);
+  addBody(player, 2, 1.0F, 0.0F, 0.0F, identity);
+  addBody(player, kMaxTrackedBodies, 5.0F, 0.0F, 0.0F, identity);
+  addBody(player, 2, 2.0F, 0.0F, 0.0F, identity);  // 重复槽位以最后一个为准
+
+  picoradar::CompactPlayer compact;
+  PoseCodec::encode(player, PrecisionBand::Near, &compact);
+  EXPECT_EQ(compact.body_mask(), 0b100U);
+
+  picoradar::PlayerData decoded;
+  PoseCodec::decode(compact, &decoded);
+  ASSERT_EQ(decoded.bodies_size(), 1);
+  EXPECT_FLOAT_EQ(decoded.bodies(0).position().x(), 2.0F);
+
+  // 截断的部位数据被丢弃，头部不受影响
+  compact.mutable_bodies()->pop_back();
+  PoseCodec::decode(compact, &decoded);
+  EXPECT_EQ(decoded.bodies_size(), 0);
+  EXPECT_EQ(decoded.player_id(), "p");
+}
+
+TEST(CompactFrameBuilderTest, FarPlayersOmitTrackedBodies) {
+  CompactFrameBuilder::PlayerMap players;
+  players["viewer"] = makePlayer("viewer", "scene", 0.0F, 0.0F, 0.0F);
+  players["mid"] = makeTrackedPlayer("mid", 10.0F);
+  players["far"] = makeTrackedPlayer("far", 100.0F);
+
+  for (const bool far_bodies : {false, true}) {
+    PrecisionLodConfig config;
+    config.far_bodies = far_bodies;
+    CompactFrameBuilder builder(players, config);
+    picoradar::ServerToClient message;
+    ASSERT_TRUE(message.ParseFromString(builder.buildFor("viewer")));
+
+    const auto& list = message.compact_player_list();
+    EXPECT_EQ(findPlayer(list, "mid")->body_mask(), 0b100011U);
+    EXPECT_EQ(findPlayer(list, "far")->body_mask(),
+              far_bodies ? 0b100011U : 0U);
+  }
+}
+
+TEST(CompactFrameBuilderTest, FrameParsesAndUsesPerViewerBands) {
+  CompactFrameBuilder::PlayerMap players;
+  players["viewer"] = makePlayer("viewer", "scene", 0.0F, 0.0F, 0.0F);
+  players["near"] = makePlayer("near", "scene", 1.0F, 0.0F, 0.0F);
+  players["mid"] = makePlayer("mid", "scene", 10.0F, 0.0F, 0.0F);
+  players["far"] = makePlayer("far", "scene", 100.0F, 0.0F, 0.0F);
+
+  CompactFrameBuilder builder(players, PrecisionLodConfig{});
+  picoradar::ServerToClient message;
+  ASSERT_TRUE(message.ParseFromString(builder.buildFor("viewer")));
+  ASSERT_TRUE(message.has_compact_player_list());
+
+  const auto& list = message.compact_player_list();
+  ASSERT_EQ(list.players_size(), 4);
+  EXPECT_EQ(findPlayer(list, "near")->precision(),
+            static_cast<uint32_t>(PrecisionBand::Near));
+  EXPECT_EQ(findPlayer(list, "mid")->precision(),
+            static_cast<uint32_t>(PrecisionBand::Mid));
+  EXPECT_EQ(findPlayer(list, "far")->precision(),
+            static_cast<uint32_t>(PrecisionBand::Far));
+}
+
+TEST(CompactFrameBuilderTest, SharesEncodingsAcrossViewers) {
+  CompactFrameBuilder::PlayerMap players;
+  for (int i = 0; i < 10; ++i) {
+    const auto id = "p" + std::to_string(i);
+    players[id] =
+        makePlayer(id, "scene", static_cast<float>(i) * 0.1F, 0.0F, 0.0F);
+  }
+
+  // 所有玩家彼此都在 Near 范围内，每个玩家只需编码一次
+  CompactFrameBuilder builder(players, PrecisionLodConfig{});
+  for (const auto& [id, player] : players) {
+    builder.buildFor(id);
+  }
+  EXPECT_EQ(builder.getEncodeCount(), players.size());
+}
+
+TEST(CompactFrameBuilderTest, UnknownViewerGetsNearPrecision) {
+  CompactFrameBuilder::PlayerMap players;
+  players["a"] = makePlayer("a", "scene", 0.0F, 0.0F, 0.0F);
+  players["b"] = makePlayer("b", "scene", 500.0F, 0.0F, 0.0F);
+
+  CompactFrameBuilder builder(players, PrecisionLodConfig{});
+  picoradar::ServerToClient message;
+  ASSERT_TRUE(message.ParseFromString(builder.buildFor("")));
+  for (const auto& player : message.compact_player_list().players()) {
+    EXPECT_EQ(player.precision(), static_cast<uint32_t>(PrecisionBand::Near));
+  }
+}
+
+TEST(CompactFrameBuilderTest, MinBandCoarsensEveryPlayer) {
+  CompactFrameBuilder::PlayerMap players;
+  players["viewer"] = makePlayer("viewer", "scene", 0.0F, 0.0F, 0.0F);
+  players["near"] = makeTrackedPlayer("near", 1.0F);
+  players["far"] = makePlayer("far", "scene", 100.0F, 0.0F, 0.0F);
+
+  CompactFrameBuilder builder(players, PrecisionLodConfig{});
+  const auto detailed = builder.buildFor("viewer");
+  const auto coarse = builder.buildFor("viewer", PrecisionBand::Far);
+  EXPECT_LT(coarse.size(), detailed.size());
+
+  picoradar::ServerToClient message;
+  ASSERT_TRUE(message.ParseFromString(coarse));
+  for (const auto& player : message.compact_player_list().players()) {
+    EXPECT_EQ(player.precision(), static_cast<uint32_t>(PrecisionBand::Far));
+    EXPECT_EQ(player.body_mask(), 0U);
+  }
+  // 远处玩家的 Far 编码被两个帧共享
+  EXPECT_EQ(builder.getEncodeCount(), 5);
+}
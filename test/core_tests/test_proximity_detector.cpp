@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <set>
+#include <string>
+
+#include "core/proximity_detector.hpp"
+#include "core/spatial_hash.hpp"
+
+using namespace picoradar::core;
+using namespace std::chrono_literals;
+
+namespace {
+
+auto makeVector(float x, float y, float z) -> picoradar::Vector3 {
+  picoradar::Vector3 v;
+  v.set_x(x);
+  v.set_y(y);
+  v.set_z(z);
+  return v;
+}
+
+void addPlayer(ProximityDetector::PlayerMap& players, const std::string& id,
+               float x, float z, const std::string& scene = "scene") {
+  auto& player = players[id];
+  player.set_player_id(id);
+  player.set_scene_id(scene);
+  *player.mutable_position() = makeVector(x, 1.7F, z);
+}
+
+}  // namespace
+
+// ================================ SpatialHash ================================
+
+TEST(SpatialHashTest, MatchesBruteForce) {
+  constexpr float kRadius = 2.0F;
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<float> coord(-20.0F, 20.0F);
+
+  std::vector<picoradar::Vector3> points;
+  SpatialHash hash(kRadius);
+  for (std::size_t i = 0; i < 300; ++i) {
+    points.push_back(makeVector(coord(rng), coord(rng) / 10.0F, coord(rng)));
+    hash.insert(i, "scene", points.back());
+  }
+
+  std::set<SpatialHash::Pair> expected;
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    for (std::size_t j = i + 1; j < points.size(); ++j) {
+      const float dx = points[i].x() - points[j].x();
+      const float dy = points[i].y() - points[j].y();
+      const float dz = points[i].z() - points[j].z();
+      if (dx * dx + dy * dy + dz * dz <= kRadius * kRadius) {
+        expected.emplace(i, j);
+      }
+    }
+  }
+
+  const auto pairs = hash.findPairs();
+  const std::set<SpatialHash::Pair> actual(pairs.begin(), pairs.end());
+  EXPECT_EQ(actual.size(), pairs.size());  // 没有重复
+  EXPECT_EQ(actual, expected);
+}
+
+TEST(SpatialHashTest, ScenesAndInvalidPositionsAreIsolated) {
+  SpatialHash hash(1.0F);
+  hash.insert(0, "a", makeVector(0.0F, 0.0F, 0.0F));
+  hash.insert(1, "b", makeVector(0.0F, 0.0F, 0.0F));
+  hash.insert(2, "a", makeVector(NAN, 0.0F, 0.0F));
+  hash.insert(3, "a", makeVector(INFINITY, 0.0F, 0.0F));
+  EXPECT_EQ(hash.size(), 2);
+  EXPECT_TRUE(hash.findPairs().empty());
+}
+
+// ============================= ProximityDetector =============================
+
+TEST(ProximityDetectorTest, ReportsCloseApproach) {
+  ProximityDetector detector;
+  ProximityDetector::PlayerMap players;
+  addPlayer(players, "a", 0.0F, 0.0F);
+  addPlayer(players, "b", 10.0F, 0.0F);
+  addPlayer(players, "c", 0.0F, 1.0F);
+
+  const auto events = detector.update(players, ProximityDetector::Clock::now());
+  ASSERT_EQ(events.size(), 1);
+  EXPECT_EQ(events.front().first, "a");
+  EXPECT_EQ(events.front().second, "c");
+  EXPECT_NEAR(events.front().distance, 1.0F, 1e-4F);
+  EXPECT_FALSE(events.front().cleared);
+  EXPECT_EQ(detector.getActivePairCount(), 1);
+}
+
+TEST(ProximityDetectorTest, ComputesClosingSpeed) {
+  ProximityDetector detector;
+  ProximityDetector::PlayerMap players;
+  addPlayer(players, "a", 0.0F, 0.0F);
+  addPlayer(players, "b", 1.4F, 0.0F);
+
+  const auto start = ProximityDetector::Clock::now();
+  detector.update(players, start);
+
+  // 100ms 内靠近 0.4 米 => 4 米/秒
+  addPlayer(players, "b", 1.0F, 0.0F);
+  const auto events = detector.update(players, start + 100ms);
+  ASSERT_EQ(events.size(), 1);
+  EXPECT_NEAR(events.front().closing_speed, 4.0F, 1e-2F);
+}
+
+TEST(ProximityDetectorTest, ClearsWithHysteresis) {
+  ProximityDetector detector(ProximityConfig{1.5F, 2.0F});
+  ProximityDetector::PlayerMap players;
+  addPlayer(players, "a", 0.0F, 0.0F);
+  addPlayer(players, "b", 1.0F, 0.0F);
+
+  auto now = ProximityDetector::Clock::now();
+  ASSERT_EQ(detector.update(players, now).size(), 1);
+
+  // 在警报与解除距离之间仍保持警报
+  addPlayer(players, "b", 1.8F, 0.0F);
+  auto events = detector.update(players, now += 50ms);
+  ASSERT_EQ(events.size(), 1);
+  EXPECT_FALSE(events.front().cleared);
+
+  addPlayer(players, "b", 3.0F, 0.0F);
+  events = detector.update(players, now += 50ms);
+  ASSERT_EQ(events.size(), 1);
+  EXPECT_TRUE(events.front().cleared);
+  EXPECT_EQ(detector.getActivePairCount(), 0);
+
+  // 解除后不再重复上报
+  EXPECT_TRUE(detector.update(players, now += 50ms).empty());
+
+  // 未触发的玩家对进入滞回区间不会触发
+  addPlayer(players, "b", 1.8F, 0.0F);
+  EXPECT_TRUE(detector.update(players, now += 50ms).empty());
+}
+
+TEST(ProximityDetectorTest, ClearsWhenPlayerLeaves) {
+  ProximityDetector detector;
+  ProximityDetector::PlayerMap players;
+  addPlayer(players, "a", 0.0F, 0.0F);
+  addPlayer(players, "b", 0.5F, 0.0F);
+
+  auto now = ProximityDetector::Clock::now();
+  detector.update(players, now);
+
+  players.erase("b");
+  const auto events = detector.update(players, now + 50ms);
+  ASSERT_EQ(events.size(), 1);
+  EXPECT_TRUE(events.front().cleared);
+}
+
+TEST(ProximityDetectorTest, IgnoresPlayersInOtherScenes) {
+  ProximityDetector detector;
+  ProximityDetector::PlayerMap players;
+  addPlayer(players, "a", 0.0F, 0.0F, "lobby");
+  addPlayer(players, "b", 0.0F, 0.0F, "arena");
+  EXPECT_TRUE(
+      detector.update(players, ProximityDetector::Clock::now()).empty());
+}
+
+TEST(ProximityDetectorTest, IgnoresPlayersWithoutPose) {
+  // 鉴权时的占位数据：无场景，位于原点
+  ProximityDetector detector;
+  ProximityDetector::PlayerMap players;
+  addPlayer(players, "a", 0.0F, 0.0F, "");
+  addPlayer(players, "b", 0.0F, 0.0F, "");
+  players["c"].set_player_id("c");
+  players["c"].set_scene_id("scene");
+  players["d"].set_player_id("d");
+  players["d"].set_scene_id("scene");
+  EXPECT_TRUE(
+      detector.update(players, ProximityDetector::Clock::now()).empty());
+  EXPECT_EQ(detector.getActivePairCount(), 0);
+}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "client.pb.h"
+#include "core/wire_format.hpp"
+
+using namespace picoradar::core;
+
+namespace {
+
+auto makeUpdate(const std::string& id) -> picoradar::ClientToServer {
+  picoradar::ClientToServer message;
+  auto* player = message.mutable_player_data();
+  player->set_player_id(id);
+  player->set_scene_id("scene");
+  player->mutable_position()->set_x(1.5F);
+  player->mutable_rotation()->set_w(1.0F);
+  player->set_timestamp(1234567890123);
+  return message;
+}
+
+}  // namespace
+
+TEST(WireFormatTest, FindsSubmessageBytes) {
+  const auto message = makeUpdate("player1");
+  const auto raw = message.SerializeAsString();
+
+  const auto payload = wire::findLengthDelimited(
+      raw, picoradar::ClientToServer::kPlayerDataFieldNumber);
+  ASSERT_TRUE(payload.has_value());
+  EXPECT_EQ(std::string(*payload), message.player_data().SerializeAsString());
+
+  EXPECT_FALSE(wire::findLengthDelimited(
+                   raw, picoradar::ClientToServer::kAuthRequestFieldNumber)
+                   .has_value());
+}
+
+TEST(WireFormatTest, SkipsOtherFieldTypes) {
+  // varint、fixed32、fixed64 字段夹在目标字段前后
+  std::string raw;
+  wire::appendVarint(raw, wire::makeTag(7, wire::kWireTypeVarint));
+  wire::appendVarint(raw, 300);
+  wire::appendVarint(raw, wire::makeTag(8, wire::kWireTypeFixed32));
+  raw.append(4, '\x01');
+  wire::appendLengthDelimited(raw, 2, "payload");
+  wire::appendVarint(raw, wire::makeTag(9, wire::kWireTypeFixed64));
+  raw.append(8, '\x02');
+
+  const auto payload = wire::findLengthDelimited(raw, 2);
+  ASSERT_TRUE(payload.has_value());
+  EXPECT_EQ(*payload, "payload");
+}
+
+TEST(WireFormatTest, RejectsRepeatedOrMalformedFields) {
+  // 重复出现的子消息在解析时会被合并，原始字节不再等价
+  std::string repeated;
+  wire::appendLengthDelimited(repeated, 2, "a");
+  wire::appendLengthDelimited(repeated, 2, "b");
+  EXPECT_FALSE(wire::findLengthDelimited(repeated, 2).has_value());
+
+  auto truncated = makeUpdate("player1").SerializeAsString();
+  truncated.pop_back();
+  EXPECT_FALSE(wire::findLengthDelimited(truncated, 2).has_value());
+
+  std::string bad_varint(11, '\xff');
+  EXPECT_FALSE(wire::findLengthDelimited(bad_varint, 2).has_value());
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include "core/worker_scaler.hpp"
+
+using picoradar::core::WorkerLoadSample;
+using picoradar::core::WorkerScaler;
+using picoradar::core::WorkerScalerConfig;
+using namespace std::chrono_literals;
+
+namespace {
+
+auto makeConfig() -> WorkerScalerConfig {
+  WorkerScalerConfig config;
+  config.min_workers = 1;
+  config.max_workers = 4;
+  config.scale_up_samples = 2;
+  config.scale_down_samples = 3;
+  return config;
+}
+
+const WorkerLoadSample kLagging{20ms, 0.1};
+const WorkerLoadSample kBusy{0us, 0.9};
+const WorkerLoadSample kIdle{0us, 0.05};
+const WorkerLoadSample kSteady{2ms, 0.5};
+
+}  // namespace
+
+// 测试用例: 连续过载后每次扩容一个线程，直到上限
+TEST(WorkerScalerTest, ScalesUpAfterSustainedOverload) {
+  WorkerScaler scaler(makeConfig());
+
+  EXPECT_EQ(scaler.update(1, kLagging), 1);
+  EXPECT_EQ(scaler.update(1, kLagging), 2);
+  EXPECT_EQ(scaler.update(2, kBusy), 2);  // 调整后重新计数
+  EXPECT_EQ(scaler.update(2, kBusy), 3);
+
+  EXPECT_EQ(scaler.update(3, kBusy), 3);
+  EXPECT_EQ(scaler.update(3, kBusy), 4);
+  EXPECT_EQ(scaler.update(4, kBusy), 4);
+  EXPECT_EQ(scaler.update(4, kBusy), 4);  // 已到上限
+}
+
+// 测试用例: 缩容比扩容慢，且不会低于下限
+TEST(WorkerScalerTest, ScalesDownSlowlyWhenIdle) {
+  WorkerScaler scaler(makeConfig());
+
+  EXPECT_EQ(scaler.update(2, kIdle), 2);
+  EXPECT_EQ(scaler.update(2, kIdle), 2);
+  EXPECT_EQ(scaler.update(2, kIdle), 1);
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(scaler.update(1, kIdle), 1);
+  }
+}
+
+// 测试用例: 中间状态的采样打断连续计数
+TEST(WorkerScalerTest, MixedSamplesHoldSteady) {
+  WorkerScaler scaler(makeConfig());
+
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(scaler.update(2, kLagging), 2);
+    EXPECT_EQ(scaler.update(2, kSteady), 2);
+    EXPECT_EQ(scaler.update(2, kIdle), 2);
+    EXPECT_EQ(scaler.update(2, kSteady), 2);
+  }
+}
+
+// 测试用例: 当前线程数超出范围时直接拉回范围内
+TEST(WorkerScalerTest, ClampsToConfiguredRange) {
+  auto config = makeConfig();
+  config.min_workers = 2;
+  WorkerScaler scaler(config);
+
+  EXPECT_EQ(scaler.update(1, kSteady), 2);
+  EXPECT_EQ(scaler.update(8, kSteady), 4);
+}
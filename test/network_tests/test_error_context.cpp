@@ -4,6 +4,7 @@
 #include <boost/beast/core/error.hpp>
 #include <boost/beast/websocket/error.hpp>
 
+#include "common/logging.hpp"
 #include "network/error_context.hpp"
 
 using namespace picoradar::network;
@@ -344,3 +345,37 @@ TEST_F(ErrorContextTest, PerformanceStressTest) {
   std::cout << "Logged " << num_logs << " errors in " << duration.count()
             << " ms" << std::endl;
 }
+
+/**
+ * @brief 风暴抑制按 logNetworkError 的调用方计数，不同调用点互不影响
+ */
+TEST_F(ErrorContextTest, NetworkErrorSuppressionKeyedByCaller) {
+  logger::LogConfig config;
+  config.file_enabled = false;
+  config.console_enabled = false;
+  config.format_pattern = "{message}";
+  config.dedup_enabled = true;
+  config.dedup_window_ms = 60000;
+  config.dedup_burst = 1;
+  logger::Logger::Init("test_error_context_dedup", config);
+
+  auto memory_stream = std::make_unique<logger::MemoryLogStream>(100);
+  auto* memory_ptr = memory_stream.get();
+  logger::Logger::addOutputStream(std::move(memory_stream));
+
+  const NetworkContext read_ctx("read", "127.0.0.1:1");
+  const NetworkContext accept_ctx("accept", "127.0.0.1:2");
+  const boost::beast::error_code error = boost::asio::error::connection_reset;
+
+  for (int i = 0; i < 5; ++i) {
+    ErrorLogger::logNetworkError(read_ctx, error);
+  }
+  ErrorLogger::logNetworkError(accept_ctx, error);
+
+  const auto entries = memory_ptr->getEntries();
+  logger::Logger::shutdown();
+
+  ASSERT_EQ(entries.size(), 2);
+  EXPECT_NE(entries[0].find("read"), std::string::npos);
+  EXPECT_NE(entries[1].find("accept"), std::string::npos);
+}
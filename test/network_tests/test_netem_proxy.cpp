@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <boost/asio.hpp>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "network/netem_proxy.hpp"
+
+namespace net = boost::asio;
+using tcp = net::ip::tcp;
+using picoradar::network::NetemDirection;
+using picoradar::network::NetemProfile;
+using picoradar::network::NetemProxy;
+using namespace std::chrono_literals;
+
+namespace {
+
+// 把收到的数据原样写回的会话
+class EchoSession : public std::enable_shared_from_this<EchoSession> {
+ public:
+  explicit EchoSession(tcp::socket socket) : socket_(std::move(socket)) {}
+
+  void start() { doRead(); }
+
+ private:
+  void doRead() {
+    socket_.async_read_some(
+        net::buffer(buffer_),
+        [self = shared_from_this()](boost::system::error_code ec,
+                                    std::size_t bytes) {
+          if (ec) {
+            return;
+          }
+          net::async_write(self->socket_, net::buffer(self->buffer_, bytes),
+                           [self](boost::system::error_code write_ec,
+                                  std::size_t /*bytes*/) {
+                             if (!write_ec) {
+                               self->doRead();
+                             }
+                           });
+        });
+  }
+
+  tcp::socket socket_;
+  std::array<char, 8192> buffer_{};
+};
+
+}  // namespace
+
+class NetemProxyTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    acceptor_.open(tcp::v4());
+    acceptor_.bind({net::ip::make_address("127.0.0.1"), 0});
+    acceptor_.listen();
+    doAccept();
+    echo_thread_ = std::thread([this] { echo_ioc_.run(); });
+
+    proxy_ = std::make_unique<NetemProxy>("127.0.0.1",
+                                          acceptor_.local_endpoint().port());
+    proxy_->start();
+  }
+
+  void TearDown() override {
+    proxy_->stop();
+    echo_ioc_.stop();
+    if (echo_thread_.joinable()) {
+      echo_thread_.join();
+    }
+  }
+
+  auto connect() -> tcp::socket {
+    tcp::socket socket(client_ioc_);
+    socket.connect({net::ip::make_address("127.0.0.1"), proxy_->getPort()});
+    socket.set_option(tcp::no_delay(true));
+    return socket;
+  }
+
+  // 发送 payload 并等待完整回显，返回往返耗时
+  auto roundTrip(tcp::socket& socket, const std::string& payload)
+      -> std::chrono::steady_clock::duration {
+    const auto started = std::chrono::steady_clock::now();
+    net::write(socket, net::buffer(payload));
+    std::string echoed(payload.size(), '\0');
+    net::read(socket, net::buffer(echoed));
+    EXPECT_EQ(echoed, payload);
+    return std::chrono::steady_clock::now() - started;
+  }
+
+  std::unique_ptr<NetemProxy> proxy_;
+
+ private:
+  void doAccept() {
+    acceptor_.async_accept(
+        [this](boost::system::error_code ec, tcp::socket socket) {
+          if (ec) {
+            return;
+          }
+          std::make_shared<EchoSession>(std::move(socket))->start();
+          doAccept();
+        });
+  }
+
+  net::io_context echo_ioc_;
+  tcp::acceptor acceptor_{echo_ioc_};
+  std::thread echo_thread_;
+  net::io_context client_ioc_;
+};
+
+TEST_F(NetemProxyTest, ForwardsTransparently) {
+  auto socket = connect();
+  const std::string payload(64 * 1024, 'x');
+  roundTrip(socket, payload);
+
+  EXPECT_EQ(proxy_->getConnectionCount(), 1);
+  EXPECT_EQ(proxy_->getBytesForwarded(NetemDirection::Upstream),
+            payload.size());
+  EXPECT_EQ(proxy_->getBytesForwarded(NetemDirection::Downstream),
+            payload.size());
+}
+
+TEST_F(NetemProxyTest, AddsLatencyInBothDirections) {
+  NetemProfile profile;
+  profile.latency = 50ms;
+  proxy_->setProfile(profile);
+
+  auto socket = connect();
+  EXPECT_GE(roundTrip(socket, "ping"), 100ms);
+}
+
+TEST_F(NetemProxyTest, CapsBandwidth) {
+  NetemProfile profile;
+  profile.bytes_per_sec = 50 * 1024;
+  proxy_->setProfile(NetemDirection::Downstream, profile);
+
+  auto socket = connect();
+  // 20KB 在 50KB/s 的下行链路上至少需要 400ms
+  EXPECT_GE(roundTrip(socket, std::string(20 * 1024, 'b')), 350ms);
+}
+
+TEST_F(NetemProxyTest, StallHoldsTraffic) {
+  auto socket = connect();
+  roundTrip(socket, "warmup");
+
+  proxy_->stallFor(200ms);
+  EXPECT_GE(roundTrip(socket, "stalled"), 190ms);
+  EXPECT_LT(roundTrip(socket, "resumed"), 190ms);
+}
+
+TEST_F(NetemProxyTest, DropConnectionsResetsClients) {
+  auto socket = connect();
+  roundTrip(socket, "hello");
+
+  proxy_->dropConnections();
+
+  std::array<char, 16> buffer{};
+  boost::system::error_code ec;
+  socket.read_some(net::buffer(buffer), ec);
+  EXPECT_TRUE(ec);
+  EXPECT_EQ(proxy_->getDroppedConnections(), 1);
+  EXPECT_EQ(proxy_->getConnectionCount(), 0);
+}
+
+TEST_F(NetemProxyTest, DropProbabilityResetsConnection) {
+  NetemProfile profile;
+  profile.drop_probability = 1.0;
+  proxy_->setProfile(NetemDirection::Upstream, profile);
+
+  auto socket = connect();
+  net::write(socket, net::buffer(std::string("doomed")));
+
+  std::array<char, 16> buffer{};
+  boost::system::error_code ec;
+  socket.read_some(net::buffer(buffer), ec);
+  EXPECT_TRUE(ec);
+  EXPECT_EQ(proxy_->getDroppedConnections(), 1);
+}
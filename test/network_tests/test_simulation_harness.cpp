@@ -0,0 +1,432 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/config_manager.hpp"
+#include "network/simulation_harness.hpp"
+#include "utils/player_utils.hpp"
+
+using picoradar::network::SimulationHarness;
+using picoradar::network::TickTrace;
+using picoradar::test::makePlayer;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr auto kToken = "simulation_token";
+
+constexpr auto kScene = "arena";
+constexpr float kHeight = 1.7F;  // 站立时的头显高度
+
+// 玩家沿各自的圆周移动，位置只取决于虚拟时间
+auto runCircleScenario(std::size_t players, std::chrono::milliseconds duration)
+    -> std::vector<TickTrace> {
+  SimulationHarness harness;
+  for (std::size_t i = 0; i < players; ++i) {
+    harness.connect("player_" + std::to_string(i));
+  }
+
+  harness.advance(duration, [&](std::chrono::milliseconds now) {
+    if (now.count() % 100 != 0) {
+      return;  // 10Hz 位姿更新
+    }
+    const float t = static_cast<float>(now.count()) / 1000.0F;
+    for (std::size_t i = 0; i < players; ++i) {
+      const float radius = 2.0F + static_cast<float>(i);
+      const auto id = "player_" + std::to_string(i);
+      harness.sendPose(id, makePlayer(id, kScene, radius * std::cos(t),
+                                      kHeight, radius * std::sin(t)));
+    }
+  });
+  return harness.getTrace();
+}
+
+}  // namespace
+
+class SimulationHarnessTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    picoradar::common::ConfigManager::getInstance().set("auth.token",
+                                                        std::string(kToken));
+  }
+};
+
+TEST_F(SimulationHarnessTest, AuthenticatesAndDeliversRoster) {
+  SimulationHarness harness;
+  std::size_t auth_ok = 0;
+  std::size_t largest_roster = 0;
+  harness.setOnFrame([&](const std::string& /*player_id*/,
+                         const picoradar::ServerToClient& frame) {
+    if (frame.has_auth_response() && frame.auth_response().success()) {
+      ++auth_ok;
+    }
+    if (frame.has_player_list()) {
+      largest_roster = std::max<std::size_t>(
+          largest_roster, frame.player_list().players_size());
+    }
+  });
+
+  harness.connect("a");
+  harness.connect("b");
+  harness.connect("c");
+  harness.advance(20ms);
+
+  EXPECT_EQ(auth_ok, 3);
+  EXPECT_EQ(largest_roster, 3);
+  EXPECT_EQ(harness.getRegistry().getPlayerCount(), 3);
+  EXPECT_EQ(harness.getServer().getConnectionCount(), 3);
+  EXPECT_EQ(harness.getTrace().size(), 2);
+  EXPECT_EQ(harness.getTrace().front().messages_received, 3);
+  EXPECT_EQ(harness.getTrace().back().total_queue_depth, 0);
+}
+
+TEST_F(SimulationHarnessTest, RejectedClientIsDisconnected) {
+  SimulationHarness harness;
+  harness.connect("");  // 空玩家 ID 会被服务器关闭
+  harness.advance(10ms);
+  EXPECT_EQ(harness.getServer().getConnectionCount(), 0);
+}
+
+TEST_F(SimulationHarnessTest, PeriodicTasksRunInVirtualTime) {
+  SimulationHarness harness;
+  std::size_t proximity_alerts = 0;
+  harness.setOnFrame([&](const std::string& /*player_id*/,
+                         const picoradar::ServerToClient& frame) {
+    if (frame.has_proximity_alert()) {
+      ++proximity_alerts;
+    }
+  });
+
+  harness.connect("a");
+  harness.connect("b");
+  harness.sendPose("a", makePlayer("a", kScene, 0.0F, kHeight, 0.0F));
+  harness.sendPose("b", makePlayer("b", kScene, 0.5F, kHeight, 0.0F));
+
+  // 接近检测默认每 50ms 运行一次，之前不会有警报
+  harness.advance(40ms);
+  EXPECT_EQ(proximity_alerts, 0);
+  harness.advance(10ms);
+  EXPECT_EQ(proximity_alerts, 2);  // 玩家对中的每个玩家各一条
+}
+
+TEST_F(SimulationHarnessTest, PlayersWithoutPoseRaiseNoProximityAlert) {
+  SimulationHarness harness;
+  std::size_t proximity_alerts = 0;
+  harness.setOnFrame([&](const std::string& /*player_id*/,
+                         const picoradar::ServerToClient& frame) {
+    if (frame.has_proximity_alert()) {
+      ++proximity_alerts;
+    }
+  });
+
+  // 两个玩家都只完成了鉴权，占位数据都位于原点
+  harness.connect("a");
+  harness.connect("b");
+  harness.advance(200ms);
+  EXPECT_EQ(harness.getRegistry().getPlayerCount(), 2);
+  EXPECT_EQ(proximity_alerts, 0);
+}
+
+TEST_F(SimulationHarnessTest, ScenarioIsDeterministicAndFasterThanRealTime) {
+  constexpr auto kDuration = 30s;
+
+  const auto started = std::chrono::steady_clock::now();
+  const auto first = runCircleScenario(20, kDuration);
+  const auto wall_time = std::chrono::steady_clock::now() - started;
+  const auto second = runCircleScenario(20, kDuration);
+
+  ASSERT_EQ(first.size(), 3000);
+  EXPECT_TRUE(first == second);
+  EXPECT_LT(wall_time, kDuration);
+
+  std::size_t received = 0;
+  for (const auto& tick : first) {
+    received += tick.messages_received;
+  }
+  EXPECT_EQ(received, 20 + 20 * 300);  // 认证 + 30 秒 10Hz 位姿
+}
+
+TEST_F(SimulationHarnessTest, SlowLinkBuildsQueue) {
+  SimulationHarness harness;
+  harness.connect("fast");
+  harness.connect("slow", 4000);  // 4 KB/s
+
+  harness.advance(5s, [&](std::chrono::milliseconds now) {
+    if (now.count() % 20 == 0) {
+      harness.sendPose("fast",
+                       makePlayer("fast", kScene, 0.0F, kHeight, 10.0F));
+      harness.sendPose("slow",
+                       makePlayer("slow", kScene, 0.0F, kHeight, -10.0F));
+    }
+  });
+
+  std::size_t deepest = 0;
+  for (const auto& tick : harness.getTrace()) {
+    deepest = std::max(deepest, tick.max_queue_depth);
+  }
+  EXPECT_GT(deepest, 0);
+  EXPECT_LT(harness.getFramesDelivered("slow"),
+            harness.getFramesDelivered("fast"));
+}
+
+TEST_F(SimulationHarnessTest, InjectedPlayersReachClientsAndObservers) {
+  SimulationHarness harness;
+  std::vector<picoradar::core::PlayerRegistry::ChangeSet> batches;
+  harness.getRegistry().addObserver(
+      [&](const picoradar::core::PlayerRegistry::ChangeSet& changes) {
+        batches.push_back(changes);
+      });
+
+  bool npc_seen = false;
+  bool npc_id_rejected = false;
+  harness.setOnFrame([&](const std::string& player_id,
+                         const picoradar::ServerToClient& frame) {
+    if (frame.has_player_list() && player_id == "a") {
+      for (const auto& player : frame.player_list().players()) {
+        npc_seen |= player.player_id() == "npc_guard";
+      }
+    }
+    if (frame.has_auth_response() && player_id == "npc_guard") {
+      npc_id_rejected = !frame.auth_response().success();
+    }
+  });
+
+  harness.connect("a");
+  harness.getServer().injectPlayer(
+      makePlayer("npc_guard", kScene, 5.0F, kHeight, 5.0F));
+  EXPECT_TRUE(harness.getServer().isInjectedPlayer("npc_guard"));
+  harness.connect("npc_guard");  // 客户端不能冒用 NPC 的 ID
+  harness.advance(20ms);
+
+  EXPECT_TRUE(npc_seen);
+  EXPECT_TRUE(npc_id_rejected);
+  ASSERT_EQ(batches.size(), 1);  // 20ms 内的变更合并为一个批次
+  EXPECT_EQ(batches[0].updated.size(), 2);
+  EXPECT_EQ(batches[0].snapshot->count("npc_guard"), 1);
+
+  harness.getServer().removeInjectedPlayer("npc_guard");
+  EXPECT_FALSE(harness.getServer().isInjectedPlayer("npc_guard"));
+  harness.advance(20ms);
+  ASSERT_EQ(batches.size(), 2);
+  EXPECT_EQ(batches[1].removed, std::vector<std::string>{"npc_guard"});
+}
+
+TEST_F(SimulationHarnessTest, InjectedIdsReadableFromOtherIoThreads) {
+  // 鉴权与位姿更新在其他 I/O 线程上检查 NPC 的 ID
+  SimulationHarness harness;
+  auto& server = harness.getServer();
+  std::atomic<bool> done{false};
+  std::thread reader([&] {
+    while (!done) {
+      (void)server.isInjectedPlayer("npc_0");
+    }
+  });
+
+  for (int i = 0; i < 200; ++i) {
+    const auto id = "npc_" + std::to_string(i % 4);
+    server.injectPlayer(makePlayer(id, kScene, 1.0F, kHeight, 1.0F));
+    EXPECT_TRUE(server.isInjectedPlayer(id));
+    server.removeInjectedPlayer(id);
+    EXPECT_FALSE(server.isInjectedPlayer(id));
+  }
+  done = true;
+  reader.join();
+}
+
+TEST_F(SimulationHarnessTest, SimulationThreadAppliesUpdatesOncePerTick) {
+  auto& config = picoradar::common::ConfigManager::getInstance();
+  config.set("network.simulation_thread.enabled", true);
+  config.set("network.simulation_thread.tick_ms", 20);
+  SimulationHarness harness;
+  config.set("network.simulation_thread.enabled", false);
+
+  std::size_t rosters = 0;
+  float last_b_x = 0.0F;
+  harness.setOnFrame([&](const std::string& player_id,
+                         const picoradar::ServerToClient& frame) {
+    if (player_id != "a" || !frame.has_player_list()) {
+      return;
+    }
+    ++rosters;
+    for (const auto& player : frame.player_list().players()) {
+      if (player.player_id() == "b") {
+        last_b_x = player.position().x();
+      }
+    }
+  });
+
+  // 鉴权只入队，注册表由模拟 tick 写入
+  harness.connect("a");
+  harness.connect("b");
+  EXPECT_EQ(harness.getRegistry().getPlayerCount(), 0);
+  harness.advance(20ms);
+  EXPECT_EQ(harness.getRegistry().getPlayerCount(), 2);
+  EXPECT_EQ(rosters, 1);
+
+  // 同一 tick 内的多次位姿更新合并为一次，最新的一条生效
+  for (int i = 1; i <= 5; ++i) {
+    harness.sendPose(
+        "b", makePlayer("b", kScene, static_cast<float>(i), kHeight, 0.0F));
+  }
+  harness.advance(20ms);
+  EXPECT_EQ(rosters, 2);
+  EXPECT_FLOAT_EQ(last_b_x, 5.0F);
+
+  harness.disconnect("b");
+  harness.advance(20ms);
+  EXPECT_EQ(harness.getRegistry().getPlayerCount(), 1);
+  EXPECT_EQ(rosters, 3);
+  EXPECT_EQ(harness.getServer().getIngestDropped(), 0);
+}
+
+TEST_F(SimulationHarnessTest, SpectatorsWatchWithoutJoiningRoster) {
+  SimulationHarness harness;
+  bool spectator_authenticated = false;
+  std::size_t spectator_rosters = 0;
+  std::size_t largest_roster = 0;
+  harness.setOnFrame([&](const std::string& player_id,
+                         const picoradar::ServerToClient& frame) {
+    if (player_id != "screen") {
+      return;
+    }
+    if (frame.has_auth_response()) {
+      spectator_authenticated = frame.auth_response().success();
+    }
+    if (frame.has_player_list()) {
+      ++spectator_rosters;
+      largest_roster = std::max<std::size_t>(
+          largest_roster, frame.player_list().players_size());
+    }
+  });
+
+  harness.connect("a");
+  harness.connect("screen", 0, picoradar::SESSION_CLASS_SPECTATOR);
+  harness.sendPose("a", makePlayer("a", kScene, 1.0F, kHeight, 0.0F));
+  harness.sendPose("screen",  // 被忽略
+                   makePlayer("screen", kScene, 2.0F, kHeight, 0.0F));
+  harness.advance(50ms);
+
+  EXPECT_TRUE(spectator_authenticated);
+  EXPECT_GT(spectator_rosters, 0);
+  EXPECT_EQ(largest_roster, 1);
+  EXPECT_EQ(harness.getRegistry().getPlayerCount(), 1);
+
+  // 断开旁观屏幕不会移除任何玩家
+  harness.disconnect("screen");
+  EXPECT_EQ(harness.getRegistry().getPlayerCount(), 1);
+}
+
+TEST_F(SimulationHarnessTest, ShedsSpectatorsBeforePlayers) {
+  SimulationHarness harness;
+  harness.connect("a");
+  harness.connect("screen", 0, picoradar::SESSION_CLASS_SPECTATOR);
+
+  // 玩家 100Hz 更新一秒；旁观屏幕默认最多 30Hz
+  const auto run_second = [&harness] {
+    harness.advance(1s, [&harness](std::chrono::milliseconds now) {
+      if (now.count() % 10 == 0) {
+        harness.sendPose("a", makePlayer("a", kScene, 0.0F, kHeight, 0.0F));
+      }
+    });
+  };
+  run_second();
+  const auto player_frames = harness.getFramesDelivered("a");
+  const auto spectator_frames = harness.getFramesDelivered("screen");
+  EXPECT_GE(player_frames, 100);
+  EXPECT_LE(spectator_frames, 32);
+  EXPECT_GE(spectator_frames, 25);
+  EXPECT_GT(harness.getServer().getFramesShed(), 0);
+
+  // 第一级：旁观屏幕降为 5Hz
+  auto& server = harness.getServer();
+  server.setShedLevel(1);
+  run_second();
+  EXPECT_GE(harness.getFramesDelivered("a") - player_frames, 100);
+  EXPECT_LE(harness.getFramesDelivered("screen") - spectator_frames, 6);
+
+  // 第二级：不再向旁观屏幕推送，玩家不受影响
+  server.setShedLevel(2);
+  const auto player_before = harness.getFramesDelivered("a");
+  const auto spectator_before = harness.getFramesDelivered("screen");
+  run_second();
+  EXPECT_GE(harness.getFramesDelivered("a") - player_before, 100);
+  EXPECT_EQ(harness.getFramesDelivered("screen"), spectator_before);
+
+  // 恢复后重新推送
+  server.setShedLevel(0);
+  run_second();
+  EXPECT_GT(harness.getFramesDelivered("screen"), spectator_before);
+}
+
+TEST_F(SimulationHarnessTest, SlowLinkSwitchesToCheaperEncodingAndBack) {
+  auto& config = picoradar::common::ConfigManager::getInstance();
+  config.set("network.adaptive_encoding.enabled", true);
+  SimulationHarness harness;
+  config.set("network.adaptive_encoding.enabled", false);
+
+  std::size_t compact_frames = 0;
+  harness.setOnFrame([&](const std::string& player_id,
+                         const picoradar::ServerToClient& frame) {
+    if (player_id == "slow" && frame.has_compact_player_list()) {
+      ++compact_frames;
+    }
+  });
+
+  constexpr int kPlayers = 20;
+  for (int i = 0; i < kPlayers; ++i) {
+    harness.connect("player_" + std::to_string(i));
+  }
+  harness.connect("slow", 8000, picoradar::SESSION_CLASS_PLAYER, true);
+
+  // 所有玩家 50Hz 移动，完整列表约 40 KB/s，远超 8 KB/s 的链路
+  const auto run = [&harness](std::chrono::milliseconds duration) {
+    harness.advance(duration, [&harness](std::chrono::milliseconds now) {
+      if (now.count() % 20 != 0) {
+        return;
+      }
+      const float t = static_cast<float>(now.count()) / 1000.0F;
+      for (int i = 0; i < kPlayers; ++i) {
+        const auto id = "player_" + std::to_string(i);
+        harness.sendPose(id, makePlayer(id, kScene, static_cast<float>(i) + t,
+                                        kHeight, t));
+      }
+    });
+  };
+  run(3s);
+
+  using picoradar::core::EncodingTier;
+  const auto slow = harness.getSession("slow");
+  const auto fast = harness.getSession("player_0");
+  ASSERT_TRUE(slow->isAdaptiveEncoding());
+  EXPECT_GE(slow->getEncodingTier(), EncodingTier::Compact);
+  EXPECT_EQ(fast->getEncodingTier(), EncodingTier::Full);
+  EXPECT_GT(compact_frames, 0);
+  const auto estimate = slow->getLinkEstimate();
+  ASSERT_TRUE(estimate.has_value());
+  EXPECT_GT(estimate->latency, 0us);
+
+  auto& server = harness.getServer();
+  const auto counts = server.getEncodingTierCounts();
+  EXPECT_EQ(counts[static_cast<std::size_t>(EncodingTier::Full)],
+            kPlayers);
+  EXPECT_GE(server.getEncodingSwitches(), 2);
+
+  // 链路恢复后逐级升回完整帧，且不会来回切换
+  harness.setLink("slow", 0);
+  run(10s);
+  EXPECT_EQ(slow->getEncodingTier(), EncodingTier::Full);
+  const auto switches = server.getEncodingSwitches();
+  run(3s);
+  EXPECT_EQ(server.getEncodingSwitches(), switches);
+
+  harness.disconnect("slow");
+  const auto remaining = server.getEncodingTierCounts();
+  EXPECT_EQ(remaining[static_cast<std::size_t>(EncodingTier::Full)],
+            kPlayers);
+}
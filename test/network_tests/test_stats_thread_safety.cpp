@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "core/player_registry.hpp"
+#include "network/simulation_harness.hpp"
 #include "network/websocket_server.hpp"
 
 class StatsThreadSafetyTest : public ::testing::Test {
@@ -170,6 +171,49 @@ TEST_F(StatsThreadSafetyTest, PlayerRegistryThreadSafety) {
   EXPECT_LE(registry_->getPlayerCount(), num_threads * operations_per_thread);
 }
 
+TEST_F(StatsThreadSafetyTest, SessionChurnDuringBroadcasts) {
+  picoradar::PlayerData player;
+  player.set_player_id("anchor");
+  registry_->updatePlayer("anchor", player);
+
+  // Sessions open and close on their own workers while periodic tasks and
+  // broadcasts walk the session list from another thread
+  std::atomic<bool> stop_flag{false};
+  std::vector<std::thread> churners;
+  for (int i = 0; i < 4; ++i) {
+    churners.emplace_back([this, i, &stop_flag] {
+      int n = 0;
+      while (!stop_flag) {
+        auto session = std::make_shared<picoradar::network::LoopbackSession>(
+            *server_, "churn_" + std::to_string(i) + "_" + std::to_string(n++));
+        session->setHeatmapSubscribed(true);
+        session->setGeofenceSubscribed(true);
+        server_->onSessionOpened(session);
+        server_->onSessionClosed(session);
+      }
+    });
+  }
+
+  std::size_t broadcasts = 0;
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+  while (std::chrono::steady_clock::now() < deadline) {
+    server_->broadcastPlayerList();
+    server_->broadcastHeatmap();
+    server_->checkProximity();
+    server_->checkGeofences();
+    ++broadcasts;
+  }
+  stop_flag = true;
+  for (auto& t : churners) {
+    t.join();
+  }
+
+  EXPECT_GT(broadcasts, 0);
+  EXPECT_EQ(server_->getConnectionCount(), 0);
+  EXPECT_TRUE(server_->getSessions()->empty());
+}
+
 // Test statistics reset behavior
 class StatsResetTest : public ::testing::Test {
  protected:
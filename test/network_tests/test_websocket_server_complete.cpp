@@ -4,9 +4,11 @@
 #include <boost/asio.hpp>
 #include <boost/beast.hpp>
 #include <chrono>
+#include <optional>
 #include <thread>
 
 #include "client.pb.h"
+#include "common/config_manager.hpp"
 #include "core/player_registry.hpp"
 #include "network/websocket_server.hpp"
 #include "server.pb.h"
@@ -114,6 +116,52 @@ TEST_F(WebSocketServerTest, BasicStartStop) {
   EXPECT_NO_THROW(server_->stop());
 }
 
+/**
+ * @brief 端口为 0 时由系统分配，getPort() 报告实际绑定的端口
+ */
+TEST_F(WebSocketServerTest, ReportsEphemeralPort) {
+  EXPECT_EQ(server_->getPort(), 0);
+  server_->start("127.0.0.1", 0, 1);
+  server_port_ = server_->getPort();
+  ASSERT_NE(server_port_, 0);
+  io_thread_ = std::thread([this] { ioc_->run(); });
+
+  auto client = createTestClient();
+  EXPECT_NE(client, nullptr) << "Client error: " << client_error_;
+}
+
+/**
+ * @brief stop() 返回前关闭客户端连接，而不是等服务器析构
+ */
+TEST_F(WebSocketServerTest, StopClosesClientConnections) {
+  startServer();
+  auto client = createTestClient();
+  ASSERT_NE(client, nullptr) << client_error_;
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ASSERT_EQ(server_->getConnectionCount(), 1);
+
+  const auto started = std::chrono::steady_clock::now();
+  server_->stop();
+  EXPECT_LT(std::chrono::steady_clock::now() - started,
+            std::chrono::milliseconds(500));
+
+  io_thread_.join();
+
+  // 服务器端套接字已经关闭，客户端读取立即失败而不是挂起
+  beast::flat_buffer buffer;
+  std::optional<beast::error_code> result;
+  client->async_read(buffer, [&](beast::error_code ec, std::size_t) {
+    result = ec;
+  });
+  ioc_->restart();
+  ioc_->run_for(std::chrono::seconds(2));
+  ASSERT_TRUE(result.has_value());
+  EXPECT_TRUE(*result == net::error::eof ||
+              *result == net::error::connection_reset ||
+              *result == websocket::error::closed)
+      << result->message();
+}
+
 /**
  * @brief 测试服务器初始统计信息
  */
@@ -292,6 +340,294 @@ TEST_F(WebSocketServerTest, PlayerRegistryIntegration) {
   EXPECT_TRUE(all_players.find("player2") != all_players.end());
 }
 
+/**
+ * @brief 测试单写者模式：位姿经摄入队列由模拟线程写入注册表并广播
+ */
+TEST_F(WebSocketServerTest, SimulationThreadAppliesQueuedUpdates) {
+  auto& config = picoradar::common::ConfigManager::getInstance();
+  config.set("auth.token", std::string("simulation_thread_token"));
+  config.set("network.simulation_thread.enabled", true);
+  server_ = std::make_unique<picoradar::network::WebsocketServer>(*ioc_,
+                                                                  *registry_);
+  startServer();
+  config.set("network.simulation_thread.enabled", false);
+  ASSERT_TRUE(server_error_.empty()) << "Server error: " << server_error_;
+
+  auto client = createTestClient();
+  ASSERT_NE(client, nullptr) << client_error_;
+  client->binary(true);
+
+  picoradar::ClientToServer auth;
+  auth.mutable_auth_request()->set_player_id("sim_player");
+  auth.mutable_auth_request()->set_token("simulation_thread_token");
+  client->write(net::buffer(auth.SerializeAsString()));
+
+  beast::flat_buffer buffer;
+  client->read(buffer);
+  picoradar::ServerToClient response;
+  ASSERT_TRUE(
+      response.ParseFromString(beast::buffers_to_string(buffer.data())));
+  ASSERT_TRUE(response.has_auth_response());
+  EXPECT_TRUE(response.auth_response().success());
+
+  for (int i = 1; i <= 10; ++i) {
+    picoradar::ClientToServer pose;
+    pose.mutable_player_data()->set_player_id("sim_player");
+    pose.mutable_player_data()->mutable_position()->set_x(
+        static_cast<float>(i));
+    client->write(net::buffer(pose.SerializeAsString()));
+  }
+
+  // 模拟线程按 tick 应用最新的位姿
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  float x = 0.0F;
+  while (std::chrono::steady_clock::now() < deadline) {
+    if (auto player = registry_->getPlayer("sim_player")) {
+      x = player->position().x();
+      if (x == 10.0F) {
+        break;
+      }
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_FLOAT_EQ(x, 10.0F);
+
+  buffer.clear();
+  client->read(buffer);
+  ASSERT_TRUE(
+      response.ParseFromString(beast::buffers_to_string(buffer.data())));
+  EXPECT_TRUE(response.has_player_list());
+  EXPECT_EQ(server_->getIngestDropped(), 0);
+
+  client->close(websocket::close_code::normal);
+}
+
+/**
+ * @brief 测试越界或重复槽位的追踪部位在入库前被裁剪
+ */
+TEST_F(WebSocketServerTest, TrimsInvalidTrackedBodies) {
+  auto& config = picoradar::common::ConfigManager::getInstance();
+  config.set("auth.token", std::string("tracked_bodies_token"));
+  startServer();
+  ASSERT_TRUE(server_error_.empty()) << "Server error: " << server_error_;
+
+  auto client = createTestClient();
+  ASSERT_NE(client, nullptr) << client_error_;
+  client->binary(true);
+
+  picoradar::ClientToServer auth;
+  auth.mutable_auth_request()->set_player_id("tracked_player");
+  auth.mutable_auth_request()->set_token("tracked_bodies_token");
+  client->write(net::buffer(auth.SerializeAsString()));
+  beast::flat_buffer buffer;
+  client->read(buffer);
+
+  auto sendBodies = [&](std::initializer_list<std::pair<int, float>> bodies) {
+    picoradar::ClientToServer pose;
+    auto* data = pose.mutable_player_data();
+    data->set_player_id("tracked_player");
+    for (const auto& [slot, x] : bodies) {
+      auto* body = data->add_bodies();
+      body->set_slot(static_cast<std::uint32_t>(slot));
+      body->mutable_position()->set_x(x);
+    }
+    client->write(net::buffer(pose.SerializeAsString()));
+  };
+  auto waitForBodies =
+      [&](int count) -> std::unique_ptr<picoradar::PlayerData> {
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (std::chrono::steady_clock::now() < deadline) {
+      auto player = registry_->getPlayer("tracked_player");
+      if (player && player->bodies_size() == count) {
+        return player;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return nullptr;
+  };
+
+  sendBodies({{0, 1.0F}, {3, 2.0F}});
+  auto player = waitForBodies(2);
+  ASSERT_NE(player, nullptr);
+  EXPECT_EQ(player->bodies(1).slot(), 3U);
+
+  sendBodies({{1, 1.0F}, {99, 2.0F}, {1, 3.0F}});
+  player = waitForBodies(1);
+  ASSERT_NE(player, nullptr);
+  EXPECT_EQ(player->bodies(0).slot(), 1U);
+  EXPECT_FLOAT_EQ(player->bodies(0).position().x(), 3.0F);
+
+  client->close(websocket::close_code::normal);
+}
+
+/**
+ * @brief 测试 I/O 线程池在运行时伸缩，缩容后仍能接受新连接
+ */
+TEST_F(WebSocketServerTest, WorkerPoolResizesAtRuntime) {
+  auto& config = picoradar::common::ConfigManager::getInstance();
+  config.set("network.workers.autoscale", true);
+  config.set("network.workers.min", 2);
+  config.set("network.workers.max", 4);
+  config.set("network.workers.probe_interval_ms", 20);
+  server_ = std::make_unique<picoradar::network::WebsocketServer>(*ioc_,
+                                                                  *registry_);
+  startServer();
+  config.set("network.workers.autoscale", false);
+  config.set("network.workers.min", 1);
+  config.set("network.workers.probe_interval_ms", 100);
+  ASSERT_TRUE(server_error_.empty()) << "Server error: " << server_error_;
+
+  // 以 1 个线程启动，自动伸缩把线程数拉到下限
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  while (server_->getWorkerCount() != 2 &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(server_->getWorkerCount(), 2);
+  EXPECT_TRUE(server_->isWorkerAutoscale());
+
+  // 手动设置关闭自动伸缩，并限制在 [1, max] 内
+  server_->setWorkerCount(4);
+  EXPECT_EQ(server_->getWorkerCount(), 4);
+  EXPECT_FALSE(server_->isWorkerAutoscale());
+  server_->setWorkerCount(1);
+  EXPECT_EQ(server_->getWorkerCount(), 1);
+  server_->setWorkerCount(10);
+  EXPECT_EQ(server_->getWorkerCount(), 4);
+  server_->setWorkerCount(1);
+
+  auto client = createTestClient();
+  ASSERT_NE(client, nullptr) << client_error_;
+  for (int i = 0; i < 100 && server_->getConnectionCount() != 1; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(server_->getConnectionCount(), 1);
+  client->close(websocket::close_code::normal);
+}
+
+/**
+ * @brief 测试同一场景的会话放在同一通道，并按负载整体迁移场景
+ */
+TEST_F(WebSocketServerTest, SceneAffinityPlacesAndRebalancesScenes) {
+  auto& config = picoradar::common::ConfigManager::getInstance();
+  config.set("auth.token", std::string("scene_affinity_token"));
+  config.set("network.scene_affinity.enabled", true);
+  config.set("network.scene_affinity.rebalance_interval_ms", 0);
+  config.set("network.workers.max", 2);
+  server_ = std::make_unique<picoradar::network::WebsocketServer>(*ioc_,
+                                                                  *registry_);
+  startServer();
+  config.set("network.scene_affinity.enabled", false);
+  config.set("network.workers.max", 16);
+  ASSERT_TRUE(server_error_.empty()) << "Server error: " << server_error_;
+  ASSERT_EQ(server_->getLaneCount(), 2);
+
+  const auto placed = [this] {
+    size_t total = 0;
+    for (auto load : server_->getLaneLoads()) {
+      total += load;
+    }
+    return total;
+  };
+
+  // 逐个加入，保证每个场景放置时看到的负载是确定的
+  std::vector<std::unique_ptr<websocket::stream<tcp::socket>>> clients;
+  const auto join = [&](const std::string& id, const std::string& scene) {
+    auto client = createTestClient();
+    ASSERT_NE(client, nullptr) << client_error_;
+    client->binary(true);
+
+    picoradar::ClientToServer auth;
+    auth.mutable_auth_request()->set_player_id(id);
+    auth.mutable_auth_request()->set_token("scene_affinity_token");
+    client->write(net::buffer(auth.SerializeAsString()));
+
+    picoradar::ClientToServer pose;
+    pose.mutable_player_data()->set_player_id(id);
+    pose.mutable_player_data()->set_scene_id(scene);
+    client->write(net::buffer(pose.SerializeAsString()));
+
+    const auto expected = clients.size() + 1;
+    for (int i = 0; i < 200 && placed() != expected; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(placed(), expected);
+    clients.push_back(std::move(client));
+  };
+
+  join("a1", "arena");  // 通道 0
+  join("b1", "lobby");  // 通道 1
+  join("c1", "court");  // 负载相同，取通道 0
+  join("c2", "court");
+  EXPECT_EQ(server_->getSceneLane("arena"), 0U);
+  EXPECT_EQ(server_->getSceneLane("lobby"), 1U);
+  EXPECT_EQ(server_->getSceneLane("court"), 0U);
+  EXPECT_EQ(server_->getLaneLoads(), (std::vector<size_t>{3, 1}));
+
+  // 只迁移小于负载差的场景，court 整体留在原通道
+  server_->rebalanceScenes();
+  EXPECT_EQ(server_->getSceneLane("arena"), 1U);
+  EXPECT_EQ(server_->getSceneLane("court"), 0U);
+  EXPECT_EQ(server_->getLaneLoads(), (std::vector<size_t>{2, 2}));
+  server_->rebalanceScenes();
+  EXPECT_EQ(server_->getSceneLane("arena"), 1U);
+
+  // 迁移后的会话仍能收到广播
+  picoradar::ClientToServer pose;
+  pose.mutable_player_data()->set_player_id("b1");
+  pose.mutable_player_data()->set_scene_id("lobby");
+  pose.mutable_player_data()->mutable_position()->set_x(7.0F);
+  clients[1]->write(net::buffer(pose.SerializeAsString()));
+
+  bool seen = false;
+  for (int i = 0; i < 20 && !seen; ++i) {
+    beast::flat_buffer buffer;
+    clients[0]->read(buffer);
+    picoradar::ServerToClient response;
+    ASSERT_TRUE(
+        response.ParseFromString(beast::buffers_to_string(buffer.data())));
+    for (const auto& player : response.player_list().players()) {
+      seen |= player.player_id() == "b1" && player.position().x() == 7.0F;
+    }
+  }
+  EXPECT_TRUE(seen);
+
+  // 迁移时读操作一直挂起，迁移后的会话仍能继续读取客户端消息
+  pose.mutable_player_data()->set_player_id("a1");
+  pose.mutable_player_data()->set_scene_id("arena");
+  pose.mutable_player_data()->mutable_position()->set_x(9.0F);
+  clients[0]->write(net::buffer(pose.SerializeAsString()));
+
+  seen = false;
+  for (int i = 0; i < 20 && !seen; ++i) {
+    beast::flat_buffer buffer;
+    clients[2]->read(buffer);
+    picoradar::ServerToClient response;
+    ASSERT_TRUE(
+        response.ParseFromString(beast::buffers_to_string(buffer.data())));
+    for (const auto& player : response.player_list().players()) {
+      seen |= player.player_id() == "a1" && player.position().x() == 9.0F;
+    }
+  }
+  EXPECT_TRUE(seen);
+
+  // 断开的会话释放所在通道的负载，空场景被移除
+  clients[1]->close(websocket::close_code::normal);
+  for (int i = 0; i < 200 && placed() != 3; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(server_->getLaneLoads(), (std::vector<size_t>{2, 1}));
+  EXPECT_FALSE(server_->getSceneLane("lobby").has_value());
+
+  for (auto& client : clients) {
+    beast::error_code ec;
+    client->close(websocket::close_code::normal, ec);
+  }
+}
+
 /**
  * @brief 测试服务器在不同线程数下的行为
  */
@@ -0,0 +1,292 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/config_manager.hpp"
+#include "common/constants.hpp"
+#include "common/logging.hpp"
+#include "load_generator.hpp"
+#include "server.hpp"
+#include "utils/network_utils.hpp"
+
+#ifdef __linux__
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+using picoradar::server::Server;
+using picoradar::server::LoadGenerator;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr auto kToken = "scalability_token";
+
+// 预算来自 docs/PERFORMANCE_TESTING_SPEC.md 的“可扩展性门禁”一节：
+// 约为 Release 构建在单核参考机上实测最大值的 1.5 倍，注释中为实测范围
+struct Budgets {
+  double rss_kb_per_session = 150.0;  // 60–98 KB
+  double fds_per_session = 2.1;  // 2.0：客户端与服务端各一个套接字
+  // 8–84 ms；沿用“延迟要求”，不按倍数收紧
+  double p99_broadcast_latency_ms = 100.0;
+  // 5.8–7.6 ms，1.5 倍即 11.4 ms。整个进程，含负载客户端；每条位姿都要
+  // 向 roster 会话序列化并解析约 1000 名玩家的列表
+  double cpu_us_per_message = 11400.0;
+  double cpu_utilization = 0.55;  // 0.27–0.35
+  double shutdown_ms = 75.0;  // 22–47 ms
+  double peak_rss_mb = 160.0;  // 68–106 MB
+};
+
+// 时间类预算只对优化构建有意义；未优化构建仍报告这些指标，但只检查资源预算
+#ifdef NDEBUG
+constexpr bool kTimingBudgetsEnforced = true;
+#else
+constexpr bool kTimingBudgetsEnforced = false;
+#endif
+
+// 负载参数：roster 会话接收完整玩家列表，其余会话只占用连接
+struct LoadProfile {
+  std::size_t sessions = 1000;
+  std::size_t roster_sessions = 5;  // 同时测量广播延迟
+  std::size_t ramp_batch = 50;  // 每批连接数；服务器握手超时为 1 秒
+  // 每个 roster 会话鉴权时都会触发一次全量列表广播，因此批次更小
+  std::size_t roster_batch = 10;
+  std::size_t senders = 10;
+  int rate_hz = 5;
+  std::chrono::milliseconds duration{2000};
+};
+
+auto envOr(const char* name, std::size_t fallback) -> std::size_t {
+  const char* value = std::getenv(name);
+  return value != nullptr ? std::strtoul(value, nullptr, 10) : fallback;
+}
+
+#ifdef __linux__
+auto readRssKb() -> double {
+  std::ifstream statm("/proc/self/statm");
+  long pages = 0;
+  long resident = 0;
+  statm >> pages >> resident;
+  return static_cast<double>(resident) *
+         static_cast<double>(sysconf(_SC_PAGESIZE)) / 1024.0;
+}
+
+auto countOpenFds() -> std::size_t {
+  const std::filesystem::path fd_dir("/proc/self/fd");
+  return static_cast<std::size_t>(
+      std::distance(std::filesystem::directory_iterator(fd_dir),
+                    std::filesystem::directory_iterator{}));
+}
+
+auto cpuTime() -> std::chrono::microseconds {
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  const auto to_us = [](const timeval& tv) {
+    return std::chrono::seconds(tv.tv_sec) +
+           std::chrono::microseconds(tv.tv_usec);
+  };
+  return to_us(usage.ru_utime) + to_us(usage.ru_stime);
+}
+
+// 每个会话需要客户端与服务端两个描述符，按需提高软限制
+auto ensureFdLimit(std::size_t needed) -> bool {
+  rlimit limit{};
+  if (getrlimit(RLIMIT_NOFILE, &limit) != 0) {
+    return false;
+  }
+  if (limit.rlim_cur >= needed) {
+    return true;
+  }
+  if (limit.rlim_max < needed) {
+    return false;
+  }
+  limit.rlim_cur = needed;
+  return setrlimit(RLIMIT_NOFILE, &limit) == 0;
+}
+#endif
+
+auto percentile(std::vector<std::int64_t>& samples, double p) -> double {
+  if (samples.empty()) {
+    return 0.0;
+  }
+  const auto index = static_cast<std::size_t>(
+      p * static_cast<double>(samples.size() - 1) + 0.5);
+  std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+  return static_cast<double>(samples[index]);
+}
+
+}  // namespace
+
+class ScalabilityTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+#ifndef __linux__
+    GTEST_SKIP() << "Resource measurements require /proc";
+#else
+    profile_.sessions = envOr("PICORADAR_SCALABILITY_SESSIONS",
+                              profile_.sessions);
+    profile_.roster_sessions = std::min(
+        profile_.sessions,
+        envOr("PICORADAR_SCALABILITY_ROSTER", profile_.roster_sessions));
+    profile_.senders = std::min(
+        profile_.sessions,
+        envOr("PICORADAR_SCALABILITY_SENDERS", profile_.senders));
+    profile_.rate_hz = static_cast<int>(
+        envOr("PICORADAR_SCALABILITY_RATE_HZ",
+              static_cast<std::size_t>(profile_.rate_hz)));
+    if (!ensureFdLimit(profile_.sessions * 2 + 256)) {
+      GTEST_SKIP() << "RLIMIT_NOFILE too low for " << profile_.sessions
+                   << " sessions";
+    }
+
+    port_ = picoradar::test::get_available_port();
+    auto& config = picoradar::common::ConfigManager::getInstance();
+    config.set("auth.token", std::string(kToken));
+    config.set("server.host", std::string("127.0.0.1"));
+    config.set("discovery.udp_port",
+               static_cast<int>(picoradar::test::get_available_port()));
+
+    // 每个连接都会产生日志，避免控制台输出主导测量结果
+    logger::Logger::setGlobalLevel(logger::LogLevel::WARNING);
+#endif
+  }
+
+  void TearDown() override {
+    logger::Logger::setGlobalLevel(logger::LogLevel::DEBUG);
+  }
+
+  LoadProfile profile_;
+  Budgets budgets_;
+  std::uint16_t port_ = 0;
+};
+
+#ifdef __linux__
+TEST_F(ScalabilityTest, ThousandSessionsWithinBudgets) {
+  const auto session_count = static_cast<double>(profile_.sessions);
+  const auto baseline_fds = countOpenFds();
+
+  auto server = std::make_unique<Server>();
+  server->start(port_, picoradar::constants::kDefaultThreadCount);
+  auto load = std::make_unique<LoadGenerator>("127.0.0.1", port_, kToken);
+  const auto idle_fds = countOpenFds();
+  const auto idle_rss_kb = readRssKb();
+
+  // 1. 分批爬升：纯负载会话先连接，roster 会话最后连接以避开鉴权广播
+  const auto connect_started = std::chrono::steady_clock::now();
+  const auto filler = profile_.sessions - profile_.roster_sessions;
+  for (std::size_t connected = 0; connected < profile_.sessions;) {
+    const bool roster = connected >= filler;
+    const auto batch =
+        roster ? std::min(profile_.roster_batch, profile_.sessions - connected)
+               : std::min(profile_.ramp_batch, filler - connected);
+    connected += batch;
+    ASSERT_EQ(load->connect(batch, roster, 10s), connected);
+  }
+  const auto connect_ms = std::chrono::duration<double, std::milli>(
+                              std::chrono::steady_clock::now() -
+                              connect_started)
+                              .count();
+  ASSERT_EQ(server->getConnectionCount(), profile_.sessions);
+
+  const double rss_kb_per_session =
+      (readRssKb() - idle_rss_kb) / session_count;
+  const double fds_per_session =
+      static_cast<double>(countOpenFds() - idle_fds) / session_count;
+
+  // 2. 稳态广播：senders 个会话按 rate_hz 发送位姿
+  load->takeLatencies();
+  const auto received_before = server->getMessagesReceived();
+  const auto cpu_before = cpuTime();
+  const auto send_started = std::chrono::steady_clock::now();
+  load->sendPoses(profile_.senders, profile_.rate_hz, profile_.duration);
+  std::this_thread::sleep_for(200ms);  // 让最后一批广播到达
+  const auto poses_sent = load->getPosesSent();
+  const auto cpu_used = cpuTime() - cpu_before;
+  const double cpu_utilization =
+      std::chrono::duration<double>(cpu_used).count() /
+      std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                    send_started)
+          .count();
+  const auto messages = server->getMessagesReceived() - received_before;
+
+  auto latencies = load->takeLatencies();
+  const double p50_ms = percentile(latencies, 0.50) / 1000.0;
+  const double p99_ms = percentile(latencies, 0.99) / 1000.0;
+  const double cpu_us_per_message =
+      messages == 0 ? 0.0
+                    : static_cast<double>(cpu_used.count()) /
+                          static_cast<double>(messages);
+  const double peak_rss_mb = readRssKb() / 1024.0;
+
+  // 3. 关闭：stop() 返回前关闭全部套接字，不依赖服务器析构
+  const auto shutdown_started = std::chrono::steady_clock::now();
+  server->stop();
+  const auto shutdown_ms = std::chrono::duration<double, std::milli>(
+                               std::chrono::steady_clock::now() -
+                               shutdown_started)
+                               .count();
+  EXPECT_TRUE(load->waitForClosed(10s));
+  server.reset();
+  load.reset();
+  const auto leaked_fds = static_cast<long>(countOpenFds()) -
+                          static_cast<long>(baseline_fds);
+
+  const nlohmann::json report = {
+      {"sessions", profile_.sessions},
+      {"roster_sessions", profile_.roster_sessions},
+      {"senders", profile_.senders},
+      {"rate_hz", profile_.rate_hz},
+      {"duration_ms", profile_.duration.count()},
+      {"connect_ms", connect_ms},
+      {"rss_kb_per_session", rss_kb_per_session},
+      {"fds_per_session", fds_per_session},
+      {"peak_rss_mb", peak_rss_mb},
+      {"poses_sent", poses_sent},
+      {"messages_received", messages},
+      {"latency_samples", latencies.size()},
+      {"p50_broadcast_latency_ms", p50_ms},
+      {"p99_broadcast_latency_ms", p99_ms},
+      {"cpu_us_per_message", cpu_us_per_message},
+      {"cpu_utilization", cpu_utilization},
+      {"shutdown_ms", shutdown_ms},
+      {"leaked_fds", leaked_fds},
+      {"budgets",
+       {{"rss_kb_per_session", budgets_.rss_kb_per_session},
+        {"fds_per_session", budgets_.fds_per_session},
+        {"p99_broadcast_latency_ms", budgets_.p99_broadcast_latency_ms},
+        {"cpu_us_per_message", budgets_.cpu_us_per_message},
+        {"cpu_utilization", budgets_.cpu_utilization},
+        {"shutdown_ms", budgets_.shutdown_ms},
+        {"peak_rss_mb", budgets_.peak_rss_mb}}}};
+
+  const char* report_path = std::getenv("PICORADAR_SCALABILITY_REPORT");
+  std::ofstream(report_path != nullptr ? report_path
+                                       : "scalability_report.json")
+      << report.dump(2) << "\n";
+  std::cout << report.dump(2) << std::endl;
+
+  EXPECT_FALSE(latencies.empty());
+  EXPECT_LE(rss_kb_per_session, budgets_.rss_kb_per_session);
+  EXPECT_LE(fds_per_session, budgets_.fds_per_session);
+  EXPECT_LE(peak_rss_mb, budgets_.peak_rss_mb);
+  EXPECT_LE(leaked_fds, 0);
+  if (!kTimingBudgetsEnforced) {
+    std::cout << "Unoptimized build: timing budgets not enforced"
+              << std::endl;
+    return;
+  }
+  EXPECT_LE(p99_ms, budgets_.p99_broadcast_latency_ms);
+  EXPECT_LE(cpu_us_per_message, budgets_.cpu_us_per_message);
+  EXPECT_LE(cpu_utilization, budgets_.cpu_utilization);
+  EXPECT_LE(shutdown_ms, budgets_.shutdown_ms);
+}
+#endif
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "common/config_manager.hpp"
+#include "common/logging.hpp"
+#include "self_test.hpp"
+
+using picoradar::server::SelfTest;
+using picoradar::server::SelfTestConfig;
+using picoradar::server::SelfTestStep;
+
+namespace {
+
+constexpr auto kToken = "self_test_token";
+
+class SelfTestTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    picoradar::common::ConfigManager::getInstance().set(
+        "auth.token", std::string(kToken));
+    logger::Logger::setGlobalLevel(logger::LogLevel::WARNING);
+  }
+
+  void TearDown() override {
+    logger::Logger::setGlobalLevel(logger::LogLevel::DEBUG);
+  }
+
+  // 两个频率、每个频率两档的短爬升
+  static auto shortRamp() -> SelfTestConfig {
+    SelfTestConfig config;
+    config.min_players = 2;
+    config.player_step = 2;
+    config.max_players = 4;
+    config.min_rate_hz = 10;
+    config.rate_step_hz = 10;
+    config.max_rate_hz = 20;
+    config.step_duration = std::chrono::milliseconds(500);
+    config.probes = 2;
+    config.threads = 1;
+    return config;
+  }
+};
+
+}  // namespace
+
+TEST_F(SelfTestTest, RampsWithinGenerousBudgets) {
+  auto config = shortRamp();
+  config.max_p99_latency_ms = 1000.0;
+  config.tick_budget = 1.0;
+
+  std::vector<SelfTestStep> seen;
+  SelfTest self_test(config);
+  const auto report = self_test.run(
+      [&seen](const SelfTestStep& step) { seen.push_back(step); });
+
+  ASSERT_EQ(report.steps.size(), 4);
+  EXPECT_EQ(seen.size(), report.steps.size());
+  for (const auto& step : report.steps) {
+    EXPECT_TRUE(step.passed) << step.limit;
+    EXPECT_GT(step.updates, 0);
+    EXPECT_GT(step.frames, 0);
+    EXPECT_GT(step.p99_latency_ms, 0.0);
+    // 每条更新都经过摄入、编码与分发
+    EXPECT_GT(step.ingest_us, 0.0);
+    EXPECT_GT(step.encode_us, 0.0);
+    EXPECT_GT(step.fanout_us, 0.0);
+  }
+  ASSERT_EQ(report.capacity.size(), 2);
+  EXPECT_EQ(report.capacity[0].rate_hz, 10);
+  EXPECT_EQ(report.capacity[0].players, 4);
+  EXPECT_TRUE(report.capacity[0].at_ceiling);
+  EXPECT_EQ(report.capacity[1].rate_hz, 20);
+  EXPECT_EQ(report.capacity[1].players, 4);
+
+  const auto lines = picoradar::server::formatSelfTestReport(report);
+  ASSERT_EQ(lines.size(), 3);
+  EXPECT_NE(lines[1].find(">= 4 players"), std::string::npos) << lines[1];
+}
+
+TEST_F(SelfTestTest, StopsAtFirstExceededBudget) {
+  auto config = shortRamp();
+  config.tick_budget = 0.0;  // 任何流水线耗时都超出预算
+
+  const auto report = SelfTest(config).run();
+
+  // 最小档位未通过，更高频率不再测试
+  ASSERT_EQ(report.steps.size(), 1);
+  EXPECT_FALSE(report.steps[0].passed);
+  EXPECT_EQ(report.steps[0].limit, "tick budget");
+  ASSERT_EQ(report.capacity.size(), 1);
+  EXPECT_EQ(report.capacity[0].players, 0);
+}
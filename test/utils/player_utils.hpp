@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cmath>
+#include <string>
+
+#include "player.pb.h"
+
+namespace picoradar::test {
+
+/**
+ * @brief 构造测试用的玩家位姿。
+ *
+ * 朝向为绕竖直轴旋转 yaw 弧度，默认 yaw = 0 即单位四元数。
+ * 其余字段（时间戳、追踪部位等）保持默认值，由测试按需设置。
+ */
+inline auto makePlayer(const std::string& id, const std::string& scene,
+                       float x, float y, float z, float yaw = 0.0F)
+    -> picoradar::PlayerData {
+  picoradar::PlayerData player;
+  player.set_player_id(id);
+  player.set_scene_id(scene);
+  player.mutable_position()->set_x(x);
+  player.mutable_position()->set_y(y);
+  player.mutable_position()->set_z(z);
+  player.mutable_rotation()->set_y(std::sin(yaw / 2.0F));
+  player.mutable_rotation()->set_w(std::cos(yaw / 2.0F));
+  return player;
+}
+
+}  // namespace picoradar::test
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <openssl/ec.h>
+#include <openssl/evp.h>
+#include <openssl/obj_mac.h>
+#include <openssl/pem.h>
+#include <openssl/x509.h>
+#include <openssl/x509v3.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace picoradar::test {
+
+/**
+ * @brief 测试用证书与私钥文件的路径。
+ */
+struct TestCertificate {
+  std::filesystem::path certificate_file;
+  std::filesystem::path private_key_file;
+};
+
+/**
+ * @brief 在 dir 下生成一份自签名的 P-256 证书。
+ *
+ * 证书对 127.0.0.1 与 localhost 有效，期限一天；客户端把证书本身作为
+ * 信任的 CA 即可通过完整的证书与主机名校验。
+ *
+ * @throws std::runtime_error 生成或写入失败时
+ */
+inline auto make_test_certificate(const std::filesystem::path& dir)
+    -> TestCertificate {
+  const auto fail = [](const char* what) {
+    throw std::runtime_error(std::string("Test certificate: ") + what);
+  };
+
+  std::unique_ptr<EVP_PKEY_CTX, decltype(&EVP_PKEY_CTX_free)> key_ctx(
+      EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr), &EVP_PKEY_CTX_free);
+  EVP_PKEY* raw_key = nullptr;
+  if (!key_ctx || EVP_PKEY_keygen_init(key_ctx.get()) != 1 ||
+      EVP_PKEY_CTX_set_ec_paramgen_curve_nid(key_ctx.get(),
+                                             NID_X9_62_prime256v1) != 1 ||
+      EVP_PKEY_keygen(key_ctx.get(), &raw_key) != 1) {
+    fail("key generation failed");
+  }
+  std::unique_ptr<EVP_PKEY, decltype(&EVP_PKEY_free)> key(raw_key,
+                                                          &EVP_PKEY_free);
+
+  std::unique_ptr<X509, decltype(&X509_free)> cert(X509_new(), &X509_free);
+  X509_set_version(cert.get(), 2);
+  ASN1_INTEGER_set(X509_get_serialNumber(cert.get()), 1);
+  X509_gmtime_adj(X509_getm_notBefore(cert.get()), 0);
+  X509_gmtime_adj(X509_getm_notAfter(cert.get()), 24 * 60 * 60);
+  X509_set_pubkey(cert.get(), key.get());
+
+  auto* name = X509_get_subject_name(cert.get());
+  X509_NAME_add_entry_by_txt(
+      name, "CN", MBSTRING_ASC,
+      reinterpret_cast<const unsigned char*>("localhost"), -1, -1, 0);
+  X509_set_issuer_name(cert.get(), name);
+
+  X509V3_CTX ext_ctx;
+  X509V3_set_ctx_nodb(&ext_ctx);
+  X509V3_set_ctx(&ext_ctx, cert.get(), cert.get(), nullptr, nullptr, 0);
+  auto* san = X509V3_EXT_conf_nid(nullptr, &ext_ctx, NID_subject_alt_name,
+                                  "IP:127.0.0.1,DNS:localhost");
+  if (san == nullptr) {
+    fail("subjectAltName failed");
+  }
+  X509_add_ext(cert.get(), san, -1);
+  X509_EXTENSION_free(san);
+
+  if (X509_sign(cert.get(), key.get(), EVP_sha256()) == 0) {
+    fail("signing failed");
+  }
+
+  TestCertificate result{dir / "test_cert.pem", dir / "test_key.pem"};
+  const auto write_pem = [&](const std::filesystem::path& path,
+                             const auto& writer) {
+    std::unique_ptr<FILE, decltype(&std::fclose)> file(
+        std::fopen(path.string().c_str(), "wb"), &std::fclose);
+    if (!file || writer(file.get()) != 1) {
+      fail("cannot write PEM file");
+    }
+  };
+  write_pem(result.certificate_file,
+            [&](FILE* file) { return PEM_write_X509(file, cert.get()); });
+  write_pem(result.private_key_file, [&](FILE* file) {
+    return PEM_write_PrivateKey(file, key.get(), nullptr, nullptr, 0,
+                                nullptr, nullptr);
+  });
+  return result;
+}
+
+}  // namespace picoradar::test